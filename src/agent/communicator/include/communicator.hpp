@@ -55,17 +55,21 @@ namespace communicator
         GetCommandsFromManager(std::function<void(const int, const std::string&)> onSuccess);
 
         /// @brief Processes messages in a stateful manner
-        /// @param getMessages A function to retrieve a message from the queue
+        /// @param getMessages A function to retrieve a batch of messages from the queue, given the batch size and the
+        /// number of messages at the head of the queue already being sent
         /// @param onSuccess A callback function to execute when a message is processed
         boost::asio::awaitable<void> StatefulMessageProcessingTask(
-            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> getMessages,
+            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const size_t)>
+                getMessages,
             std::function<void(const int, const std::string&)> onSuccess);
 
         /// @brief Processes messages in a stateless manner
-        /// @param getMessages A function to retrieve a message from the queue
+        /// @param getMessages A function to retrieve a batch of messages from the queue, given the batch size and the
+        /// number of messages at the head of the queue already being sent
         /// @param onSuccess A callback function to execute when a message is processed
         boost::asio::awaitable<void> StatelessMessageProcessingTask(
-            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> getMessages,
+            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const size_t)>
+                getMessages,
             std::function<void(const int, const std::string&)> onSuccess);
 
         /// @brief Retrieves group configuration from the manager
@@ -78,6 +82,25 @@ namespace communicator
         void Stop();
 
     private:
+        /// @brief A batch of messages sent to the manager
+        struct MessageBatch
+        {
+            /// @brief Number of messages in the batch
+            int messagesCount = 0;
+
+            /// @brief Whether the batch was sent compressed
+            bool compressed = false;
+
+            /// @brief Whether the request has completed
+            bool done = false;
+
+            /// @brief Status code of the response
+            int statusCode = 0;
+
+            /// @brief Body of the response
+            std::string responseBody;
+        };
+
         /// @brief Calculates the remaining time (in seconds) until the authentication token expires
         /// @return The remaining time in seconds until the authentication token expires
         long GetTokenRemainingSecs() const;
@@ -87,12 +110,30 @@ namespace communicator
 
         /// @brief Executes a request loop
         /// @param reqParams The parameters for the request
-        /// @param messageGetter Function to retrieve messages
         /// @param onSuccess Action to take on successful request
-        boost::asio::awaitable<void> ExecuteRequestLoop(
+        boost::asio::awaitable<void> ExecuteRequestLoop(http_client::HttpRequestParams reqParams,
+                                                        std::function<void(const int, const std::string&)> onSuccess);
+
+        /// @brief Sends batches of messages, keeping up to the configured number of them in flight
+        /// @details Batches are acknowledged through onSuccess in the order they were retrieved. If one of them fails,
+        /// the batches after it are not acknowledged either, and are retrieved and sent again once the retry
+        /// interval has passed. Must run on a strand, which the requests in flight share.
+        /// @param reqParams The parameters for the requests
+        /// @param messageGetter Function to retrieve messages
+        /// @param onSuccess Action to take on each acknowledged batch
+        boost::asio::awaitable<void> ProcessMessageBatches(
             http_client::HttpRequestParams reqParams,
-            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> messageGetter = {},
-            std::function<void(const int, const std::string&)> onSuccess = {});
+            std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const size_t)>
+                messageGetter,
+            std::function<void(const int, const std::string&)> onSuccess);
+
+        /// @brief Sends a single batch and stores the response in it
+        /// @param reqParams The parameters for the request, including the batch
+        /// @param batch The batch being sent
+        /// @param batchDone Timer cancelled once the request completes, to wake up ProcessMessageBatches
+        boost::asio::awaitable<void> SendMessageBatch(http_client::HttpRequestParams reqParams,
+                                                      std::shared_ptr<MessageBatch> batch,
+                                                      std::shared_ptr<boost::asio::steady_timer> batchDone);
 
         /// @brief Indicates if the communication process should keep running
         std::atomic<bool> m_keepRunning = true;
@@ -112,6 +153,18 @@ namespace communicator
         /// @brief Size for batch requests
         size_t m_batchSize;
 
+        /// @brief Compression of the event batches, "none" or "gzip"
+        std::string m_compression;
+
+        /// @brief Compression level of the event batches
+        int m_compressionLevel;
+
+        /// @brief Smallest event batch that is compressed, in bytes
+        size_t m_compressionMinSize;
+
+        /// @brief Maximum number of event batches of each type sent at the same time
+        size_t m_maxInflightBatches;
+
         /// @brief The server URL
         std::string m_serverUrl;
 
@@ -1,6 +1,7 @@
 #include <communicator.hpp>
 
 #include <config.h>
+#include <http_compression.hpp>
 #include <http_request_params.hpp>
 #include <logger.hpp>
 
@@ -12,6 +13,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
 #include <fstream>
 #include <thread>
 #include <utility>
@@ -20,6 +22,10 @@ namespace
 {
     constexpr auto MIN_BATCH_SIZE = 1000ULL;
     constexpr auto MAX_BATCH_SIZE = 100000000ULL;
+    constexpr auto MIN_COMPRESSION_LEVEL = 1;
+    constexpr auto MAX_COMPRESSION_LEVEL = 9;
+    constexpr auto MIN_INFLIGHT_BATCHES = 1;
+    constexpr auto MAX_INFLIGHT_BATCHES = 16;
 
     boost::asio::awaitable<void> WaitForTimer(std::shared_ptr<boost::asio::steady_timer> timer,
                                               const std::time_t retryInMillis)
@@ -78,6 +84,34 @@ namespace communicator
         m_batchSize = configurationParser->GetBytesConfigInRangeOrDefault(
             config::agent::DEFAULT_BATCH_SIZE, MIN_BATCH_SIZE, MAX_BATCH_SIZE, "events", "batch_size");
 
+        m_compression =
+            configurationParser->GetConfigOrDefault(config::agent::DEFAULT_COMPRESSION, "events", "compression");
+
+        if (std::find(std::begin(config::agent::VALID_COMPRESSIONS),
+                      std::end(config::agent::VALID_COMPRESSIONS),
+                      m_compression) == std::end(config::agent::VALID_COMPRESSIONS))
+        {
+            LogWarn("Incorrect value for 'compression', the default value '{}' is used.",
+                    config::agent::DEFAULT_COMPRESSION);
+            m_compression = config::agent::DEFAULT_COMPRESSION;
+        }
+
+        m_compressionLevel = configurationParser->GetConfigInRangeOrDefault(config::agent::DEFAULT_COMPRESSION_LEVEL,
+                                                                           std::optional {MIN_COMPRESSION_LEVEL},
+                                                                           std::optional {MAX_COMPRESSION_LEVEL},
+                                                                           "events",
+                                                                           "compression_level");
+
+        m_compressionMinSize = configurationParser->GetBytesConfigInRangeOrDefault(
+            config::agent::DEFAULT_COMPRESSION_MIN_SIZE, 0, MAX_BATCH_SIZE, "events", "compression_min_size");
+
+        m_maxInflightBatches = static_cast<size_t>(
+            configurationParser->GetConfigInRangeOrDefault(config::agent::DEFAULT_MAX_INFLIGHT_BATCHES,
+                                                           std::optional {MIN_INFLIGHT_BATCHES},
+                                                           std::optional {MAX_INFLIGHT_BATCHES},
+                                                           "events",
+                                                           "max_inflight_batches"));
+
         m_verificationMode = configurationParser->GetConfigOrDefault(
             config::agent::DEFAULT_VERIFICATION_MODE, "agent", "verification_mode");
 
@@ -265,11 +299,11 @@ namespace communicator
                                                               "",
                                                               "",
                                                               m_timeoutCommands);
-        co_await ExecuteRequestLoop(reqParams, {}, onSuccess);
+        co_await ExecuteRequestLoop(reqParams, onSuccess);
     }
 
     boost::asio::awaitable<void> Communicator::StatefulMessageProcessingTask(
-        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> getMessages,
+        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const size_t)> getMessages,
         std::function<void(const int, const std::string&)> onSuccess)
     {
         const auto reqParams = http_client::HttpRequestParams(http_client::MethodType::POST,
@@ -277,11 +311,14 @@ namespace communicator
                                                               "/api/v1/events/stateful",
                                                               m_getHeaderInfo ? m_getHeaderInfo() : "",
                                                               m_verificationMode);
-        co_await ExecuteRequestLoop(reqParams, getMessages, onSuccess);
+        const auto executor = co_await boost::asio::this_coro::executor;
+        co_await boost::asio::co_spawn(boost::asio::make_strand(executor),
+                                       ProcessMessageBatches(reqParams, getMessages, onSuccess),
+                                       boost::asio::use_awaitable);
     }
 
     boost::asio::awaitable<void> Communicator::StatelessMessageProcessingTask(
-        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> getMessages,
+        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const size_t)> getMessages,
         std::function<void(const int, const std::string&)> onSuccess)
     {
         const auto reqParams = http_client::HttpRequestParams(http_client::MethodType::POST,
@@ -289,7 +326,10 @@ namespace communicator
                                                               "/api/v1/events/stateless",
                                                               m_getHeaderInfo ? m_getHeaderInfo() : "",
                                                               m_verificationMode);
-        co_await ExecuteRequestLoop(reqParams, getMessages, onSuccess);
+        const auto executor = co_await boost::asio::this_coro::executor;
+        co_await boost::asio::co_spawn(boost::asio::make_strand(executor),
+                                       ProcessMessageBatches(reqParams, getMessages, onSuccess),
+                                       boost::asio::use_awaitable);
     }
 
     void Communicator::TryReAuthenticate()
@@ -352,10 +392,9 @@ namespace communicator
         co_return downloaded;
     }
 
-    boost::asio::awaitable<void> Communicator::ExecuteRequestLoop(
-        http_client::HttpRequestParams reqParams,
-        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t)> messageGetter,
-        std::function<void(const int, const std::string&)> onSuccess)
+    boost::asio::awaitable<void>
+    Communicator::ExecuteRequestLoop(http_client::HttpRequestParams reqParams,
+                                     std::function<void(const int, const std::string&)> onSuccess)
     {
         using namespace std::chrono_literals;
 
@@ -370,28 +409,6 @@ namespace communicator
                 continue;
             }
 
-            auto messagesCount = 0;
-
-            if (messageGetter != nullptr)
-            {
-                while (m_keepRunning.load())
-                {
-                    const auto messages = co_await messageGetter(m_batchSize);
-                    messagesCount = std::get<0>(messages);
-
-                    if (messagesCount)
-                    {
-                        LogTrace("Items count: {}", messagesCount);
-                        reqParams.Body = std::get<1>(messages);
-                        break;
-                    }
-                }
-            }
-            else
-            {
-                reqParams.Body = "";
-            }
-
             reqParams.Token = *m_token;
 
             const auto [statusCode, responseBody] = co_await m_httpClient->Co_PerformHttpRequest(reqParams);
@@ -402,7 +419,7 @@ namespace communicator
             {
                 if (onSuccess != nullptr)
                 {
-                    onSuccess(messagesCount, responseBody);
+                    onSuccess(0, responseBody);
                 }
             }
             else
@@ -421,6 +438,163 @@ namespace communicator
         } while (m_keepRunning.load());
     }
 
+    boost::asio::awaitable<void> Communicator::ProcessMessageBatches(
+        http_client::HttpRequestParams reqParams,
+        std::function<boost::asio::awaitable<std::tuple<int, std::string>>(const size_t, const size_t)> messageGetter,
+        std::function<void(const int, const std::string&)> onSuccess)
+    {
+        auto executor = co_await boost::asio::this_coro::executor;
+        auto timer = std::make_shared<boost::asio::steady_timer>(executor);
+        auto batchDone = std::make_shared<boost::asio::steady_timer>(executor);
+
+        // Turned off for this endpoint if the server doesn't accept compressed batches
+        auto compress = m_compression == http_client::CONTENT_ENCODING_GZIP;
+
+        std::deque<std::shared_ptr<MessageBatch>> window;
+        size_t messagesInFlight = 0;
+
+        // Set once a batch fails, new batches are not sent until the window drains and the retry interval passes
+        std::optional<std::time_t> retryIn;
+
+        while (m_keepRunning.load() || !window.empty())
+        {
+            // Acknowledge the completed batches at the head of the window, in order
+            while (!window.empty() && window.front()->done)
+            {
+                const auto batch = window.front();
+                window.pop_front();
+                messagesInFlight -= static_cast<size_t>(batch->messagesCount);
+
+                if (retryIn.has_value())
+                {
+                    // The messages of this batch are still at the head of the queue and will be sent again
+                    continue;
+                }
+
+                if (batch->statusCode >= http_client::HTTP_CODE_OK &&
+                    batch->statusCode < http_client::HTTP_CODE_MULTIPLE_CHOICES)
+                {
+                    if (onSuccess != nullptr)
+                    {
+                        onSuccess(batch->messagesCount, batch->responseBody);
+                    }
+                    continue;
+                }
+
+                if (batch->statusCode == http_client::HTTP_CODE_UNAUTHORIZED ||
+                    batch->statusCode == http_client::HTTP_CODE_FORBIDDEN)
+                {
+                    TryReAuthenticate();
+                }
+
+                if (batch->statusCode == http_client::HTTP_CODE_UNSUPPORTED_MEDIA_TYPE && batch->compressed)
+                {
+                    LogWarn("The server does not accept compressed batches on {}, sending them uncompressed.",
+                            reqParams.Endpoint);
+                    compress = false;
+                    retryIn = 0;
+                }
+                else
+                {
+                    retryIn = batch->statusCode != http_client::HTTP_CODE_TIMEOUT ? m_retryInterval
+                                                                                    : A_SECOND_IN_MILLIS;
+                }
+            }
+
+            if (retryIn.has_value() && window.empty())
+            {
+                if (*retryIn > 0 && m_keepRunning.load())
+                {
+                    co_await WaitForTimer(timer, *retryIn);
+                }
+                retryIn.reset();
+                continue;
+            }
+
+            if (m_keepRunning.load() && !retryIn.has_value() && window.size() < m_maxInflightBatches)
+            {
+                if (!m_token || m_token->empty())
+                {
+                    if (window.empty())
+                    {
+                        co_await WaitForTimer(timer, A_SECOND_IN_MILLIS);
+                        continue;
+                    }
+                }
+                else
+                {
+                    // With batches in flight the getter returns straight away, and only if a full batch is queued
+                    auto messages = co_await messageGetter(m_batchSize, messagesInFlight);
+                    const auto messagesCount = std::get<0>(messages);
+
+                    if (messagesCount > 0)
+                    {
+                        LogTrace("Items count: {}", messagesCount);
+
+                        auto batch = std::make_shared<MessageBatch>();
+                        batch->messagesCount = messagesCount;
+
+                        auto batchParams = reqParams;
+                        batchParams.Token = *m_token;
+
+                        auto& body = std::get<1>(messages);
+                        if (compress && body.size() >= m_compressionMinSize &&
+                            http_client::GzipCompress(body, batchParams.Body, m_compressionLevel))
+                        {
+                            LogTrace("Batch compressed from {} to {} bytes", body.size(), batchParams.Body.size());
+                            batchParams.Content_Encoding = http_client::CONTENT_ENCODING_GZIP;
+                            batch->compressed = true;
+                        }
+                        else
+                        {
+                            batchParams.Body = std::move(body);
+                        }
+
+                        window.push_back(batch);
+                        messagesInFlight += static_cast<size_t>(messagesCount);
+
+                        boost::asio::co_spawn(executor,
+                                              SendMessageBatch(std::move(batchParams), batch, batchDone),
+                                              boost::asio::detached);
+                        continue;
+                    }
+
+                    if (window.empty())
+                    {
+                        continue;
+                    }
+                }
+            }
+
+            if (!window.empty() && !window.front()->done)
+            {
+                batchDone->expires_at(std::chrono::steady_clock::time_point::max());
+
+                boost::system::error_code ec;
+                co_await batchDone->async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+        }
+    }
+
+    boost::asio::awaitable<void> Communicator::SendMessageBatch(http_client::HttpRequestParams reqParams,
+                                                                std::shared_ptr<MessageBatch> batch,
+                                                                std::shared_ptr<boost::asio::steady_timer> batchDone)
+    {
+        try
+        {
+            const auto [statusCode, responseBody] = co_await m_httpClient->Co_PerformHttpRequest(reqParams);
+            batch->statusCode = statusCode;
+            batch->responseBody = responseBody;
+        }
+        catch (const std::exception& e)
+        {
+            LogError("Error sending batch to {}: {}.", reqParams.Endpoint, e.what());
+        }
+
+        batch->done = true;
+        batchDone->cancel();
+    }
+
     void Communicator::Stop()
     {
         m_keepRunning.store(false);
@@ -16,11 +16,12 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
 
 using namespace testing;
-using GetMessagesFuncType = std::function<boost::asio::awaitable<intStringTuple>(const size_t)>;
+using GetMessagesFuncType = std::function<boost::asio::awaitable<intStringTuple>(const size_t, const size_t)>;
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
 MATCHER_P3(HttpRequestParamsCheck, expected, token, body, "Check http request params")
@@ -55,6 +56,25 @@ namespace
           batch_size: 1
     )"));
 
+    const auto MOCK_CONFIG_PARSER_COMPRESSION = std::make_shared<configuration::ConfigurationParser>(std::string(R"(
+        agent:
+          retry_interval: 5
+          verification_mode: none
+        events:
+          batch_size: 1
+          compression: gzip
+          compression_min_size: 0B
+    )"));
+
+    const auto MOCK_CONFIG_PARSER_PIPELINE = std::make_shared<configuration::ConfigurationParser>(std::string(R"(
+        agent:
+          retry_interval: 5
+          verification_mode: none
+        events:
+          batch_size: 1
+          max_inflight_batches: 2
+    )"));
+
     void SpawnCoroutine(std::function<boost::asio::awaitable<void>()> func)
     {
         boost::asio::io_context ioContext;
@@ -82,6 +102,20 @@ protected:
                                    { return {http_client::HTTP_CODE_OK, R"({"token":")" + token + R"("})"}; }));
     }
 
+    void UseConfig(const std::shared_ptr<configuration::ConfigurationParser>& configurationParser)
+    {
+        auto mockHttpClient = std::make_unique<MockHttpClient>();
+        m_mockHttpClientPtr = mockHttpClient.get();
+        testing::Mock::AllowLeak(m_mockHttpClientPtr);
+
+        m_communicator = std::make_shared<communicator::Communicator>(
+            std::move(mockHttpClient), configurationParser, "uuid", "key", nullptr);
+
+        EXPECT_CALL(*m_mockHttpClientPtr, PerformHttpRequest(testing::_))
+            .WillRepeatedly(Invoke([token = m_mockedToken]() -> intStringTuple
+                                   { return {http_client::HTTP_CODE_OK, R"({"token":")" + token + R"("})"}; }));
+    }
+
     void TearDown() override
     {
         m_mockedToken.clear();
@@ -138,7 +172,7 @@ TEST_F(CommunicatorTest, StatelessMessageProcessingTask_FailedAuthenticationLeav
         {
             m_communicator->SendAuthenticationRequest();
             co_await m_communicator->StatelessMessageProcessingTask(
-                [&getMessagesCalled](const size_t) -> boost::asio::awaitable<intStringTuple>
+                [&getMessagesCalled](const size_t, const size_t) -> boost::asio::awaitable<intStringTuple>
                 {
                     getMessagesCalled = true;
                     co_return intStringTuple {1, std::string {"message"}};
@@ -172,7 +206,7 @@ TEST_F(CommunicatorTest, StatelessMessageProcessingTask_CallsWithValidToken)
         {
             m_communicator->SendAuthenticationRequest();
             co_await m_communicator->StatelessMessageProcessingTask(
-                [&getMessagesCalled](const size_t) -> boost::asio::awaitable<intStringTuple>
+                [&getMessagesCalled](const size_t, const size_t) -> boost::asio::awaitable<intStringTuple>
                 {
                     getMessagesCalled = true;
                     co_return intStringTuple {1, std::string {"message"}};
@@ -184,6 +218,118 @@ TEST_F(CommunicatorTest, StatelessMessageProcessingTask_CallsWithValidToken)
     EXPECT_TRUE(onSuccessCalled);
 }
 
+TEST_F(CommunicatorTest, StatelessMessageProcessingTask_CompressesBatchWhenConfigured)
+{
+    UseConfig(MOCK_CONFIG_PARSER_COMPRESSION);
+
+    EXPECT_CALL(*m_mockHttpClientPtr,
+                Co_PerformHttpRequest(AllOf(Field(&http_client::HttpRequestParams::Content_Encoding, "gzip"),
+                                            Field(&http_client::HttpRequestParams::Body, StartsWith("\x1f\x8b")))))
+        .WillOnce(Invoke(
+            [this]() -> boost::asio::awaitable<intStringTuple>
+            {
+                m_communicator->Stop();
+                co_return intStringTuple {http_client::HTTP_CODE_OK, "Dummy response"};
+            }));
+
+    auto onSuccessCalled = false;
+
+    SpawnCoroutine(
+        [this, &onSuccessCalled]() mutable -> boost::asio::awaitable<void>
+        {
+            m_communicator->SendAuthenticationRequest();
+            co_await m_communicator->StatelessMessageProcessingTask(
+                [](const size_t, const size_t) -> boost::asio::awaitable<intStringTuple>
+                { co_return intStringTuple {1, std::string {"message"}}; },
+                [&onSuccessCalled](const int, const std::string&) { onSuccessCalled = true; });
+        });
+
+    EXPECT_TRUE(onSuccessCalled);
+}
+
+TEST_F(CommunicatorTest, StatelessMessageProcessingTask_SendsUncompressedIfServerRejectsCompression)
+{
+    UseConfig(MOCK_CONFIG_PARSER_COMPRESSION);
+
+    const InSequence seq;
+
+    EXPECT_CALL(*m_mockHttpClientPtr,
+                Co_PerformHttpRequest(Field(&http_client::HttpRequestParams::Content_Encoding, "gzip")))
+        .WillOnce(Invoke(
+            []() -> boost::asio::awaitable<intStringTuple>
+            { co_return intStringTuple {http_client::HTTP_CODE_UNSUPPORTED_MEDIA_TYPE, "Unsupported Media Type"}; }));
+
+    EXPECT_CALL(*m_mockHttpClientPtr,
+                Co_PerformHttpRequest(AllOf(Field(&http_client::HttpRequestParams::Content_Encoding, ""),
+                                            Field(&http_client::HttpRequestParams::Body, "message"))))
+        .WillOnce(Invoke(
+            [this]() -> boost::asio::awaitable<intStringTuple>
+            {
+                m_communicator->Stop();
+                co_return intStringTuple {http_client::HTTP_CODE_OK, "Dummy response"};
+            }));
+
+    auto getMessagesCalls = 0;
+    auto onSuccessCalls = 0;
+
+    SpawnCoroutine(
+        [this, &getMessagesCalls, &onSuccessCalls]() mutable -> boost::asio::awaitable<void>
+        {
+            m_communicator->SendAuthenticationRequest();
+            co_await m_communicator->StatelessMessageProcessingTask(
+                [&getMessagesCalls](const size_t, const size_t) -> boost::asio::awaitable<intStringTuple>
+                {
+                    ++getMessagesCalls;
+                    co_return intStringTuple {1, std::string {"message"}};
+                },
+                [&onSuccessCalls](const int, const std::string&) { ++onSuccessCalls; });
+        });
+
+    EXPECT_EQ(getMessagesCalls, 2);
+    EXPECT_EQ(onSuccessCalls, 1);
+}
+
+TEST_F(CommunicatorTest, StatelessMessageProcessingTask_SendsBatchesWithoutWaitingForResponses)
+{
+    UseConfig(MOCK_CONFIG_PARSER_PIPELINE);
+
+    std::vector<size_t> skips;
+    std::vector<std::string> acknowledged;
+
+    EXPECT_CALL(*m_mockHttpClientPtr, Co_PerformHttpRequest(Field(&http_client::HttpRequestParams::Body, "first")))
+        .WillOnce(Invoke(
+            [&skips]() -> boost::asio::awaitable<intStringTuple>
+            {
+                // Both batches are requested before the first response arrives
+                EXPECT_EQ(skips.size(), 2);
+                co_return intStringTuple {http_client::HTTP_CODE_OK, "first"};
+            }));
+
+    EXPECT_CALL(*m_mockHttpClientPtr, Co_PerformHttpRequest(Field(&http_client::HttpRequestParams::Body, "second")))
+        .WillOnce(Invoke(
+            [this]() -> boost::asio::awaitable<intStringTuple>
+            {
+                m_communicator->Stop();
+                co_return intStringTuple {http_client::HTTP_CODE_OK, "second"};
+            }));
+
+    SpawnCoroutine(
+        [this, &skips, &acknowledged]() mutable -> boost::asio::awaitable<void>
+        {
+            m_communicator->SendAuthenticationRequest();
+            co_await m_communicator->StatelessMessageProcessingTask(
+                [&skips](const size_t, const size_t skip) -> boost::asio::awaitable<intStringTuple>
+                {
+                    skips.push_back(skip);
+                    co_return intStringTuple {1, std::string {skip == 0 ? "first" : "second"}};
+                },
+                [&acknowledged](const int, const std::string& response) { acknowledged.push_back(response); });
+        });
+
+    EXPECT_EQ(skips, (std::vector<size_t> {0, 1}));
+    EXPECT_EQ(acknowledged, (std::vector<std::string> {"first", "second"}));
+}
+
 TEST_F(CommunicatorTest, GetCommandsFromManager_CallsWithValidToken)
 {
     const auto timeout = static_cast<time_t>(11) * 60 * 1000;
@@ -2,6 +2,7 @@
 
 #include <ihttp_client.hpp>
 
+#include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/awaitable.hpp>
 
 #include <functional>
@@ -11,7 +12,10 @@
 
 namespace http_client
 {
+    class HttpConnectionPool;
+    class HttpResolverCache;
     class IHttpResolverFactory;
+    class IHttpSocket;
     class IHttpSocketFactory;
 
     /// @brief HTTP client implementation
@@ -27,7 +31,24 @@ namespace http_client
         HttpClient(std::shared_ptr<IHttpResolverFactory> resolverFactory = nullptr,
                    std::shared_ptr<IHttpSocketFactory> socketFactory = nullptr);
 
+        /// @brief Destroys the HttpClient, closing its pooled connections
+        ~HttpClient() override;
+
+        /// @brief Deleted copy constructor
+        HttpClient(const HttpClient&) = delete;
+
+        /// @brief Deleted copy assignment operator
+        HttpClient& operator=(const HttpClient&) = delete;
+
+        /// @brief Deleted move constructor
+        HttpClient(HttpClient&&) = delete;
+
+        /// @brief Deleted move assignment operator
+        HttpClient& operator=(HttpClient&&) = delete;
+
         /// @brief Performs an asynchronous HTTP request
+        /// @details Connections are kept alive and reused by later requests to the same host. A request that fails
+        /// on a reused connection, which the server may have closed meanwhile, is retried once on a new one.
         /// @param params Parameters for the request
         /// @return An awaitable tuple containing the response status code and body
         boost::asio::awaitable<std::tuple<int, std::string>>
@@ -39,10 +60,23 @@ namespace http_client
         std::tuple<int, std::string> PerformHttpRequest(const HttpRequestParams& params) override;
 
     private:
+        /// @brief Opens a new connection for a request
+        /// @param executor The executor to use for the connection
+        /// @param params Parameters for the request
+        /// @return An awaitable connected socket. Throws if the host can't be resolved or connected to.
+        boost::asio::awaitable<std::unique_ptr<IHttpSocket>> Co_Connect(boost::asio::any_io_executor executor,
+                                                                        const HttpRequestParams& params);
+
         /// @brief HTTP resolver factory
         std::shared_ptr<IHttpResolverFactory> m_resolverFactory;
 
         /// @brief HTTP socket factory
         std::shared_ptr<IHttpSocketFactory> m_socketFactory;
+
+        /// @brief Idle keep-alive connections
+        std::unique_ptr<HttpConnectionPool> m_connectionPool;
+
+        /// @brief Recently resolved hosts
+        std::unique_ptr<HttpResolverCache> m_resolverCache;
     };
 } // namespace http_client
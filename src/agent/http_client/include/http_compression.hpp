@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace http_client
+{
+    /// @brief Content-Encoding of gzip compressed bodies
+    constexpr auto CONTENT_ENCODING_GZIP = "gzip";
+
+    /// @brief Compresses data in gzip format
+    /// @details The output grows as the deflate stream produces data, so no buffer the size of the worst case is
+    /// reserved up front.
+    /// @param input The data to compress
+    /// @param output String the compressed data is written to, replacing its contents
+    /// @param level Compression level, from 1 (fastest) to 9 (smallest)
+    /// @return true if the data was compressed, false otherwise
+    bool GzipCompress(std::string_view input, std::string& output, int level);
+} // namespace http_client
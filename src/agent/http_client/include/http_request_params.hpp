@@ -12,6 +12,7 @@ namespace http_client
     constexpr int HTTP_CODE_UNAUTHORIZED = 401;
     constexpr int HTTP_CODE_FORBIDDEN = 403;
     constexpr int HTTP_CODE_TIMEOUT = 408;
+    constexpr int HTTP_CODE_UNSUPPORTED_MEDIA_TYPE = 415;
     constexpr int HTTP_CODE_INTERNAL_SERVER_ERROR = 500;
 
     /// @brief Supported HTTP methods
@@ -36,6 +37,7 @@ namespace http_client
         std::string Token;
         std::string User_pass;
         std::string Body;
+        std::string Content_Encoding;
         bool Use_Https;
         time_t RequestTimeout;
 
@@ -1,5 +1,7 @@
 #include <http_client.hpp>
 
+#include "http_connection_pool.hpp"
+#include "http_resolver_cache.hpp"
 #include "http_resolver_factory.hpp"
 #include "http_socket_factory.hpp"
 #include "ihttp_resolver_factory.hpp"
@@ -29,6 +31,24 @@ namespace
         }
     }
 
+    /// @brief Tells whether a request that failed on a reused connection can be sent again on a new one.
+    /// @details A kept-alive connection closed by the server makes the write fail, or the read end before any byte
+    /// of the response arrives. Any other failure, a timeout above all, may come after the server got the request,
+    /// which must not reach it twice.
+    /// @param ec The error the request failed with.
+    /// @param written Whether the request had been fully written when it failed.
+    /// @return True if the request can be retried.
+    bool IsClosedConnectionError(const boost::system::error_code& ec, bool written)
+    {
+        if (ec == boost::asio::error::operation_aborted || ec == boost::beast::error::timeout)
+        {
+            return false;
+        }
+
+        return !written || ec == boost::beast::http::error::end_of_stream ||
+               ec == boost::asio::error::connection_reset;
+    }
+
     boost::beast::http::request<boost::beast::http::string_body>
     CreateHttpRequest(const http_client::HttpRequestParams& params)
     {
@@ -60,6 +80,12 @@ namespace
         {
             req.set(boost::beast::http::field::content_type, "application/json");
             req.set(boost::beast::http::field::transfer_encoding, "chunked");
+
+            if (!params.Content_Encoding.empty())
+            {
+                req.set(boost::beast::http::field::content_encoding, params.Content_Encoding);
+            }
+
             req.body() = params.Body;
             req.prepare_payload();
         }
@@ -67,6 +93,12 @@ namespace
         return req;
     }
 
+    std::string ConnectionPoolKey(const http_client::HttpRequestParams& params)
+    {
+        return (params.Use_Https ? "https://" : "http://") + params.Host + ":" + params.Port + " " +
+               params.Verification_Mode;
+    }
+
     std::string ResponseToString(const std::string& endpoint,
                                  const boost::beast::http::response<boost::beast::http::dynamic_body>& res)
     {
@@ -98,65 +130,130 @@ namespace http_client
         {
             m_socketFactory = std::make_shared<HttpSocketFactory>();
         }
+
+        m_connectionPool = std::make_unique<HttpConnectionPool>();
+        m_resolverCache = std::make_unique<HttpResolverCache>();
     }
 
-    boost::asio::awaitable<std::tuple<int, std::string>>
-    HttpClient::Co_PerformHttpRequest(const HttpRequestParams params)
+    HttpClient::~HttpClient() = default;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    boost::asio::awaitable<std::unique_ptr<IHttpSocket>> HttpClient::Co_Connect(boost::asio::any_io_executor executor,
+                                                                               const HttpRequestParams& params)
     {
-        boost::beast::http::response<boost::beast::http::dynamic_body> res;
+        auto results = m_resolverCache->Get(params.Host, params.Port);
 
-        try
+        if (results.empty())
         {
-            auto executor = co_await boost::asio::this_coro::executor;
             auto resolver = m_resolverFactory->Create(executor);
 
-            const auto results = co_await resolver->AsyncResolve(params.Host, params.Port);
+            results = co_await resolver->AsyncResolve(params.Host, params.Port);
 
             if (results.empty())
             {
                 throw std::runtime_error("Failed to resolve host.");
             }
 
-            auto socket = m_socketFactory->Create(executor, params.Use_Https);
+            m_resolverCache->Put(params.Host, params.Port, results);
+        }
 
-            if (!socket)
-            {
-                throw std::runtime_error("Failed to create socket.");
-            }
+        auto socket = m_socketFactory->Create(executor, params.Use_Https);
 
-            if (params.Use_Https)
-            {
-                socket->SetVerificationMode(params.Host, params.Verification_Mode);
-            }
+        if (!socket)
+        {
+            throw std::runtime_error("Failed to create socket.");
+        }
 
-            if (params.RequestTimeout)
-            {
-                socket->SetTimeout(std::chrono::milliseconds(params.RequestTimeout));
-            }
+        if (params.Use_Https)
+        {
+            socket->SetVerificationMode(params.Host, params.Verification_Mode);
+        }
 
-            boost::system::error_code ec;
+        if (params.RequestTimeout)
+        {
+            socket->SetTimeout(std::chrono::milliseconds(params.RequestTimeout));
+        }
 
-            co_await socket->AsyncConnect(results, ec);
+        boost::system::error_code ec;
 
-            if (ec)
-            {
-                throw std::runtime_error("Error connecting to host: " + ec.message());
-            }
+        co_await socket->AsyncConnect(results, ec);
 
+        if (ec)
+        {
+            // The host may have moved, resolve it again next time
+            m_resolverCache->Invalidate(params.Host, params.Port);
+            throw std::runtime_error("Error connecting to host: " + ec.message());
+        }
+
+        co_return socket;
+    }
+
+    boost::asio::awaitable<std::tuple<int, std::string>>
+    HttpClient::Co_PerformHttpRequest(const HttpRequestParams params)
+    {
+        boost::beast::http::response<boost::beast::http::dynamic_body> res;
+
+        try
+        {
+            auto executor = co_await boost::asio::this_coro::executor;
+            const auto poolKey = ConnectionPoolKey(params);
             const auto req = CreateHttpRequest(params);
 
-            co_await socket->AsyncWrite(req, ec);
+            // Held until the request is done, whether the connection is kept or not
+            const auto slot = co_await m_connectionPool->AcquireSlot(poolKey);
 
-            if (ec)
+            auto socket = m_connectionPool->Acquire(poolKey, executor);
+            auto reused = socket != nullptr;
+
+            if (reused)
             {
-                throw std::runtime_error("Error writing request: " + ec.message());
+                socket->SetTimeout(params.RequestTimeout ? std::chrono::milliseconds(params.RequestTimeout)
+                                                         : SOCKET_TIMEOUT);
             }
 
-            co_await socket->AsyncRead(res, ec);
+            boost::system::error_code ec;
+            std::string failedStep;
+
+            while (true)
+            {
+                if (!socket)
+                {
+                    socket = co_await Co_Connect(executor, params);
+                }
+
+                co_await socket->AsyncWrite(req, ec);
+                failedStep = "Error writing request: ";
+
+                const auto written = !ec;
+
+                if (written)
+                {
+                    co_await socket->AsyncRead(res, ec);
+                    failedStep = "Error handling response: ";
+                }
+
+                if (ec && reused && IsClosedConnectionError(ec, written))
+                {
+                    // The server may have closed the idle connection meanwhile
+                    LogDebug("Request {} failed on a reused connection: {}. Retrying.", params.Endpoint, ec.message());
+                    socket.reset();
+                    reused = false;
+                    ec.clear();
+                    res = {};
+                    continue;
+                }
+
+                break;
+            }
 
             if (ec)
             {
-                throw std::runtime_error("Error handling response: " + ec.message());
+                throw std::runtime_error(failedStep + ec.message());
+            }
+
+            if (res.keep_alive())
+            {
+                m_connectionPool->Release(poolKey, executor, std::move(socket));
             }
 
             LogDebug("Request {}: Status {}", params.Endpoint, res.result_int());
@@ -0,0 +1,73 @@
+#include <http_compression.hpp>
+
+#include <logger.hpp>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    // Adding 16 to the maximum window bits makes deflate write a gzip header and trailer
+    constexpr int GZIP_WINDOW_BITS = MAX_WBITS + 16;
+    constexpr int DEFAULT_MEM_LEVEL = 8;
+    constexpr size_t OUTPUT_CHUNK_SIZE = 16 * 1024;
+    constexpr size_t MAX_INPUT_CHUNK_SIZE = std::numeric_limits<uInt>::max();
+} // namespace
+
+namespace http_client
+{
+    bool GzipCompress(std::string_view input, std::string& output, int level)
+    {
+        z_stream stream {};
+
+        if (deflateInit2(&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, DEFAULT_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            LogError("Error initializing gzip compression: {}.", stream.msg ? stream.msg : "unknown error");
+            return false;
+        }
+
+        output.clear();
+
+        size_t consumed = 0;
+        size_t produced = 0;
+        int result = Z_OK;
+
+        while (result != Z_STREAM_END)
+        {
+            if (stream.avail_in == 0 && consumed < input.size())
+            {
+                const auto chunk = std::min(input.size() - consumed, MAX_INPUT_CHUNK_SIZE);
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+                stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data() + consumed));
+                stream.avail_in = static_cast<uInt>(chunk);
+                consumed += chunk;
+            }
+
+            if (produced == output.size())
+            {
+                output.resize(output.size() + std::max(OUTPUT_CHUNK_SIZE, output.size() / 2));
+            }
+
+            stream.next_out = reinterpret_cast<Bytef*>(output.data() + produced);
+            stream.avail_out = static_cast<uInt>(std::min(output.size() - produced, MAX_INPUT_CHUNK_SIZE));
+
+            const auto available = stream.avail_out;
+            result = deflate(&stream, consumed < input.size() ? Z_NO_FLUSH : Z_FINISH);
+            produced += available - stream.avail_out;
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+            {
+                LogError("Error compressing with gzip: {}.", stream.msg ? stream.msg : "unknown error");
+                deflateEnd(&stream);
+                output.clear();
+                return false;
+            }
+        }
+
+        deflateEnd(&stream);
+        output.resize(produced);
+        return true;
+    }
+} // namespace http_client
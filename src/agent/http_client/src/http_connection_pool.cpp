@@ -0,0 +1,196 @@
+#include <http_connection_pool.hpp>
+
+#include <logger.hpp>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace http_client
+{
+    HttpConnectionPool::Slot::Slot(HttpConnectionPool* pool, std::string key, std::shared_ptr<SlotWaiter> waiter)
+        : m_pool(pool)
+        , m_key(std::move(key))
+        , m_waiter(std::move(waiter))
+    {
+    }
+
+    HttpConnectionPool::Slot::Slot(Slot&& other) noexcept
+        : m_pool(std::exchange(other.m_pool, nullptr))
+        , m_key(std::move(other.m_key))
+        , m_waiter(std::move(other.m_waiter))
+    {
+    }
+
+    HttpConnectionPool::Slot::~Slot()
+    {
+        if (m_pool)
+        {
+            m_pool->ReleaseSlot(m_key, m_waiter);
+        }
+    }
+
+    HttpConnectionPool::HttpConnectionPool(size_t maxConnectionsPerHost,
+                                           std::chrono::milliseconds idleTimeout,
+                                           size_t maxActiveConnectionsPerHost)
+        : m_maxConnectionsPerHost(maxConnectionsPerHost)
+        , m_idleTimeout(idleTimeout)
+        , m_maxActiveConnectionsPerHost(std::max<size_t>(maxActiveConnectionsPerHost, 1))
+    {
+    }
+
+    boost::asio::awaitable<HttpConnectionPool::Slot> HttpConnectionPool::AcquireSlot(std::string key)
+    {
+        auto waiter = std::make_shared<SlotWaiter>(co_await boost::asio::this_coro::executor);
+
+        // If the request is abandoned while waiting, the slot stops waiting (or is handed on) on destruction
+        Slot slot(this, key, waiter);
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto& host = m_slots[key];
+            if (host.active < m_maxActiveConnectionsPerHost)
+            {
+                ++host.active;
+                waiter->granted = true;
+            }
+            else
+            {
+                LogDebug("Too many connections to {}, waiting for one to finish.", key);
+                host.waiters.push_back(waiter);
+            }
+        }
+
+        // The wake-up is posted from another request, so the state is checked again in case it was missed
+        while (!Granted(waiter))
+        {
+            waiter->timer.expires_after(CONNECTION_SLOT_RECHECK_INTERVAL);
+
+            boost::system::error_code ec;
+            co_await waiter->timer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        }
+
+        co_return slot;
+    }
+
+    bool HttpConnectionPool::Granted(const std::shared_ptr<SlotWaiter>& waiter)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return waiter->granted;
+    }
+
+    void HttpConnectionPool::ReleaseSlot(const std::string& key, const std::shared_ptr<SlotWaiter>& waiter)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto it = m_slots.find(key);
+        if (it == m_slots.end())
+        {
+            return;
+        }
+
+        auto& host = it->second;
+
+        if (!waiter->granted)
+        {
+            std::erase(host.waiters, waiter);
+        }
+        else if (!host.waiters.empty())
+        {
+            // The slot goes straight to the oldest waiting request, so that newcomers do not overtake it
+            const auto next = host.waiters.front();
+            host.waiters.pop_front();
+            next->granted = true;
+            boost::asio::post(next->timer.get_executor(), [next] { next->timer.cancel(); });
+        }
+        else
+        {
+            --host.active;
+        }
+
+        if (host.active == 0 && host.waiters.empty())
+        {
+            m_slots.erase(it);
+        }
+    }
+
+    std::unique_ptr<IHttpSocket> HttpConnectionPool::Acquire(const std::string& key,
+                                                             const boost::asio::any_io_executor& executor)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        EvictIdle();
+
+        const auto it = m_idle.find(key);
+        if (it == m_idle.end())
+        {
+            return nullptr;
+        }
+
+        auto& connections = it->second;
+        const auto connection = std::find_if(connections.rbegin(),
+                                             connections.rend(),
+                                             [&executor](const IdleConnection& idle)
+                                             { return idle.executor == executor; });
+        if (connection == connections.rend())
+        {
+            return nullptr;
+        }
+
+        auto socket = std::move(connection->socket);
+        connections.erase(std::next(connection).base());
+        return socket;
+    }
+
+    void HttpConnectionPool::Release(const std::string& key,
+                                     const boost::asio::any_io_executor& executor,
+                                     std::unique_ptr<IHttpSocket> socket)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        EvictIdle();
+
+        auto& connections = m_idle[key];
+        if (connections.size() >= m_maxConnectionsPerHost)
+        {
+            LogDebug("Connection pool for {} is full, closing the connection.", key);
+            return;
+        }
+
+        connections.push_back({executor, std::move(socket), std::chrono::steady_clock::now()});
+    }
+
+    size_t HttpConnectionPool::IdleConnections(const std::string& key)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        EvictIdle();
+
+        const auto it = m_idle.find(key);
+        return it != m_idle.end() ? it->second.size() : 0;
+    }
+
+    size_t HttpConnectionPool::ActiveConnections(const std::string& key)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto it = m_slots.find(key);
+        return it != m_slots.end() ? it->second.active : 0;
+    }
+
+    void HttpConnectionPool::EvictIdle()
+    {
+        const auto oldest = std::chrono::steady_clock::now() - m_idleTimeout;
+
+        for (auto it = m_idle.begin(); it != m_idle.end();)
+        {
+            std::erase_if(it->second, [oldest](const IdleConnection& idle) { return idle.releasedAt <= oldest; });
+            it = it->second.empty() ? m_idle.erase(it) : std::next(it);
+        }
+    }
+} // namespace http_client
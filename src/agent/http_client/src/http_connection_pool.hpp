@@ -0,0 +1,175 @@
+#pragma once
+
+#include <ihttp_socket.hpp>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace http_client
+{
+    /// @brief Maximum number of idle connections kept per host
+    constexpr size_t MAX_POOLED_CONNECTIONS_PER_HOST = 4;
+
+    /// @brief Maximum number of requests in progress per host, each one holding a connection
+    constexpr size_t MAX_ACTIVE_CONNECTIONS_PER_HOST = 8;
+
+    /// @brief Time after which a request waiting for a connection slot checks again if it was given one
+    constexpr auto CONNECTION_SLOT_RECHECK_INTERVAL = std::chrono::seconds {1};
+
+    /// @brief Time an idle connection is kept before being closed
+    constexpr auto POOLED_CONNECTION_IDLE_TIMEOUT = std::chrono::seconds {30};
+
+    /// @brief Pool of idle keep-alive connections, grouped by host
+    ///
+    /// Connections are handed out to a single request at a time. Once the response has been read, the request gives
+    /// the connection back so the next one to the same host skips the TCP connect and the TLS handshake.
+    ///
+    /// The pool also bounds the connections open to a host: every request takes a slot before getting a connection
+    /// and gives it back once done, so a burst of requests waits in order instead of opening a connection each.
+    class HttpConnectionPool
+    {
+    private:
+        /// @brief Request waiting for a connection slot
+        struct SlotWaiter
+        {
+            explicit SlotWaiter(const boost::asio::any_io_executor& executor)
+                : timer(executor)
+            {
+            }
+
+            /// @brief Timer the request sleeps on, canceled once it is given a slot
+            boost::asio::steady_timer timer;
+
+            /// @brief Set once the request holds a slot
+            bool granted = false;
+        };
+
+    public:
+        /// @brief Permission to keep a connection to a host open, given back to the pool on destruction
+        class Slot
+        {
+        public:
+            /// @brief Constructs a Slot
+            /// @param pool Pool the slot belongs to
+            /// @param key Identifies the host and the connection settings
+            /// @param waiter State of the request the slot is for
+            Slot(HttpConnectionPool* pool, std::string key, std::shared_ptr<SlotWaiter> waiter);
+
+            /// @brief Move constructor
+            Slot(Slot&& other) noexcept;
+
+            Slot(const Slot&) = delete;
+            Slot& operator=(const Slot&) = delete;
+            Slot& operator=(Slot&&) = delete;
+
+            /// @brief Gives the slot back, or stops waiting for it
+            ~Slot();
+
+        private:
+            /// @brief Pool the slot belongs to, or nullptr once moved from
+            HttpConnectionPool* m_pool;
+
+            /// @brief Identifies the host and the connection settings
+            std::string m_key;
+
+            /// @brief State of the request the slot is for
+            std::shared_ptr<SlotWaiter> m_waiter;
+        };
+
+        /// @brief Constructs an HttpConnectionPool
+        /// @param maxConnectionsPerHost Maximum number of idle connections kept per host
+        /// @param idleTimeout Time an idle connection is kept before being closed
+        /// @param maxActiveConnectionsPerHost Maximum number of requests in progress per host
+        HttpConnectionPool(size_t maxConnectionsPerHost = MAX_POOLED_CONNECTIONS_PER_HOST,
+                           std::chrono::milliseconds idleTimeout = POOLED_CONNECTION_IDLE_TIMEOUT,
+                           size_t maxActiveConnectionsPerHost = MAX_ACTIVE_CONNECTIONS_PER_HOST);
+
+        /// @brief Waits until a request may use a connection to a host
+        /// @details Slots are given in the order they were asked for. The pool must outlive the slot.
+        /// @param key Identifies the host and the connection settings
+        /// @return The slot, to be kept until the request is done with the connection
+        boost::asio::awaitable<Slot> AcquireSlot(std::string key);
+
+        /// @brief Takes an idle connection out of the pool
+        /// @param key Identifies the host and the connection settings
+        /// @param executor Executor the connection must be bound to
+        /// @return The most recently used idle connection, or nullptr if there is none
+        std::unique_ptr<IHttpSocket> Acquire(const std::string& key, const boost::asio::any_io_executor& executor);
+
+        /// @brief Gives a connection back to the pool
+        /// @details The connection is dropped if the host already has the maximum number of idle connections.
+        /// @param key Identifies the host and the connection settings
+        /// @param executor Executor the connection is bound to
+        /// @param socket The connection, which must be ready for a new request
+        void Release(const std::string& key,
+                     const boost::asio::any_io_executor& executor,
+                     std::unique_ptr<IHttpSocket> socket);
+
+        /// @brief Returns the number of idle connections kept for a host
+        /// @param key Identifies the host and the connection settings
+        /// @return The number of idle connections
+        size_t IdleConnections(const std::string& key);
+
+        /// @brief Returns the number of slots held for a host
+        /// @param key Identifies the host and the connection settings
+        /// @return The number of requests in progress
+        size_t ActiveConnections(const std::string& key);
+
+    private:
+        /// @brief Idle connection and the time it was given back
+        struct IdleConnection
+        {
+            boost::asio::any_io_executor executor;
+            std::unique_ptr<IHttpSocket> socket;
+            std::chrono::steady_clock::time_point releasedAt;
+        };
+
+        /// @brief Slots held for a host and the requests waiting for one
+        struct HostSlots
+        {
+            size_t active = 0;
+            std::deque<std::shared_ptr<SlotWaiter>> waiters;
+        };
+
+        /// @brief Drops the connections that have been idle for too long. Must be called with the mutex held.
+        void EvictIdle();
+
+        /// @brief Checks if a request was given a slot
+        /// @param waiter State of the request
+        /// @return True if it holds a slot
+        bool Granted(const std::shared_ptr<SlotWaiter>& waiter);
+
+        /// @brief Gives a slot back, handing it to the oldest waiting request, or stops waiting for one
+        /// @param key Identifies the host and the connection settings
+        /// @param waiter State of the request that held or waited for the slot
+        void ReleaseSlot(const std::string& key, const std::shared_ptr<SlotWaiter>& waiter);
+
+        /// @brief Maximum number of idle connections kept per host
+        size_t m_maxConnectionsPerHost;
+
+        /// @brief Time an idle connection is kept before being closed
+        std::chrono::milliseconds m_idleTimeout;
+
+        /// @brief Maximum number of requests in progress per host
+        size_t m_maxActiveConnectionsPerHost;
+
+        /// @brief Slots per host
+        std::map<std::string, HostSlots> m_slots;
+
+        /// @brief Idle connections per host, the most recently used last
+        std::map<std::string, std::vector<IdleConnection>> m_idle;
+
+        /// @brief Mutex protecting the idle connections and the slots
+        std::mutex m_mutex;
+    };
+} // namespace http_client
@@ -55,7 +55,7 @@ namespace http_client
     {
         return Method == other.Method && Host == other.Host && Port == other.Port && Endpoint == other.Endpoint &&
                User_agent == other.User_agent && Verification_Mode == other.Verification_Mode && Token == other.Token &&
-               User_pass == other.User_pass && Body == other.Body && Use_Https == other.Use_Https &&
-               RequestTimeout == other.RequestTimeout;
+               User_pass == other.User_pass && Body == other.Body && Content_Encoding == other.Content_Encoding &&
+               Use_Https == other.Use_Https && RequestTimeout == other.RequestTimeout;
     }
 } // namespace http_client
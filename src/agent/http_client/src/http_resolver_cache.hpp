@@ -0,0 +1,87 @@
+#pragma once
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace http_client
+{
+    /// @brief Time a resolved host is kept before resolving it again
+    constexpr auto RESOLVER_CACHE_TTL = std::chrono::seconds {60};
+
+    /// @brief Cache of resolved hosts, so that new connections don't resolve the host every time
+    class HttpResolverCache
+    {
+    public:
+        /// @brief Constructs an HttpResolverCache
+        /// @param ttl Time a resolved host is kept
+        HttpResolverCache(std::chrono::milliseconds ttl = RESOLVER_CACHE_TTL)
+            : m_ttl(ttl)
+        {
+        }
+
+        /// @brief Returns the endpoints a host was resolved to, if they haven't expired
+        /// @param host The host
+        /// @param port The port
+        /// @return The cached endpoints, or an empty result if there are none
+        boost::asio::ip::tcp::resolver::results_type Get(const std::string& host, const std::string& port)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+
+            const auto it = m_entries.find(host + ":" + port);
+            if (it == m_entries.end())
+            {
+                return {};
+            }
+
+            if (it->second.expiresAt <= std::chrono::steady_clock::now())
+            {
+                m_entries.erase(it);
+                return {};
+            }
+
+            return it->second.results;
+        }
+
+        /// @brief Stores the endpoints a host was resolved to
+        /// @param host The host
+        /// @param port The port
+        /// @param results The resolved endpoints
+        void Put(const std::string& host,
+                 const std::string& port,
+                 const boost::asio::ip::tcp::resolver::results_type& results)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries[host + ":" + port] = {results, std::chrono::steady_clock::now() + m_ttl};
+        }
+
+        /// @brief Forgets the endpoints of a host, e.g. after failing to connect to them
+        /// @param host The host
+        /// @param port The port
+        void Invalidate(const std::string& host, const std::string& port)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.erase(host + ":" + port);
+        }
+
+    private:
+        /// @brief Resolved endpoints and their expiration time
+        struct Entry
+        {
+            boost::asio::ip::tcp::resolver::results_type results;
+            std::chrono::steady_clock::time_point expiresAt;
+        };
+
+        /// @brief Time a resolved host is kept
+        std::chrono::milliseconds m_ttl;
+
+        /// @brief Resolved endpoints by host and port
+        std::map<std::string, Entry> m_entries;
+
+        /// @brief Mutex protecting the entries
+        std::mutex m_mutex;
+    };
+} // namespace http_client
@@ -27,6 +27,10 @@ namespace http_client
         { // No implementation for Http
         }
 
+        void set_session_key(const std::string&) override
+        { // No implementation for Http
+        }
+
         void expires_after(std::chrono::milliseconds ms) override
         {
             m_socket.expires_after(ms);
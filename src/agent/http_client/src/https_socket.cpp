@@ -17,6 +17,8 @@ namespace http_client
 
     void HttpsSocket::SetVerificationMode(const std::string& host, const std::string& verificationMode)
     {
+        m_ssl_socket->set_session_key(host + "|" + verificationMode);
+
         if (verificationMode == "none")
         {
             m_ssl_socket->set_verify_mode(boost::asio::ssl::verify_none);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ihttp_socket_wrapper.hpp>
+#include <tls_session_cache.hpp>
 
 #include <logger.hpp>
 
@@ -12,6 +13,8 @@
 #include <boost/beast/ssl/ssl_stream.hpp>
 #include <boost/system/error_code.hpp>
 
+#include <string>
+
 namespace http_client
 {
     /// @brief Helper class that wraps boost network functions for testing purposes
@@ -23,6 +26,17 @@ namespace http_client
         {
         }
 
+        HttpsSocketHelper(const HttpsSocketHelper&) = delete;
+        HttpsSocketHelper& operator=(const HttpsSocketHelper&) = delete;
+        HttpsSocketHelper(HttpsSocketHelper&&) = delete;
+        HttpsSocketHelper& operator=(HttpsSocketHelper&&) = delete;
+
+        ~HttpsSocketHelper() override
+        {
+            // TLS 1.3 session tickets arrive after the handshake, so the session is saved again once it's done
+            SaveSession();
+        }
+
         void set_verify_mode(boost::asio::ssl::verify_mode mode) override
         {
             m_socket.set_verify_mode(mode);
@@ -33,6 +47,11 @@ namespace http_client
             m_socket.set_verify_callback(vf);
         }
 
+        void set_session_key(const std::string& key) override
+        {
+            m_sessionKey = key;
+        }
+
         void expires_after(std::chrono::milliseconds ms) override
         {
             m_socket.next_layer().expires_after(ms);
@@ -41,6 +60,7 @@ namespace http_client
         void connect(const boost::asio::ip::tcp::resolver::results_type& endpoints,
                      boost::system::error_code& ec) override
         {
+            ResumeSession(endpoints);
             m_socket.next_layer().async_connect(endpoints,
                                                 [this, &ec](const boost::system::error_code& ecConnect, const auto&)
                                                 {
@@ -53,13 +73,15 @@ namespace http_client
 
                                                     m_socket.async_handshake(
                                                         boost::asio::ssl::stream_base::client,
-                                                        [&ec](const boost::system::error_code& ecHandshake)
+                                                        [this, &ec](const boost::system::error_code& ecHandshake)
                                                         {
                                                             ec = ecHandshake;
                                                             if (ecHandshake)
                                                             {
                                                                 LogDebug("Handshake failed: {}", ecHandshake.message());
+                                                                return;
                                                             }
+                                                            SaveSession();
                                                         });
                                                 });
         }
@@ -76,12 +98,17 @@ namespace http_client
             }
             else
             {
+                ResumeSession(endpoints);
                 co_await m_socket.async_handshake(boost::asio::ssl::stream_base::client,
                                                   boost::asio::redirect_error(boost::asio::use_awaitable, ec));
                 if (ec)
                 {
                     LogDebug("boost::asio::async_handshake returned error code: {} {}", ec.value(), ec.message());
                 }
+                else
+                {
+                    SaveSession();
+                }
             }
         }
 
@@ -120,6 +147,33 @@ namespace http_client
         }
 
     private:
+        /// @brief Offers a previous session with the same server for resumption before the handshake
+        void ResumeSession(const boost::asio::ip::tcp::resolver::results_type& endpoints)
+        {
+            if (m_sessionKey.empty() || endpoints.empty())
+            {
+                return;
+            }
+
+            m_resumptionKey = m_sessionKey + ":" + endpoints.begin()->service_name();
+            TlsSessionCache::Instance().Resume(m_resumptionKey, m_socket.native_handle());
+        }
+
+        /// @brief Keeps the current session so later connections to the same server can resume it
+        void SaveSession()
+        {
+            if (!m_resumptionKey.empty())
+            {
+                TlsSessionCache::Instance().Save(m_resumptionKey, m_socket.native_handle());
+            }
+        }
+
         boost::beast::ssl_stream<boost::beast::tcp_stream> m_socket;
+
+        /// @brief Host and verification mode used to look up sessions to resume
+        std::string m_sessionKey;
+
+        /// @brief Session key including the port of the server, set when connecting
+        std::string m_resumptionKey;
     };
 } // namespace http_client
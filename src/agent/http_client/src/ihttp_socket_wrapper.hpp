@@ -8,6 +8,7 @@
 #include <boost/system/error_code.hpp>
 
 #include <chrono>
+#include <string>
 
 namespace http_client
 {
@@ -21,6 +22,8 @@ namespace http_client
 
         virtual void set_verify_callback(std::function<bool(bool, boost::asio::ssl::verify_context&)> vf) = 0;
 
+        virtual void set_session_key(const std::string& key) = 0;
+
         virtual void expires_after(std::chrono::milliseconds ms) = 0;
 
         virtual void connect(const boost::asio::ip::tcp::resolver::results_type& endpoints,
@@ -0,0 +1,36 @@
+#include <tls_session_cache.hpp>
+
+#include <logger.hpp>
+
+namespace http_client
+{
+    void TlsSessionCache::Resume(const std::string& key, SSL* ssl)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto it = m_sessions.find(key);
+        if (it == m_sessions.end())
+        {
+            return;
+        }
+
+        if (SSL_set_session(ssl, it->second.get()) != 1)
+        {
+            LogDebug("Failed to resume the TLS session for {}.", key);
+            m_sessions.erase(it);
+        }
+    }
+
+    void TlsSessionCache::Save(const std::string& key, SSL* ssl)
+    {
+        std::unique_ptr<SSL_SESSION, SessionDeleter> session(SSL_get1_session(ssl));
+
+        if (!session || SSL_SESSION_is_resumable(session.get()) != 1)
+        {
+            return;
+        }
+
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_sessions[key] = std::move(session);
+    }
+} // namespace http_client
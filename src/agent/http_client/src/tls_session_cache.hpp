@@ -0,0 +1,52 @@
+#pragma once
+
+#include <openssl/ssl.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace http_client
+{
+    /// @brief Process-wide cache of TLS sessions, used to resume them instead of doing a full handshake
+    ///
+    /// Sessions are keyed by host, port and verification mode, so a session established without verifying the
+    /// server is never resumed by a connection that requires it.
+    class TlsSessionCache
+    {
+    public:
+        /// @brief Returns the cache shared by every HTTPS socket
+        static TlsSessionCache& Instance()
+        {
+            static TlsSessionCache s_instance;
+            return s_instance;
+        }
+
+        /// @brief Offers the cached session, if any, to a connection about to start its handshake
+        /// @param key Identifies the host and the connection settings
+        /// @param ssl The connection
+        void Resume(const std::string& key, SSL* ssl);
+
+        /// @brief Stores the session of a connection, if it can be resumed
+        /// @param key Identifies the host and the connection settings
+        /// @param ssl The connection
+        void Save(const std::string& key, SSL* ssl);
+
+    private:
+        /// @brief Frees a session when it is no longer referenced by the cache
+        struct SessionDeleter
+        {
+            void operator()(SSL_SESSION* session) const
+            {
+                SSL_SESSION_free(session);
+            }
+        };
+
+        /// @brief Cached sessions by key
+        std::map<std::string, std::unique_ptr<SSL_SESSION, SessionDeleter>> m_sessions;
+
+        /// @brief Mutex protecting the sessions
+        std::mutex m_mutex;
+    };
+} // namespace http_client
@@ -16,6 +16,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines,cppcoreguidelines-avoid-reference-coroutine-parameters)
 
@@ -330,6 +331,219 @@ TEST_F(HttpClientTest, Co_PerformHttpRequest_OnSuccessNotCalledIfAsyncReadFails)
     EXPECT_EQ(std::get<1>(res), "Internal server error: Error handling response: Bad address");
 }
 
+TEST_F(HttpClientTest, Co_PerformHttpRequest_ReusesConnection)
+{
+    SetupMockResolverFactory();
+    SetupMockSocketFactory();
+    SetupMockResolverExpectations();
+    SetupMockSocketConnectExpectations();
+    EXPECT_CALL(*mockSocket, SetVerificationMode("localhost", "full")).Times(1);
+    EXPECT_CALL(*mockSocket, SetTimeout(http_client::SOCKET_TIMEOUT)).Times(1);
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                                  boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*mockSocket, AsyncRead(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::ok);
+                co_return;
+            }));
+
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::GET, "https://localhost:8080", "/test", "Wazuh 5.0.0", "full");
+
+    std::vector<int> statuses;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            statuses.push_back(std::get<0>(co_await client->Co_PerformHttpRequest(params)));
+            statuses.push_back(std::get<0>(co_await client->Co_PerformHttpRequest(params)));
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_THAT(statuses, ElementsAre(http_client::HTTP_CODE_OK, http_client::HTTP_CODE_OK));
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_RetriesOnNewConnectionIfReusedOneFails)
+{
+    auto newSocket = std::make_unique<MockHttpSocket>();
+    auto* const newSocketPtr = newSocket.get();
+
+    SetupMockResolverFactory();
+    SetupMockResolverExpectations();
+    EXPECT_CALL(*mockSocketFactory, Create(_, _))
+        .WillOnce(Invoke([&](const auto&, const bool) -> std::unique_ptr<http_client::IHttpSocket>
+                         { return std::move(mockSocket); }))
+        .WillOnce(Invoke([&](const auto&, const bool) -> std::unique_ptr<http_client::IHttpSocket>
+                         { return std::move(newSocket); }));
+
+    SetupMockSocketConnectExpectations();
+    SetupMockSocketReadExpectations(boost::beast::http::status::ok);
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .WillOnce(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }))
+        .WillOnce(Invoke(
+            [](const boost::beast::http::request<boost::beast::http::string_body>&,
+               boost::system::error_code& ec) -> boost::asio::awaitable<void>
+            {
+                ec = boost::asio::error::broken_pipe;
+                co_return;
+            }));
+
+    EXPECT_CALL(*newSocketPtr, AsyncConnect(_, _))
+        .WillOnce(Invoke([](const boost::asio::ip::tcp::resolver::results_type&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*newSocketPtr, AsyncWrite(_, _))
+        .WillOnce(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*newSocketPtr, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::created);
+                co_return;
+            }));
+
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::GET, "https://localhost:8080", "/test", "Wazuh 5.0.0", "full");
+
+    std::vector<int> statuses;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            statuses.push_back(std::get<0>(co_await client->Co_PerformHttpRequest(params)));
+            statuses.push_back(std::get<0>(co_await client->Co_PerformHttpRequest(params)));
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_THAT(statuses, ElementsAre(http_client::HTTP_CODE_OK, http_client::HTTP_CODE_CREATED));
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_RetriesIfServerClosedReusedConnection)
+{
+    auto newSocket = std::make_unique<MockHttpSocket>();
+    auto* const newSocketPtr = newSocket.get();
+
+    SetupMockResolverFactory();
+    SetupMockResolverExpectations();
+    EXPECT_CALL(*mockSocketFactory, Create(_, _))
+        .WillOnce(Invoke([&](const auto&, const bool) -> std::unique_ptr<http_client::IHttpSocket>
+                         { return std::move(mockSocket); }))
+        .WillOnce(Invoke([&](const auto&, const bool) -> std::unique_ptr<http_client::IHttpSocket>
+                         { return std::move(newSocket); }));
+
+    SetupMockSocketConnectExpectations();
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                                  boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*mockSocket, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::ok);
+                co_return;
+            }))
+        .WillOnce(Invoke(
+            [](auto&, boost::system::error_code& ec) -> boost::asio::awaitable<void>
+            {
+                // The server closed the kept-alive connection before answering
+                ec = boost::beast::http::error::end_of_stream;
+                co_return;
+            }));
+
+    EXPECT_CALL(*newSocketPtr, AsyncConnect(_, _))
+        .WillOnce(Invoke([](const boost::asio::ip::tcp::resolver::results_type&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*newSocketPtr, AsyncWrite(_, _))
+        .WillOnce(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                            boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*newSocketPtr, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::created);
+                co_return;
+            }));
+
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::GET, "https://localhost:8080", "/test", "Wazuh 5.0.0", "full");
+
+    std::vector<int> statuses;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            statuses.push_back(std::get<0>(co_await client->Co_PerformHttpRequest(params)));
+            statuses.push_back(std::get<0>(co_await client->Co_PerformHttpRequest(params)));
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_THAT(statuses, ElementsAre(http_client::HTTP_CODE_OK, http_client::HTTP_CODE_CREATED));
+}
+
+TEST_F(HttpClientTest, Co_PerformHttpRequest_DoesNotRetryReusedConnectionOnTimeout)
+{
+    SetupMockResolverFactory();
+    SetupMockSocketFactory();
+    SetupMockResolverExpectations();
+    SetupMockSocketConnectExpectations();
+    EXPECT_CALL(*mockSocket, AsyncWrite(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([](const boost::beast::http::request<boost::beast::http::string_body>&,
+                                  boost::system::error_code&) -> boost::asio::awaitable<void> { co_return; }));
+    EXPECT_CALL(*mockSocket, AsyncRead(_, _))
+        .WillOnce(Invoke(
+            [](auto& res, boost::system::error_code&) -> boost::asio::awaitable<void>
+            {
+                res.result(boost::beast::http::status::ok);
+                co_return;
+            }))
+        .WillOnce(Invoke(
+            [](auto&, boost::system::error_code& ec) -> boost::asio::awaitable<void>
+            {
+                ec = boost::beast::error::timeout;
+                co_return;
+            }));
+
+    const http_client::HttpRequestParams params(
+        http_client::MethodType::GET, "https://localhost:8080", "/test", "Wazuh 5.0.0", "full");
+
+    std::vector<int> statuses;
+
+    boost::asio::io_context ioContext;
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            statuses.push_back(std::get<0>(co_await client->Co_PerformHttpRequest(params)));
+            statuses.push_back(std::get<0>(co_await client->Co_PerformHttpRequest(params)));
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    // The request may have reached the server, so it is not sent again
+    EXPECT_THAT(statuses, ElementsAre(http_client::HTTP_CODE_OK, http_client::HTTP_CODE_INTERNAL_SERVER_ERROR));
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
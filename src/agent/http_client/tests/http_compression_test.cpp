@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <http_compression.hpp>
+
+#include <zlib.h>
+
+#include <string>
+
+namespace
+{
+    std::string GzipDecompress(const std::string& input)
+    {
+        z_stream stream {};
+        EXPECT_EQ(inflateInit2(&stream, MAX_WBITS + 16), Z_OK);
+
+        std::string output;
+        std::string chunk(1024, '\0');
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        stream.avail_in = static_cast<uInt>(input.size());
+
+        auto result = Z_OK;
+        while (result == Z_OK)
+        {
+            stream.next_out = reinterpret_cast<Bytef*>(chunk.data());
+            stream.avail_out = static_cast<uInt>(chunk.size());
+            result = inflate(&stream, Z_NO_FLUSH);
+            output.append(chunk.data(), chunk.size() - stream.avail_out);
+        }
+
+        EXPECT_EQ(result, Z_STREAM_END);
+        inflateEnd(&stream);
+        return output;
+    }
+} // namespace
+
+TEST(HttpCompressionTest, GzipCompressRoundTrip)
+{
+    const std::string input = R"({"module":"logcollector","type":"file"})"
+                              "\n"
+                              R"({"log":{"file":{"path":"/var/log/syslog"}},"event":{"original":"message"}})";
+
+    std::string output;
+    ASSERT_TRUE(http_client::GzipCompress(input, output, 6));
+
+    // gzip magic number
+    ASSERT_GE(output.size(), 2u);
+    EXPECT_EQ(static_cast<unsigned char>(output[0]), 0x1f);
+    EXPECT_EQ(static_cast<unsigned char>(output[1]), 0x8b);
+
+    EXPECT_EQ(GzipDecompress(output), input);
+}
+
+TEST(HttpCompressionTest, GzipCompressLargeInputSpanningSeveralChunks)
+{
+    std::string input;
+    for (int i = 0; i < 100000; ++i)
+    {
+        input += R"({"event":{"original":"line )" + std::to_string(i) + R"("}})" + "\n";
+    }
+
+    std::string output;
+    ASSERT_TRUE(http_client::GzipCompress(input, output, 1));
+
+    EXPECT_LT(output.size(), input.size());
+    EXPECT_EQ(GzipDecompress(output), input);
+}
+
+TEST(HttpCompressionTest, GzipCompressReplacesOutputContents)
+{
+    std::string output = "previous contents";
+    ASSERT_TRUE(http_client::GzipCompress("", output, 9));
+
+    EXPECT_EQ(GzipDecompress(output), "");
+}
+
+TEST(HttpCompressionTest, GzipCompressFailsWithInvalidLevel)
+{
+    std::string output;
+    EXPECT_FALSE(http_client::GzipCompress("data", output, 42));
+}
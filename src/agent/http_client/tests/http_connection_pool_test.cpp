@@ -0,0 +1,190 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <http_connection_pool.hpp>
+
+#include "mocks/mock_http_socket.hpp"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace testing;
+
+namespace
+{
+    const std::string POOL_KEY = "https://localhost:27000 full";
+} // namespace
+
+class HttpConnectionPoolTest : public Test
+{
+protected:
+    boost::asio::io_context ioContext;
+};
+
+TEST_F(HttpConnectionPoolTest, AcquireFromEmptyPool)
+{
+    http_client::HttpConnectionPool pool;
+
+    EXPECT_EQ(pool.Acquire(POOL_KEY, ioContext.get_executor()), nullptr);
+}
+
+TEST_F(HttpConnectionPoolTest, AcquireReturnsReleasedConnection)
+{
+    http_client::HttpConnectionPool pool;
+    auto socket = std::make_unique<MockHttpSocket>();
+    auto* const released = socket.get();
+
+    pool.Release(POOL_KEY, ioContext.get_executor(), std::move(socket));
+    EXPECT_EQ(pool.IdleConnections(POOL_KEY), 1);
+
+    const auto acquired = pool.Acquire(POOL_KEY, ioContext.get_executor());
+    EXPECT_EQ(acquired.get(), released);
+    EXPECT_EQ(pool.IdleConnections(POOL_KEY), 0);
+}
+
+TEST_F(HttpConnectionPoolTest, AcquireDoesNotShareConnectionsBetweenHosts)
+{
+    http_client::HttpConnectionPool pool;
+
+    pool.Release(POOL_KEY, ioContext.get_executor(), std::make_unique<MockHttpSocket>());
+
+    EXPECT_EQ(pool.Acquire("https://otherhost:27000 full", ioContext.get_executor()), nullptr);
+    EXPECT_EQ(pool.IdleConnections(POOL_KEY), 1);
+}
+
+TEST_F(HttpConnectionPoolTest, AcquireDoesNotShareConnectionsBetweenExecutors)
+{
+    http_client::HttpConnectionPool pool;
+    boost::asio::io_context otherIoContext;
+
+    pool.Release(POOL_KEY, ioContext.get_executor(), std::make_unique<MockHttpSocket>());
+
+    EXPECT_EQ(pool.Acquire(POOL_KEY, otherIoContext.get_executor()), nullptr);
+    EXPECT_NE(pool.Acquire(POOL_KEY, ioContext.get_executor()), nullptr);
+}
+
+TEST_F(HttpConnectionPoolTest, ReleaseKeepsAtMostTheMaximumPerHost)
+{
+    const size_t maxConnections = 2;
+    http_client::HttpConnectionPool pool(maxConnections);
+
+    for (size_t i = 0; i < maxConnections + 1; ++i)
+    {
+        pool.Release(POOL_KEY, ioContext.get_executor(), std::make_unique<MockHttpSocket>());
+    }
+
+    EXPECT_EQ(pool.IdleConnections(POOL_KEY), maxConnections);
+}
+
+TEST_F(HttpConnectionPoolTest, IdleConnectionsAreEvicted)
+{
+    const auto idleTimeout = std::chrono::milliseconds(10);
+    http_client::HttpConnectionPool pool(http_client::MAX_POOLED_CONNECTIONS_PER_HOST, idleTimeout);
+
+    pool.Release(POOL_KEY, ioContext.get_executor(), std::make_unique<MockHttpSocket>());
+    std::this_thread::sleep_for(idleTimeout * 2);
+
+    EXPECT_EQ(pool.Acquire(POOL_KEY, ioContext.get_executor()), nullptr);
+    EXPECT_EQ(pool.IdleConnections(POOL_KEY), 0);
+}
+
+TEST_F(HttpConnectionPoolTest, AcquireSlotWaitsForActiveConnections)
+{
+    http_client::HttpConnectionPool pool(
+        http_client::MAX_POOLED_CONNECTIONS_PER_HOST, http_client::POOLED_CONNECTION_IDLE_TIMEOUT, 1);
+    std::vector<std::string> events;
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            const auto slot = co_await pool.AcquireSlot(POOL_KEY);
+            events.emplace_back("first acquired");
+
+            boost::asio::steady_timer timer(ioContext, std::chrono::milliseconds(50));
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            events.emplace_back("first released");
+        },
+        boost::asio::detached);
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            const auto slot = co_await pool.AcquireSlot(POOL_KEY);
+            events.emplace_back("second acquired");
+            EXPECT_EQ(pool.ActiveConnections(POOL_KEY), 1);
+        },
+        boost::asio::detached);
+
+    const auto start = std::chrono::steady_clock::now();
+    ioContext.run();
+
+    EXPECT_THAT(events, ElementsAre("first acquired", "first released", "second acquired"));
+    EXPECT_EQ(pool.ActiveConnections(POOL_KEY), 0);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, http_client::CONNECTION_SLOT_RECHECK_INTERVAL);
+}
+
+TEST_F(HttpConnectionPoolTest, AcquireSlotDoesNotLimitOtherHosts)
+{
+    http_client::HttpConnectionPool pool(
+        http_client::MAX_POOLED_CONNECTIONS_PER_HOST, http_client::POOLED_CONNECTION_IDLE_TIMEOUT, 1);
+    auto acquired = false;
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            const auto slot = co_await pool.AcquireSlot(POOL_KEY);
+            const auto otherSlot = co_await pool.AcquireSlot("https://otherhost:27000 full");
+            acquired = true;
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_TRUE(acquired);
+}
+
+TEST_F(HttpConnectionPoolTest, AbandonedWaitDoesNotKeepASlot)
+{
+    http_client::HttpConnectionPool pool(
+        http_client::MAX_POOLED_CONNECTIONS_PER_HOST, http_client::POOLED_CONNECTION_IDLE_TIMEOUT, 1);
+    std::optional<http_client::HttpConnectionPool::Slot> held;
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void> { held.emplace(co_await pool.AcquireSlot(POOL_KEY)); },
+        boost::asio::detached);
+    ioContext.poll();
+
+    {
+        boost::asio::io_context abandonedIoContext;
+
+        boost::asio::co_spawn(
+            abandonedIoContext,
+            [&]() -> boost::asio::awaitable<void> { co_await pool.AcquireSlot(POOL_KEY); },
+            boost::asio::detached);
+        abandonedIoContext.poll();
+
+        // The waiting request is destroyed along with its context, before the slot is given back
+    }
+
+    EXPECT_EQ(pool.ActiveConnections(POOL_KEY), 1);
+
+    held.reset();
+    EXPECT_EQ(pool.ActiveConnections(POOL_KEY), 0);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
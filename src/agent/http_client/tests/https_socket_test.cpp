@@ -54,6 +54,15 @@ TEST_F(HttpsSocketTest, SetVerificationMode)
     EXPECT_NO_THROW(m_socket->SetVerificationMode("www.google.com", "full"));
 }
 
+TEST_F(HttpsSocketTest, SetVerificationModeSetsSessionKey)
+{
+    EXPECT_CALL(*m_mockHelper, set_session_key("www.google.com|none")).Times(1);
+    EXPECT_CALL(*m_mockHelper, set_session_key("www.google.com|full")).Times(1);
+
+    m_socket->SetVerificationMode("www.google.com", "none");
+    m_socket->SetVerificationMode("www.google.com", "full");
+}
+
 TEST_F(HttpsSocketTest, ConnectSocketSuccess)
 {
     EXPECT_CALL(*m_mockHelper, expires_after(_)).Times(1);
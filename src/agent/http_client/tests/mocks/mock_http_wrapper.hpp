@@ -9,6 +9,8 @@ public:
 
     MOCK_METHOD(void, set_verify_callback, (std::function<bool(bool, boost::asio::ssl::verify_context&)>), (override));
 
+    MOCK_METHOD(void, set_session_key, (const std::string&), (override));
+
     MOCK_METHOD(void, expires_after, (std::chrono::milliseconds), (override));
     MOCK_METHOD(void,
                 connect,
@@ -0,0 +1,133 @@
+#include <segmented_log_storage.hpp>
+#include <storage.hpp>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Compares the SQLite and the segmented log queue backends.
+//
+// Usage: queue_storage_benchmark [messages] [message size] [pop batch] [folder]
+//
+// For each backend, the given number of messages is stored one by one, then drained in batches of "pop batch"
+// messages (retrieve + remove, like the communicator does). Bytes written are taken from /proc/self/io when
+// available, which accounts for the WAL, checkpoints and segment files alike.
+
+namespace
+{
+    const std::vector<std::string> TABLE_NAMES {"STATELESS"};
+    const std::string TABLE_NAME = "STATELESS";
+
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Bytes this process caused to be sent to the storage layer, or 0 when unavailable
+    size_t WrittenBytes()
+    {
+        std::ifstream io("/proc/self/io");
+        std::string key;
+        size_t value = 0;
+        while (io >> key >> value)
+        {
+            if (key == "write_bytes:")
+            {
+                return value;
+            }
+        }
+        return 0;
+    }
+
+    double Seconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    void Run(const std::string& name,
+             const std::function<std::unique_ptr<IStorage>()>& factory,
+             size_t messages,
+             size_t messageSize,
+             int popBatch)
+    {
+        const nlohmann::json message = {{"event", {{"original", std::string(messageSize, 'x')}}}};
+        const std::string metadata = R"({"module":"logcollector","type":"file"})";
+
+        auto storage = factory();
+
+        const auto writtenBefore = WrittenBytes();
+        const auto storeStart = Clock::now();
+        for (size_t i = 0; i < messages; ++i)
+        {
+            storage->Store(message, TABLE_NAME, "logcollector", "file", metadata);
+        }
+        if (auto* logStorage = dynamic_cast<SegmentedLogStorage*>(storage.get()))
+        {
+            // Account for the last group commit so both backends report durable throughput
+            logStorage->Sync();
+        }
+        const auto storeTime = Clock::now() - storeStart;
+
+        size_t drained = 0;
+        const auto drainStart = Clock::now();
+        while (drained < messages)
+        {
+            const auto batch = storage->RetrieveMultiple(popBatch, TABLE_NAME);
+            if (batch.empty())
+            {
+                break;
+            }
+            drained += static_cast<size_t>(storage->RemoveMultiple(static_cast<int>(batch.size()), TABLE_NAME));
+        }
+        const auto drainTime = Clock::now() - drainStart;
+
+        storage.reset();
+        const auto written = WrittenBytes() - writtenBefore;
+
+        fmt::print("{:<8} store: {:>10.0f} msg/s  drain: {:>10.0f} msg/s  written: {}\n",
+                   name,
+                   static_cast<double>(messages) / Seconds(storeTime),
+                   static_cast<double>(drained) / Seconds(drainTime),
+                   written ? fmt::format("{:.1f} B/msg", static_cast<double>(written) / static_cast<double>(messages))
+                           : std::string("n/a"));
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t messages = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t messageSize = argc > 2 ? std::stoul(argv[2]) : 256;
+    const int popBatch = argc > 3 ? std::stoi(argv[3]) : 1000;
+    const std::filesystem::path root =
+        argc > 4 ? std::filesystem::path(argv[4]) : std::filesystem::temp_directory_path() / "queue_storage_benchmark";
+
+    fmt::print("{} messages of {} bytes, popped in batches of {}\n", messages, messageSize, popBatch);
+
+    const auto sqliteFolder = root / "sqlite";
+    std::filesystem::remove_all(sqliteFolder);
+    std::filesystem::create_directories(sqliteFolder);
+    Run(
+        "sqlite",
+        [&]() { return std::make_unique<Storage>(sqliteFolder.string(), TABLE_NAMES); },
+        messages,
+        messageSize,
+        popBatch);
+
+    const auto logFolder = root / "log";
+    std::filesystem::remove_all(logFolder);
+    std::filesystem::create_directories(logFolder);
+    Run(
+        "log",
+        [&]() { return std::make_unique<SegmentedLogStorage>(logFolder.string(), TABLE_NAMES); },
+        messages,
+        messageSize,
+        popBatch);
+
+    std::filesystem::remove_all(root);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+#include <storage.hpp>
+
+#include <persistence_factory.hpp>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Measures RetrieveBySize against a large backlog.
+//
+// Usage: retrieve_by_size_benchmark [messages] [message size] [batch bytes] [folder]
+//
+// The queue is filled with the given number of messages and then a batch of "batch bytes" is retrieved several
+// times, reporting latency and peak memory. For reference, the whole table is then selected at once, which is what
+// a size-bounded retrieval used to do before trimming the result.
+
+namespace
+{
+    const std::vector<std::string> TABLE_NAMES {"STATELESS"};
+    const std::string TABLE_NAME = "STATELESS";
+    constexpr size_t STORE_CHUNK = 10000;
+    constexpr int RETRIEVALS = 10;
+
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Peak resident set size of the process in KiB
+    long PeakRss()
+    {
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    double Milliseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t messages = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t messageSize = argc > 2 ? std::stoul(argv[2]) : 256;
+    const size_t batchBytes = argc > 3 ? std::stoul(argv[3]) : 1000000;
+    const std::filesystem::path folder = argc > 4 ? std::filesystem::path(argv[4])
+                                                  : std::filesystem::temp_directory_path() / "retrieve_by_size_benchmark";
+
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+
+    fmt::print("{} messages of {} bytes, batches of {} bytes\n", messages, messageSize, batchBytes);
+
+    {
+        Storage storage(folder.string(), TABLE_NAMES);
+
+        const nlohmann::json message = {{"event", {{"original", std::string(messageSize, 'x')}}}};
+        const std::string metadata = R"({"module":"logcollector","type":"file"})";
+
+        const auto fillStart = Clock::now();
+        for (size_t stored = 0; stored < messages; stored += STORE_CHUNK)
+        {
+            const auto chunk = nlohmann::json::array_t(std::min(STORE_CHUNK, messages - stored), message);
+            storage.Store(chunk, TABLE_NAME, "logcollector", "file", metadata);
+        }
+        fmt::print("fill:            {:>10.1f} ms\n", Milliseconds(Clock::now() - fillStart));
+
+        const auto rssBefore = PeakRss();
+        size_t retrieved = 0;
+        const auto retrieveStart = Clock::now();
+        for (int i = 0; i < RETRIEVALS; ++i)
+        {
+            retrieved += storage.RetrieveBySize(batchBytes, TABLE_NAME).size();
+        }
+        fmt::print("RetrieveBySize:  {:>10.1f} ms/batch  {:>8} msg/batch  peak RSS +{} KiB\n",
+                   Milliseconds(Clock::now() - retrieveStart) / RETRIEVALS,
+                   retrieved / RETRIEVALS,
+                   PeakRss() - rssBefore);
+    }
+
+    {
+        auto db = PersistenceFactory::CreatePersistence(PersistenceFactory::PersistenceType::SQLITE3,
+                                                        (folder / "queue.db").string());
+
+        const auto rssBefore = PeakRss();
+        const auto selectStart = Clock::now();
+        const auto rows = db->Select(TABLE_NAME, {});
+        fmt::print("full Select:     {:>10.1f} ms        {:>8} rows       peak RSS +{} KiB\n",
+                   Milliseconds(Clock::now() - selectStart),
+                   rows.size(),
+                   PeakRss() - rssBefore);
+    }
+
+    std::filesystem::remove_all(folder);
+    return EXIT_SUCCESS;
+}
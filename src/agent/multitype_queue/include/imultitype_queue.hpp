@@ -52,6 +52,24 @@ public:
                                                                                const std::string moduleName = "",
                                                                                const std::string moduleType = "") = 0;
 
+    /// @brief Retrieves the next Bytes of messages from the queue asynchronously, without parsing them.
+    /// @details The stored metadata and data of each message are handed over untouched, so they can be appended
+    /// directly to an output buffer.
+    /// @param type The type of the queue to use as the source.
+    /// @param messageQuantity In bytes of messages.
+    /// @param onMessage Callback invoked with the metadata and the serialized data of each message, in order.
+    /// @param moduleName The name of the module requesting the message.
+    /// @param moduleType The type of the module requesting the messages.
+    /// @param skip The number of messages at the head of the queue already being sent. When not zero, the call
+    /// doesn't wait and only retrieves messages if a full batch is stored past the skipped ones.
+    /// @return boost::asio::awaitable<int> The number of retrieved messages.
+    virtual boost::asio::awaitable<int> getNextBytesRawAwaitable(MessageType type,
+                                                                 const size_t messageQuantity,
+                                                                 RawMessageCallback onMessage,
+                                                                 const std::string moduleName = "",
+                                                                 const std::string moduleType = "",
+                                                                 const size_t skip = 0) = 0;
+
     /// @brief Retrieves the next N messages from the queue.
     /// @param type The type of the queue to use as the source.
     /// @param messageQuantity The quantity of bytes of messages to return.
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <message.hpp>
+
 #include <nlohmann/json.hpp>
 
 #include <memory>
@@ -24,14 +26,18 @@ public:
     /// @param moduleName The name of the module that created the message.
     /// @param moduleType The type of the module that created the message.
     /// @param metadata The metadata message to store.
+    /// @param storedBytes If not null, receives the bytes occupied by the stored elements.
     /// @return The number of stored elements.
     virtual int Store(const nlohmann::json& message,
                       const std::string& tableName,
                       const std::string& moduleName = "",
                       const std::string& moduleType = "",
-                      const std::string& metadata = "") = 0;
+                      const std::string& metadata = "",
+                      size_t* storedBytes = nullptr) = 0;
 
     /// @brief Remove multiple JSON messages.
+    /// @details The oldest messages matching the module filters are removed, wherever they are in the table, the
+    /// same ones the retrieve functions return.
     /// @param n The number of messages to remove.
     /// @param tableName The name of the table to remove the message from.
     /// @param moduleName The name of the module that created the message.
@@ -64,6 +70,21 @@ public:
                                           const std::string& moduleName = "",
                                           const std::string& moduleType = "") = 0;
 
+    /// @brief Retrieve messages based on size from the specified queue, without parsing them.
+    /// @param n size occupied by the messages to be retrieved.
+    /// @param tableName The name of the table to retrieve the message from.
+    /// @param onMessage Callback invoked with the stored metadata and data of each message, in order.
+    /// @param moduleName The name of the module.
+    /// @param moduleType The type of the module.
+    /// @param skip The number of messages at the head of the queue to leave out, e.g. because they are being sent.
+    /// @return The number of retrieved messages.
+    virtual int RetrieveRawBySize(size_t n,
+                                  const std::string& tableName,
+                                  const RawMessageCallback& onMessage,
+                                  const std::string& moduleName = "",
+                                  const std::string& moduleType = "",
+                                  size_t skip = 0) = 0;
+
     /// @brief Get the number of elements in the table.
     /// @param tableName The name of the table to retrieve the message from.
     /// @param moduleName The name of the module that created the message.
@@ -2,7 +2,10 @@
 
 #include <nlohmann/json.hpp>
 
+#include <functional>
 #include <string>
+#include <string_view>
+#include <utility>
 
 /// @brief Types of messages enum
 enum class MessageType
@@ -12,6 +15,9 @@ enum class MessageType
     COMMAND
 };
 
+/// @brief Callback receiving the metadata and the serialized data of a stored message, exactly as they were stored
+using RawMessageCallback = std::function<void(std::string_view metadata, std::string_view data)>;
+
 /// @brief Wrapper for Message, contains the message type, the json data, the
 /// module name, the module type and the metadata.
 class Message
@@ -31,10 +37,10 @@ public:
     /// @param mD The metadata
     Message(MessageType t, nlohmann::json d, std::string mN = "", std::string mT = "", std::string mD = "")
         : type(t)
-        , data(d)
-        , moduleName(mN)
-        , moduleType(mT)
-        , metaData(mD)
+        , data(std::move(d))
+        , moduleName(std::move(mN))
+        , moduleType(std::move(mT))
+        , metaData(std::move(mD))
     {
     }
 
@@ -5,7 +5,9 @@
 #include <istorage.hpp>
 
 #include <boost/asio/awaitable.hpp>
+#include <boost/asio/steady_timer.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <map>
@@ -29,6 +31,16 @@ namespace
 class MultiTypeQueue : public IMultiTypeQueue
 {
 private:
+    /// @brief In-memory accounting of the messages stored for a type, kept in step with the storage
+    struct QueueCounters
+    {
+        /// @brief Number of stored messages
+        std::atomic<size_t> items {0};
+
+        /// @brief Size in bytes of the stored messages, as reported by IStorage::GetElementsStoredSize
+        std::atomic<size_t> bytes {0};
+    };
+
     const std::vector<std::string> m_vMessageTypeStrings {
         STATELESS_TABLE_NAME, STATEFUL_TABLE_NAME, COMMAND_TABLE_NAME};
     const std::map<MessageType, std::string> m_mapMessageTypeName {
@@ -52,9 +64,46 @@ private:
     /// @brief condition variable related to the mutex
     std::condition_variable m_cv;
 
+    /// @brief Counters per message type, seeded from the storage on construction
+    std::map<MessageType, QueueCounters> m_counters;
+
+    /// @brief Timers of the coroutines waiting for the queue to change, guarded by m_mtx
+    std::vector<std::shared_ptr<boost::asio::steady_timer>> m_waiters;
+
     /// @brief Time between batch requests
     std::time_t m_batchInterval;
 
+    /// @brief Waits until the given amount of bytes is stored or the batch interval expires.
+    /// @param type The type of the queue.
+    /// @param messageQuantity In bytes of messages.
+    boost::asio::awaitable<void> waitForBytes(MessageType type, size_t messageQuantity);
+
+    /// @brief Checks whether a full batch is stored after the given number of messages.
+    /// @param type The type of the queue.
+    /// @param skip The number of messages at the head of the queue to leave out.
+    /// @param messageQuantity In bytes of messages.
+    /// @return True if at least messageQuantity bytes are stored after the skipped messages.
+    bool hasFullBatchAfter(MessageType type, size_t skip, size_t messageQuantity);
+
+    /// @brief Waits until the queue changes or the given time elapses, whichever happens first.
+    /// @details Pushes and pops wake the waiters up, the timeout only bounds a wake-up that races with the wait.
+    /// @param timeout Maximum time to wait.
+    boost::asio::awaitable<void> waitForChange(std::chrono::milliseconds timeout);
+
+    /// @brief Wakes up the threads and coroutines waiting for the queue to change
+    void notifyWaiters();
+
+    /// @brief Stores a message, updating the counters of its type.
+    /// @param message The message to store. Arrays are stored as one message per element, only if all of them fit.
+    /// @param availableItems Number of messages that still fit in the queue.
+    /// @return The number of messages stored.
+    int store(const Message& message, size_t availableItems);
+
+    /// @brief Updates the counters of a type after removing messages from it.
+    /// @param type The type of the queue.
+    /// @param removed The number of messages removed.
+    void countRemoved(MessageType type, int removed);
+
 public:
     /// @brief Constructor
     /// @param configurationParser Pointer to the configuration parser
@@ -95,6 +144,15 @@ public:
                                                                        const std::string moduleName = "",
                                                                        const std::string moduleType = "") override;
 
+    /// @copydoc IMultiTypeQueue::getNextBytesRawAwaitable(MessageType, const size_t, RawMessageCallback, const
+    /// std::string, const std::string, const size_t)
+    boost::asio::awaitable<int> getNextBytesRawAwaitable(MessageType type,
+                                                         const size_t messageQuantity,
+                                                         RawMessageCallback onMessage,
+                                                         const std::string moduleName = "",
+                                                         const std::string moduleType = "",
+                                                         const size_t skip = 0) override;
+
     /// @copydoc IMultiTypeQueue::getNextBytes(MessageType, size_t, const std::string, const std::string)
     std::vector<Message> getNextBytes(MessageType type,
                                       const size_t messageQuantity,
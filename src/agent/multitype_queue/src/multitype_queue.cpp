@@ -2,8 +2,14 @@
 #include <multitype_queue.hpp>
 #include <storage.hpp>
 
+#if !defined(_WIN32)
+#include <segmented_log_storage.hpp>
+#endif
+
 #include <boost/asio.hpp>
 #include <logger.hpp>
+
+#include <algorithm>
 #include <utility>
 
 namespace
@@ -31,12 +37,33 @@ MultiTypeQueue::MultiTypeQueue(std::shared_ptr<configuration::ConfigurationParse
 
     const auto dbFolderPath = configurationParser->GetConfigOrDefault(config::DEFAULT_DATA_PATH, "agent", "path.data");
 
+    auto queueBackend =
+        configurationParser->GetConfigOrDefault(config::agent::QUEUE_DEFAULT_BACKEND, "agent", "queue_backend");
+
+    if (std::find(std::begin(config::agent::VALID_QUEUE_BACKENDS),
+                  std::end(config::agent::VALID_QUEUE_BACKENDS),
+                  queueBackend) == std::end(config::agent::VALID_QUEUE_BACKENDS))
+    {
+        LogWarn("Incorrect value for 'queue_backend', the default value '{}' is used.",
+                config::agent::QUEUE_DEFAULT_BACKEND);
+        queueBackend = config::agent::QUEUE_DEFAULT_BACKEND;
+    }
+
     try
     {
         if (persistenceDest)
         {
             m_persistenceDest = std::move(persistenceDest);
         }
+        else if (queueBackend == "log")
+        {
+#if !defined(_WIN32)
+            m_persistenceDest = std::make_unique<SegmentedLogStorage>(dbFolderPath, m_vMessageTypeStrings);
+#else
+            LogWarn("The 'log' queue backend is not supported on this platform, using 'sqlite'.");
+            m_persistenceDest = std::make_unique<Storage>(dbFolderPath, m_vMessageTypeStrings);
+#endif
+        }
         else
         {
             m_persistenceDest = std::make_unique<Storage>(dbFolderPath, m_vMessageTypeStrings);
@@ -46,6 +73,16 @@ MultiTypeQueue::MultiTypeQueue(std::shared_ptr<configuration::ConfigurationParse
     {
         LogError("Error creating persistence: {}.", e.what());
     }
+
+    for (const auto& [type, tableName] : m_mapMessageTypeName)
+    {
+        auto& counters = m_counters[type];
+        if (m_persistenceDest)
+        {
+            counters.items = static_cast<size_t>(std::max(m_persistenceDest->GetElementCount(tableName), 0));
+            counters.bytes = m_persistenceDest->GetElementsStoredSize(tableName);
+        }
+    }
 }
 
 MultiTypeQueue::~MultiTypeQueue() = default;
@@ -56,46 +93,17 @@ int MultiTypeQueue::push(Message message, bool shouldWait)
 
     if (m_mapMessageTypeName.contains(message.type))
     {
-        auto sMessageType = m_mapMessageTypeName.at(message.type);
+        const auto& counters = m_counters.at(message.type);
 
         // Wait until the queue is not full
         if (shouldWait)
         {
             std::unique_lock<std::mutex> lock(m_mtx);
-            m_cv.wait_for(lock,
-                          m_timeout,
-                          [&, this] {
-                              return static_cast<size_t>(m_persistenceDest->GetElementCount(sMessageType)) < m_maxItems;
-                          });
+            m_cv.wait_for(lock, m_timeout, [&counters, this] { return counters.items < m_maxItems; });
         }
 
-        const auto storedMessages = static_cast<size_t>(m_persistenceDest->GetElementCount(sMessageType));
-        const auto spaceAvailable = (m_maxItems > storedMessages) ? m_maxItems - storedMessages : 0;
-        if (spaceAvailable)
-        {
-            auto messageData = message.data;
-            if (messageData.is_array())
-            {
-                if (messageData.size() <= spaceAvailable)
-                {
-                    for (const auto& singleMessageData : messageData)
-                    {
-                        result += m_persistenceDest->Store(
-                            singleMessageData, sMessageType, message.moduleName, message.moduleType, message.metaData);
-                        m_cv.notify_all();
-                    }
-                }
-            }
-            else
-            {
-                result = m_persistenceDest->Store(message.data,
-                                                  m_mapMessageTypeName.at(message.type),
-                                                  message.moduleName,
-                                                  message.moduleType,
-                                                  message.metaData);
-                m_cv.notify_all();
-            }
-        }
+        const size_t storedMessages = counters.items;
+        result = store(message, (m_maxItems > storedMessages) ? m_maxItems - storedMessages : 0);
     }
     else
     {
@@ -107,45 +115,18 @@ int MultiTypeQueue::push(Message message, bool shouldWait)
 boost::asio::awaitable<int> MultiTypeQueue::pushAwaitable(Message message)
 {
     int result = 0;
-    boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
 
     if (m_mapMessageTypeName.contains(message.type))
     {
-        auto sMessageType = m_mapMessageTypeName.at(message.type);
+        const auto& counters = m_counters.at(message.type);
 
-        while (static_cast<size_t>(m_persistenceDest->GetElementCount(sMessageType)) >= m_maxItems)
+        while (counters.items >= m_maxItems)
         {
-            timer.expires_after(std::chrono::milliseconds(m_timeout));
-            co_await timer.async_wait(boost::asio::use_awaitable);
+            co_await waitForChange(m_timeout);
         }
 
-        const auto storedItems = static_cast<size_t>(m_persistenceDest->GetElementCount(sMessageType));
-        const auto availableItems = (m_maxItems > storedItems) ? m_maxItems - storedItems : 0;
-        if (availableItems)
-        {
-            auto messageData = message.data;
-            if (messageData.is_array())
-            {
-                if (messageData.size() <= availableItems)
-                {
-                    for (const auto& singleMessageData : messageData)
-                    {
-                        result += m_persistenceDest->Store(
-                            singleMessageData, sMessageType, message.moduleName, message.moduleType, message.metaData);
-                        m_cv.notify_all();
-                    }
-                }
-            }
-            else
-            {
-                result = m_persistenceDest->Store(message.data,
-                                                  m_mapMessageTypeName.at(message.type),
-                                                  message.moduleName,
-                                                  message.moduleType,
-                                                  message.metaData);
-                m_cv.notify_all();
-            }
-        }
+        const size_t storedItems = counters.items;
+        result = store(message, (m_maxItems > storedItems) ? m_maxItems - storedItems : 0);
     }
     else
     {
@@ -154,6 +135,92 @@ boost::asio::awaitable<int> MultiTypeQueue::pushAwaitable(Message message)
     co_return result;
 }
 
+int MultiTypeQueue::store(const Message& message, size_t availableItems)
+{
+    int result = 0;
+
+    if (!availableItems)
+    {
+        return result;
+    }
+
+    const auto& tableName = m_mapMessageTypeName.at(message.type);
+    auto& counters = m_counters.at(message.type);
+    size_t storedBytes = 0;
+
+    if (message.data.is_array())
+    {
+        if (message.data.size() <= availableItems)
+        {
+            // The whole array is stored at once, in a single transaction
+            result = m_persistenceDest->Store(
+                message.data, tableName, message.moduleName, message.moduleType, message.metaData, &storedBytes);
+        }
+    }
+    else
+    {
+        result = m_persistenceDest->Store(
+            message.data, tableName, message.moduleName, message.moduleType, message.metaData, &storedBytes);
+    }
+
+    if (result > 0)
+    {
+        counters.items += static_cast<size_t>(result);
+        counters.bytes += storedBytes;
+        notifyWaiters();
+    }
+    return result;
+}
+
+void MultiTypeQueue::countRemoved(MessageType type, int removed)
+{
+    if (removed <= 0)
+    {
+        return;
+    }
+
+    auto& counters = m_counters.at(type);
+
+    auto items = counters.items.load();
+    while (!counters.items.compare_exchange_weak(
+        items, items > static_cast<size_t>(removed) ? items - static_cast<size_t>(removed) : 0))
+    {
+    }
+
+    // The removed messages may be anywhere in the table when filtering by module, so the size is read back from the
+    // storage, which keeps it per module, instead of being worked out here
+    counters.bytes = m_persistenceDest->GetElementsStoredSize(m_mapMessageTypeName.at(type));
+
+    notifyWaiters();
+}
+
+void MultiTypeQueue::notifyWaiters()
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_mtx);
+        for (const auto& waiter : m_waiters)
+        {
+            boost::asio::post(waiter->get_executor(), [waiter] { waiter->cancel(); });
+        }
+    }
+    m_cv.notify_all();
+}
+
+boost::asio::awaitable<void> MultiTypeQueue::waitForChange(std::chrono::milliseconds timeout)
+{
+    auto waiter = std::make_shared<boost::asio::steady_timer>(co_await boost::asio::this_coro::executor, timeout);
+    {
+        const std::lock_guard<std::mutex> lock(m_mtx);
+        m_waiters.push_back(waiter);
+    }
+
+    boost::system::error_code ec;
+    co_await waiter->async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+    const std::lock_guard<std::mutex> lock(m_mtx);
+    std::erase(m_waiters, waiter);
+}
+
 int MultiTypeQueue::push(std::vector<Message> messages)
 {
     int result = 0;
@@ -185,36 +252,84 @@ Message MultiTypeQueue::getNext(MessageType type, const std::string moduleName,
     return result;
 }
 
+boost::asio::awaitable<void> MultiTypeQueue::waitForBytes(MessageType type, size_t messageQuantity)
+{
+    //  waits for specified size stored
+    const auto batchTimeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_batchInterval);
+
+    for (auto now = std::chrono::steady_clock::now(); (sizePerType(type) < messageQuantity) && (now < batchTimeout);
+         now = std::chrono::steady_clock::now())
+    {
+        co_await waitForChange(
+            std::min(m_timeout, std::chrono::duration_cast<std::chrono::milliseconds>(batchTimeout - now)));
+    }
+
+    if (sizePerType(type) >= messageQuantity)
+    {
+        LogDebug("Required size achieved: {}B", messageQuantity);
+    }
+    else
+    {
+        LogDebug("Timeout reached after {}ms", m_batchInterval);
+    }
+}
+
+bool MultiTypeQueue::hasFullBatchAfter(MessageType type, size_t skip, size_t messageQuantity)
+{
+    const auto& counters = m_counters.at(type);
+    const auto items = counters.items.load();
+    const auto bytes = counters.bytes.load();
+
+    if (items <= skip)
+    {
+        return false;
+    }
+
+    // The skipped messages are assumed to be of average size, which saves reading them from the storage
+    const auto skippedBytes = bytes / items * skip;
+    return bytes - skippedBytes >= messageQuantity;
+}
+
 boost::asio::awaitable<std::vector<Message>> MultiTypeQueue::getNextBytesAwaitable(MessageType type,
                                                                                    const size_t messageQuantity,
                                                                                    const std::string moduleName,
                                                                                    const std::string moduleType)
 {
-    boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
-
     std::vector<Message> result;
     if (m_mapMessageTypeName.contains(type))
     {
-        //  waits for specified size stored
-        boost::asio::steady_timer batchTimeoutTimer(co_await boost::asio::this_coro::executor);
-        batchTimeoutTimer.expires_after(std::chrono::milliseconds(m_batchInterval));
+        co_await waitForBytes(type, messageQuantity);
 
-        while ((sizePerType(type) < messageQuantity) && (batchTimeoutTimer.expiry() > std::chrono::steady_clock::now()))
-        {
-            timer.expires_after(std::chrono::milliseconds(m_timeout));
-            co_await timer.async_wait(boost::asio::use_awaitable);
-        }
+        result = getNextBytes(type, messageQuantity, moduleName, moduleType);
+    }
+    else
+    {
+        LogError("Error didn't find the queue.");
+    }
+    co_return result;
+}
 
-        if (sizePerType(type) >= messageQuantity)
+boost::asio::awaitable<int> MultiTypeQueue::getNextBytesRawAwaitable(MessageType type,
+                                                                     const size_t messageQuantity,
+                                                                     RawMessageCallback onMessage,
+                                                                     const std::string moduleName,
+                                                                     const std::string moduleType,
+                                                                     const size_t skip)
+{
+    int result = 0;
+    if (m_mapMessageTypeName.contains(type))
+    {
+        if (skip == 0)
         {
-            LogDebug("Required size achieved: {}B", messageQuantity);
+            co_await waitForBytes(type, messageQuantity);
         }
-        else
+        else if (moduleName.empty() && moduleType.empty() && !hasFullBatchAfter(type, skip, messageQuantity))
         {
-            LogDebug("Timeout reached after {}ms", m_batchInterval);
+            co_return result;
         }
 
-        result = getNextBytes(type, messageQuantity, moduleName, moduleType);
+        result = m_persistenceDest->RetrieveRawBySize(
+            messageQuantity, m_mapMessageTypeName.at(type), onMessage, moduleName, moduleType, skip);
     }
     else
     {
@@ -252,7 +367,10 @@ bool MultiTypeQueue::pop(MessageType type, const std::string moduleName, const s
     bool result = false;
     if (m_mapMessageTypeName.contains(type))
     {
-        result = m_persistenceDest->RemoveMultiple(1, m_mapMessageTypeName.at(type), moduleName, moduleType);
+        const auto removed =
+            m_persistenceDest->RemoveMultiple(1, m_mapMessageTypeName.at(type), moduleName, moduleType);
+        countRemoved(type, removed);
+        result = removed > 0;
     }
     else
     {
@@ -271,6 +389,7 @@ int MultiTypeQueue::popN(MessageType type,
     {
         result =
             m_persistenceDest->RemoveMultiple(messageQuantity, m_mapMessageTypeName.at(type), moduleName, moduleType);
+        countRemoved(type, result);
     }
     else
     {
@@ -283,6 +402,10 @@ bool MultiTypeQueue::isEmpty(MessageType type, const std::string moduleName, con
 {
     if (m_mapMessageTypeName.contains(type))
     {
+        if (moduleName.empty() && moduleType.empty())
+        {
+            return m_counters.at(type).items == 0;
+        }
         return m_persistenceDest->GetElementCount(m_mapMessageTypeName.at(type), moduleName, moduleType) == 0;
     }
     else
@@ -296,8 +419,12 @@ bool MultiTypeQueue::isFull(MessageType type, const std::string moduleName, cons
 {
     if (m_mapMessageTypeName.contains(type))
     {
+        if (moduleName.empty() && moduleType.empty())
+        {
+            return m_counters.at(type).items >= m_maxItems;
+        }
         return static_cast<size_t>(m_persistenceDest->GetElementCount(
-                   m_mapMessageTypeName.at(type), moduleName, moduleType)) == m_maxItems;
+                   m_mapMessageTypeName.at(type), moduleName, moduleType)) >= m_maxItems;
     }
     else
     {
@@ -310,6 +437,10 @@ int MultiTypeQueue::storedItems(MessageType type, const std::string moduleName,
 {
     if (m_mapMessageTypeName.contains(type))
     {
+        if (moduleName.empty() && moduleType.empty())
+        {
+            return static_cast<int>(m_counters.at(type).items);
+        }
         return m_persistenceDest->GetElementCount(m_mapMessageTypeName.at(type), moduleName, moduleType);
     }
     else
@@ -323,7 +454,7 @@ size_t MultiTypeQueue::sizePerType(MessageType type)
 {
     if (m_mapMessageTypeName.contains(type))
     {
-        return m_persistenceDest->GetElementsStoredSize(m_mapMessageTypeName.at(type));
+        return m_counters.at(type).bytes;
     }
     else
     {
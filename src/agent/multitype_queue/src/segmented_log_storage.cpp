@@ -0,0 +1,1145 @@
+#include <segmented_log_storage.hpp>
+
+#include <logger.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // storage layout
+    const std::string QUEUE_LOG_FOLDER_NAME = "queue.log";
+    const std::string SEGMENT_EXTENSION = ".log";
+    const std::string CURSOR_FILE_NAME = "cursor";
+
+    // record layout: [payload length][payload checksum] followed by four length-prefixed fields
+    constexpr size_t RECORD_HEADER_SIZE = 2 * sizeof(uint32_t);
+    constexpr size_t FIELD_HEADER_SIZE = sizeof(uint32_t);
+    constexpr size_t RECORD_FIELDS = 4;
+
+    // high bit of the payload length, set on records removed ahead of the head of the log
+    constexpr uint32_t REMOVED_FLAG = 0x80000000U;
+
+    /// @brief FNV-1a checksum used to detect torn records on recovery
+    uint32_t Checksum(const char* data, size_t size)
+    {
+        uint32_t hash = 2166136261U;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+
+    uint32_t ReadU32(const char* data)
+    {
+        uint32_t value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    void WriteU32(char* data, uint32_t value)
+    {
+        std::memcpy(data, &value, sizeof(value));
+    }
+
+    std::system_error SystemError(const std::string& what, const fs::path& path)
+    {
+        return {errno, std::generic_category(), fmt::format("{} {}", what, path.string())};
+    }
+
+    size_t PageSize()
+    {
+        static const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return pageSize;
+    }
+
+    int SyncFileDescriptor(int fd)
+    {
+#if defined(__APPLE__)
+        return fsync(fd);
+#else
+        return fdatasync(fd);
+#endif
+    }
+
+    /// @brief Flushes the entries of a directory, so that the files created or removed in it persist
+    bool SyncDirectory(const fs::path& dir)
+    {
+        const int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0)
+        {
+            LogError("Error opening directory {}: {}.", dir.string(), std::strerror(errno));
+            return false;
+        }
+
+        const bool synced = fsync(fd) == 0;
+        if (!synced)
+        {
+            LogError("Error syncing directory {}: {}.", dir.string(), std::strerror(errno));
+        }
+        close(fd);
+        return synced;
+    }
+} // namespace
+
+/// @brief Memory-mapped segment file
+struct SegmentedLogStorage::Segment
+{
+    /// @brief Opens or creates a segment file and maps it in memory
+    /// @param segmentPath Path of the segment file
+    /// @param firstSequence Sequence number of the first record in the segment
+    /// @param segmentCapacity Capacity used when the segment is created
+    /// @param create Whether the segment must be created
+    Segment(fs::path segmentPath, uint64_t firstSequence, size_t segmentCapacity, bool create)
+        : path(std::move(segmentPath))
+        , baseSeq(firstSequence)
+    {
+        fd = open(path.c_str(), create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0640);
+        if (fd < 0)
+        {
+            throw SystemError("Cannot open segment", path);
+        }
+
+        if (create)
+        {
+            capacity = segmentCapacity;
+#if defined(__linux__)
+            // Reserve the blocks up front so that running out of disk space is reported here instead of as a
+            // SIGBUS when writing through the mapping.
+            if (const int err = posix_fallocate(fd, 0, static_cast<off_t>(capacity)); err != 0)
+            {
+                errno = err;
+                const auto error = SystemError("Cannot allocate segment", path);
+                Release();
+                fs::remove(path);
+                throw error;
+            }
+#else
+            if (ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+            {
+                const auto error = SystemError("Cannot allocate segment", path);
+                Release();
+                fs::remove(path);
+                throw error;
+            }
+#endif
+        }
+        else
+        {
+            struct stat st {};
+            if (fstat(fd, &st) != 0)
+            {
+                const auto error = SystemError("Cannot stat segment", path);
+                Release();
+                throw error;
+            }
+            capacity = static_cast<size_t>(st.st_size);
+        }
+
+        if (capacity > 0)
+        {
+            void* mapping = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            {
+                const auto error = SystemError("Cannot map segment", path);
+                Release();
+                throw error;
+            }
+            data = static_cast<char*>(mapping);
+        }
+    }
+
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+    Segment(Segment&&) = delete;
+    Segment& operator=(Segment&&) = delete;
+
+    ~Segment()
+    {
+        Release();
+    }
+
+    /// @brief Unmaps and closes the segment
+    void Release()
+    {
+        if (data != nullptr)
+        {
+            munmap(data, capacity);
+            data = nullptr;
+        }
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    /// @brief Sequence number following the last record of the segment
+    uint64_t EndSeq() const
+    {
+        return baseSeq + records;
+    }
+
+    /// @brief Flags a record as removed and widens the range rewritten since the last group commit
+    /// @param offset Offset of the record in the segment
+    void MarkRemoved(size_t offset)
+    {
+        WriteU32(data + offset, ReadU32(data + offset) | REMOVED_FLAG);
+        MarkDirty(offset, offset + sizeof(uint32_t));
+    }
+
+    /// @brief Widens the range of already appended bytes that must be flushed again
+    /// @param from Start of the range
+    /// @param to End of the range
+    void MarkDirty(size_t from, size_t to)
+    {
+        dirtyFrom = (dirtyFrom == dirtyTo) ? from : std::min(dirtyFrom, from);
+        dirtyTo = std::max(dirtyTo, to);
+    }
+
+    fs::path path;
+    uint64_t baseSeq = 0;
+    int fd = -1;
+    char* data = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t synced = 0;
+    size_t dirtyFrom = 0;
+    size_t dirtyTo = 0;
+    uint64_t records = 0;
+};
+
+/// @brief Per-table log state
+struct SegmentedLogStorage::Log
+{
+    Log() = default;
+    Log(const Log&) = delete;
+    Log& operator=(const Log&) = delete;
+    Log(Log&&) = delete;
+    Log& operator=(Log&&) = delete;
+
+    ~Log()
+    {
+        if (cursorFd >= 0)
+        {
+            close(cursorFd);
+        }
+    }
+
+    /// @brief Number of unconsumed records
+    size_t Count() const
+    {
+        return static_cast<size_t>(nextSeq - headSeq) - removed;
+    }
+
+    fs::path dir;
+    std::deque<std::unique_ptr<Segment>> segments;
+    size_t headOffset = 0;
+    uint64_t headSeq = 0;
+    uint64_t nextSeq = 0;
+    size_t removed = 0;
+    size_t bytes = 0;
+    int cursorFd = -1;
+    bool cursorDirty = false;
+    bool dirDirty = false;
+};
+
+namespace
+{
+    /// @brief Decodes the record stored at the given position.
+    /// @param data Start of the record.
+    /// @param available Bytes available from data to the end of the segment.
+    /// @param verify Whether the checksum of the record must be verified.
+    /// @param fields Output views of the four record fields.
+    /// @param recordSize Output total size of the record.
+    /// @return True if a valid record was decoded, whether it was removed or not.
+    bool DecodeRecord(const char* data,
+                      size_t available,
+                      bool verify,
+                      std::array<std::string_view, RECORD_FIELDS>& fields,
+                      size_t& recordSize)
+    {
+        if (available < RECORD_HEADER_SIZE)
+        {
+            return false;
+        }
+
+        const size_t payloadSize = ReadU32(data) & ~REMOVED_FLAG;
+        if (payloadSize < RECORD_FIELDS * FIELD_HEADER_SIZE || payloadSize > available - RECORD_HEADER_SIZE)
+        {
+            return false;
+        }
+
+        const char* payload = data + RECORD_HEADER_SIZE;
+        if (verify && Checksum(payload, payloadSize) != ReadU32(data + sizeof(uint32_t)))
+        {
+            return false;
+        }
+
+        size_t offset = 0;
+        for (auto& field : fields)
+        {
+            if (payloadSize - offset < FIELD_HEADER_SIZE)
+            {
+                return false;
+            }
+            const size_t fieldSize = ReadU32(payload + offset);
+            offset += FIELD_HEADER_SIZE;
+            if (payloadSize - offset < fieldSize)
+            {
+                return false;
+            }
+            field = std::string_view(payload + offset, fieldSize);
+            offset += fieldSize;
+        }
+
+        recordSize = RECORD_HEADER_SIZE + payloadSize;
+        return true;
+    }
+
+    bool IsRemoved(const char* data)
+    {
+        return (ReadU32(data) & REMOVED_FLAG) != 0;
+    }
+
+    bool Matches(std::string_view value, const std::string& filter)
+    {
+        return filter.empty() || value == filter;
+    }
+
+    nlohmann::json ToJson(std::string_view moduleName,
+                          std::string_view moduleType,
+                          std::string_view metadata,
+                          std::string_view message)
+    {
+        nlohmann::json outputJson = {{"moduleName", moduleName},
+                                     {"moduleType", moduleType},
+                                     {"metadata", metadata},
+                                     {"data", {}}};
+        if (!message.empty())
+        {
+            outputJson["data"] = nlohmann::json::parse(message);
+        }
+        return outputJson;
+    }
+} // namespace
+
+SegmentedLogStorage::SegmentedLogStorage(const std::string& dbFolderPath,
+                                         const std::vector<std::string>& tableNames,
+                                         size_t segmentSize,
+                                         std::chrono::milliseconds syncInterval)
+    : m_segmentSize(segmentSize)
+    , m_syncInterval(syncInterval)
+{
+    const auto logFolderPath = fs::path(dbFolderPath) / QUEUE_LOG_FOLDER_NAME;
+
+    try
+    {
+        for (const auto& table : tableNames)
+        {
+            auto log = std::make_unique<Log>();
+            log->dir = logFolderPath / table;
+            m_logs.emplace(table, std::move(log));
+            OpenLog(table);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        throw std::runtime_error(fmt::format("Cannot open queue log {}: {}", logFolderPath.string(), e.what()));
+    }
+
+    m_syncThread = std::thread([this]() { SyncLoop(); });
+}
+
+SegmentedLogStorage::~SegmentedLogStorage()
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopSync = true;
+    }
+    m_syncCv.notify_all();
+
+    if (m_syncThread.joinable())
+    {
+        m_syncThread.join();
+    }
+
+    Sync();
+}
+
+void SegmentedLogStorage::OpenLog(const std::string& tableName)
+{
+    auto& log = *m_logs.at(tableName);
+
+    fs::create_directories(log.dir);
+
+    std::vector<std::pair<uint64_t, fs::path>> segmentFiles;
+    for (const auto& entry : fs::directory_iterator(log.dir))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == SEGMENT_EXTENSION)
+        {
+            segmentFiles.emplace_back(std::stoull(entry.path().stem().string()), entry.path());
+        }
+    }
+    std::sort(segmentFiles.begin(), segmentFiles.end());
+
+    std::array<std::string_view, RECORD_FIELDS> fields;
+    for (const auto& [baseSeq, path] : segmentFiles)
+    {
+        auto segment = std::make_unique<Segment>(path, baseSeq, 0, false);
+
+        // A segment without records was left behind by an interrupted creation
+        if (segment->capacity < RECORD_HEADER_SIZE || ReadU32(segment->data) == 0)
+        {
+            segment.reset();
+            fs::remove(path);
+            continue;
+        }
+
+        size_t recordSize = 0;
+        while (DecodeRecord(
+            segment->data + segment->used, segment->capacity - segment->used, true, fields, recordSize))
+        {
+            segment->used += recordSize;
+            ++segment->records;
+        }
+
+        if (segment->used + RECORD_HEADER_SIZE <= segment->capacity && ReadU32(segment->data + segment->used) != 0)
+        {
+            LogWarn("Discarding torn record at offset {} of {}.", segment->used, path.string());
+            std::memset(segment->data + segment->used, 0, segment->capacity - segment->used);
+        }
+        segment->synced = segment->used;
+
+        log.segments.push_back(std::move(segment));
+    }
+
+    log.nextSeq = log.segments.empty() ? 0 : log.segments.back()->EndSeq();
+    log.headSeq = log.segments.empty() ? 0 : log.segments.front()->baseSeq;
+
+    const auto cursorPath = log.dir / CURSOR_FILE_NAME;
+    log.cursorFd = open(cursorPath.c_str(), O_RDWR | O_CREAT, 0640);
+    if (log.cursorFd < 0)
+    {
+        throw SystemError("Cannot open cursor", cursorPath);
+    }
+
+    uint64_t committedSeq = 0;
+    if (pread(log.cursorFd, &committedSeq, sizeof(committedSeq), 0) == static_cast<ssize_t>(sizeof(committedSeq)))
+    {
+        log.headSeq = std::clamp(committedSeq, log.headSeq, log.nextSeq);
+        if (log.segments.empty())
+        {
+            log.headSeq = log.nextSeq = committedSeq;
+        }
+    }
+
+    // Drop the segments that were consumed before the last shutdown, keeping the tail one for appending
+    while (log.segments.size() > 1 && log.segments.front()->EndSeq() <= log.headSeq)
+    {
+        const auto path = log.segments.front()->path;
+        log.segments.pop_front();
+        fs::remove(path);
+    }
+
+    if (!log.segments.empty())
+    {
+        const auto& front = *log.segments.front();
+        size_t recordSize = 0;
+        for (uint64_t seq = front.baseSeq; seq < log.headSeq; ++seq)
+        {
+            DecodeRecord(front.data + log.headOffset, front.used - log.headOffset, false, fields, recordSize);
+            log.headOffset += recordSize;
+        }
+    }
+
+    ForEachPosition(log,
+                    [&log](const Segment& segment, size_t offset, size_t, const RecordView& record)
+                    {
+                        if (IsRemoved(segment.data + offset))
+                        {
+                            ++log.removed;
+                        }
+                        else
+                        {
+                            log.bytes += record.moduleName.size() + record.moduleType.size() + record.metadata.size() +
+                                         record.message.size();
+                        }
+                        return true;
+                    });
+
+    SkipRemovedHead(log);
+
+    // The cursor may have just been created and consumed segments removed
+    SyncDirectory(log.dir);
+}
+
+SegmentedLogStorage::Log* SegmentedLogStorage::GetLog(const std::string& tableName)
+{
+    const auto it = m_logs.find(tableName);
+    return it == m_logs.end() ? nullptr : it->second.get();
+}
+
+void SegmentedLogStorage::Append(Log& log, const RecordView& record)
+{
+    const std::array<std::string_view, RECORD_FIELDS> fields {
+        record.moduleName, record.moduleType, record.metadata, record.message};
+
+    size_t payloadSize = 0;
+    for (const auto& field : fields)
+    {
+        payloadSize += FIELD_HEADER_SIZE + field.size();
+    }
+    const size_t recordSize = RECORD_HEADER_SIZE + payloadSize;
+
+    if (log.segments.empty() || log.segments.back()->capacity - log.segments.back()->used < recordSize)
+    {
+        const auto path = log.dir / fmt::format("{:020}{}", log.nextSeq, SEGMENT_EXTENSION);
+        log.segments.push_back(std::make_unique<Segment>(path, log.nextSeq, std::max(m_segmentSize, recordSize), true));
+        log.dirDirty = true;
+
+        // The previous tail may have been fully consumed already
+        while (log.segments.size() > 1 && log.segments.front()->EndSeq() <= log.headSeq)
+        {
+            m_retiredSegments.push_back(std::move(log.segments.front()));
+            log.segments.pop_front();
+            log.headOffset = 0;
+        }
+    }
+
+    auto& tail = *log.segments.back();
+    char* const recordStart = tail.data + tail.used;
+    char* payload = recordStart + RECORD_HEADER_SIZE;
+    for (const auto& field : fields)
+    {
+        WriteU32(payload, static_cast<uint32_t>(field.size()));
+        payload += FIELD_HEADER_SIZE;
+        std::memcpy(payload, field.data(), field.size());
+        payload += field.size();
+    }
+
+    WriteU32(recordStart + sizeof(uint32_t), Checksum(recordStart + RECORD_HEADER_SIZE, payloadSize));
+    WriteU32(recordStart, static_cast<uint32_t>(payloadSize));
+
+    tail.used += recordSize;
+    ++tail.records;
+    ++log.nextSeq;
+    log.bytes += record.moduleName.size() + record.moduleType.size() + record.metadata.size() + record.message.size();
+}
+
+void SegmentedLogStorage::ForEachPosition(
+    const Log& log, const std::function<bool(Segment&, size_t, size_t, const RecordView&)>& visitor) const
+{
+    std::array<std::string_view, RECORD_FIELDS> fields;
+    size_t recordSize = 0;
+
+    for (size_t i = 0; i < log.segments.size(); ++i)
+    {
+        auto& segment = *log.segments[i];
+        size_t offset = (i == 0) ? log.headOffset : 0;
+
+        while (offset < segment.used &&
+               DecodeRecord(segment.data + offset, segment.used - offset, false, fields, recordSize))
+        {
+            if (!visitor(segment, offset, recordSize, RecordView {fields[0], fields[1], fields[2], fields[3]}))
+            {
+                return;
+            }
+            offset += recordSize;
+        }
+    }
+}
+
+void SegmentedLogStorage::ForEach(const Log& log, const std::function<bool(const RecordView&)>& visitor) const
+{
+    ForEachPosition(log,
+                    [&visitor](const Segment& segment, size_t offset, size_t, const RecordView& record)
+                    { return IsRemoved(segment.data + offset) || visitor(record); });
+}
+
+void SegmentedLogStorage::AdvanceHead(Log& log, size_t recordSize)
+{
+    log.headOffset += recordSize;
+    ++log.headSeq;
+    log.cursorDirty = true;
+
+    while (log.segments.size() > 1 && log.segments.front()->EndSeq() <= log.headSeq)
+    {
+        m_retiredSegments.push_back(std::move(log.segments.front()));
+        log.segments.pop_front();
+        log.headOffset = 0;
+    }
+}
+
+void SegmentedLogStorage::SkipRemovedHead(Log& log)
+{
+    std::array<std::string_view, RECORD_FIELDS> fields;
+    size_t recordSize = 0;
+
+    while (log.removed > 0)
+    {
+        const auto& front = *log.segments.front();
+        if (!IsRemoved(front.data + log.headOffset) ||
+            !DecodeRecord(front.data + log.headOffset, front.used - log.headOffset, false, fields, recordSize))
+        {
+            break;
+        }
+
+        --log.removed;
+        AdvanceHead(log, recordSize);
+    }
+}
+
+bool SegmentedLogStorage::Clear(const std::vector<std::string>& tableNames)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool result = true;
+    for (const auto& table : tableNames)
+    {
+        auto* log = GetLog(table);
+        if (log == nullptr)
+        {
+            LogError("Clear operation failed: unknown table {}.", table);
+            result = false;
+            continue;
+        }
+
+        for (auto& segment : log->segments)
+        {
+            m_retiredSegments.push_back(std::move(segment));
+        }
+        log->segments.clear();
+        log->headOffset = 0;
+        log->headSeq = log->nextSeq;
+        log->removed = 0;
+        log->bytes = 0;
+        log->cursorDirty = true;
+    }
+    return result;
+}
+
+int SegmentedLogStorage::Store(const nlohmann::json& message,
+                               const std::string& tableName,
+                               const std::string& moduleName,
+                               const std::string& moduleType,
+                               const std::string& metadata,
+                               size_t* storedBytes)
+{
+    int result = 0;
+    size_t bytes = 0;
+
+    if (storedBytes != nullptr)
+    {
+        *storedBytes = 0;
+    }
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto* log = GetLog(tableName);
+    if (log == nullptr)
+    {
+        LogError("Error during Store operation: unknown table {}.", tableName);
+        return result;
+    }
+
+    const auto store = [&](const nlohmann::json& data)
+    {
+        try
+        {
+            const auto dataString = data.dump();
+            Append(*log, RecordView {moduleName, moduleType, metadata, dataString});
+            bytes += moduleName.size() + moduleType.size() + metadata.size() + dataString.size();
+            result++;
+        }
+        catch (const std::exception& e)
+        {
+            LogError("Error during Store operation: {}.", e.what());
+        }
+    };
+
+    if (message.is_array())
+    {
+        for (const auto& singleMessageData : message)
+        {
+            store(singleMessageData);
+        }
+    }
+    else
+    {
+        store(message);
+    }
+
+    if (storedBytes != nullptr)
+    {
+        *storedBytes = bytes;
+    }
+
+    return result;
+}
+
+int SegmentedLogStorage::RemoveMultiple(int n,
+                                        const std::string& tableName,
+                                        const std::string& moduleName,
+                                        const std::string& moduleType)
+{
+    int result = 0;
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto* log = GetLog(tableName);
+    if (log == nullptr)
+    {
+        LogError("Error during RemoveMultiple operation: unknown table {}.", tableName);
+        return result;
+    }
+
+    const size_t limit = n > 0 ? static_cast<size_t>(n) : log->Count();
+    std::array<std::string_view, RECORD_FIELDS> fields;
+    size_t recordSize = 0;
+
+    // Matching records at the head are consumed right away
+    while (static_cast<size_t>(result) < limit && log->Count() > 0)
+    {
+        SkipRemovedHead(*log);
+
+        const auto& front = *log->segments.front();
+        if (!DecodeRecord(front.data + log->headOffset, front.used - log->headOffset, false, fields, recordSize) ||
+            !Matches(fields[0], moduleName) || !Matches(fields[1], moduleType))
+        {
+            break;
+        }
+
+        log->bytes -= fields[0].size() + fields[1].size() + fields[2].size() + fields[3].size();
+        AdvanceHead(*log, recordSize);
+        result++;
+    }
+
+    // The ones behind a record of another module are flagged, and consumed once the head reaches them
+    if (static_cast<size_t>(result) < limit && log->Count() > 0)
+    {
+        ForEachPosition(*log,
+                        [&](Segment& segment, size_t offset, size_t, const RecordView& record)
+                        {
+                            if (static_cast<size_t>(result) >= limit)
+                            {
+                                return false;
+                            }
+                            if (IsRemoved(segment.data + offset) || !Matches(record.moduleName, moduleName) ||
+                                !Matches(record.moduleType, moduleType))
+                            {
+                                return true;
+                            }
+
+                            segment.MarkRemoved(offset);
+                            ++log->removed;
+                            log->bytes -= record.moduleName.size() + record.moduleType.size() +
+                                          record.metadata.size() + record.message.size();
+                            result++;
+                            return true;
+                        });
+    }
+
+    SkipRemovedHead(*log);
+
+    return result;
+}
+
+nlohmann::json SegmentedLogStorage::RetrieveMultiple(int n,
+                                                     const std::string& tableName,
+                                                     const std::string& moduleName,
+                                                     const std::string& moduleType)
+{
+    nlohmann::json messages = nlohmann::json::array();
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto* log = GetLog(tableName);
+    if (log == nullptr)
+    {
+        LogError("Error during RetrieveMultiple operation: unknown table {}.", tableName);
+        return {};
+    }
+
+    try
+    {
+        ForEach(*log,
+                [&](const RecordView& record)
+                {
+                    if (n > 0 && messages.size() >= static_cast<size_t>(n))
+                    {
+                        return false;
+                    }
+                    if (Matches(record.moduleName, moduleName) && Matches(record.moduleType, moduleType))
+                    {
+                        messages.push_back(
+                            ToJson(record.moduleName, record.moduleType, record.metadata, record.message));
+                    }
+                    return true;
+                });
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error during RetrieveMultiple operation: {}.", e.what());
+        return {};
+    }
+
+    return messages;
+}
+
+nlohmann::json SegmentedLogStorage::RetrieveBySize(size_t n,
+                                                   const std::string& tableName,
+                                                   const std::string& moduleName,
+                                                   const std::string& moduleType)
+{
+    nlohmann::json messages = nlohmann::json::array();
+    size_t sizeAccum = 0;
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto* log = GetLog(tableName);
+    if (log == nullptr)
+    {
+        LogError("Error during RetrieveBySize operation: unknown table {}.", tableName);
+        return {};
+    }
+
+    try
+    {
+        ForEach(*log,
+                [&](const RecordView& record)
+                {
+                    if (!Matches(record.moduleName, moduleName) || !Matches(record.moduleType, moduleType))
+                    {
+                        return true;
+                    }
+
+                    messages.push_back(ToJson(record.moduleName, record.moduleType, record.metadata, record.message));
+
+                    if (n)
+                    {
+                        const size_t messageSize = record.moduleName.size() + record.moduleType.size() +
+                                                   record.metadata.size() + record.message.size();
+                        if (sizeAccum + messageSize >= n)
+                        {
+                            return false;
+                        }
+                        sizeAccum += messageSize;
+                    }
+                    return true;
+                });
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error during RetrieveBySize operation: {}.", e.what());
+        return {};
+    }
+
+    return messages;
+}
+
+int SegmentedLogStorage::RetrieveRawBySize(size_t n,
+                                           const std::string& tableName,
+                                           const RawMessageCallback& onMessage,
+                                           const std::string& moduleName,
+                                           const std::string& moduleType,
+                                           size_t skip)
+{
+    int count = 0;
+    size_t sizeAccum = 0;
+    size_t skipped = 0;
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto* log = GetLog(tableName);
+    if (log == nullptr)
+    {
+        LogError("Error during RetrieveRawBySize operation: unknown table {}.", tableName);
+        return 0;
+    }
+
+    try
+    {
+        ForEach(*log,
+                [&](const RecordView& record)
+                {
+                    if (!Matches(record.moduleName, moduleName) || !Matches(record.moduleType, moduleType))
+                    {
+                        return true;
+                    }
+
+                    // Records are only decoded to be skipped, walking the mapped segments is cheap
+                    if (skipped < skip)
+                    {
+                        skipped++;
+                        return true;
+                    }
+
+                    onMessage(record.metadata, record.message);
+                    count++;
+
+                    if (n)
+                    {
+                        const size_t messageSize = record.moduleName.size() + record.moduleType.size() +
+                                                   record.metadata.size() + record.message.size();
+                        if (sizeAccum + messageSize >= n)
+                        {
+                            return false;
+                        }
+                        sizeAccum += messageSize;
+                    }
+                    return true;
+                });
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error during RetrieveRawBySize operation: {}.", e.what());
+    }
+
+    return count;
+}
+
+int SegmentedLogStorage::GetElementCount(const std::string& tableName,
+                                         const std::string& moduleName,
+                                         const std::string& moduleType)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto* log = GetLog(tableName);
+    if (log == nullptr)
+    {
+        LogError("Error during GetElementCount operation: unknown table {}.", tableName);
+        return 0;
+    }
+
+    if (moduleName.empty() && moduleType.empty())
+    {
+        return static_cast<int>(log->Count());
+    }
+
+    int count = 0;
+    ForEach(*log,
+            [&](const RecordView& record)
+            {
+                if (Matches(record.moduleName, moduleName) && Matches(record.moduleType, moduleType))
+                {
+                    count++;
+                }
+                return true;
+            });
+    return count;
+}
+
+size_t SegmentedLogStorage::GetElementsStoredSize(const std::string& tableName,
+                                                  const std::string& moduleName,
+                                                  const std::string& moduleType)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto* log = GetLog(tableName);
+    if (log == nullptr)
+    {
+        LogError("Error during GetElementsStoredSize operation: unknown table {}.", tableName);
+        return 0;
+    }
+
+    if (moduleName.empty() && moduleType.empty())
+    {
+        return log->bytes;
+    }
+
+    size_t size = 0;
+    ForEach(*log,
+            [&](const RecordView& record)
+            {
+                if (Matches(record.moduleName, moduleName) && Matches(record.moduleType, moduleType))
+                {
+                    size += record.moduleName.size() + record.moduleType.size() + record.metadata.size() +
+                            record.message.size();
+                }
+                return true;
+            });
+    return size;
+}
+
+void SegmentedLogStorage::Sync()
+{
+    struct PendingRange
+    {
+        Segment* segment;
+        size_t from;
+        size_t to;
+        bool appended;
+    };
+
+    struct PendingCursor
+    {
+        Log* log;
+        uint64_t headSeq;
+    };
+
+    const std::lock_guard<std::mutex> syncLock(m_syncMutex);
+
+    std::vector<PendingRange> ranges;
+    std::vector<Log*> directories;
+    std::vector<PendingCursor> cursors;
+    std::vector<std::unique_ptr<Segment>> retired;
+
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& [table, log] : m_logs)
+        {
+            for (auto& segment : log->segments)
+            {
+                if (segment->used > segment->synced)
+                {
+                    ranges.push_back({segment.get(), segment->synced, segment->used, true});
+                }
+                if (segment->dirtyTo > segment->dirtyFrom)
+                {
+                    ranges.push_back({segment.get(), segment->dirtyFrom, segment->dirtyTo, false});
+                    segment->dirtyFrom = segment->dirtyTo = 0;
+                }
+            }
+
+            if (log->dirDirty)
+            {
+                directories.push_back(log.get());
+                log->dirDirty = false;
+            }
+
+            if (log->cursorDirty)
+            {
+                cursors.push_back({log.get(), log->headSeq});
+                log->cursorDirty = false;
+            }
+        }
+
+        retired.swap(m_retiredSegments);
+    }
+
+    // Segments are only unmapped by this function, so they stay valid after releasing the lock even if they are
+    // retired in the meantime.
+    std::vector<PendingRange> failedRanges;
+    for (const auto& range : ranges)
+    {
+        const size_t from = range.from - (range.from % PageSize());
+        if (msync(range.segment->data + from, range.to - from, MS_SYNC) != 0)
+        {
+            LogError("Error syncing {}: {}.", range.segment->path.string(), std::strerror(errno));
+            if (!range.appended)
+            {
+                failedRanges.push_back(range);
+            }
+            continue;
+        }
+        if (range.appended)
+        {
+            range.segment->synced = range.to;
+        }
+    }
+
+    // New segments are only reachable after a crash once their directory entries are on disk
+    std::vector<Log*> failedDirectories;
+    for (auto* log : directories)
+    {
+        if (!SyncDirectory(log->dir))
+        {
+            failedDirectories.push_back(log);
+        }
+    }
+
+    std::vector<Log*> failedCursors;
+    for (const auto& cursor : cursors)
+    {
+        if (pwrite(cursor.log->cursorFd, &cursor.headSeq, sizeof(cursor.headSeq), 0) !=
+                static_cast<ssize_t>(sizeof(cursor.headSeq)) ||
+            SyncFileDescriptor(cursor.log->cursorFd) != 0)
+        {
+            LogError("Error writing queue cursor of {}: {}.", cursor.log->dir.string(), std::strerror(errno));
+            failedCursors.push_back(cursor.log);
+        }
+    }
+
+    if (!failedRanges.empty() || !failedDirectories.empty() || !failedCursors.empty())
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const auto& range : failedRanges)
+        {
+            range.segment->MarkDirty(range.from, range.to);
+        }
+        for (auto* log : failedDirectories)
+        {
+            log->dirDirty = true;
+        }
+        for (auto* log : failedCursors)
+        {
+            log->cursorDirty = true;
+        }
+
+        // Consumed segments are deleted only once the cursor that skips them is on disk, retry with the next commit
+        if (!failedCursors.empty())
+        {
+            std::move(retired.begin(), retired.end(), std::back_inserter(m_retiredSegments));
+            retired.clear();
+        }
+    }
+
+    std::vector<fs::path> removedFrom;
+    for (auto& segment : retired)
+    {
+        const auto path = segment->path;
+        segment.reset();
+
+        std::error_code ec;
+        fs::remove(path, ec);
+        if (ec)
+        {
+            LogError("Error removing segment {}: {}.", path.string(), ec.message());
+            continue;
+        }
+
+        if (std::find(removedFrom.begin(), removedFrom.end(), path.parent_path()) == removedFrom.end())
+        {
+            removedFrom.push_back(path.parent_path());
+        }
+    }
+
+    for (const auto& dir : removedFrom)
+    {
+        SyncDirectory(dir);
+    }
+}
+
+void SegmentedLogStorage::SyncLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stopSync)
+    {
+        m_syncCv.wait_for(lock, m_syncInterval, [this]() { return m_stopSync; });
+
+        lock.unlock();
+        Sync();
+        lock.lock();
+    }
+}
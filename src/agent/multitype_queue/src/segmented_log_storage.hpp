@@ -0,0 +1,188 @@
+#pragma once
+
+#include <istorage.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/// @brief Append-only, segmented and memory-mapped storage.
+///
+/// Each table is kept in its own directory as a sequence of fixed-capacity segment files. Messages are appended
+/// at the tail of the newest segment and consumed from the head, whose sequence number is persisted as the
+/// commit cursor. Records removed from behind the head, when filtering by module, are flagged in place and
+/// consumed once the head reaches them. Segments that have been fully consumed are deleted as a whole, and writes
+/// are flushed to disk in groups by a background thread instead of once per message.
+class SegmentedLogStorage : public IStorage
+{
+public:
+    /// @brief Default capacity of each segment file in bytes
+    static constexpr size_t DEFAULT_SEGMENT_SIZE = 16 * 1024 * 1024;
+
+    /// @brief Default interval between group commits
+    static constexpr std::chrono::milliseconds DEFAULT_SYNC_INTERVAL {100};
+
+    /// @brief Constructor
+    /// @param dbFolderPath The path to the database folder
+    /// @param tableNames A vector of table names
+    /// @param segmentSize The capacity of each segment file in bytes
+    /// @param syncInterval The interval between group commits
+    SegmentedLogStorage(const std::string& dbFolderPath,
+                        const std::vector<std::string>& tableNames,
+                        size_t segmentSize = DEFAULT_SEGMENT_SIZE,
+                        std::chrono::milliseconds syncInterval = DEFAULT_SYNC_INTERVAL);
+
+    /// @brief Delete copy constructor
+    SegmentedLogStorage(const SegmentedLogStorage&) = delete;
+
+    /// @brief Delete copy assignment operator
+    SegmentedLogStorage& operator=(const SegmentedLogStorage&) = delete;
+
+    /// @brief Delete move constructor
+    SegmentedLogStorage(SegmentedLogStorage&&) = delete;
+
+    /// @brief Delete move assignment operator
+    SegmentedLogStorage& operator=(SegmentedLogStorage&&) = delete;
+
+    /// @brief Destructor. Flushes pending writes and unmaps every segment.
+    ~SegmentedLogStorage() override;
+
+    /// @copydoc IStorage::Clear
+    bool Clear(const std::vector<std::string>& tableNames) override;
+
+    /// @copydoc IStorage::Store
+    int Store(const nlohmann::json& message,
+              const std::string& tableName,
+              const std::string& moduleName = "",
+              const std::string& moduleType = "",
+              const std::string& metadata = "",
+              size_t* storedBytes = nullptr) override;
+
+    /// @copydoc IStorage::RemoveMultiple
+    int RemoveMultiple(int n,
+                       const std::string& tableName,
+                       const std::string& moduleName = "",
+                       const std::string& moduleType = "") override;
+
+    /// @copydoc IStorage::RetrieveMultiple
+    nlohmann::json RetrieveMultiple(int n,
+                                    const std::string& tableName,
+                                    const std::string& moduleName = "",
+                                    const std::string& moduleType = "") override;
+
+    /// @copydoc IStorage::RetrieveBySize
+    nlohmann::json RetrieveBySize(size_t n,
+                                  const std::string& tableName,
+                                  const std::string& moduleName = "",
+                                  const std::string& moduleType = "") override;
+
+    /// @copydoc IStorage::RetrieveRawBySize
+    int RetrieveRawBySize(size_t n,
+                          const std::string& tableName,
+                          const RawMessageCallback& onMessage,
+                          const std::string& moduleName = "",
+                          const std::string& moduleType = "",
+                          size_t skip = 0) override;
+
+    /// @copydoc IStorage::GetElementCount
+    int GetElementCount(const std::string& tableName,
+                        const std::string& moduleName = "",
+                        const std::string& moduleType = "") override;
+
+    /// @copydoc IStorage::GetElementsStoredSize
+    size_t GetElementsStoredSize(const std::string& tableName,
+                                 const std::string& moduleName = "",
+                                 const std::string& moduleType = "") override;
+
+    /// @brief Flushes every pending write and cursor update to disk.
+    void Sync();
+
+private:
+    struct Segment;
+    struct Log;
+
+    /// @brief View over the fields of a stored record
+    struct RecordView
+    {
+        std::string_view moduleName;
+        std::string_view moduleType;
+        std::string_view metadata;
+        std::string_view message;
+    };
+
+    /// @brief Opens the log of a table, recovering its segments and commit cursor.
+    /// @param tableName The name of the table.
+    void OpenLog(const std::string& tableName);
+
+    /// @brief Appends a single record at the tail of the log.
+    /// @param log The log to append to.
+    /// @param record The record to append.
+    void Append(Log& log, const RecordView& record);
+
+    /// @brief Visits the records of a log from its head, including the removed ones.
+    /// @param log The log to visit.
+    /// @param visitor Callback invoked with the segment, offset, size and fields of every record. Returning false
+    /// stops the walk.
+    void ForEachPosition(const Log& log,
+                         const std::function<bool(Segment&, size_t, size_t, const RecordView&)>& visitor) const;
+
+    /// @brief Visits the records of a log from its head, skipping the removed ones.
+    /// @param log The log to visit.
+    /// @param visitor Callback invoked for every record. Returning false stops the walk.
+    void ForEach(const Log& log, const std::function<bool(const RecordView&)>& visitor) const;
+
+    /// @brief Moves the commit cursor of a log past its head record, retiring the segment when consumed.
+    /// @param log The log to advance.
+    /// @param recordSize The size of the head record.
+    void AdvanceHead(Log& log, size_t recordSize);
+
+    /// @brief Moves the commit cursor of a log past the removed records found at its head.
+    /// @param log The log to advance.
+    void SkipRemovedHead(Log& log);
+
+    /// @brief Gets the log of a table.
+    /// @param tableName The name of the table.
+    /// @return Pointer to the log, or nullptr if the table is unknown.
+    Log* GetLog(const std::string& tableName);
+
+    /// @brief Group commit loop run by the sync thread.
+    void SyncLoop();
+
+    /// @brief Segment capacity
+    const size_t m_segmentSize;
+
+    /// @brief Interval between group commits
+    const std::chrono::milliseconds m_syncInterval;
+
+    /// @brief Logs by table name
+    std::map<std::string, std::unique_ptr<Log>> m_logs;
+
+    /// @brief Consumed segments waiting to be unmapped and deleted by the next group commit
+    std::vector<std::unique_ptr<Segment>> m_retiredSegments;
+
+    /// @brief Mutex to ensure thread-safe operations.
+    std::mutex m_mutex;
+
+    /// @brief Serializes group commits
+    std::mutex m_syncMutex;
+
+    /// @brief Condition variable used to wake up the sync thread
+    std::condition_variable m_syncCv;
+
+    /// @brief Flag to stop the sync thread
+    bool m_stopSync = false;
+
+    /// @brief Group commit thread
+    std::thread m_syncThread;
+};
@@ -6,6 +6,9 @@
 #include <persistence.hpp>
 #include <persistence_factory.hpp>
 
+#include <functional>
+#include <vector>
+
 using namespace column;
 
 namespace
@@ -19,54 +22,168 @@ namespace
     const std::string MODULE_TYPE_COLUMN_NAME = "module_type";
     const std::string METADATA_COLUMN_NAME = "metadata";
     const std::string MESSAGE_COLUMN_NAME = "message";
+    const std::string SIZE_COLUMN_NAME = "size";
 
-    nlohmann::json ProcessRequest(const std::vector<Row>& rows, size_t maxSize = 0)
+    Names MessageColumns()
     {
-        nlohmann::json messages = nlohmann::json::array();
-        size_t sizeAccum = 0;
+        Names columns;
+        columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
+        columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
+        columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
+        columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
+        columns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+        columns.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER);
+        return columns;
+    }
+
+    /// @brief Columns of the messages a table's stored size is accounted by.
+    Names SizeColumns()
+    {
+        Names columns;
+        columns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+        columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
+        columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
+        columns.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER);
+        return columns;
+    }
+
+    /// @brief Size recorded in a row selected with SizeColumns.
+    size_t RecordedSize(const Row& row)
+    {
+        return row[3].Value.empty() ? 0 : std::stoull(row[3].Value);
+    }
+
+    Criteria ModuleFilters(const std::string& moduleName, const std::string& moduleType)
+    {
+        Criteria filters;
+        if (!moduleName.empty())
+            filters.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
+        if (!moduleType.empty())
+            filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
+        return filters;
+    }
 
-        for (const auto& row : rows)
+    /// @brief Module filters plus the acknowledgement cursor, so selections seek past removed rows.
+    Criteria CursorFilters(const std::string& moduleName, const std::string& moduleType, long long acknowledged)
+    {
+        Criteria filters = ModuleFilters(moduleName, moduleType);
+        if (acknowledged > 0)
+            filters.emplace_back(ROW_ID_COLUMN_NAME,
+                                 ColumnType::INTEGER,
+                                 std::to_string(acknowledged),
+                                 ComparisonOperator::GREATER_THAN);
+        return filters;
+    }
+
+    /// @brief Size of a stored message, as accounted for by RetrieveBySize.
+    size_t MessageSize(const Row& row)
+    {
+        // Rows stored before the size column existed have no value for it
+        if (row[5].Value.empty())
         {
-            const std::string moduleNameString = row[0].Value;
-            const std::string moduleTypeString = row[1].Value;
-            const std::string metadataString = row[2].Value;
-            const std::string dataString = row[3].Value;
+            return row[0].Value.size() + row[1].Value.size() + row[2].Value.size() + row[3].Value.size();
+        }
+        return std::stoull(row[5].Value);
+    }
 
-            nlohmann::json outputJson = {{"moduleName", ""}, {"moduleType", ""}, {"metadata", ""}, {"data", {}}};
+    nlohmann::json MessageFromRow(const Row& row)
+    {
+        const std::string& moduleNameString = row[0].Value;
+        const std::string& moduleTypeString = row[1].Value;
+        const std::string& metadataString = row[2].Value;
+        const std::string& dataString = row[3].Value;
 
-            if (!dataString.empty())
-            {
-                outputJson["data"] = nlohmann::json::parse(dataString);
-            }
+        nlohmann::json outputJson = {{"moduleName", ""}, {"moduleType", ""}, {"metadata", ""}, {"data", {}}};
 
-            if (!metadataString.empty())
-            {
-                outputJson["metadata"] = metadataString;
-            }
+        if (!dataString.empty())
+        {
+            outputJson["data"] = nlohmann::json::parse(dataString);
+        }
 
-            if (!moduleNameString.empty())
-            {
-                outputJson["moduleName"] = moduleNameString;
-            }
+        if (!metadataString.empty())
+        {
+            outputJson["metadata"] = metadataString;
+        }
 
-            if (!moduleTypeString.empty())
-            {
-                outputJson["moduleType"] = moduleTypeString;
-            }
+        if (!moduleNameString.empty())
+        {
+            outputJson["moduleName"] = moduleNameString;
+        }
+
+        if (!moduleTypeString.empty())
+        {
+            outputJson["moduleType"] = moduleTypeString;
+        }
+
+        return outputJson;
+    }
+
+    /// @brief Steps through the oldest rows of a table, stopping after n messages or once maxSize bytes are reached,
+    /// so no more rows than needed are read from the database.
+    /// @param skip Number of leading rows to step over without handing them to onRow.
+    /// @return The number of rows visited, not counting the skipped ones.
+    int SelectRows(Persistence& db,
+                   const std::string& tableName,
+                   const Criteria& filters,
+                   int n,
+                   size_t maxSize,
+                   long long& lastRowId,
+                   const std::function<void(const Row&)>& onRow,
+                   size_t skip = 0)
+    {
+        Names orderColumns;
+        orderColumns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
 
-            messages.push_back(outputJson);
-            if (maxSize)
+        int count = 0;
+        size_t sizeAccum = 0;
+        size_t skipped = 0;
+
+        db.SelectEach(
+            tableName,
+            MessageColumns(),
+            [&](const Row& row)
             {
-                const size_t messageSize = moduleNameString.size() + moduleTypeString.size() + metadataString.size() +
-                                           outputJson["data"].dump().size();
-                if (sizeAccum + messageSize >= maxSize)
+                if (skipped < skip)
                 {
-                    break;
+                    skipped++;
+                    return true;
                 }
-                sizeAccum += messageSize;
-            }
-        }
 
+                onRow(row);
+                lastRowId = std::stoll(row[4].Value);
+                count++;
+
+                if (maxSize)
+                {
+                    const size_t messageSize = MessageSize(row);
+                    if (sizeAccum + messageSize >= maxSize)
+                    {
+                        return false;
+                    }
+                    sizeAccum += messageSize;
+                }
+                return true;
+            },
+            filters,
+            LogicalOperator::AND,
+            orderColumns,
+            OrderType::ASC,
+            n > 0 ? n + static_cast<int>(skip) : n);
+
+        return count;
+    }
+
+    nlohmann::json SelectMessages(Persistence& db,
+                                  const std::string& tableName,
+                                  const Criteria& filters,
+                                  int n,
+                                  size_t maxSize,
+                                  long long& lastRowId)
+    {
+        nlohmann::json messages = nlohmann::json::array();
+        SelectRows(
+            db, tableName, filters, n, maxSize, lastRowId, [&messages](const Row& row)
+            { messages.push_back(MessageFromRow(row)); });
         return messages;
     }
 } // namespace
@@ -94,6 +211,11 @@ Storage::Storage(const std::string& dbFolderPath,
             {
                 CreateTable(table);
             }
+            else
+            {
+                m_db->AddColumn(table, ColumnKey(SIZE_COLUMN_NAME, ColumnType::INTEGER));
+                LoadStoredSize(table);
+            }
         }
     }
     catch (const std::exception&)
@@ -113,6 +235,7 @@ void Storage::CreateTable(const std::string& tableName)
         columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
         columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
         columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, NOT_NULL);
+        columns.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER);
 
         m_db->CreateTable(tableName, columns);
     }
@@ -123,13 +246,71 @@ void Storage::CreateTable(const std::string& tableName)
     }
 }
 
+void Storage::LoadStoredSize(const std::string& tableName)
+{
+    try
+    {
+        StoredSize storedSize;
+        std::vector<long long> unsizedRows;
+
+        m_db->SelectEach(tableName,
+                         SizeColumns(),
+                         [&storedSize, &unsizedRows](const Row& row)
+                         {
+                             if (row[3].Value.empty())
+                             {
+                                 unsizedRows.push_back(std::stoll(row[0].Value));
+                             }
+                             else
+                             {
+                                 storedSize.Add(row[1].Value, row[2].Value, RecordedSize(row));
+                             }
+                             return true;
+                         });
+
+        if (!unsizedRows.empty())
+        {
+            LogInfo("Recording the size of {} messages in {}.", unsizedRows.size(), tableName);
+
+            auto transaction = m_db->BeginTransaction();
+
+            for (const auto rowId : unsizedRows)
+            {
+                const Criteria byRowId {ColumnValue(ROW_ID_COLUMN_NAME, ColumnType::INTEGER, std::to_string(rowId))};
+                const auto rows = m_db->Select(tableName, MessageColumns(), byRowId);
+                if (rows.empty())
+                {
+                    continue;
+                }
+
+                const auto size = MessageSize(rows.front());
+                m_db->Update(
+                    tableName, {ColumnValue(SIZE_COLUMN_NAME, ColumnType::INTEGER, std::to_string(size))}, byRowId);
+                storedSize.Add(rows.front()[0].Value, rows.front()[1].Value, size);
+            }
+
+            m_db->CommitTransaction(transaction);
+        }
+
+        m_sizes[tableName] = std::move(storedSize);
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error computing the size of {}: {}.", tableName, e.what());
+    }
+}
+
 bool Storage::Clear(const std::vector<std::string>& tableNames)
 {
+    const std::unique_lock<std::mutex> lock(m_mutex);
+
     try
     {
         for (const auto& table : tableNames)
         {
             m_db->Remove(table, {});
+            m_cursors.erase(table);
+            m_sizes.erase(table);
         }
     }
     catch (const std::exception& e)
@@ -144,14 +325,18 @@ int Storage::Store(const nlohmann::json& message,
                    const std::string& tableName,
                    const std::string& moduleName,
                    const std::string& moduleType,
-                   const std::string& metadata)
+                   const std::string& metadata,
+                   size_t* storedBytes)
 {
     Row fields;
     fields.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
     fields.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
     fields.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT, metadata);
 
+    const size_t headerSize = moduleName.size() + moduleType.size() + metadata.size();
+
     int result = 0;
+    size_t bytes = 0;
 
     const std::unique_lock<std::mutex> lock(m_mutex);
 
@@ -161,11 +346,15 @@ int Storage::Store(const nlohmann::json& message,
     {
         for (const auto& singleMessageData : message)
         {
-            fields.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, singleMessageData.dump());
+            auto data = singleMessageData.dump();
+            const auto size = headerSize + data.size();
+            fields.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, std::move(data));
+            fields.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER, std::to_string(size));
 
             try
             {
                 m_db->Insert(tableName, fields);
+                bytes += size;
                 result++;
             }
             catch (const std::exception& e)
@@ -173,15 +362,20 @@ int Storage::Store(const nlohmann::json& message,
                 LogError("Error during Store operation: {}.", e.what());
             }
             fields.pop_back();
+            fields.pop_back();
         }
     }
     else
     {
-        fields.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, message.dump());
+        auto data = message.dump();
+        const auto size = headerSize + data.size();
+        fields.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT, std::move(data));
+        fields.emplace_back(SIZE_COLUMN_NAME, ColumnType::INTEGER, std::to_string(size));
 
         try
         {
             m_db->Insert(tableName, fields);
+            bytes += size;
             result++;
         }
         catch (const std::exception& e)
@@ -192,6 +386,16 @@ int Storage::Store(const nlohmann::json& message,
 
     m_db->CommitTransaction(transaction);
 
+    if (result > 0)
+    {
+        m_sizes[tableName].Add(moduleName, moduleType, bytes);
+    }
+
+    if (storedBytes != nullptr)
+    {
+        *storedBytes = bytes;
+    }
+
     return result;
 }
 
@@ -200,52 +404,111 @@ int Storage::RemoveMultiple(int n,
                             const std::string& moduleName,
                             const std::string& moduleType)
 {
-    Criteria filters;
-    if (!moduleName.empty())
-        filters.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
-    if (!moduleType.empty())
-        filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
+    Criteria filters = ModuleFilters(moduleName, moduleType);
 
     int result = 0;
 
     const std::unique_lock<std::mutex> lock(m_mutex);
 
+    auto& cursor = m_cursors[tableName];
+
     auto transaction = m_db->BeginTransaction();
 
     try
     {
-        Names columns;
-        columns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
-
-        // Select first n messages
-        const auto results =
-            m_db->Select(tableName, columns, filters, LogicalOperator::AND, columns, OrderType::ASC, n);
+        long long upperBound = 0;
+        StoredSize removed;
 
-        if (!results.empty())
+        if (const auto boundary = cursor.delivered.find(static_cast<size_t>(n));
+            filters.empty() && n > 0 && boundary != cursor.delivered.end())
         {
-            filters.clear();
+            // Acknowledging delivered batches, whose bounds are already known
+            upperBound = boundary->second;
+            result = n;
+
+            auto range = CursorFilters(moduleName, moduleType, cursor.acknowledged);
+            range.emplace_back(
+                ROW_ID_COLUMN_NAME, ColumnType::INTEGER, std::to_string(upperBound), ComparisonOperator::LESS_EQUAL);
+
+            m_db->SelectEach(tableName,
+                             SizeColumns(),
+                             [&removed](const Row& row)
+                             {
+                                 removed.Add(row[1].Value, row[2].Value, RecordedSize(row));
+                                 return true;
+                             },
+                             range);
+        }
+        else
+        {
+            Names orderColumns;
+            orderColumns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+
+            // Select first n messages
+            const auto results = m_db->Select(tableName,
+                                              SizeColumns(),
+                                              CursorFilters(moduleName, moduleType, cursor.acknowledged),
+                                              LogicalOperator::AND,
+                                              orderColumns,
+                                              OrderType::ASC,
+                                              n);
+
+            if (!results.empty())
+            {
+                upperBound = std::stoll(results.back()[0].Value);
+                result = static_cast<int>(results.size());
+            }
 
             for (const auto& row : results)
             {
-                filters.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER, row[0].Value);
+                removed.Add(row[1].Value, row[2].Value, RecordedSize(row));
+            }
+        }
 
-                try
-                {
-                    // Remove selected message
-                    m_db->Remove(tableName, filters, LogicalOperator::AND);
-                    result++;
-                }
-                catch (const std::exception& e)
+        if (result > 0)
+        {
+            // Remove the whole range with a single statement
+            filters.emplace_back(
+                ROW_ID_COLUMN_NAME, ColumnType::INTEGER, std::to_string(upperBound), ComparisonOperator::LESS_EQUAL);
+            m_db->Remove(tableName, filters, LogicalOperator::AND);
+            m_sizes[tableName].Subtract(removed);
+
+            if (moduleName.empty() && moduleType.empty())
+            {
+                cursor.acknowledged = upperBound;
+
+                // The batches delivered past the removed messages are now that much closer to the head
+                std::map<size_t, long long> delivered;
+                for (const auto& [position, rowId] : cursor.delivered)
                 {
-                    LogError("Error during Remove operation: {}.", e.what());
+                    if (position > static_cast<size_t>(result))
+                    {
+                        delivered.emplace(position - static_cast<size_t>(result), rowId);
+                    }
                 }
-                filters.pop_back();
+                cursor.delivered = std::move(delivered);
+            }
+            else
+            {
+                cursor.delivered.clear();
+            }
+
+            // SQLite reuses rowids once a table is emptied, so the cursor must start over
+            Names columns;
+            columns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+            if (m_db->Select(tableName, columns, {}, LogicalOperator::AND, {}, OrderType::ASC, 1).empty())
+            {
+                cursor.acknowledged = 0;
+                cursor.delivered.clear();
+                m_sizes.erase(tableName);
             }
         }
     }
     catch (const std::exception& e)
     {
         LogError("Error during RemoveMultiple operation: {}.", e.what());
+        cursor.delivered.clear();
+        result = 0;
     }
 
     m_db->CommitTransaction(transaction);
@@ -258,27 +521,22 @@ nlohmann::json Storage::RetrieveMultiple(int n,
                                          const std::string& moduleName,
                                          const std::string& moduleType)
 {
-    Names columns;
-    columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
-
-    Criteria filters;
-    if (!moduleName.empty())
-        filters.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
-    if (!moduleType.empty())
-        filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
+    const std::unique_lock<std::mutex> lock(m_mutex);
 
-    Names orderColumns;
-    orderColumns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+    auto& cursor = m_cursors[tableName];
 
     try
     {
-        const auto results =
-            m_db->Select(tableName, columns, filters, LogicalOperator::AND, orderColumns, OrderType::ASC, n);
+        long long lastRowId = 0;
+        auto messages = SelectMessages(
+            *m_db, tableName, CursorFilters(moduleName, moduleType, cursor.acknowledged), n, 0, lastRowId);
+
+        if (moduleName.empty() && moduleType.empty())
+        {
+            cursor.Deliver(0, messages.size(), lastRowId);
+        }
 
-        return ProcessRequest(results);
+        return messages;
     }
     catch (const std::exception& e)
     {
@@ -292,27 +550,22 @@ nlohmann::json Storage::RetrieveBySize(size_t n,
                                        const std::string& moduleName,
                                        const std::string& moduleType)
 {
-    Names columns;
-    columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
-    columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
-
-    Criteria filters;
-    if (!moduleName.empty())
-        filters.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
-    if (!moduleType.empty())
-        filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
+    const std::unique_lock<std::mutex> lock(m_mutex);
 
-    Names orderColumns;
-    orderColumns.emplace_back(ROW_ID_COLUMN_NAME, ColumnType::INTEGER);
+    auto& cursor = m_cursors[tableName];
 
     try
     {
-        const auto results =
-            m_db->Select(tableName, columns, filters, LogicalOperator::AND, orderColumns, OrderType::ASC);
+        long long lastRowId = 0;
+        auto messages = SelectMessages(
+            *m_db, tableName, CursorFilters(moduleName, moduleType, cursor.acknowledged), 0, n, lastRowId);
+
+        if (moduleName.empty() && moduleType.empty())
+        {
+            cursor.Deliver(0, messages.size(), lastRowId);
+        }
 
-        return ProcessRequest(results, n);
+        return messages;
     }
     catch (const std::exception& e)
     {
@@ -321,31 +574,57 @@ nlohmann::json Storage::RetrieveBySize(size_t n,
     }
 }
 
-int Storage::GetElementCount(const std::string& tableName, const std::string& moduleName, const std::string& moduleType)
+int Storage::RetrieveRawBySize(size_t n,
+                               const std::string& tableName,
+                               const RawMessageCallback& onMessage,
+                               const std::string& moduleName,
+                               const std::string& moduleType,
+                               size_t skip)
 {
-    Criteria filters;
-    if (!moduleName.empty())
-        filters.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT, moduleName);
-    if (!moduleType.empty())
-        filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
+    const std::unique_lock<std::mutex> lock(m_mutex);
 
-    int count = 0;
+    auto& cursor = m_cursors[tableName];
 
     try
     {
-        count = m_db->GetCount(tableName, filters, LogicalOperator::AND);
+        const bool unfiltered = moduleName.empty() && moduleType.empty();
+
+        // Seek past the skipped messages if they were delivered as whole batches, otherwise step over them
+        auto seekRowId = cursor.acknowledged;
+        auto skipRows = skip;
+        if (const auto boundary = cursor.delivered.find(skip);
+            unfiltered && skip > 0 && boundary != cursor.delivered.end())
+        {
+            seekRowId = boundary->second;
+            skipRows = 0;
+        }
+
+        long long lastRowId = 0;
+        const auto count = SelectRows(
+            *m_db,
+            tableName,
+            CursorFilters(moduleName, moduleType, seekRowId),
+            0,
+            n,
+            lastRowId,
+            [&onMessage](const Row& row) { onMessage(row[2].Value, row[3].Value); },
+            skipRows);
+
+        if (unfiltered)
+        {
+            cursor.Deliver(skip, static_cast<size_t>(count), lastRowId);
+        }
+
+        return count;
     }
     catch (const std::exception& e)
     {
-        LogError("Error during GetElementCount operation: {}.", e.what());
+        LogError("Error during RetrieveRawBySize operation: {}.", e.what());
+        return 0;
     }
-
-    return count;
 }
 
-size_t Storage::GetElementsStoredSize(const std::string& tableName,
-                                      const std::string& moduleName,
-                                      const std::string& moduleType)
+int Storage::GetElementCount(const std::string& tableName, const std::string& moduleName, const std::string& moduleType)
 {
     Criteria filters;
     if (!moduleName.empty())
@@ -353,22 +632,26 @@ size_t Storage::GetElementsStoredSize(const std::string& tableName,
     if (!moduleType.empty())
         filters.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT, moduleType);
 
-    size_t count = 0;
+    int count = 0;
 
     try
     {
-        Names columns;
-        columns.emplace_back(MODULE_NAME_COLUMN_NAME, ColumnType::TEXT);
-        columns.emplace_back(MODULE_TYPE_COLUMN_NAME, ColumnType::TEXT);
-        columns.emplace_back(METADATA_COLUMN_NAME, ColumnType::TEXT);
-        columns.emplace_back(MESSAGE_COLUMN_NAME, ColumnType::TEXT);
-
-        count = m_db->GetSize(tableName, columns, filters, LogicalOperator::AND);
+        count = m_db->GetCount(tableName, filters, LogicalOperator::AND);
     }
     catch (const std::exception& e)
     {
-        LogError("Error during GetElementsStoredSize operation: {}.", e.what());
+        LogError("Error during GetElementCount operation: {}.", e.what());
     }
 
     return count;
 }
+
+size_t Storage::GetElementsStoredSize(const std::string& tableName,
+                                      const std::string& moduleName,
+                                      const std::string& moduleType)
+{
+    const std::unique_lock<std::mutex> lock(m_mutex);
+
+    const auto it = m_sizes.find(tableName);
+    return it != m_sizes.end() ? it->second.Get(moduleName, moduleType) : 0;
+}
@@ -5,9 +5,12 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 
 /// @brief Storage class.
 ///
@@ -50,12 +53,14 @@ public:
     /// @param moduleName The name of the module that created the message.
     /// @param moduleType The type of the module that created the message.
     /// @param metadata The metadata message to store.
+    /// @param storedBytes If not null, receives the bytes occupied by the stored elements.
     /// @return The number of stored elements.
     int Store(const nlohmann::json& message,
               const std::string& tableName,
               const std::string& moduleName = "",
               const std::string& moduleType = "",
-              const std::string& metadata = "") override;
+              const std::string& metadata = "",
+              size_t* storedBytes = nullptr) override;
 
     /// @brief Remove multiple JSON messages.
     /// @param n The number of messages to remove.
@@ -90,6 +95,21 @@ public:
                                   const std::string& moduleName = "",
                                   const std::string& moduleType = "") override;
 
+    /// @brief Retrieve messages based on size from the specified queue, without parsing them.
+    /// @param n size occupied by the messages to be retrieved.
+    /// @param tableName The name of the table to retrieve the message from.
+    /// @param onMessage Callback invoked with the stored metadata and data of each message, in order.
+    /// @param moduleName The name of the module.
+    /// @param moduleType The type of the module.
+    /// @param skip The number of messages at the head of the queue to leave out.
+    /// @return The number of retrieved messages.
+    int RetrieveRawBySize(size_t n,
+                          const std::string& tableName,
+                          const RawMessageCallback& onMessage,
+                          const std::string& moduleName = "",
+                          const std::string& moduleType = "",
+                          size_t skip = 0) override;
+
     /// @brief Get the number of elements in the table.
     /// @param tableName The name of the table to retrieve the message from.
     /// @param moduleName The name of the module that created the message.
@@ -100,6 +120,7 @@ public:
                         const std::string& moduleType = "") override;
 
     /// @brief Get the bytes occupied by elements stored in the specified queue.
+    /// @details The sizes are kept up to date on every store and removal, so this doesn't read the table.
     /// @param tableName  The name of the table.
     /// @param moduleName The name of the module.
     /// @param moduleType The type of the module.
@@ -109,13 +130,110 @@ public:
                                  const std::string& moduleType = "") override;
 
 private:
+    /// @brief Delivery and acknowledgement cursors of a table.
+    struct QueueCursor
+    {
+        /// @brief Every row with a rowid lower than or equal to this one has been removed.
+        long long acknowledged = 0;
+
+        /// @brief Rowid of the last message of each batch handed out by unfiltered retrievals, keyed by the number of
+        /// messages from the head of the table up to and including it.
+        std::map<size_t, long long> delivered;
+
+        /// @brief Records a batch handed out by an unfiltered retrieval.
+        /// @param skip Number of messages before the batch.
+        /// @param count Number of messages in the batch.
+        /// @param lastRowId Rowid of the last message of the batch.
+        void Deliver(size_t skip, size_t count, long long lastRowId)
+        {
+            // Later batches were cut from a different view of the table, they are recorded again once handed out
+            delivered.erase(delivered.upper_bound(skip), delivered.end());
+            if (count > 0)
+            {
+                delivered[skip + count] = lastRowId;
+            }
+        }
+    };
+
+    /// @brief Bytes occupied by the messages of a table, in total and per module.
+    struct StoredSize
+    {
+        /// @brief Bytes of all the messages.
+        size_t total = 0;
+
+        /// @brief Bytes of the messages of each module name and type.
+        std::map<std::pair<std::string, std::string>, size_t> modules;
+
+        /// @brief Accounts for a message.
+        /// @param moduleName The name of the module that created the message.
+        /// @param moduleType The type of the module that created the message.
+        /// @param size The size of the message.
+        void Add(const std::string& moduleName, const std::string& moduleType, size_t size)
+        {
+            total += size;
+            modules[{moduleName, moduleType}] += size;
+        }
+
+        /// @brief Discounts the messages accounted for by another size.
+        /// @param removed The size of the removed messages.
+        void Subtract(const StoredSize& removed)
+        {
+            total -= std::min(total, removed.total);
+            for (const auto& [module, size] : removed.modules)
+            {
+                if (const auto it = modules.find(module); it != modules.end())
+                {
+                    it->second -= std::min(it->second, size);
+                    if (it->second == 0)
+                    {
+                        modules.erase(it);
+                    }
+                }
+            }
+        }
+
+        /// @brief Gets the bytes of the messages of a module.
+        /// @param moduleName The name of the module, or empty for any.
+        /// @param moduleType The type of the module, or empty for any.
+        /// @return The bytes of the matching messages.
+        size_t Get(const std::string& moduleName, const std::string& moduleType) const
+        {
+            if (moduleName.empty() && moduleType.empty())
+            {
+                return total;
+            }
+
+            size_t size = 0;
+            for (const auto& [module, moduleSize] : modules)
+            {
+                if ((moduleName.empty() || module.first == moduleName) &&
+                    (moduleType.empty() || module.second == moduleType))
+                {
+                    size += moduleSize;
+                }
+            }
+            return size;
+        }
+    };
+
     /// @brief Create a table in the database.
     /// @param tableName The name of the table to create.
     void CreateTable(const std::string& tableName);
 
+    /// @brief Computes the size of the messages of a table, when opening it. Messages stored before their size was
+    /// recorded get it filled in, so that removals only need to read the size column.
+    /// @param tableName The name of the table.
+    void LoadStoredSize(const std::string& tableName);
+
     /// @brief Pointer to the database connection.
     std::unique_ptr<Persistence> m_db;
 
+    /// @brief Cursors per table.
+    std::map<std::string, QueueCursor> m_cursors;
+
+    /// @brief Size of the stored messages per table.
+    std::map<std::string, StoredSize> m_sizes;
+
     /// @brief Mutex to ensure thread-safe operations.
     std::mutex m_mutex;
 };
@@ -25,6 +25,15 @@ public:
         getNextBytesAwaitable,
         (MessageType type, const size_t messageQuantity, const std::string moduleName, const std::string moduleType),
         (override));
+    MOCK_METHOD(boost::asio::awaitable<int>,
+                getNextBytesRawAwaitable,
+                (MessageType type,
+                 const size_t messageQuantity,
+                 RawMessageCallback onMessage,
+                 const std::string moduleName,
+                 const std::string moduleType,
+                 const size_t skip),
+                (override));
     MOCK_METHOD(
         std::vector<Message>,
         getNextBytes,
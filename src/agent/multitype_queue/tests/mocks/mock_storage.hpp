@@ -20,7 +20,8 @@ public:
                  const std::string& tableName,
                  const std::string& moduleName,
                  const std::string& moduleType,
-                 const std::string& metadata),
+                 const std::string& metadata,
+                 size_t* storedBytes),
                 (override));
 
     MOCK_METHOD(int,
@@ -38,6 +39,16 @@ public:
                 (size_t n, const std::string& tableName, const std::string& moduleName, const std::string& moduleType),
                 (override));
 
+    MOCK_METHOD(int,
+                RetrieveRawBySize,
+                (size_t n,
+                 const std::string& tableName,
+                 const RawMessageCallback& onMessage,
+                 const std::string& moduleName,
+                 const std::string& moduleType,
+                 size_t skip),
+                (override));
+
     MOCK_METHOD(int,
                 GetElementCount,
                 (const std::string& tableName, const std::string& moduleName, const std::string& moduleType),
@@ -71,6 +71,16 @@ void MultiTypeQueueTest::SetUp()
 
 void MultiTypeQueueTest::TearDown() {};
 
+void MultiTypeQueueTest::SeedCounters(int storedItems, size_t storedSize)
+{
+    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, "", ""))
+        .Times(3)
+        .WillRepeatedly(testing::Return(storedItems));
+    EXPECT_CALL(*m_mockStorage, GetElementsStoredSize(testing::_, "", ""))
+        .Times(testing::AtLeast(3))
+        .WillRepeatedly(testing::Return(storedSize));
+}
+
 /// TESTS
 
 // JSON Basic methods. Move or delete if JSON Wrapper is done
@@ -149,26 +159,25 @@ TEST_F(MultiTypeQueueTest, PushGetNotQueue)
 
 TEST_F(MultiTypeQueueTest, PushNotSpaceAvailable)
 {
+    SeedCounters(DEFAULT_QUEUE_SIZE);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     const Message messageToSend {messageType, BASE_DATA_CONTENT};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(DEFAULT_QUEUE_SIZE));
-
     EXPECT_EQ(multiTypeQueue.push(messageToSend), 0);
 }
 
 TEST_F(MultiTypeQueueTest, PushStoreMessage)
 {
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     const nlohmann::json sigleData = R"({"data": "for STATELESS_0"})";
     const Message messageToSend {messageType, sigleData};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_)).WillOnce(testing::Return(0));
-
-    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(1));
 
     EXPECT_EQ(multiTypeQueue.push(messageToSend), 1);
@@ -176,6 +185,8 @@ TEST_F(MultiTypeQueueTest, PushStoreMessage)
 
 TEST_F(MultiTypeQueueTest, PushStoreArray)
 {
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     nlohmann::json arrayData = nlohmann::json::array();
@@ -184,17 +195,16 @@ TEST_F(MultiTypeQueueTest, PushStoreArray)
 
     const Message messageToSend {messageType, arrayData};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_)).WillOnce(testing::Return(0));
-
-    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
-        .Times(2)
-        .WillRepeatedly(testing::Return(1));
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Return(2));
 
     EXPECT_EQ(multiTypeQueue.push(messageToSend), 2);
 }
 
 TEST_F(MultiTypeQueueTest, PushStoreArrayFailFirst)
 {
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     nlohmann::json arrayData = nlohmann::json::array();
@@ -203,19 +213,16 @@ TEST_F(MultiTypeQueueTest, PushStoreArrayFailFirst)
 
     const Message messageToSend {messageType, arrayData};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_)).WillOnce(testing::Return(0));
-
-    const testing::Sequence seq;
-    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
-        .InSequence(seq)
-        .WillOnce(testing::Return(0))
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(1));
 
     EXPECT_EQ(multiTypeQueue.push(messageToSend), 1);
 }
 
-TEST_F(MultiTypeQueueTest, PushStoreArrayNotSpaceAvailable)
+TEST_F(MultiTypeQueueTest, PushCountsBytesReportedByStore)
 {
+    SeedCounters(0, 10);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     nlohmann::json arrayData = nlohmann::json::array();
@@ -224,8 +231,24 @@ TEST_F(MultiTypeQueueTest, PushStoreArrayNotSpaceAvailable)
 
     const Message messageToSend {messageType, arrayData};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(DEFAULT_QUEUE_SIZE - 1));
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::NotNull()))
+        .WillOnce(testing::DoAll(testing::SetArgPointee<5>(42), testing::Return(2)));
+
+    EXPECT_EQ(multiTypeQueue.push(messageToSend), 2);
+    EXPECT_EQ(multiTypeQueue.sizePerType(messageType), 52);
+}
+
+TEST_F(MultiTypeQueueTest, PushStoreArrayNotSpaceAvailable)
+{
+    SeedCounters(DEFAULT_QUEUE_SIZE - 1);
+
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+    const MessageType messageType {MessageType::STATELESS};
+    nlohmann::json arrayData = nlohmann::json::array();
+    arrayData.push_back({{"data1", "for STATELESS_0"}});
+    arrayData.push_back({{"data2", "for STATELESS_0"}});
+
+    const Message messageToSend {messageType, arrayData};
 
     EXPECT_EQ(multiTypeQueue.push(messageToSend), 0);
 }
@@ -253,22 +276,26 @@ TEST_F(MultiTypeQueueTest, PushAwaitableNotQueue)
     ioContext.run();
 }
 
-TEST_F(MultiTypeQueueTest, PushAwaitableNotSpaceAvailable)
+TEST_F(MultiTypeQueueTest, PushAwaitableWaitsForPop)
 {
     boost::asio::io_context ioContext;
+    SeedCounters(DEFAULT_QUEUE_SIZE);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
 
     const MessageType messageType {MessageType::STATELESS};
     const Message messageToSend {messageType, BASE_DATA_CONTENT};
 
     const testing::Sequence seq;
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
+    EXPECT_CALL(*m_mockStorage, RemoveMultiple(1, testing::_, testing::_, testing::_))
         .InSequence(seq)
-        .WillOnce(testing::Return(DEFAULT_QUEUE_SIZE - 1))
-        .WillOnce(testing::Return(DEFAULT_QUEUE_SIZE));
+        .WillOnce(testing::Return(1));
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .InSequence(seq)
+        .WillOnce(testing::Return(1));
 
     testing::MockFunction<void(int)> checkResult;
-    EXPECT_CALL(checkResult, Call(0));
+    EXPECT_CALL(checkResult, Call(1));
 
     boost::asio::co_spawn(
         ioContext,
@@ -279,22 +306,24 @@ TEST_F(MultiTypeQueueTest, PushAwaitableNotSpaceAvailable)
         },
         boost::asio::detached);
 
+    boost::asio::post(ioContext, [&multiTypeQueue, messageType] { EXPECT_TRUE(multiTypeQueue.pop(messageType)); });
+
     ioContext.run();
+
+    EXPECT_EQ(multiTypeQueue.storedItems(messageType), DEFAULT_QUEUE_SIZE);
 }
 
 TEST_F(MultiTypeQueueTest, PushAwaitableStoreMessage)
 {
     boost::asio::io_context ioContext;
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     const nlohmann::json sigleData = R"({"data": "for STATELESS_0"})";
     const Message messageToSend {messageType, sigleData};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
-        .Times(2)
-        .WillRepeatedly(testing::Return(0));
-
-    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(1));
 
     testing::MockFunction<void(int)> checkResult;
@@ -315,6 +344,8 @@ TEST_F(MultiTypeQueueTest, PushAwaitableStoreMessage)
 TEST_F(MultiTypeQueueTest, PushAwaitableStoreArray)
 {
     boost::asio::io_context ioContext;
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     nlohmann::json arrayData = nlohmann::json::array();
@@ -323,13 +354,8 @@ TEST_F(MultiTypeQueueTest, PushAwaitableStoreArray)
 
     const Message messageToSend {messageType, arrayData};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
-        .Times(2)
-        .WillRepeatedly(testing::Return(0));
-
-    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
-        .Times(2)
-        .WillRepeatedly(testing::Return(1));
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Return(2));
 
     testing::MockFunction<void(int)> checkResult;
     EXPECT_CALL(checkResult, Call(2));
@@ -349,6 +375,8 @@ TEST_F(MultiTypeQueueTest, PushAwaitableStoreArray)
 TEST_F(MultiTypeQueueTest, PushAwaitableStoreArrayFailFirst)
 {
     boost::asio::io_context ioContext;
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     nlohmann::json arrayData = nlohmann::json::array();
@@ -357,14 +385,7 @@ TEST_F(MultiTypeQueueTest, PushAwaitableStoreArrayFailFirst)
 
     const Message messageToSend {messageType, arrayData};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
-        .Times(2)
-        .WillRepeatedly(testing::Return(0));
-
-    const testing::Sequence seq;
-    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
-        .InSequence(seq)
-        .WillOnce(testing::Return(0))
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(1));
 
     testing::MockFunction<void(int)> checkResult;
@@ -385,6 +406,8 @@ TEST_F(MultiTypeQueueTest, PushAwaitableStoreArrayFailFirst)
 TEST_F(MultiTypeQueueTest, PushAwaitableStoreArrayNotSpaceAvailable)
 {
     boost::asio::io_context ioContext;
+    SeedCounters(DEFAULT_QUEUE_SIZE - 1);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     nlohmann::json arrayData = nlohmann::json::array();
@@ -393,10 +416,6 @@ TEST_F(MultiTypeQueueTest, PushAwaitableStoreArrayNotSpaceAvailable)
 
     const Message messageToSend {messageType, arrayData};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
-        .Times(2)
-        .WillRepeatedly(testing::Return(DEFAULT_QUEUE_SIZE - 1));
-
     testing::MockFunction<void(int)> checkResult;
     EXPECT_CALL(checkResult, Call(0));
 
@@ -415,6 +434,8 @@ TEST_F(MultiTypeQueueTest, PushAwaitableStoreArrayNotSpaceAvailable)
 TEST_F(MultiTypeQueueTest, PushVector)
 {
     std::vector<Message> messages = {};
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
     nlohmann::json arrayData = nlohmann::json::array();
@@ -430,13 +451,9 @@ TEST_F(MultiTypeQueueTest, PushVector)
     messages.push_back(messageToSend);
     messages.push_back(messageToSend2);
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
+    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
         .Times(2)
-        .WillRepeatedly(testing::Return(0));
-
-    EXPECT_CALL(*m_mockStorage, Store(testing::_, testing::_, testing::_, testing::_, testing::_))
-        .Times(4)
-        .WillRepeatedly(testing::Return(1));
+        .WillRepeatedly(testing::Return(2));
 
     EXPECT_EQ(multiTypeQueue.push(messages), 4);
 }
@@ -519,11 +536,12 @@ TEST_F(MultiTypeQueueTest, GetNextBytesAwaitableBadQueue)
 TEST_F(MultiTypeQueueTest, GetNextBytesAwaitableSuccess)
 {
     boost::asio::io_context ioContext;
-    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
-
     const MessageType messageType {MessageType::STATELESS};
     const size_t messageQuantity = 3;
 
+    SeedCounters(0, messageQuantity);
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+
     const nlohmann::json retrievedMessages = nlohmann::json::array(
         {{{"data", "msg1"}, {"moduleName", "mod1"}, {"moduleType", "type1"}, {"metadata", "meta1"}},
          {{"data", "msg2"}, {"moduleName", "mod2"}, {"moduleType", "type2"}, {"metadata", "meta2"}},
@@ -537,9 +555,6 @@ TEST_F(MultiTypeQueueTest, GetNextBytesAwaitableSuccess)
                                                    {messageType, msgData2, "mod2", "type2", "meta2"},
                                                    {messageType, msgData3, "mod3", "type3", "meta3"}};
 
-    EXPECT_CALL(*m_mockStorage, GetElementsStoredSize(testing::_, testing::_, testing::_))
-        .WillRepeatedly(testing::Return(messageQuantity));
-
     EXPECT_CALL(*m_mockStorage, RetrieveBySize(testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(retrievedMessages));
 
@@ -558,6 +573,89 @@ TEST_F(MultiTypeQueueTest, GetNextBytesAwaitableSuccess)
     ioContext.run();
 }
 
+TEST_F(MultiTypeQueueTest, GetNextBytesRawAwaitableSuccess)
+{
+    boost::asio::io_context ioContext;
+    const MessageType messageType {MessageType::STATELESS};
+    const size_t messageQuantity = 3;
+
+    SeedCounters(0, messageQuantity);
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+
+    EXPECT_CALL(*m_mockStorage, RetrieveRawBySize(messageQuantity, "STATELESS", testing::_, "", "", 0))
+        .WillOnce(
+            [](size_t,
+               const std::string&,
+               const RawMessageCallback& onMessage,
+               const std::string&,
+               const std::string&,
+               size_t)
+            {
+                onMessage("meta1", R"("msg1")");
+                onMessage("meta2", R"("msg2")");
+                return 2;
+            });
+
+    std::string body;
+    testing::MockFunction<void(int)> checkResult;
+    EXPECT_CALL(checkResult, Call(2));
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            auto result = co_await multiTypeQueue.getNextBytesRawAwaitable(
+                messageType,
+                messageQuantity,
+                [&body](std::string_view metadata, std::string_view data)
+                {
+                    body += metadata;
+                    body += data;
+                });
+            checkResult.Call(result);
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_EQ(body, R"(meta1"msg1"meta2"msg2")");
+}
+
+TEST_F(MultiTypeQueueTest, GetNextBytesRawAwaitableWithSkipNeedsAFullBatch)
+{
+    boost::asio::io_context ioContext;
+    const size_t messageQuantity = 20;
+
+    // 4 messages of 10 bytes on average
+    SeedCounters(4, 40);
+    MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
+
+    EXPECT_CALL(*m_mockStorage, RetrieveRawBySize(messageQuantity, "STATELESS", testing::_, "", "", 2))
+        .WillOnce(testing::Return(2));
+
+    testing::MockFunction<void(int)> checkResult;
+    EXPECT_CALL(checkResult, Call(2));
+    EXPECT_CALL(checkResult, Call(0));
+
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            const auto ignore = [](std::string_view, std::string_view) {};
+
+            // 20 bytes are stored past the 2 messages being sent
+            checkResult.Call(co_await multiTypeQueue.getNextBytesRawAwaitable(
+                MessageType::STATELESS, messageQuantity, ignore, "", "", 2));
+
+            // Only 10 bytes are stored past 3 messages, so nothing is retrieved and nothing is waited for
+            checkResult.Call(co_await multiTypeQueue.getNextBytesRawAwaitable(
+                MessageType::STATELESS, messageQuantity, ignore, "", "", 3));
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+}
+
 TEST_F(MultiTypeQueueTest, GetNextBytesBadQueue)
 {
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
@@ -688,21 +786,21 @@ TEST_F(MultiTypeQueueTest, IsEmptyBadQueue)
 
 TEST_F(MultiTypeQueueTest, IsEmptyTrue)
 {
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_)).WillOnce(testing::Return(0));
-
     EXPECT_TRUE(multiTypeQueue.isEmpty(messageType));
 }
 
 TEST_F(MultiTypeQueueTest, IsEmptyFalse)
 {
+    SeedCounters(2);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_)).WillOnce(testing::Return(2));
-
     EXPECT_FALSE(multiTypeQueue.isEmpty(messageType));
 }
 
@@ -716,22 +814,21 @@ TEST_F(MultiTypeQueueTest, IsFullBadQueue)
 
 TEST_F(MultiTypeQueueTest, IsFullTrue)
 {
+    SeedCounters(DEFAULT_QUEUE_SIZE);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(DEFAULT_QUEUE_SIZE));
-
     EXPECT_TRUE(multiTypeQueue.isFull(messageType));
 }
 
 TEST_F(MultiTypeQueueTest, IsFullFalse)
 {
+    SeedCounters(2);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_)).WillOnce(testing::Return(2));
-
     EXPECT_FALSE(multiTypeQueue.isFull(messageType));
 }
 
@@ -745,21 +842,21 @@ TEST_F(MultiTypeQueueTest, StoredItemsBadQueue)
 
 TEST_F(MultiTypeQueueTest, StoredItemsEmpty)
 {
+    SeedCounters(0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_)).WillOnce(testing::Return(0));
-
     EXPECT_EQ(multiTypeQueue.storedItems(messageType), 0);
 }
 
 TEST_F(MultiTypeQueueTest, StoredItemsNotEmpty)
 {
+    SeedCounters(2);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
 
-    EXPECT_CALL(*m_mockStorage, GetElementCount(testing::_, testing::_, testing::_)).WillOnce(testing::Return(2));
-
     EXPECT_EQ(multiTypeQueue.storedItems(messageType), 2);
 }
 
@@ -773,21 +870,21 @@ TEST_F(MultiTypeQueueTest, SizePerTypeBadQueue)
 
 TEST_F(MultiTypeQueueTest, SizePerTypeEmpty)
 {
+    SeedCounters(0, 0);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
 
-    EXPECT_CALL(*m_mockStorage, GetElementsStoredSize(testing::_, testing::_, testing::_)).WillOnce(testing::Return(0));
-
     EXPECT_EQ(multiTypeQueue.sizePerType(messageType), 0);
 }
 
 TEST_F(MultiTypeQueueTest, SizePerTypeNotEmpty)
 {
+    SeedCounters(0, 2);
+
     MultiTypeQueue multiTypeQueue(MOCK_CONFIG_PARSER, std::move(m_mockStoragePtr));
     const MessageType messageType {MessageType::STATELESS};
 
-    EXPECT_CALL(*m_mockStorage, GetElementsStoredSize(testing::_, testing::_, testing::_)).WillOnce(testing::Return(2));
-
     EXPECT_EQ(multiTypeQueue.sizePerType(messageType), 2);
 }
 
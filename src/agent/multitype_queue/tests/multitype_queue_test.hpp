@@ -14,6 +14,9 @@ protected:
 
     void SetUp() override;
     void TearDown() override;
+
+    /// @brief Expects the queue to read the stored items and size of each type from the storage once, on construction
+    void SeedCounters(int storedItems, size_t storedSize = 0);
 };
 
 class JsonTest : public ::testing::Test
@@ -0,0 +1,277 @@
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include <nlohmann/json.hpp>
+
+#include <segmented_log_storage.hpp>
+
+namespace
+{
+    const std::vector<std::string> TABLE_NAMES {"STATELESS", "STATEFUL"};
+    const std::string TABLE_NAME = "STATELESS";
+    constexpr size_t SMALL_SEGMENT_SIZE = 256;
+} // namespace
+
+class SegmentedLogStorageTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path m_dbFolder;
+    std::unique_ptr<SegmentedLogStorage> m_storage;
+
+    void SetUp() override
+    {
+        m_dbFolder = std::filesystem::temp_directory_path() /
+                     ("segmented_log_storage_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                      "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(m_dbFolder);
+        std::filesystem::create_directories(m_dbFolder);
+        Reopen();
+    }
+
+    void TearDown() override
+    {
+        m_storage.reset();
+        std::filesystem::remove_all(m_dbFolder);
+    }
+
+    void Reopen()
+    {
+        m_storage.reset();
+        m_storage = std::make_unique<SegmentedLogStorage>(
+            m_dbFolder.string(), TABLE_NAMES, SMALL_SEGMENT_SIZE, std::chrono::milliseconds(10));
+    }
+
+    size_t SegmentCount() const
+    {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(m_dbFolder / "queue.log" / TABLE_NAME))
+        {
+            if (entry.path().extension() == ".log")
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+};
+
+TEST_F(SegmentedLogStorageTest, StoreAndRetrieve)
+{
+    EXPECT_EQ(m_storage->Store({{"key", "value1"}}, TABLE_NAME, "module", "type", "metadata"), 1);
+    EXPECT_EQ(m_storage->Store({{"key", "value2"}}, TABLE_NAME), 1);
+
+    const auto messages = m_storage->RetrieveMultiple(2, TABLE_NAME);
+    ASSERT_EQ(messages.size(), 2);
+    EXPECT_EQ(messages[0]["data"], nlohmann::json({{"key", "value1"}}));
+    EXPECT_EQ(messages[0]["moduleName"], "module");
+    EXPECT_EQ(messages[0]["moduleType"], "type");
+    EXPECT_EQ(messages[0]["metadata"], "metadata");
+    EXPECT_EQ(messages[1]["data"], nlohmann::json({{"key", "value2"}}));
+    EXPECT_EQ(messages[1]["moduleName"], "");
+}
+
+TEST_F(SegmentedLogStorageTest, StoreArray)
+{
+    const nlohmann::json messages = {"content 1", "content 2", "content 3"};
+
+    size_t storedBytes = 0;
+    EXPECT_EQ(m_storage->Store(messages, TABLE_NAME, "module", "", "", &storedBytes), 3);
+    EXPECT_EQ(storedBytes, 3 * (std::string("module").size() + std::string("\"content 1\"").size()));
+    EXPECT_EQ(storedBytes, m_storage->GetElementsStoredSize(TABLE_NAME));
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 3);
+    EXPECT_EQ(m_storage->GetElementCount("STATEFUL"), 0);
+}
+
+TEST_F(SegmentedLogStorageTest, StoreUnknownTable)
+{
+    EXPECT_EQ(m_storage->Store({{"key", "value"}}, "UNKNOWN"), 0);
+}
+
+TEST_F(SegmentedLogStorageTest, RemoveMultiple)
+{
+    for (int i = 0; i < 5; ++i)
+    {
+        m_storage->Store({{"index", i}}, TABLE_NAME);
+    }
+
+    EXPECT_EQ(m_storage->RemoveMultiple(2, TABLE_NAME), 2);
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 3);
+
+    const auto messages = m_storage->RetrieveMultiple(1, TABLE_NAME);
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0]["data"]["index"], 2);
+
+    EXPECT_EQ(m_storage->RemoveMultiple(10, TABLE_NAME), 3);
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 0);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(TABLE_NAME), 0);
+}
+
+TEST_F(SegmentedLogStorageTest, RemoveMultipleSkipsOtherModules)
+{
+    m_storage->Store({{"key", "value1"}}, TABLE_NAME, "moduleY");
+    m_storage->Store({{"key", "value2"}}, TABLE_NAME, "moduleX");
+    m_storage->Store({{"key", "value3"}}, TABLE_NAME, "moduleY");
+    m_storage->Store({{"key", "value4"}}, TABLE_NAME, "moduleX");
+
+    // The same messages a filtered retrieve returns are removed, even if they are not at the head
+    EXPECT_EQ(m_storage->RetrieveMultiple(1, TABLE_NAME, "moduleX")[0]["data"]["key"], "value2");
+    EXPECT_EQ(m_storage->RemoveMultiple(1, TABLE_NAME, "moduleX"), 1);
+    EXPECT_EQ(m_storage->RetrieveMultiple(1, TABLE_NAME, "moduleX")[0]["data"]["key"], "value4");
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 3);
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME, "moduleX"), 1);
+
+    const auto messages = m_storage->RetrieveMultiple(0, TABLE_NAME);
+    ASSERT_EQ(messages.size(), 3);
+    EXPECT_EQ(messages[0]["data"]["key"], "value1");
+    EXPECT_EQ(messages[1]["data"]["key"], "value3");
+    EXPECT_EQ(messages[2]["data"]["key"], "value4");
+
+    // Removing the head reaches past the removed record
+    EXPECT_EQ(m_storage->RemoveMultiple(1, TABLE_NAME, "moduleY"), 1);
+    EXPECT_EQ(m_storage->RetrieveMultiple(1, TABLE_NAME)[0]["data"]["key"], "value3");
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 2);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(TABLE_NAME),
+              2 * (std::string("moduleY").size() + std::string(R"({"key":"value1"})").size()));
+}
+
+TEST_F(SegmentedLogStorageTest, RemovedRecordsSurviveReopen)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        m_storage->Store({{"index", i}}, TABLE_NAME, i % 2 == 0 ? "moduleY" : "moduleX");
+    }
+    m_storage->Sync();
+
+    // Records already flushed are flagged, and flushed again
+    EXPECT_EQ(m_storage->RemoveMultiple(2, TABLE_NAME, "moduleX"), 2);
+
+    Reopen();
+
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 4);
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME, "moduleX"), 1);
+
+    const auto messages = m_storage->RetrieveMultiple(0, TABLE_NAME);
+    ASSERT_EQ(messages.size(), 4);
+    EXPECT_EQ(messages[0]["data"]["index"], 0);
+    EXPECT_EQ(messages[1]["data"]["index"], 2);
+    EXPECT_EQ(messages[2]["data"]["index"], 4);
+    EXPECT_EQ(messages[3]["data"]["index"], 5);
+
+    EXPECT_EQ(m_storage->RemoveMultiple(3, TABLE_NAME), 3);
+    EXPECT_EQ(m_storage->RetrieveMultiple(0, TABLE_NAME)[0]["data"]["index"], 5);
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 1);
+}
+
+TEST_F(SegmentedLogStorageTest, RetrieveBySize)
+{
+    const std::string moduleName = "moduleX";
+    const std::string moduleType = "type1";
+    const std::string metadata = "metadata1";
+    const nlohmann::json data = {{"key", "value"}};
+
+    m_storage->Store(data, TABLE_NAME, moduleName, moduleType, metadata);
+    m_storage->Store(data, TABLE_NAME, moduleName, moduleType, metadata);
+    m_storage->Store(data, TABLE_NAME, moduleName, moduleType, metadata);
+
+    const size_t messageSize = moduleName.size() + moduleType.size() + metadata.size() + data.dump().size();
+
+    EXPECT_EQ(m_storage->GetElementsStoredSize(TABLE_NAME), 3 * messageSize);
+    EXPECT_EQ(m_storage->RetrieveBySize(messageSize, TABLE_NAME).size(), 1);
+    EXPECT_EQ(m_storage->RetrieveBySize(messageSize + 1, TABLE_NAME).size(), 2);
+    EXPECT_EQ(m_storage->RetrieveBySize(0, TABLE_NAME).size(), 3);
+}
+
+TEST_F(SegmentedLogStorageTest, RetrieveRawBySize)
+{
+    m_storage->Store({{"key", "value1"}}, TABLE_NAME, "moduleX", "type1", "metadata1");
+    m_storage->Store({{"key", "value2"}}, TABLE_NAME, "moduleY", "type1", "metadata2");
+    m_storage->Store({{"key", "value3"}}, TABLE_NAME, "moduleX", "type1", "metadata3");
+
+    std::vector<std::pair<std::string, std::string>> messages;
+    const auto collect = [&messages](std::string_view metadata, std::string_view data)
+    {
+        messages.emplace_back(metadata, data);
+    };
+
+    EXPECT_EQ(m_storage->RetrieveRawBySize(0, TABLE_NAME, collect, "moduleX"), 2);
+    ASSERT_EQ(messages.size(), 2);
+    EXPECT_EQ(messages[0].first, "metadata1");
+    EXPECT_EQ(messages[0].second, R"({"key":"value1"})");
+    EXPECT_EQ(messages[1].first, "metadata3");
+
+    messages.clear();
+    EXPECT_EQ(m_storage->RetrieveRawBySize(1, TABLE_NAME, collect), 1);
+    EXPECT_EQ(messages.size(), 1);
+
+    EXPECT_EQ(m_storage->RetrieveRawBySize(1, "UNKNOWN", collect), 0);
+
+    messages.clear();
+    EXPECT_EQ(m_storage->RetrieveRawBySize(0, TABLE_NAME, collect, "", "", 2), 1);
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].first, "metadata3");
+}
+
+TEST_F(SegmentedLogStorageTest, ConsumedSegmentsAreDeleted)
+{
+    for (int i = 0; i < 50; ++i)
+    {
+        m_storage->Store({{"index", i}, {"payload", "some repeated payload"}}, TABLE_NAME);
+    }
+    m_storage->Sync();
+
+    const auto segmentsBefore = SegmentCount();
+    EXPECT_GT(segmentsBefore, 1);
+
+    EXPECT_EQ(m_storage->RemoveMultiple(45, TABLE_NAME), 45);
+    m_storage->Sync();
+
+    EXPECT_LT(SegmentCount(), segmentsBefore);
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 5);
+    EXPECT_EQ(m_storage->RetrieveMultiple(1, TABLE_NAME)[0]["data"]["index"], 45);
+}
+
+TEST_F(SegmentedLogStorageTest, RecoverCursorAfterReopen)
+{
+    for (int i = 0; i < 20; ++i)
+    {
+        m_storage->Store({{"index", i}}, TABLE_NAME);
+    }
+    m_storage->RemoveMultiple(7, TABLE_NAME);
+
+    Reopen();
+
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 13);
+    EXPECT_EQ(m_storage->RetrieveMultiple(1, TABLE_NAME)[0]["data"]["index"], 7);
+
+    m_storage->Store({{"index", 20}}, TABLE_NAME);
+    const auto messages = m_storage->RetrieveMultiple(0, TABLE_NAME);
+    ASSERT_EQ(messages.size(), 14);
+    EXPECT_EQ(messages.back()["data"]["index"], 20);
+}
+
+TEST_F(SegmentedLogStorageTest, Clear)
+{
+    m_storage->Store({{"key", "value1"}}, TABLE_NAME);
+    m_storage->Store({{"key", "value2"}}, "STATEFUL");
+
+    EXPECT_TRUE(m_storage->Clear({TABLE_NAME}));
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 0);
+    EXPECT_EQ(m_storage->GetElementCount("STATEFUL"), 1);
+
+    Reopen();
+
+    EXPECT_EQ(m_storage->GetElementCount(TABLE_NAME), 0);
+    EXPECT_EQ(m_storage->GetElementCount("STATEFUL"), 1);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
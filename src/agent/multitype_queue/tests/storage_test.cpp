@@ -16,6 +16,24 @@ namespace
     const std::string MODULE_TYPE_COLUMN_NAME = "module_type";
     const std::string METADATA_COLUMN_NAME = "metadata";
     const std::string MESSAGE_COLUMN_NAME = "message";
+    const std::string ROW_ID_COLUMN_NAME = "rowid";
+    const std::string SIZE_COLUMN_NAME = "size";
+
+    /// @brief Action feeding the given rows to the callback of a SelectEach call
+    auto ReplayRows(std::vector<column::Row> rows)
+    {
+        return testing::WithArg<2>(
+            [rows = std::move(rows)](const RowCallback& onRow)
+            {
+                for (const auto& row : rows)
+                {
+                    if (!onRow(row))
+                    {
+                        break;
+                    }
+                }
+            });
+    }
 } // namespace
 
 class StorageConstructorTest : public ::testing::Test
@@ -30,10 +48,85 @@ TEST_F(StorageConstructorTest, TableExists)
     auto mockPersistencePtr = std::make_unique<MockPersistence>();
     auto mockPersistence = mockPersistencePtr.get();
     EXPECT_CALL(*mockPersistence, TableExists("test_table.db")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockPersistence,
+                AddColumn("test_table.db", testing::Field(&column::ColumnName::Name, testing::Eq(SIZE_COLUMN_NAME))))
+        .Times(1);
+    EXPECT_CALL(*mockPersistence,
+                SelectEach("test_table.db",
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_))
+        .Times(1);
 
     ASSERT_NO_THROW(std::make_unique<Storage>(".", tableName, std::move(mockPersistencePtr)));
 }
 
+TEST_F(StorageConstructorTest, TableExistsLoadsStoredSize)
+{
+    const std::vector<std::string> tableName {"test_table.db"};
+    auto mockPersistencePtr = std::make_unique<MockPersistence>();
+    auto mockPersistence = mockPersistencePtr.get();
+
+    // The second message was stored before its size was recorded
+    const std::vector<column::Row> sizeRows = {
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module2"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::TEXT, "")}};
+    const std::vector<column::Row> unsizedRows = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module2"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::TEXT, "")}};
+
+    EXPECT_CALL(*mockPersistence, TableExists("test_table.db")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockPersistence, AddColumn("test_table.db", testing::_)).Times(1);
+    EXPECT_CALL(*mockPersistence,
+                SelectEach("test_table.db",
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_))
+        .WillOnce(ReplayRows(sizeRows));
+    EXPECT_CALL(*mockPersistence, BeginTransaction()).Times(1);
+    EXPECT_CALL(*mockPersistence,
+                Select("test_table.db",
+                       testing::_,
+                       testing::ElementsAre(testing::Field(&column::ColumnValue::Value, testing::Eq("2"))),
+                       testing::_,
+                       testing::_,
+                       testing::_,
+                       testing::_))
+        .WillOnce(testing::Return(unsizedRows));
+    EXPECT_CALL(*mockPersistence,
+                Update("test_table.db",
+                       testing::ElementsAre(testing::Field(&column::ColumnValue::Value, testing::Eq("37"))),
+                       testing::ElementsAre(testing::Field(&column::ColumnValue::Value, testing::Eq("2"))),
+                       testing::_))
+        .Times(1);
+    EXPECT_CALL(*mockPersistence, CommitTransaction(testing::_)).Times(1);
+
+    const auto storage = std::make_unique<Storage>(".", tableName, std::move(mockPersistencePtr));
+
+    EXPECT_EQ(storage->GetElementsStoredSize("test_table.db"), 74);
+    EXPECT_EQ(storage->GetElementsStoredSize("test_table.db", "module1"), 37);
+    EXPECT_EQ(storage->GetElementsStoredSize("test_table.db", "module2", "type2"), 37);
+    EXPECT_EQ(storage->GetElementsStoredSize("test_table.db", "module2", "type1"), 0);
+}
+
 TEST_F(StorageConstructorTest, TableExistsException)
 {
     const std::vector<std::string> tableName {"test_table.db"};
@@ -98,6 +191,11 @@ protected:
 
         EXPECT_CALL(*m_mockPersistence, TableExists("test_table")).WillOnce(testing::Return(true));
         EXPECT_CALL(*m_mockPersistence, TableExists("test_table2")).WillOnce(testing::Return(true));
+        EXPECT_CALL(*m_mockPersistence, AddColumn(testing::_, testing::_)).Times(2);
+        EXPECT_CALL(
+            *m_mockPersistence,
+            SelectEach(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+            .Times(2);
 
         m_storage = std::make_unique<Storage>(".", m_vMessageTypeStrings, std::move(mockPersistencePtr));
     }
@@ -162,7 +260,7 @@ TEST_F(StorageTest, StoreSingleMessageWithModule)
     EXPECT_CALL(
         *m_mockPersistence,
         Insert(testing::Eq(tableName),
-               testing::AllOf(testing::SizeIs(4),
+               testing::AllOf(testing::SizeIs(5),
                               testing::Contains(testing::AllOf(
                                   testing::Field(&column::ColumnValue::Name, testing::Eq(MODULE_NAME_COLUMN_NAME)),
                                   testing::Field(&column::ColumnValue::Value, testing::Eq(moduleName)))),
@@ -174,7 +272,10 @@ TEST_F(StorageTest, StoreSingleMessageWithModule)
                                   testing::Field(&column::ColumnValue::Value, testing::Eq("")))),
                               testing::Contains(testing::AllOf(
                                   testing::Field(&column::ColumnValue::Name, testing::Eq(MESSAGE_COLUMN_NAME)),
-                                  testing::Field(&column::ColumnValue::Value, testing::Eq("{\"key\":\"value\"}")))))))
+                                  testing::Field(&column::ColumnValue::Value, testing::Eq("{\"key\":\"value\"}")))),
+                              testing::Contains(testing::AllOf(
+                                  testing::Field(&column::ColumnValue::Name, testing::Eq(SIZE_COLUMN_NAME)),
+                                  testing::Field(&column::ColumnValue::Value, testing::Eq("22")))))))
         .Times(1);
     EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(1);
 
@@ -209,7 +310,9 @@ TEST_F(StorageTest, StoreMultipleMessagesFailFirst)
         .WillOnce(testing::Return());
     EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(1);
 
-    EXPECT_EQ(m_storage->Store(messages, tableName), 1);
+    size_t storedBytes = 0;
+    EXPECT_EQ(m_storage->Store(messages, tableName, "", "", "", &storedBytes), 1);
+    EXPECT_EQ(storedBytes, messages[1].dump().size());
 }
 
 TEST_F(StorageTest, StoreMultipleMessagesFailSecond)
@@ -254,15 +357,20 @@ TEST_F(StorageTest, RetrieveMultipleMessages)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})")},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module2"),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
 
-    EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(mockRows));
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(ReplayRows(mockRows));
 
     const auto retrievedMessages = m_storage->RetrieveMultiple(2, tableName);
     EXPECT_EQ(retrievedMessages.size(), 2);
@@ -274,15 +382,20 @@ TEST_F(StorageTest, RetrieveMultipleMessagesLessThanRequested)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})")},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module2"),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
 
-    EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(mockRows));
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(ReplayRows(mockRows));
 
     const auto retrievedMessages = m_storage->RetrieveMultiple(3, tableName);
     EXPECT_EQ(retrievedMessages.size(), 2);
@@ -294,25 +407,30 @@ TEST_F(StorageTest, RetrieveMultipleMessagesWithModule)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})")},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
 
     EXPECT_CALL(
         *m_mockPersistence,
-        Select(tableName,
-               testing::_,
-               testing::AllOf(testing::SizeIs(1),
-                              testing::Contains(testing::AllOf(
-                                  testing::Field(&column::ColumnValue::Name, testing::Eq(MODULE_NAME_COLUMN_NAME)),
-                                  testing::Field(&column::ColumnValue::Value, testing::Eq(moduleName))))),
-               testing::_,
-               testing::_,
-               testing::_,
-               testing::_))
-        .WillOnce(testing::Return(mockRows));
+        SelectEach(tableName,
+                   testing::_,
+                   testing::_,
+                   testing::AllOf(testing::SizeIs(1),
+                                  testing::Contains(testing::AllOf(
+                                      testing::Field(&column::ColumnValue::Name, testing::Eq(MODULE_NAME_COLUMN_NAME)),
+                                      testing::Field(&column::ColumnValue::Value, testing::Eq(moduleName))))),
+                   testing::_,
+                   testing::_,
+                   testing::_,
+                   testing::_))
+        .WillOnce(ReplayRows(mockRows));
 
     const auto retrievedMessages = m_storage->RetrieveMultiple(2, tableName, moduleName);
     EXPECT_EQ(retrievedMessages.size(), 2);
@@ -320,8 +438,9 @@ TEST_F(StorageTest, RetrieveMultipleMessagesWithModule)
 
 TEST_F(StorageTest, RetrieveMultipleSelectFail)
 {
-    EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Throw(std::runtime_error("Error Select")));
 
     const auto retrievedMessages = m_storage->RetrieveMultiple(2, tableName, moduleName);
@@ -339,15 +458,20 @@ TEST_F(StorageTest, RetrieveBySizeMessage1)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, moduleTypeString),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, metadataString),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString)},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
 
-    EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(mockRows));
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(ReplayRows(mockRows));
 
     const size_t sizeMessage1 =
         moduleNameString.size() + moduleTypeString.size() + metadataString.size() + dataString.size();
@@ -367,15 +491,20 @@ TEST_F(StorageTest, RetrieveBySizeHalfMessage1)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, moduleTypeString),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, metadataString),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString)},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
 
-    EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(mockRows));
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(ReplayRows(mockRows));
 
     const size_t sizeHalfMessage1 = moduleNameString.size() + moduleTypeString.size();
 
@@ -394,15 +523,20 @@ TEST_F(StorageTest, RetrieveBySizeMessage1HalfMessage2)
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, moduleTypeString),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, metadataString),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString)},
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, dataString),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
         {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
          column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
          column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
-         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})")}};
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
 
-    EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(mockRows));
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(ReplayRows(mockRows));
 
     const size_t sizeMessage = moduleNameString.size() + moduleTypeString.size() + metadataString.size() +
                                dataString.size() + moduleNameString.size();
@@ -413,14 +547,369 @@ TEST_F(StorageTest, RetrieveBySizeMessage1HalfMessage2)
 
 TEST_F(StorageTest, RetrieveBySizeSelectFail)
 {
-    EXPECT_CALL(*m_mockPersistence,
-                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
         .WillOnce(testing::Throw(std::runtime_error("Error Select")));
 
     const auto retrievedMessages = m_storage->RetrieveBySize(2, tableName, moduleName);
     EXPECT_EQ(retrievedMessages.size(), 0);
 }
 
+TEST_F(StorageTest, RetrieveBySizeWithoutStoredSize)
+{
+    // Rows stored before the size column existed
+    const std::vector<column::Row> mockRows = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::TEXT, "")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::TEXT, "")}};
+
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .Times(2)
+        .WillRepeatedly(ReplayRows(mockRows));
+
+    EXPECT_EQ(m_storage->RetrieveBySize(37, tableName).size(), 1);
+    EXPECT_EQ(m_storage->RetrieveBySize(38, tableName).size(), 2);
+}
+
+TEST_F(StorageTest, RetrieveBySizeStopsReadingAtBudget)
+{
+    const std::vector<column::Row> mockRows = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, "not a json"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "31")}};
+
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(ReplayRows(mockRows));
+
+    // The second row would fail to parse if it was read at all
+    EXPECT_EQ(m_storage->RetrieveBySize(10, tableName).size(), 1);
+}
+
+TEST_F(StorageTest, RetrieveRawBySize)
+{
+    const std::vector<column::Row> mockRows = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, "not a json"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "31")}};
+
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(ReplayRows(mockRows));
+
+    // Stored values are handed over without being parsed
+    std::vector<std::pair<std::string, std::string>> messages;
+    EXPECT_EQ(m_storage->RetrieveRawBySize(
+                  38,
+                  tableName,
+                  [&messages](std::string_view metadata, std::string_view data)
+                  { messages.emplace_back(metadata, data); }),
+              2);
+
+    ASSERT_EQ(messages.size(), 2);
+    EXPECT_EQ(messages[0].first, "metadata1");
+    EXPECT_EQ(messages[0].second, R"({"key":"value1"})");
+    EXPECT_EQ(messages[1].first, "metadata2");
+    EXPECT_EQ(messages[1].second, "not a json");
+}
+
+TEST_F(StorageTest, RemoveMultipleAfterRetrieveUsesRangeDelete)
+{
+    const std::vector<column::Row> mockRows = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "7"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module2"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type2"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "9"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
+    const std::vector<column::Row> remainingRows = {
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "10")}};
+
+    const testing::Sequence seq;
+    EXPECT_CALL(*m_mockPersistence,
+                SelectEach(tableName,
+                           testing::SizeIs(6),
+                           testing::_,
+                           testing::IsEmpty(),
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           2))
+        .InSequence(seq)
+        .WillOnce(ReplayRows(mockRows));
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(1);
+    EXPECT_CALL(*m_mockPersistence,
+                SelectEach(tableName,
+                           testing::SizeIs(4),
+                           testing::_,
+                           testing::ElementsAre(testing::AllOf(
+                               testing::Field(&column::ColumnValue::Name, testing::Eq(ROW_ID_COLUMN_NAME)),
+                               testing::Field(&column::ColumnValue::Value, testing::Eq("9")),
+                               testing::Field(&column::ColumnValue::Operator,
+                                              testing::Eq(column::ComparisonOperator::LESS_EQUAL)))),
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_))
+        .InSequence(seq)
+        .WillOnce(ReplayRows({}));
+    EXPECT_CALL(*m_mockPersistence,
+                Remove(tableName,
+                       testing::ElementsAre(testing::AllOf(
+                           testing::Field(&column::ColumnValue::Name, testing::Eq(ROW_ID_COLUMN_NAME)),
+                           testing::Field(&column::ColumnValue::Value, testing::Eq("9")),
+                           testing::Field(&column::ColumnValue::Operator,
+                                          testing::Eq(column::ComparisonOperator::LESS_EQUAL)))),
+                       testing::_))
+        .Times(1)
+        .InSequence(seq);
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::SizeIs(1), testing::IsEmpty(), testing::_, testing::_, testing::_, 1))
+        .InSequence(seq)
+        .WillOnce(testing::Return(remainingRows));
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(1);
+
+    EXPECT_EQ(m_storage->RetrieveMultiple(2, tableName).size(), 2);
+    EXPECT_EQ(m_storage->RemoveMultiple(2, tableName), 2);
+
+    // Next retrieval seeks past the acknowledged rows
+    EXPECT_CALL(
+        *m_mockPersistence,
+        SelectEach(tableName,
+                   testing::_,
+                   testing::_,
+                   testing::ElementsAre(testing::AllOf(
+                       testing::Field(&column::ColumnValue::Name, testing::Eq(ROW_ID_COLUMN_NAME)),
+                       testing::Field(&column::ColumnValue::Value, testing::Eq("9")),
+                       testing::Field(&column::ColumnValue::Operator,
+                                      testing::Eq(column::ComparisonOperator::GREATER_THAN)))),
+                   testing::_,
+                   testing::_,
+                   testing::_,
+                   testing::_))
+        .WillOnce(ReplayRows({}));
+
+    EXPECT_EQ(m_storage->RetrieveMultiple(2, tableName).size(), 0);
+}
+
+TEST_F(StorageTest, RetrieveRawBySizeWithSkipSeeksPastDeliveredBatches)
+{
+    const std::vector<column::Row> firstBatch = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "3"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "5"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
+    const std::vector<column::Row> secondBatch = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata3"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value3"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "8"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
+    const auto rowIdAfter = [](const std::string& rowId)
+    {
+        return testing::ElementsAre(
+            testing::AllOf(testing::Field(&column::ColumnValue::Name, testing::Eq(ROW_ID_COLUMN_NAME)),
+                           testing::Field(&column::ColumnValue::Value, testing::Eq(rowId)),
+                           testing::Field(&column::ColumnValue::Operator,
+                                          testing::Eq(column::ComparisonOperator::GREATER_THAN))));
+    };
+
+    const testing::Sequence seq;
+    EXPECT_CALL(*m_mockPersistence,
+                SelectEach(tableName,
+                           testing::_,
+                           testing::_,
+                           testing::IsEmpty(),
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_))
+        .InSequence(seq)
+        .WillOnce(ReplayRows(firstBatch));
+    EXPECT_CALL(*m_mockPersistence,
+                SelectEach(tableName,
+                           testing::_,
+                           testing::_,
+                           rowIdAfter("5"),
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_))
+        .InSequence(seq)
+        .WillOnce(ReplayRows(secondBatch));
+
+    const auto ignore = [](std::string_view, std::string_view) {};
+    EXPECT_EQ(m_storage->RetrieveRawBySize(0, tableName, ignore), 2);
+    EXPECT_EQ(m_storage->RetrieveRawBySize(0, tableName, ignore, "", "", 2), 1);
+
+    // Acknowledging the first batch leaves the second one at the head, with its bounds still known
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(2);
+    EXPECT_CALL(*m_mockPersistence,
+                SelectEach(tableName,
+                           testing::SizeIs(4),
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_))
+        .Times(2)
+        .WillRepeatedly(ReplayRows({}));
+    EXPECT_CALL(*m_mockPersistence, Remove(tableName, testing::_, testing::_)).Times(2);
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::SizeIs(1), testing::IsEmpty(), testing::_, testing::_, testing::_, 1))
+        .Times(2)
+        .WillRepeatedly(testing::Return(std::vector<column::Row> {
+            {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "10")}}));
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(2);
+
+    EXPECT_EQ(m_storage->RemoveMultiple(2, tableName), 2);
+    EXPECT_EQ(m_storage->RemoveMultiple(1, tableName), 1);
+}
+
+TEST_F(StorageTest, RetrieveRawBySizeWithSkipStepsOverUnknownBatches)
+{
+    const std::vector<column::Row> mockRows = {
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata1"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value1"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
+        {column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "module1"),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(METADATA_COLUMN_NAME, column::ColumnType::TEXT, "metadata2"),
+         column::ColumnValue(MESSAGE_COLUMN_NAME, column::ColumnType::TEXT, R"({"key":"value2"})"),
+         column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
+
+    EXPECT_CALL(*m_mockPersistence,
+                SelectEach(tableName,
+                           testing::_,
+                           testing::_,
+                           testing::IsEmpty(),
+                           testing::_,
+                           testing::_,
+                           testing::_,
+                           testing::_))
+        .WillOnce(ReplayRows(mockRows));
+
+    std::vector<std::string> metadata;
+    EXPECT_EQ(m_storage->RetrieveRawBySize(
+                  0,
+                  tableName,
+                  [&metadata](std::string_view meta, std::string_view) { metadata.emplace_back(meta); },
+                  "",
+                  "",
+                  1),
+              1);
+    EXPECT_THAT(metadata, testing::ElementsAre("metadata2"));
+}
+
+TEST_F(StorageTest, RemoveMultipleWithoutRetrieveSelectsUpperBound)
+{
+    const std::vector<column::Row> rowIds = {
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1"),
+         column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")},
+        {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "4"),
+         column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, moduleName),
+         column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, "type1"),
+         column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "37")}};
+
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(1);
+
+    const testing::Sequence seq;
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName,
+                       testing::SizeIs(4),
+                       testing::ElementsAre(
+                           testing::Field(&column::ColumnValue::Name, testing::Eq(MODULE_NAME_COLUMN_NAME))),
+                       testing::_,
+                       testing::_,
+                       testing::_,
+                       3))
+        .InSequence(seq)
+        .WillOnce(testing::Return(rowIds));
+    EXPECT_CALL(*m_mockPersistence,
+                Remove(tableName,
+                       testing::ElementsAre(
+                           testing::Field(&column::ColumnValue::Name, testing::Eq(MODULE_NAME_COLUMN_NAME)),
+                           testing::AllOf(testing::Field(&column::ColumnValue::Value, testing::Eq("4")),
+                                          testing::Field(&column::ColumnValue::Operator,
+                                                         testing::Eq(column::ComparisonOperator::LESS_EQUAL)))),
+                       testing::_))
+        .Times(1)
+        .InSequence(seq);
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::_, testing::IsEmpty(), testing::_, testing::_, testing::_, 1))
+        .InSequence(seq)
+        .WillOnce(testing::Return(std::vector<column::Row> {}));
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(1);
+
+    EXPECT_EQ(m_storage->RemoveMultiple(3, tableName, moduleName), 2);
+}
+
+TEST_F(StorageTest, RemoveMultipleSelectFail)
+{
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(1);
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::_, testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillOnce(testing::Throw(std::runtime_error("Error Select")));
+    EXPECT_CALL(*m_mockPersistence, Remove(testing::_, testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(1);
+
+    EXPECT_EQ(m_storage->RemoveMultiple(2, tableName), 0);
+}
+
 TEST_F(StorageTest, GetElementCount)
 {
     EXPECT_CALL(*m_mockPersistence, GetCount(tableName, testing::_, testing::_)).WillOnce(testing::Return(1));
@@ -436,16 +925,49 @@ TEST_F(StorageTest, GetElementCountGetCountFail)
 
 TEST_F(StorageTest, GetElementsStoredSize)
 {
-    EXPECT_CALL(*m_mockPersistence, GetSize(tableName, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Return(1));
-    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 1);
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(2);
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(3);
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(2);
+    EXPECT_CALL(*m_mockPersistence, GetSize(testing::_, testing::_, testing::_, testing::_)).Times(0);
+
+    const nlohmann::json message = {{"key", "value"}};
+    EXPECT_EQ(m_storage->Store(message, tableName, moduleName), 1);
+    EXPECT_EQ(m_storage->Store(nlohmann::json::array({message, message}), tableName, "moduleY", "typeY"), 2);
+
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 22 + 2 * 27);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName, moduleName), 22);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName, "", "typeY"), 2 * 27);
+    EXPECT_EQ(m_storage->GetElementsStoredSize("test_table2"), 0);
 }
 
-TEST_F(StorageTest, GetElementsStoredSizeGetSizeFail)
+TEST_F(StorageTest, GetElementsStoredSizeAfterRemoval)
 {
-    EXPECT_CALL(*m_mockPersistence, GetSize(tableName, testing::_, testing::_, testing::_))
-        .WillOnce(testing::Throw(std::runtime_error("Error GetSize")));
-    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 0);
+    EXPECT_CALL(*m_mockPersistence, BeginTransaction()).Times(3);
+    EXPECT_CALL(*m_mockPersistence, Insert(tableName, testing::_)).Times(2);
+    EXPECT_CALL(*m_mockPersistence, CommitTransaction(testing::_)).Times(3);
+
+    const nlohmann::json message = {{"key", "value"}};
+    EXPECT_EQ(m_storage->Store(message, tableName, moduleName), 1);
+    EXPECT_EQ(m_storage->Store(message, tableName, "moduleY"), 1);
+
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::SizeIs(4), testing::SizeIs(1), testing::_, testing::_, testing::_, 1))
+        .WillOnce(testing::Return(std::vector<column::Row> {
+            {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "2"),
+             column::ColumnValue(MODULE_NAME_COLUMN_NAME, column::ColumnType::TEXT, "moduleY"),
+             column::ColumnValue(MODULE_TYPE_COLUMN_NAME, column::ColumnType::TEXT, ""),
+             column::ColumnValue(SIZE_COLUMN_NAME, column::ColumnType::INTEGER, "22")}}));
+    EXPECT_CALL(*m_mockPersistence, Remove(tableName, testing::_, testing::_)).Times(1);
+    EXPECT_CALL(*m_mockPersistence,
+                Select(tableName, testing::SizeIs(1), testing::IsEmpty(), testing::_, testing::_, testing::_, 1))
+        .WillOnce(testing::Return(std::vector<column::Row> {
+            {column::ColumnValue(ROW_ID_COLUMN_NAME, column::ColumnType::INTEGER, "1")}}));
+
+    EXPECT_EQ(m_storage->RemoveMultiple(1, tableName, "moduleY"), 1);
+
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName), 22);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName, moduleName), 22);
+    EXPECT_EQ(m_storage->GetElementsStoredSize(tableName, "moduleY"), 0);
 }
 
 int main(int argc, char** argv)
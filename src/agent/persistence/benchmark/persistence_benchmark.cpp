@@ -0,0 +1,98 @@
+#include <persistence.hpp>
+#include <persistence_factory.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+
+// Measures the throughput of the basic operations of the Persistence interface.
+//
+// Usage: persistence_benchmark [operations] [value size] [folder]
+//
+// Each operation is run the given number of times against a table shaped like the ones the queue and the agent
+// info use, each time with a different value, and reported in operations per second. Each run is grouped in a
+// transaction, so that it measures the statements rather than the commits to disk.
+
+namespace
+{
+    const std::string TABLE_NAME = "BENCHMARK";
+
+    using Clock = std::chrono::steady_clock;
+
+    void Measure(Persistence& db, const std::string& name, int operations, const std::function<void(int)>& operation)
+    {
+        const auto start = Clock::now();
+        const auto transaction = db.BeginTransaction();
+
+        for (int i = 0; i < operations; ++i)
+        {
+            operation(i);
+        }
+
+        db.CommitTransaction(transaction);
+        const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        fmt::print("{:<10} {:>12.0f} ops/s\n", name, operations / seconds);
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace column;
+
+    const int operations = argc > 1 ? std::stoi(argv[1]) : 20000;
+    const size_t valueSize = argc > 2 ? std::stoul(argv[2]) : 128;
+    const std::filesystem::path folder = argc > 3 ? std::filesystem::path(argv[3])
+                                                  : std::filesystem::temp_directory_path() / "persistence_benchmark";
+
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+
+    fmt::print("{} operations, values of {} bytes\n", operations, valueSize);
+
+    {
+        auto db = PersistenceFactory::CreatePersistence(PersistenceFactory::PersistenceType::SQLITE3,
+                                                        (folder / "benchmark.db").string());
+
+        db->CreateTable(TABLE_NAME,
+                        {ColumnKey("id", ColumnType::INTEGER, NOT_NULL | PRIMARY_KEY),
+                         ColumnKey("module", ColumnType::TEXT, NOT_NULL),
+                         ColumnKey("data", ColumnType::TEXT, NOT_NULL)});
+
+        const std::string value(valueSize, 'x');
+        const Names fields {ColumnName("data", ColumnType::TEXT)};
+        const auto byId = [](int i)
+        {
+            return Criteria {ColumnValue("id", ColumnType::INTEGER, std::to_string(i))};
+        };
+
+        Measure(*db,
+                "Insert",
+                operations,
+                [&](int i)
+                {
+                    db->Insert(TABLE_NAME,
+                               {ColumnValue("id", ColumnType::INTEGER, std::to_string(i)),
+                                ColumnValue("module", ColumnType::TEXT, fmt::format("module{}", i % 8)),
+                                ColumnValue("data", ColumnType::TEXT, value)});
+                });
+
+        Measure(*db, "Select", operations, [&](int i) { db->Select(TABLE_NAME, fields, byId(i)); });
+
+        Measure(*db, "GetCount", operations, [&](int i) { db->GetCount(TABLE_NAME, byId(i)); });
+
+        Measure(*db,
+                "Update",
+                operations,
+                [&](int i) { db->Update(TABLE_NAME, {ColumnValue("data", ColumnType::TEXT, value + "y")}, byId(i)); });
+
+        Measure(*db, "Remove", operations, [&](int i) { db->Remove(TABLE_NAME, byId(i)); });
+    }
+
+    std::filesystem::remove_all(folder);
+    return EXIT_SUCCESS;
+}
@@ -12,6 +12,17 @@ namespace column
         OR
     };
 
+    /// @brief Comparison operators applied by selection criteria.
+    enum class ComparisonOperator
+    {
+        EQUAL,
+        NOT_EQUAL,
+        LESS_THAN,
+        LESS_EQUAL,
+        GREATER_THAN,
+        GREATER_EQUAL
+    };
+
     /// @brief Supported order types for sorting results.
     enum class OrderType
     {
@@ -82,14 +93,22 @@ namespace column
         /// @param name The name of the column.
         /// @param type The data type of the column.
         /// @param value The value of the column.
-        ColumnValue(std::string name, const ColumnType type, std::string value)
+        /// @param op The comparison applied when the column is used as a selection criterion.
+        ColumnValue(std::string name,
+                    const ColumnType type,
+                    std::string value,
+                    const ComparisonOperator op = ComparisonOperator::EQUAL)
             : ColumnName(std::move(name), type)
             , Value(std::move(value))
+            , Operator(op)
         {
         }
 
         /// @brief The value of the column as a string
         std::string Value;
+
+        /// @brief The comparison applied when the column is used as a selection criterion
+        ComparisonOperator Operator;
     };
 
     using Names = std::vector<ColumnName>;
@@ -2,11 +2,15 @@
 
 #include "column.hpp"
 
+#include <functional>
 #include <string>
 #include <vector>
 
 using TransactionId = unsigned int;
 
+/// @brief Callback invoked for each selected row. Returning false stops the selection.
+using RowCallback = std::function<bool(const column::Row&)>;
+
 /// @brief Interface for persistence storage.
 class Persistence
 {
@@ -24,6 +28,11 @@ public:
     /// @param cols Keys specifying the table schema.
     virtual void CreateTable(const std::string& tableName, const column::Keys& cols) = 0;
 
+    /// @brief Adds a column to an existing table if it doesn't already have it.
+    /// @param tableName The name of the table to alter.
+    /// @param col Key specifying the new column. It can't be NOT NULL, since existing rows have no value for it.
+    virtual void AddColumn(const std::string& tableName, const column::ColumnKey& col) = 0;
+
     /// @brief Inserts data into a specified table.
     /// @param tableName The name of the table where data is inserted.
     /// @param cols Row with values to insert.
@@ -40,6 +49,8 @@ public:
                         column::LogicalOperator logOp = column::LogicalOperator::AND) = 0;
 
     /// @brief Removes rows from a specified table with optional criteria.
+    /// @details Criteria using a comparison operator other than EQUAL allow removing a whole range of rows in a
+    /// single statement, e.g. every row whose rowid is lower than or equal to a given cursor.
     /// @param tableName The name of the table to delete from.
     /// @param selCriteria Optional criteria to filter rows to delete.
     /// @param logOp Logical operator to combine selection criteria.
@@ -68,6 +79,26 @@ public:
                                             column::OrderType orderType = column::OrderType::ASC,
                                             int limit = 0) = 0;
 
+    /// @brief Selects rows from a specified table, stepping through them one at a time.
+    /// @details Rows are not materialized up front, so the caller can stop reading as soon as it has enough. The
+    /// callback must not use this persistence object.
+    /// @param tableName The name of the table to select from.
+    /// @param fields Names to retrieve.
+    /// @param onRow Callback invoked for each row. Returning false stops the selection.
+    /// @param selCriteria Optional selection criteria to filter rows.
+    /// @param logOp Logical operator to combine selection criteria (AND/OR).
+    /// @param orderBy Names to order the results by.
+    /// @param orderType The order type (ASC or DESC).
+    /// @param limit The maximum number of rows to retrieve.
+    virtual void SelectEach(const std::string& tableName,
+                            const column::Names& fields,
+                            const RowCallback& onRow,
+                            const column::Criteria& selCriteria = {},
+                            column::LogicalOperator logOp = column::LogicalOperator::AND,
+                            const column::Names& orderBy = {},
+                            column::OrderType orderType = column::OrderType::ASC,
+                            int limit = 0) = 0;
+
     /// @brief Retrieves the number of rows in a specified table.
     /// @param tableName The name of the table to count rows in.
     /// @param selCriteria Optional selection criteria to filter rows.
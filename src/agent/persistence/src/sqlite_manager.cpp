@@ -4,8 +4,8 @@
 
 #include <SQLiteCpp/SQLiteCpp.h>
 #include <fmt/format.h>
+#include <charconv>
 #include <map>
-#include <regex>
 
 using namespace column;
 
@@ -14,19 +14,102 @@ const std::map<ColumnType, std::string> MAP_COL_TYPE_STRING {
 const std::map<LogicalOperator, std::string> MAP_LOGOP_STRING {{LogicalOperator::AND, "AND"},
                                                                {LogicalOperator::OR, "OR"}};
 const std::map<OrderType, std::string> MAP_ORDER_STRING {{OrderType::ASC, "ASC"}, {OrderType::DESC, "DESC"}};
+const std::map<ComparisonOperator, std::string> MAP_COMPARISON_STRING {{ComparisonOperator::EQUAL, "="},
+                                                                       {ComparisonOperator::NOT_EQUAL, "<>"},
+                                                                       {ComparisonOperator::LESS_THAN, "<"},
+                                                                       {ComparisonOperator::LESS_EQUAL, "<="},
+                                                                       {ComparisonOperator::GREATER_THAN, ">"},
+                                                                       {ComparisonOperator::GREATER_EQUAL, ">="}};
 
 SQLiteManager::~SQLiteManager() = default;
 
 namespace
 {
-    const std::string& TO_SEARCH = "'";
-    const std::string& TO_REPLACE = "''";
+    /// @brief Maximum number of prepared statements kept. Queries are built from a small set of shapes, so this is
+    /// only reached if callers keep changing them, in which case the cache starts over.
+    constexpr size_t MAX_CACHED_STATEMENTS = 128;
 
-    /// @brief Escapes single quotes in a string.
-    std::string EscapeSingleQuotes(const std::string& str)
+    /// @brief Builds the WHERE clause for the given criteria, or an empty string if there are none.
+    /// @details Values are left as parameters, to be bound in the same order.
+    std::string BuildWhereClause(const Criteria& selCriteria, LogicalOperator logOp)
     {
-        return std::regex_replace(str, std::regex(TO_SEARCH), TO_REPLACE);
+        if (selCriteria.empty())
+        {
+            return "";
+        }
+
+        std::vector<std::string> conditions;
+        conditions.reserve(selCriteria.size());
+        for (const auto& col : selCriteria)
+        {
+            conditions.push_back(fmt::format("{}{}?", col.Name, MAP_COMPARISON_STRING.at(col.Operator)));
+        }
+        return fmt::format(" WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
+    }
+
+    /// @brief Binds a value to the next parameter of a statement, with the type of its column.
+    /// @details Values that don't parse as their numeric type are bound as text, and SQLite converts them.
+    void BindValue(SQLite::Statement& statement, int& index, const ColumnValue& col)
+    {
+        const auto* first = col.Value.data();
+        const auto* last = col.Value.data() + col.Value.size();
+        ++index;
+
+        if (col.Type == ColumnType::INTEGER)
+        {
+            int64_t value = 0;
+            const auto [ptr, ec] = std::from_chars(first, last, value);
+            if (ec == std::errc() && ptr == last)
+            {
+                statement.bind(index, value);
+                return;
+            }
+        }
+        else if (col.Type == ColumnType::REAL)
+        {
+            double value = 0;
+            const auto [ptr, ec] = std::from_chars(first, last, value);
+            if (ec == std::errc() && ptr == last)
+            {
+                statement.bind(index, value);
+                return;
+            }
+        }
+
+        // The value outlives the execution, and the bindings are cleared before the statement is used again
+        statement.bindNoCopy(index, col.Value);
     }
+
+    /// @brief Binds the values to the next parameters of a statement, in order.
+    void BindValues(SQLite::Statement& statement, int& index, const std::vector<ColumnValue>& values)
+    {
+        for (const auto& col : values)
+        {
+            BindValue(statement, index, col);
+        }
+    }
+
+    /// @brief Resets a cached statement on scope exit, so it can be executed again and doesn't keep its bindings.
+    class StatementReset
+    {
+    public:
+        explicit StatementReset(SQLite::Statement& statement)
+            : m_statement(statement)
+        {
+        }
+
+        StatementReset(const StatementReset&) = delete;
+        StatementReset& operator=(const StatementReset&) = delete;
+
+        ~StatementReset()
+        {
+            m_statement.tryReset();
+            m_statement.clearBindings();
+        }
+
+    private:
+        SQLite::Statement& m_statement;
+    };
 } // namespace
 
 ColumnType SQLiteManager::ColumnTypeFromSQLiteType(const int type) const
@@ -52,7 +135,9 @@ bool SQLiteManager::TableExists(const std::string& table)
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        SQLite::Statement query(*m_db, "SELECT name FROM sqlite_master WHERE type='table' AND name='" + table + "';");
+        auto& query = GetStatement("SELECT name FROM sqlite_master WHERE type='table' AND name=?");
+        const StatementReset reset(query);
+        query.bindNoCopy(1, table);
         return query.executeStep();
     }
     catch (const std::exception& e)
@@ -84,29 +169,42 @@ void SQLiteManager::CreateTable(const std::string& tableName, const Keys& cols)
     Execute(queryString);
 }
 
+void SQLiteManager::AddColumn(const std::string& tableName, const ColumnKey& col)
+{
+    try
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        SQLite::Statement query(
+            *m_db, fmt::format("SELECT 1 FROM pragma_table_info('{}') WHERE name='{}';", tableName, col.Name));
+        if (query.executeStep())
+        {
+            return;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Failed to check if column exists: {}.", e.what());
+        throw;
+    }
+
+    Execute(fmt::format("ALTER TABLE {} ADD COLUMN {} {}", tableName, col.Name, MAP_COL_TYPE_STRING.at(col.Type)));
+}
+
 void SQLiteManager::Insert(const std::string& tableName, const Row& cols)
 {
     std::vector<std::string> names;
-    std::vector<std::string> values;
+    std::vector<std::string> placeholders;
 
     for (const auto& col : cols)
     {
         names.push_back(col.Name);
-        if (col.Type == ColumnType::TEXT)
-        {
-            auto escapedValue = EscapeSingleQuotes(col.Value);
-            values.push_back(fmt::format("'{}'", escapedValue));
-        }
-        else
-        {
-            values.push_back(col.Value);
-        }
+        placeholders.emplace_back("?");
     }
 
-    const std::string queryString =
-        fmt::format("INSERT INTO {} ({}) VALUES ({})", tableName, fmt::join(names, ", "), fmt::join(values, ", "));
+    const std::string queryString = fmt::format(
+        "INSERT INTO {} ({}) VALUES ({})", tableName, fmt::join(names, ", "), fmt::join(placeholders, ", "));
 
-    Execute(queryString);
+    ExecuteStatement(queryString, {&cols});
 }
 
 void SQLiteManager::Update(const std::string& tableName,
@@ -123,72 +221,36 @@ void SQLiteManager::Update(const std::string& tableName,
     std::vector<std::string> setFields;
     for (const auto& col : fields)
     {
-        if (col.Type == ColumnType::TEXT)
-        {
-            auto escapedValue = EscapeSingleQuotes(col.Value);
-            setFields.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-        }
-        else
-        {
-            setFields.push_back(fmt::format("{}={}", col.Name, col.Value));
-        }
+        setFields.push_back(fmt::format("{}=?", col.Name));
     }
     std::string updateValues = fmt::format("{}", fmt::join(setFields, ", "));
 
-    std::string whereClause;
-    if (!selCriteria.empty())
-    {
-        std::vector<std::string> conditions;
-        for (const auto& col : selCriteria)
-        {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                conditions.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                conditions.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
-        }
-        whereClause = fmt::format(" WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
-    }
+    const std::string whereClause = BuildWhereClause(selCriteria, logOp);
 
     const std::string queryString = fmt::format("UPDATE {} SET {}{}", tableName, updateValues, whereClause);
 
-    Execute(queryString);
+    ExecuteStatement(queryString, {&fields, &selCriteria});
 }
 
 void SQLiteManager::Remove(const std::string& tableName, const Criteria& selCriteria, LogicalOperator logOp)
 {
-    std::string whereClause;
-    if (!selCriteria.empty())
-    {
-        std::vector<std::string> critFields;
-        for (const auto& col : selCriteria)
-        {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                critFields.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                critFields.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
-        }
-        whereClause = fmt::format(" WHERE {}", fmt::join(critFields, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
-    }
+    const std::string whereClause = BuildWhereClause(selCriteria, logOp);
 
     const std::string queryString = fmt::format("DELETE FROM {}{}", tableName, whereClause);
 
-    Execute(queryString);
+    ExecuteStatement(queryString, {&selCriteria});
 }
 
 void SQLiteManager::DropTable(const std::string& tableName)
 {
     const std::string queryString = fmt::format("DROP TABLE {}", tableName);
 
+    {
+        // Statements on the dropped table can't be used anymore
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_statements.clear();
+    }
+
     Execute(queryString);
 }
 
@@ -206,6 +268,46 @@ void SQLiteManager::Execute(const std::string& query)
     }
 }
 
+void SQLiteManager::ExecuteStatement(const std::string& query,
+                                     std::initializer_list<const std::vector<ColumnValue>*> values)
+{
+    try
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto& statement = GetStatement(query);
+        const StatementReset reset(statement);
+
+        int index = 0;
+        for (const auto* value : values)
+        {
+            BindValues(statement, index, *value);
+        }
+        statement.exec();
+    }
+    catch (const std::exception& e)
+    {
+        LogError("Error during database operation: {}.", e.what());
+        throw;
+    }
+}
+
+SQLite::Statement& SQLiteManager::GetStatement(const std::string& query)
+{
+    if (const auto it = m_statements.find(query); it != m_statements.end())
+    {
+        return *it->second;
+    }
+
+    auto statement = std::make_unique<SQLite::Statement>(*m_db, query);
+
+    if (m_statements.size() >= MAX_CACHED_STATEMENTS)
+    {
+        m_statements.clear();
+    }
+
+    return *m_statements.emplace(query, std::move(statement)).first->second;
+}
+
 std::vector<Row> SQLiteManager::Select(const std::string& tableName,
                                        const Names& fields,
                                        const Criteria& selCriteria,
@@ -213,6 +315,32 @@ std::vector<Row> SQLiteManager::Select(const std::string& tableName,
                                        const Names& orderBy,
                                        OrderType orderType,
                                        int limit)
+{
+    std::vector<Row> results;
+    SelectEach(
+        tableName,
+        fields,
+        [&results](const Row& row)
+        {
+            results.push_back(row);
+            return true;
+        },
+        selCriteria,
+        logOp,
+        orderBy,
+        orderType,
+        limit);
+    return results;
+}
+
+void SQLiteManager::SelectEach(const std::string& tableName,
+                               const Names& fields,
+                               const RowCallback& onRow,
+                               const Criteria& selCriteria,
+                               LogicalOperator logOp,
+                               const Names& orderBy,
+                               OrderType orderType,
+                               int limit)
 {
     std::string selectedFields;
     if (fields.empty())
@@ -231,24 +359,7 @@ std::vector<Row> SQLiteManager::Select(const std::string& tableName,
         selectedFields = fmt::format("{}", fmt::join(fieldNames, ", "));
     }
 
-    std::string condition;
-    if (!selCriteria.empty())
-    {
-        std::vector<std::string> conditions;
-        for (const auto& col : selCriteria)
-        {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                conditions.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                conditions.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
-        }
-        condition = fmt::format("WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
-    }
+    std::string condition = BuildWhereClause(selCriteria, logOp);
 
     if (!orderBy.empty())
     {
@@ -264,21 +375,29 @@ std::vector<Row> SQLiteManager::Select(const std::string& tableName,
 
     if (limit > 0)
     {
-        condition += fmt::format(" LIMIT {}", limit);
+        condition += " LIMIT ?";
     }
 
-    const std::string queryString = fmt::format("SELECT {} FROM {} {}", selectedFields, tableName, condition);
+    const std::string queryString = fmt::format("SELECT {} FROM {}{}", selectedFields, tableName, condition);
 
-    std::vector<Row> results;
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        SQLite::Statement query(*m_db, queryString);
+        auto& query = GetStatement(queryString);
+        const StatementReset reset(query);
 
+        int index = 0;
+        BindValues(query, index, selCriteria);
+        if (limit > 0)
+        {
+            query.bind(++index, limit);
+        }
+
+        Row queryFields;
         while (query.executeStep())
         {
             const int nColumns = query.getColumnCount();
-            Row queryFields;
+            queryFields.clear();
             queryFields.reserve(static_cast<size_t>(nColumns));
             for (int i = 0; i < nColumns; i++)
             {
@@ -286,7 +405,10 @@ std::vector<Row> SQLiteManager::Select(const std::string& tableName,
                                          ColumnTypeFromSQLiteType(query.getColumn(i).getType()),
                                          query.getColumn(i).getString());
             }
-            results.push_back(queryFields);
+            if (!onRow(queryFields))
+            {
+                break;
+            }
         }
     }
     catch (const std::exception& e)
@@ -294,37 +416,23 @@ std::vector<Row> SQLiteManager::Select(const std::string& tableName,
         LogError("Error during Select operation: {}.", e.what());
         throw;
     }
-    return results;
 }
 
 int SQLiteManager::GetCount(const std::string& tableName, const Criteria& selCriteria, LogicalOperator logOp)
 {
-    std::string condition;
-    if (!selCriteria.empty())
-    {
-        std::vector<std::string> conditions;
-        for (const auto& col : selCriteria)
-        {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                conditions.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                conditions.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
-        }
-        condition = fmt::format("WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
-    }
+    const std::string condition = BuildWhereClause(selCriteria, logOp);
 
-    const std::string queryString = fmt::format("SELECT COUNT(*) FROM {} {}", tableName, condition);
+    const std::string queryString = fmt::format("SELECT COUNT(*) FROM {}{}", tableName, condition);
 
     int count = 0;
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        SQLite::Statement query(*m_db, queryString);
+        auto& query = GetStatement(queryString);
+        const StatementReset reset(query);
+
+        int index = 0;
+        BindValues(query, index, selCriteria);
 
         if (query.executeStep())
         {
@@ -364,33 +472,20 @@ size_t SQLiteManager::GetSize(const std::string& tableName,
     }
     selectedFields = fmt::format("{}", fmt::join(fieldNames, " + "));
 
-    std::string condition;
-    if (!selCriteria.empty())
-    {
-        std::vector<std::string> conditions;
-        for (const auto& col : selCriteria)
-        {
-            if (col.Type == ColumnType::TEXT)
-            {
-                auto escapedValue = EscapeSingleQuotes(col.Value);
-                conditions.push_back(fmt::format("{}='{}'", col.Name, escapedValue));
-            }
-            else
-            {
-                conditions.push_back(fmt::format("{}={}", col.Name, col.Value));
-            }
-        }
-        condition = fmt::format("WHERE {}", fmt::join(conditions, fmt::format(" {} ", MAP_LOGOP_STRING.at(logOp))));
-    }
+    const std::string condition = BuildWhereClause(selCriteria, logOp);
 
     const std::string queryString =
-        fmt::format("SELECT SUM({}) AS total_bytes FROM {} {}", selectedFields, tableName, condition);
+        fmt::format("SELECT SUM({}) AS total_bytes FROM {}{}", selectedFields, tableName, condition);
 
     size_t count = 0;
     try
     {
         const std::lock_guard<std::mutex> lock(m_mutex);
-        SQLite::Statement query(*m_db, queryString);
+        auto& query = GetStatement(queryString);
+        const StatementReset reset(query);
+
+        int index = 0;
+        BindValues(query, index, selCriteria);
 
         if (query.executeStep())
         {
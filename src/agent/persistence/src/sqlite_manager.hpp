@@ -4,15 +4,18 @@
 #include "persistence.hpp"
 
 #include <atomic>
+#include <initializer_list>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace SQLite
 {
     class Database;
+    class Statement;
     class Transaction;
 } // namespace SQLite
 
@@ -49,6 +52,11 @@ public:
     /// @param cols Keys specifying the table schema.
     void CreateTable(const std::string& tableName, const column::Keys& cols) override;
 
+    /// @brief Adds a column to an existing table if it doesn't already have it.
+    /// @param tableName The name of the table to alter.
+    /// @param col Key specifying the new column.
+    void AddColumn(const std::string& tableName, const column::ColumnKey& col) override;
+
     /// @brief Inserts data into a specified table.
     /// @param tableName The name of the table where data is inserted.
     /// @param cols Row with values to insert.
@@ -93,6 +101,24 @@ public:
                                     column::OrderType orderType = column::OrderType::ASC,
                                     int limit = 0) override;
 
+    /// @brief Selects rows from a specified table, stepping through them one at a time.
+    /// @param tableName The name of the table to select from.
+    /// @param fields Names to retrieve.
+    /// @param onRow Callback invoked for each row. Returning false stops the selection.
+    /// @param selCriteria Optional selection criteria to filter rows.
+    /// @param logOp Logical operator to combine selection criteria (AND/OR).
+    /// @param orderBy Names to order the results by.
+    /// @param orderType The order type (ASC or DESC).
+    /// @param limit The maximum number of rows to retrieve.
+    void SelectEach(const std::string& tableName,
+                    const column::Names& fields,
+                    const RowCallback& onRow,
+                    const column::Criteria& selCriteria = {},
+                    column::LogicalOperator logOp = column::LogicalOperator::AND,
+                    const column::Names& orderBy = {},
+                    column::OrderType orderType = column::OrderType::ASC,
+                    int limit = 0) override;
+
     /// @brief Retrieves the number of rows in a specified table.
     /// @param tableName The name of the table to count rows in.
     /// @param selCriteria Optional selection criteria to filter rows.
@@ -135,6 +161,17 @@ private:
     /// @param query The SQL query string to execute.
     void Execute(const std::string& query);
 
+    /// @brief Executes a SQL query with parameters, using a cached prepared statement.
+    /// @param query The SQL query string to execute, with a '?' for each value.
+    /// @param values The values to bind to the parameters, in order.
+    void ExecuteStatement(const std::string& query,
+                          std::initializer_list<const std::vector<column::ColumnValue>*> values);
+
+    /// @brief Gets the prepared statement for a query, preparing it the first time. Must be called with the mutex held.
+    /// @param query The SQL query string.
+    /// @return The statement, ready to bind its parameters and execute.
+    SQLite::Statement& GetStatement(const std::string& query);
+
     /// @brief Mutex for thread-safe operations.
     std::mutex m_mutex;
 
@@ -144,6 +181,9 @@ private:
     /// @brief Pointer to the SQLite database connection.
     std::unique_ptr<SQLite::Database> m_db;
 
+    /// @brief Prepared statements by query.
+    std::unordered_map<std::string, std::unique_ptr<SQLite::Statement>> m_statements;
+
     /// @brief Map of open transactions.
     std::map<TransactionId, std::unique_ptr<SQLite::Transaction>> m_transactions;
 
@@ -10,6 +10,7 @@ class MockPersistence : public Persistence
 public:
     MOCK_METHOD(bool, TableExists, (const std::string& tableName), (override));
     MOCK_METHOD(void, CreateTable, (const std::string& tableName, const column::Keys& cols), (override));
+    MOCK_METHOD(void, AddColumn, (const std::string& tableName, const column::ColumnKey& col), (override));
     MOCK_METHOD(void, Insert, (const std::string& tableName, const column::Row& cols), (override));
     MOCK_METHOD(void,
                 Update,
@@ -33,6 +34,17 @@ public:
                  column::OrderType orderType,
                  int limit),
                 (override));
+    MOCK_METHOD(void,
+                SelectEach,
+                (const std::string& tableName,
+                 const column::Names& fields,
+                 const RowCallback& onRow,
+                 const column::Criteria& selCriteria,
+                 column::LogicalOperator logOp,
+                 const column::Names& orderBy,
+                 column::OrderType orderType,
+                 int limit),
+                (override));
     MOCK_METHOD(int,
                 GetCount,
                 (const std::string& tableName, const column::Criteria& selCriteria, column::LogicalOperator logOp),
@@ -280,6 +280,66 @@ TEST_F(SQLiteManagerTest, SelectTest)
     EXPECT_EQ(ret[0][1].Value, "3.5");
 }
 
+TEST_F(SQLiteManagerTest, SelectEachTest)
+{
+    AddTestData();
+
+    std::vector<std::string> names;
+    m_db->SelectEach(m_tableName,
+                     {ColumnName("Name", ColumnType::TEXT)},
+                     [&names](const Row& row)
+                     {
+                         names.push_back(row[0].Value);
+                         return true;
+                     });
+    EXPECT_EQ(names.size(), 6);
+
+    // Stop after the second row
+    names.clear();
+    m_db->SelectEach(
+        m_tableName,
+        {ColumnName("Name", ColumnType::TEXT)},
+        [&names](const Row& row)
+        {
+            names.push_back(row[0].Value);
+            return names.size() < 2;
+        },
+        {ColumnValue("Module", ColumnType::TEXT, "ItemModule3", ComparisonOperator::GREATER_EQUAL)},
+        LogicalOperator::AND,
+        {ColumnName("Name", ColumnType::TEXT)},
+        OrderType::DESC);
+    ASSERT_EQ(names.size(), 2);
+    EXPECT_EQ(names[0], "ItemName5");
+    EXPECT_EQ(names[1], "ItemName4");
+}
+
+TEST_F(SQLiteManagerTest, AddColumnTest)
+{
+    const std::string tableName = "AddColumnTable";
+    if (m_db->TableExists(tableName))
+    {
+        m_db->DropTable(tableName);
+    }
+    m_db->CreateTable(tableName, {ColumnKey("Name", ColumnType::TEXT, NOT_NULL)});
+    m_db->Insert(tableName, {ColumnValue("Name", ColumnType::TEXT, "Existing")});
+
+    EXPECT_NO_THROW(m_db->AddColumn(tableName, ColumnKey("Size", ColumnType::INTEGER)));
+    // Adding it again is a no-op
+    EXPECT_NO_THROW(m_db->AddColumn(tableName, ColumnKey("Size", ColumnType::INTEGER)));
+
+    m_db->Insert(tableName,
+                 {ColumnValue("Name", ColumnType::TEXT, "New"), ColumnValue("Size", ColumnType::INTEGER, "3")});
+
+    const auto rows = m_db->Select(tableName,
+                                   {ColumnName("Name", ColumnType::TEXT), ColumnName("Size", ColumnType::INTEGER)},
+                                   {},
+                                   LogicalOperator::AND,
+                                   {ColumnName("Name", ColumnType::TEXT)});
+    ASSERT_EQ(rows.size(), 2);
+    EXPECT_EQ(rows[0][1].Value, "");
+    EXPECT_EQ(rows[1][1].Value, "3");
+}
+
 TEST_F(SQLiteManagerTest, RemoveTest)
 {
     AddTestData();
@@ -299,6 +359,34 @@ TEST_F(SQLiteManagerTest, RemoveTest)
     EXPECT_EQ(count, 0);
 }
 
+TEST_F(SQLiteManagerTest, RemoveRangeTest)
+{
+    AddTestData();
+
+    // Remove every record up to a given rowid in a single statement
+    EXPECT_NO_THROW(
+        m_db->Remove(m_tableName, {ColumnValue("Orden", ColumnType::INTEGER, "19", ComparisonOperator::LESS_EQUAL)}));
+    EXPECT_EQ(m_db->GetCount(m_tableName), 5);
+
+    const auto firstRow = m_db->Select(m_tableName,
+                                       {ColumnName("rowid", ColumnType::INTEGER)},
+                                       {},
+                                       LogicalOperator::AND,
+                                       {ColumnName("rowid", ColumnType::INTEGER)},
+                                       OrderType::ASC,
+                                       1);
+    ASSERT_EQ(firstRow.size(), 1);
+
+    const auto upperBound = std::to_string(std::stoll(firstRow[0][0].Value) + 2);
+    EXPECT_NO_THROW(m_db->Remove(
+        m_tableName, {ColumnValue("rowid", ColumnType::INTEGER, upperBound, ComparisonOperator::LESS_EQUAL)}));
+    EXPECT_EQ(m_db->GetCount(m_tableName), 2);
+
+    const auto ret = m_db->Select(
+        m_tableName, {}, {ColumnValue("Orden", ColumnType::INTEGER, "20", ComparisonOperator::GREATER_THAN)});
+    EXPECT_EQ(ret.size(), 1);
+}
+
 TEST_F(SQLiteManagerTest, UpdateTest)
 {
     AddTestData();
@@ -394,3 +482,52 @@ TEST_F(SQLiteManagerTest, DropTableTest)
 
     EXPECT_ANY_THROW(auto ret = m_db->Select("DropMe", {}, {}));
 }
+
+TEST_F(SQLiteManagerTest, ValuesAreBoundAsParameters)
+{
+    AddTestData();
+    const std::string name = "It's a name; DROP TABLE TestTable; --";
+
+    EXPECT_NO_THROW(m_db->Insert(m_tableName,
+                                 {ColumnValue("Name", ColumnType::TEXT, name),
+                                  ColumnValue("Status", ColumnType::TEXT, "Status with 'quotes'")}));
+
+    auto ret = m_db->Select(m_tableName,
+                            {ColumnName("Name", ColumnType::TEXT), ColumnName("Status", ColumnType::TEXT)},
+                            {ColumnValue("Name", ColumnType::TEXT, name)});
+    ASSERT_EQ(ret.size(), 1);
+    EXPECT_EQ(ret[0][0].Value, name);
+    EXPECT_EQ(ret[0][1].Value, "Status with 'quotes'");
+    EXPECT_TRUE(m_db->TableExists(m_tableName));
+
+    EXPECT_NO_THROW(m_db->Remove(m_tableName, {ColumnValue("Name", ColumnType::TEXT, name)}));
+    EXPECT_EQ(m_db->GetCount(m_tableName, {ColumnValue("Name", ColumnType::TEXT, name)}), 0);
+}
+
+TEST_F(SQLiteManagerTest, RepeatedQueriesUseTheirOwnValues)
+{
+    AddTestData();
+
+    EXPECT_EQ(m_db->GetCount(m_tableName, {ColumnValue("Orden", ColumnType::INTEGER, "19")}), 1);
+    EXPECT_EQ(m_db->GetCount(m_tableName, {ColumnValue("Orden", ColumnType::INTEGER, "21")}), 1);
+    EXPECT_EQ(m_db->GetCount(m_tableName, {ColumnValue("Orden", ColumnType::INTEGER, "20")}), 0);
+
+    auto ret = m_db->Select(m_tableName, {}, {ColumnValue("Amount", ColumnType::REAL, "3.5")});
+    ASSERT_EQ(ret.size(), 1);
+    ret = m_db->Select(m_tableName, {}, {ColumnValue("Amount", ColumnType::REAL, "2.8")});
+    ASSERT_EQ(ret.size(), 1);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        m_db->Update(m_tableName,
+                     {ColumnValue("Orden", ColumnType::INTEGER, std::to_string(100 + i))},
+                     {ColumnValue("Name", ColumnType::TEXT, "ItemName5")});
+        EXPECT_EQ(m_db->GetCount(m_tableName, {ColumnValue("Orden", ColumnType::INTEGER, std::to_string(100 + i))}),
+                  1);
+    }
+
+    ret = m_db->Select(m_tableName, {}, {}, LogicalOperator::AND, {}, OrderType::ASC, 2);
+    EXPECT_EQ(ret.size(), 2);
+    ret = m_db->Select(m_tableName, {}, {}, LogicalOperator::AND, {}, OrderType::ASC, 3);
+    EXPECT_EQ(ret.size(), 3);
+}
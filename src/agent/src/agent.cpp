@@ -118,24 +118,26 @@ void Agent::Run()
                               "FetchCommands");
 
     m_taskManager.EnqueueTask(m_communicator.StatefulMessageProcessingTask(
-                                  [this](const size_t numMessages)
+                                  [this](const size_t numMessages, const size_t skip)
                                   {
                                       return GetMessagesFromQueue(m_messageQueue,
                                                                   MessageType::STATEFUL,
                                                                   numMessages,
-                                                                  [this]() { return m_agentInfo.GetMetadataInfo(); });
+                                                                  [this]() { return m_agentInfo.GetMetadataInfo(); },
+                                                                  skip);
                                   },
                                   [this]([[maybe_unused]] const int messageCount, const std::string&)
                                   { PopMessagesFromQueue(m_messageQueue, MessageType::STATEFUL, messageCount); }),
                               "Stateful");
 
     m_taskManager.EnqueueTask(m_communicator.StatelessMessageProcessingTask(
-                                  [this](const size_t numMessages)
+                                  [this](const size_t numMessages, const size_t skip)
                                   {
                                       return GetMessagesFromQueue(m_messageQueue,
                                                                   MessageType::STATELESS,
                                                                   numMessages,
-                                                                  [this]() { return m_agentInfo.GetMetadataInfo(); });
+                                                                  [this]() { return m_agentInfo.GetMetadataInfo(); },
+                                                                  skip);
                                   },
                                   [this]([[maybe_unused]] const int messageCount, const std::string&)
                                   { PopMessagesFromQueue(m_messageQueue, MessageType::STATELESS, messageCount); }),
@@ -1,13 +1,16 @@
 #include <imultitype_queue.hpp>
 #include <message_queue_utils.hpp>
 
+#include <algorithm>
+#include <string_view>
 #include <vector>
 
 boost::asio::awaitable<std::tuple<int, std::string>>
 GetMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue,
                      MessageType messageType,
                      const size_t messagesSize,
-                     std::function<std::string()> getMetadataInfo)
+                     std::function<std::string()> getMetadataInfo,
+                     const size_t skip)
 {
     std::string output;
 
@@ -16,14 +19,38 @@ GetMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue,
         output = getMetadataInfo();
     }
 
-    const auto messages = co_await multiTypeQueue->getNextBytesAwaitable(messageType, messagesSize, "", "");
-    for (const auto& message : messages)
-    {
-        output += (message.metaData.empty() ? "" : "\n" + message.metaData) +
-                  (message.data.dump() == "{}" ? "" : "\n" + message.data.dump());
-    }
+    auto reserved = false;
 
-    co_return std::tuple<int, std::string> {static_cast<int>(messages.size()), output};
+    const auto count = co_await multiTypeQueue->getNextBytesRawAwaitable(
+        messageType,
+        messagesSize,
+        [&output, &reserved, &multiTypeQueue, messageType, messagesSize](std::string_view metadata,
+                                                                          std::string_view data)
+        {
+            if (!reserved)
+            {
+                // Stored events are appended as they are, so the body is sized once the wait for them is over, from
+                // what the queue holds. That is usually far below the size limit.
+                output.reserve(output.size() + std::min(messagesSize, multiTypeQueue->sizePerType(messageType)));
+                reserved = true;
+            }
+
+            if (!metadata.empty())
+            {
+                output += '\n';
+                output += metadata;
+            }
+            if (data != "{}")
+            {
+                output += '\n';
+                output += data;
+            }
+        },
+        "",
+        "",
+        skip);
+
+    co_return std::tuple<int, std::string> {count, std::move(output)};
 }
 
 void PopMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue, MessageType messageType, int numMessages)
@@ -18,12 +18,14 @@ class IMultiTypeQueue;
 /// @param messageType The type of messages to get from the queue
 /// @param messagesSize Minimum size of messages in bytes to get from the queue
 /// @param getMetadataInfo Function to get the agent metadata
+/// @param skip Number of messages at the head of the queue already being sent, which are left out
 /// @return A string containing the messages from the queue
 boost::asio::awaitable<std::tuple<int, std::string>>
 GetMessagesFromQueue(std::shared_ptr<IMultiTypeQueue> multiTypeQueue,
                      MessageType messageType,
                      const size_t messagesSize,
-                     std::function<std::string()> getMetadataInfo);
+                     std::function<std::string()> getMetadataInfo,
+                     const size_t skip = 0);
 
 /// @brief Removes a fixed number of messages from the specified queue
 /// @param multiTypeQueue The queue from which to remove messages
@@ -12,6 +12,13 @@
 const nlohmann::json BASE_DATA_CONTENT =
     R"({"document_id":"112233", "action":{"name":"command_test","args":{"parameters":["parameters_test"]}}})"_json;
 
+/// @brief Stands for a queue holding a single stored message
+boost::asio::awaitable<int> ReplayRawMessage(RawMessageCallback onMessage, std::string metadata, std::string data)
+{
+    onMessage(metadata, data);
+    co_return 1;
+}
+
 class MessageQueueUtilsTest : public ::testing::Test
 {
 protected:
@@ -28,15 +35,13 @@ protected:
 
 TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueTestBySize)
 {
-    const std::vector<std::string> data {R"({"event":{"original":"Testing message!"}})"};
+    const std::string data {R"({"event":{"original":"Testing message!"}})"};
     const std::string metadata {R"({"module":"logcollector","type":"file"})"};
-    std::vector<Message> testMessages;
-    testMessages.emplace_back(MessageType::STATELESS, data, "", "", metadata);
 
-    // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-    EXPECT_CALL(*mockQueue, getNextBytesAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, "", ""))
-        .WillOnce([&testMessages]() -> boost::asio::awaitable<std::vector<Message>> { co_return testMessages; });
-    // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue,
+                getNextBytesRawAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, testing::_, "", "", 0))
+        .WillOnce([&data, &metadata](auto, auto, RawMessageCallback onMessage, auto, auto, auto)
+                  { return ReplayRawMessage(std::move(onMessage), metadata, data); });
 
     auto awaitableResult =
         boost::asio::co_spawn(io_context,
@@ -52,25 +57,24 @@ TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueTestBySize)
     const auto jsonResult = std::get<1>(result);
 
     const std::string expectedString = std::string("\n") + R"({"module":"logcollector","type":"file"})" +
-                                       std::string("\n") + R"(["{\"event\":{\"original\":\"Testing message!\"}}"])";
+                                       std::string("\n") + R"({"event":{"original":"Testing message!"}})";
 
+    ASSERT_EQ(std::get<0>(result), 1);
     ASSERT_EQ(jsonResult, expectedString);
 }
 
 TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueMetadataTest)
 {
-    const std::vector<std::string> data {R"({"event":{"original":"Testing message!"}})"};
+    const std::string data {R"({"event":{"original":"Testing message!"}})"};
     const std::string moduleMetadata {R"({"module":"logcollector","type":"file"})"};
-    std::vector<Message> testMessages;
-    testMessages.emplace_back(MessageType::STATELESS, data, "", "", moduleMetadata);
 
     nlohmann::json metadata;
     metadata["agent"] = "test";
 
-    // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-    EXPECT_CALL(*mockQueue, getNextBytesAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, "", ""))
-        .WillOnce([&testMessages]() -> boost::asio::awaitable<std::vector<Message>> { co_return testMessages; });
-    // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue,
+                getNextBytesRawAwaitable(MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, testing::_, "", "", 0))
+        .WillOnce([&data, &moduleMetadata](auto, auto, RawMessageCallback onMessage, auto, auto, auto)
+                  { return ReplayRawMessage(std::move(onMessage), moduleMetadata, data); });
 
     io_context.restart();
 
@@ -90,25 +94,23 @@ TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueMetadataTest)
 
     const std::string expectedString = R"({"agent":"test"})" + std::string("\n") +
                                        R"({"module":"logcollector","type":"file"})" + std::string("\n") +
-                                       R"(["{\"event\":{\"original\":\"Testing message!\"}}"])";
+                                       R"({"event":{"original":"Testing message!"}})";
 
     ASSERT_EQ(jsonResult, expectedString);
 }
 
 TEST_F(MessageQueueUtilsTest, GetEmptyMessagesFromQueueTest)
 {
-    const nlohmann::json data = nlohmann::json::object();
+    const std::string data = nlohmann::json::object().dump();
     const std::string moduleMetadata {R"({"operation":"delete"})"};
-    std::vector<Message> testMessages;
-    testMessages.emplace_back(MessageType::STATEFUL, data, "", "", moduleMetadata);
 
     nlohmann::json metadata;
     metadata["agent"] = "test";
 
-    // NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-    EXPECT_CALL(*mockQueue, getNextBytesAwaitable(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, "", ""))
-        .WillOnce([&testMessages]() -> boost::asio::awaitable<std::vector<Message>> { co_return testMessages; });
-    // NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    EXPECT_CALL(*mockQueue,
+                getNextBytesRawAwaitable(MessageType::STATEFUL, MIN_SIZE_OF_MESSAGES, testing::_, "", "", 0))
+        .WillOnce([&data, &moduleMetadata](auto, auto, RawMessageCallback onMessage, auto, auto, auto)
+                  { return ReplayRawMessage(std::move(onMessage), moduleMetadata, data); });
 
     io_context.restart();
 
@@ -131,6 +133,62 @@ TEST_F(MessageQueueUtilsTest, GetEmptyMessagesFromQueueTest)
     ASSERT_EQ(jsonResult, expectedString);
 }
 
+TEST_F(MessageQueueUtilsTest, GetMessagesFromQueuePassesSkip)
+{
+    const std::string data {R"({"event":{"original":"Testing message!"}})"};
+    const std::string metadata {R"({"module":"logcollector","type":"file"})"};
+    const size_t messagesInFlight = 5;
+
+    EXPECT_CALL(*mockQueue,
+                getNextBytesRawAwaitable(
+                    MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, testing::_, "", "", messagesInFlight))
+        .WillOnce([&data, &metadata](auto, auto, RawMessageCallback onMessage, auto, auto, auto)
+                  { return ReplayRawMessage(std::move(onMessage), metadata, data); });
+
+    io_context.restart();
+
+    auto awaitableResult = boost::asio::co_spawn(
+        io_context,
+        GetMessagesFromQueue(mockQueue, MessageType::STATELESS, MIN_SIZE_OF_MESSAGES, nullptr, messagesInFlight),
+        boost::asio::use_future);
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+    io_context.run_until(timeout);
+
+    ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
+
+    EXPECT_EQ(std::get<0>(awaitableResult.get()), 1);
+}
+
+TEST_F(MessageQueueUtilsTest, GetMessagesFromQueueReservesTheStoredSize)
+{
+    const std::string data {R"({"event":{"original":"Testing message!"}})"};
+    const std::string metadata {R"({"module":"logcollector","type":"file"})"};
+    const size_t maxSize = 100000000;
+    const size_t storedSize = 100;
+
+    EXPECT_CALL(*mockQueue, getNextBytesRawAwaitable(MessageType::STATELESS, maxSize, testing::_, "", "", 0))
+        .WillOnce([&data, &metadata](auto, auto, RawMessageCallback onMessage, auto, auto, auto)
+                  { return ReplayRawMessage(std::move(onMessage), metadata, data); });
+    EXPECT_CALL(*mockQueue, sizePerType(MessageType::STATELESS)).WillOnce(testing::Return(storedSize));
+
+    io_context.restart();
+
+    auto awaitableResult = boost::asio::co_spawn(
+        io_context, GetMessagesFromQueue(mockQueue, MessageType::STATELESS, maxSize, nullptr), boost::asio::use_future);
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+    io_context.run_until(timeout);
+
+    ASSERT_TRUE(awaitableResult.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready);
+
+    const auto result = awaitableResult.get();
+
+    // The body is sized from the stored messages, not from the size limit
+    EXPECT_EQ(std::get<0>(result), 1);
+    EXPECT_LT(std::get<1>(result).capacity(), maxSize);
+}
+
 TEST_F(MessageQueueUtilsTest, PopMessagesFromQueueTest)
 {
     EXPECT_CALL(*mockQueue, popN(MessageType::STATEFUL, 1, "", "")).Times(1);
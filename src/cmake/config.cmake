@@ -18,6 +18,11 @@ set(DEFAULT_SERVER_URL "https://localhost:27000" CACHE STRING "Default Defendx A
 set(DEFAULT_RETRY_INTERVAL "\"30000ms\"" CACHE STRING "Default Defendx Agent retry interval (30s)")
 set(DEFAULT_BATCH_INTERVAL "\"10000ms\"" CACHE STRING "Default Defendx Agent batch interval (10s)")
 set(DEFAULT_BATCH_SIZE "\"1000000B\"" CACHE STRING "Default Defendx Agent batch size limit (1MB)")
+set(DEFAULT_COMPRESSION "none" CACHE STRING "Default Defendx Agent batch compression")
+set(DEFAULT_COMPRESSION_LEVEL 6 CACHE STRING "Default Defendx Agent batch compression level (6)")
+set(DEFAULT_COMPRESSION_MIN_SIZE "\"1024B\"" CACHE STRING "Default Defendx Agent batch compression minimum size (1KB)")
+
+set(DEFAULT_MAX_INFLIGHT_BATCHES 1 CACHE STRING "Default Defendx Agent maximum number of batches sent at once (1)")
 
 set(DEFAULT_VERIFICATION_MODE "none" CACHE STRING "Default Defendx Agent verification mode")
 
@@ -25,6 +30,11 @@ set(DEFAULT_LOGCOLLECTOR_ENABLED true CACHE BOOL "Default Logcollector enabled")
 set(BUFFER_SIZE 4096 CACHE STRING "Default Logcollector reading buffer size")
 set(DEFAULT_FILE_WAIT "\"500ms\"" CACHE STRING "Default Logcollector file reading interval (500ms)")
 set(DEFAULT_RELOAD_INTERVAL "\"60000ms\"" CACHE STRING "Default Logcollector reload interval (1m)")
+set(DEFAULT_WATCH_FILES true CACHE BOOL "Default Logcollector file watching enabled")
+set(DEFAULT_LOGCOLLECTOR_BATCH_EVENTS 100 CACHE STRING "Default Logcollector maximum number of events pushed at once (100)")
+set(DEFAULT_LOGCOLLECTOR_BATCH_SIZE "\"64KB\"" CACHE STRING "Default Logcollector maximum size of the events pushed at once (64KB)")
+set(DEFAULT_LOGCOLLECTOR_BATCH_INTERVAL "\"100ms\"" CACHE STRING "Default Logcollector maximum time events wait to be pushed (100ms)")
+set(DEFAULT_CHECKPOINT_INTERVAL "\"5s\"" CACHE STRING "Default Logcollector file reading positions saving interval (5s)")
 
 set(DEFAULT_INVENTORY_ENABLED true CACHE BOOL "Default inventory enabled")
 set(DEFAULT_INTERVAL "\"3600000ms\"" CACHE STRING "Default inventory interval (1h)")
@@ -41,4 +51,5 @@ set(DEFAULT_HOTFIXES true CACHE BOOL "Default inventory hotfixes")
 
 set(QUEUE_STATUS_REFRESH_TIMER 100 CACHE STRING "Default Defendx Agent queue refresh timer (100ms)")
 set(QUEUE_DEFAULT_SIZE "\"10000B\"" CACHE STRING "Default Defendx Agent queue size (10000)")
+set(QUEUE_DEFAULT_BACKEND "sqlite" CACHE STRING "Default Defendx Agent queue storage backend (sqlite)")
 set(DEFAULT_COMMANDS_REQUEST_TIMEOUT "\"11m\"" CACHE STRING "Default Defendx Agent command request timeout (11m)")
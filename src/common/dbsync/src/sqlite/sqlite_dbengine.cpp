@@ -26,7 +26,8 @@ SQLiteDBEngine::SQLiteDBEngine(const std::shared_ptr<ISQLiteFactory>& sqliteFact
                                const std::string&                     tableStmtCreation,
                                const DbManagement                     dbManagement,
                                const std::vector<std::string>&        upgradeStatements)
-    : m_sqliteFactory(sqliteFactory)
+    : m_statementsCacheStats {}
+    , m_sqliteFactory(sqliteFactory)
 {
     initialize(path, tableStmtCreation, dbManagement, upgradeStatements);
 }
@@ -34,6 +35,7 @@ SQLiteDBEngine::SQLiteDBEngine(const std::shared_ptr<ISQLiteFactory>& sqliteFact
 SQLiteDBEngine::~SQLiteDBEngine()
 {
     std::lock_guard<std::mutex> lock(m_stmtMutex);
+    m_statementsIndex.clear();
     m_statementsCache.clear();
 
     if (m_transaction)
@@ -139,6 +141,12 @@ void SQLiteDBEngine::refreshTableData(const nlohmann::json& data,
                     std::cout << "Error during the insert rows update " << __LINE__ << " - " << __FILE__ << std::endl;
                     // LCOV_EXCL_STOP
                 }
+
+                // The rows changed by the snapshot no longer match their digest
+                if (getRowHashIndex(table).has_value())
+                {
+                    m_sqliteConnection->execute(std::string("UPDATE ") + table + " SET " + ROW_HASH_FIELD_NAME + "=NULL;");
+                }
             }
         }
         // LCOV_EXCL_START
@@ -225,56 +233,153 @@ void SQLiteDBEngine::syncTableRowData(const nlohmann::json& jsInput,
     {
         if (getPrimaryKeysFromTable(table, primaryKeyList))
         {
-            for (const auto& entry : data)
+            const auto rowHashIndex { getRowHashIndex(table) };
+            const auto tableFields { rowHashIndex.has_value() ? m_tableFields[table] : TableColumns{} };
+            const auto syncEntry
             {
-                nlohmann::json updated;
-                nlohmann::json oldData;
-                const bool diffExist { getRowDiff(primaryKeyList, ignoredColumns, table, entry, updated, oldData) };
-
-                if (diffExist)
+                [&](const nlohmann::json & entry,
+                    const bool diffExist,
+                    const nlohmann::json & updated,
+                    const nlohmann::json & oldData,
+                    const std::optional<int64_t>& rowHash)
                 {
-                    const auto& jsDataToUpdate{getDataToUpdate(primaryKeyList, updated, entry, inTransaction)};
-
-                    if (!jsDataToUpdate.empty())
+                    if (diffExist)
                     {
-                        updateSingleRow(table, jsDataToUpdate);
+                        auto jsDataToUpdate = getDataToUpdate(primaryKeyList, updated, entry, inTransaction);
 
-                        if (callback && !updated.empty())
+                        // The stored digest is outdated, even if no field changed
+                        if (rowHash.has_value())
                         {
+                            for (const auto& pKey : primaryKeyList)
+                            {
+                                jsDataToUpdate[pKey] = entry.at(pKey);
+                            }
+
+                            jsDataToUpdate[ROW_HASH_FIELD_NAME] = rowHash.value();
+                        }
 
-                            lock.unlock();
+                        if (!jsDataToUpdate.empty())
+                        {
+                            updateSingleRow(table, jsDataToUpdate);
 
-                            if (returnOldData)
+                            if (callback && !updated.empty())
                             {
-                                nlohmann::json diff;
-                                diff["old"] = oldData;
-                                diff["new"] = updated;
-                                callback(MODIFIED, diff);
+
+                                lock.unlock();
+
+                                if (returnOldData)
+                                {
+                                    nlohmann::json diff;
+                                    diff["old"] = oldData;
+                                    diff["new"] = updated;
+                                    callback(MODIFIED, diff);
+                                }
+                                else
+                                {
+                                    callback(MODIFIED, updated);
+                                }
+
+                                lock.lock();
                             }
-                            else
+                        }
+                    }
+                    else
+                    {
+                        nlohmann::json element;
+
+                        if (rowHash.has_value())
+                        {
+                            element = entry;
+                            element[ROW_HASH_FIELD_NAME] = rowHash.value();
+                        }
+
+                        insertElement(table, m_tableFields[table], rowHash.has_value() ? element : entry,
+                                      [&]()
+                        {
+                            // LCOV_EXCL_START
+                            if (callback)
                             {
-                                callback(MODIFIED, updated);
+                                lock.unlock();
+                                callback(INSERTED, entry);
+                                lock.lock();
                             }
 
-                            lock.lock();
-                        }
+                            // LCOV_EXCL_STOP
+                        });
                     }
                 }
-                else
+            };
+
+            std::vector<int64_t> rowHashes;
+
+            if (rowHashIndex.has_value() && data.is_array())
+            {
+                rowHashes.reserve(data.size());
+
+                for (const auto& entry : data)
                 {
-                    insertElement(table, m_tableFields[table], entry,
-                                  [&]()
+                    rowHashes.push_back(getRowHash(tableFields, entry, ignoredColumns));
+                }
+            }
+
+            std::vector<std::optional<Row>> currentRows;
+
+            if (getRowsMatchingPKs(table, primaryKeyList, data, inTransaction, rowHashIndex, rowHashes, currentRows))
+            {
+                // The rows were looked up all at once, the diff of each one is done in memory
+                for (size_t i = 0; i < currentRows.size(); ++i)
+                {
+                    const auto& entry { data.at(i) };
+                    const auto& currentRow { currentRows.at(i) };
+                    std::optional<int64_t> rowHash;
+                    nlohmann::json updated;
+                    nlohmann::json oldData;
+
+                    if (!rowHashes.empty())
                     {
-                        // LCOV_EXCL_START
-                        if (callback)
+                        rowHash = rowHashes.at(i);
+                    }
+
+                    if (currentRow.has_value())
+                    {
+                        // An empty row matched the stored digest, so it has no changes. The ignored columns are left as
+                        // stored, as the field by field diff never refreshes them either unless another column changed.
+                        if (currentRow->empty())
                         {
-                            lock.unlock();
-                            callback(INSERTED, entry);
-                            lock.lock();
+                            rowHash.reset();
                         }
 
-                        // LCOV_EXCL_STOP
-                    });
+                        fillRowDiff(primaryKeyList, ignoredColumns, entry, currentRow.value(), updated, oldData);
+
+                        // The status field of the unchanged rows was already updated during the lookup
+                        if (inTransaction && updated.empty() && !rowHash.has_value())
+                        {
+                            continue;
+                        }
+                    }
+
+                    syncEntry(entry, currentRow.has_value(), updated, oldData, rowHash);
+                }
+            }
+            else
+            {
+                for (const auto& entry : data)
+                {
+                    std::optional<int64_t> rowHash;
+                    nlohmann::json updated;
+                    nlohmann::json oldData;
+
+                    if (rowHashIndex.has_value())
+                    {
+                        rowHash = getRowHash(tableFields, entry, ignoredColumns);
+                    }
+
+                    const bool diffExist
+                    {
+                        getRowDiff(primaryKeyList, ignoredColumns, table, entry, rowHashIndex, rowHash, updated, oldData)
+                    };
+
+                    syncEntry(entry, diffExist, updated, oldData, rowHash);
                 }
             }
         }
@@ -399,6 +504,7 @@ void SQLiteDBEngine::returnRowsMarkedForDelete(const nlohmann::json& tableNames,
 
                 for (const auto& field : tableFields)
                 {
+                    // Internal columns are not selected, so they take no index
                     if (!std::get<TableHeader::TXNStatusField>(field))
                     {
                         getTableData(stmt,
@@ -406,9 +512,8 @@ void SQLiteDBEngine::returnRowsMarkedForDelete(const nlohmann::json& tableNames,
                                      std::get<TableHeader::Type>(field),
                                      std::get<TableHeader::Name>(field),
                                      registerFields);
+                        ++index;
                     }
-
-                    ++index;
                 }
 
                 nlohmann::json object {};
@@ -448,7 +553,8 @@ void SQLiteDBEngine::selectData(const std::string& table,
                 const auto& column{ stmt->column(i) };
                 const auto& name{ column->name() };
 
-                if (column->hasValue() && name != STATUS_FIELD_NAME)
+                if (column->hasValue() &&
+                        InternalColumnNames.end() == std::find(InternalColumnNames.begin(), InternalColumnNames.end(), name))
                 {
                     switch (column->type())
                     {
@@ -664,7 +770,21 @@ void SQLiteDBEngine::insertElement(const std::string& table,
                                    const nlohmann::json& element,
                                    const std::function<void()> callback)
 {
-    const auto stmt { getStatement(buildInsertDataSqlQuery(table, element)) };
+    // The statement depends on which columns the element has, so they identify it along with the table
+    std::string queryId { "#insert:" + table + ":" };
+
+    for (const auto& field : tableFieldsMetaData)
+    {
+        queryId.push_back(element.empty() || element.contains(std::get<TableHeader::Name>(field)) ? '1' : '0');
+    }
+
+    const auto stmt
+    {
+        getStatement(queryId, [&]()
+        {
+            return buildInsertDataSqlQuery(table, element);
+        })
+    };
     int32_t index { 1l };
 
     for (const auto& field : tableFieldsMetaData)
@@ -1405,20 +1525,23 @@ bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
                                 const nlohmann::json& ignoredColumns,
                                 const std::string& table,
                                 const nlohmann::json& data,
+                                const std::optional<int32_t>& rowHashIndex,
+                                std::optional<int64_t>& rowHash,
                                 nlohmann::json& updatedData,
                                 nlohmann::json& oldData)
 {
     bool diffExist { false };
-    bool isModified { false };
     const auto stmt
     {
-        getStatement(buildSelectMatchingPKsSqlQuery(table, primaryKeyList))
+        getStatement("#select_pk:" + table, [&]()
+        {
+            return buildSelectMatchingPKsSqlQuery(table, primaryKeyList);
+        })
     };
 
     const auto& tableFields { m_tableFields[table] };
     int32_t index { 1l };
 
-    // Always include primary keys
     for (const auto& pkValue : primaryKeyList)
     {
         const auto& it
@@ -1432,8 +1555,6 @@ bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
 
         if (it != tableFields.end())
         {
-            updatedData[pkValue] = data.at(pkValue);
-            oldData[pkValue] = data.at(pkValue);
             bindJsonData(stmt, *it, data, index);
             ++index;
         }
@@ -1441,7 +1562,16 @@ bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
 
     diffExist = SQLITE_ROW == stmt->step();
 
-    if (diffExist)
+    // The row is unchanged if it matches the stored digest, there is no need to compare it
+    if (diffExist && rowHashIndex.has_value() && rowHash.has_value() &&
+            stmt->column(rowHashIndex.value())->hasValue() &&
+            stmt->column(rowHashIndex.value())->value(int64_t{}) == rowHash.value())
+    {
+        rowHash.reset();
+        updatedData.clear();
+        oldData.clear();
+    }
+    else if (diffExist)
     {
         // The row exists, so let's generate the diff
         Row registryFields;
@@ -1455,29 +1585,55 @@ bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
                          registryFields);
         }
 
-        if (!registryFields.empty())
+        fillRowDiff(primaryKeyList, ignoredColumns, data, registryFields, updatedData, oldData);
+    }
+    else
+    {
+        updatedData.clear();
+        oldData.clear();
+    }
+
+    return diffExist;
+}
+
+void SQLiteDBEngine::fillRowDiff(const std::vector<std::string>& primaryKeyList,
+                                 const nlohmann::json& ignoredColumns,
+                                 const nlohmann::json& data,
+                                 const Row& registryFields,
+                                 nlohmann::json& updatedData,
+                                 nlohmann::json& oldData)
+{
+    bool isModified { false };
+
+    // Always include primary keys
+    for (const auto& pkValue : primaryKeyList)
+    {
+        updatedData[pkValue] = data.at(pkValue);
+        oldData[pkValue] = data.at(pkValue);
+    }
+
+    if (!registryFields.empty())
+    {
+        for (const auto& value : registryFields)
         {
-            for (const auto& value : registryFields)
+            nlohmann::json object;
+            getFieldValueFromTuple(value, object);
+            const auto& it
             {
-                nlohmann::json object;
-                getFieldValueFromTuple(value, object);
-                const auto& it
-                {
-                    data.find(value.first)
-                };
+                data.find(value.first)
+            };
 
-                if (data.end() != it)
+            if (data.end() != it)
+            {
+                // Only compare if not in ignore set
+                if (*it != object.at(value.first))
                 {
-                    // Only compare if not in ignore set
-                    if (*it != object.at(value.first))
-                    {
-                        // Diff found
-                        isModified = true;
-                        oldData[value.first] = object[value.first];
-                    }
-
-                    updatedData[value.first] = *it;
+                    // Diff found
+                    isModified = true;
+                    oldData[value.first] = object[value.first];
                 }
+
+                updatedData[value.first] = *it;
             }
         }
     }
@@ -1523,8 +1679,299 @@ bool SQLiteDBEngine::getRowDiff(const std::vector<std::string>& primaryKeyList,
             }
         }
     }
+}
 
-    return diffExist;
+std::optional<int32_t> SQLiteDBEngine::getRowHashIndex(const std::string& table)
+{
+    const auto& tableFields { m_tableFields[table] };
+    const auto it
+    {
+        std::find_if(tableFields.begin(), tableFields.end(),
+                     [](const ColumnData & column)
+        {
+            return 0 == std::get<TableHeader::Name>(column).compare(ROW_HASH_FIELD_NAME);
+        })
+    };
+
+    return tableFields.end() != it ? std::optional<int32_t> { std::get<TableHeader::CID>(*it) } : std::nullopt;
+}
+
+int64_t SQLiteDBEngine::getRowHash(const TableColumns& fields,
+                                   const nlohmann::json& data,
+                                   const nlohmann::json& ignoredColumns)
+{
+    // FNV-1a over the stored columns in table order, leaving out the ignored and internal ones. Fields of the input
+    // that are not columns of the table are never stored nor compared, so they must not change the digest either.
+    constexpr uint64_t FNV_OFFSET_BASIS { 14695981039346656037ull };
+    constexpr uint64_t FNV_PRIME { 1099511628211ull };
+    uint64_t hash { FNV_OFFSET_BASIS };
+
+    const auto hashBytes
+    {
+        [&hash](const void* bytes, const size_t size)
+        {
+            const auto* it { static_cast<const unsigned char*>(bytes) };
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= it[i];
+                hash *= FNV_PRIME;
+            }
+        }
+    };
+
+    for (const auto& field : fields)
+    {
+        const auto& key { std::get<TableHeader::Name>(field) };
+
+        if (std::get<TableHeader::TXNStatusField>(field) ||
+                std::find(ignoredColumns.begin(), ignoredColumns.end(), key) != ignoredColumns.end())
+        {
+            continue;
+        }
+
+        const auto it { data.find(key) };
+
+        if (data.end() == it)
+        {
+            continue;
+        }
+
+        const auto& value { *it };
+        const auto type { static_cast<uint8_t>(value.type()) };
+
+        // The name and type are hashed along with the value, so that no two different rows share their bytes
+        hashBytes(key.c_str(), key.size() + 1);
+        hashBytes(&type, sizeof(type));
+
+        if (value.is_string())
+        {
+            const auto& text { value.get_ref<const std::string&>() };
+            const auto size { text.size() };
+            hashBytes(&size, sizeof(size));
+            hashBytes(text.data(), size);
+        }
+        else if (value.is_number_unsigned())
+        {
+            const auto number { value.get<uint64_t>() };
+            hashBytes(&number, sizeof(number));
+        }
+        else if (value.is_number_integer())
+        {
+            const auto number { value.get<int64_t>() };
+            hashBytes(&number, sizeof(number));
+        }
+        else if (value.is_number_float())
+        {
+            const auto number { value.get<double>() };
+            hashBytes(&number, sizeof(number));
+        }
+        else if (value.is_boolean())
+        {
+            const uint8_t boolean { value.get<bool>() };
+            hashBytes(&boolean, sizeof(boolean));
+        }
+        else if (!value.is_null())
+        {
+            const auto text { value.dump() };
+            const auto size { text.size() };
+            hashBytes(&size, sizeof(size));
+            hashBytes(text.data(), size);
+        }
+    }
+
+    return static_cast<int64_t>(hash);
+}
+
+bool SQLiteDBEngine::getRowsMatchingPKs(const std::string& table,
+                                        const std::vector<std::string>& primaryKeyList,
+                                        const nlohmann::json& data,
+                                        const bool inTransaction,
+                                        const std::optional<int32_t>& rowHashIndex,
+                                        const std::vector<int64_t>& rowHashes,
+                                        std::vector<std::optional<Row>>& currentRows)
+{
+    if (!data.is_array() || data.size() < BULK_SYNC_MIN_ROWS || primaryKeyList.empty())
+    {
+        return false;
+    }
+
+    const auto& tableFields { m_tableFields[table] };
+    std::vector<ColumnData> primaryKeyFields;
+
+    for (const auto& pkValue : primaryKeyList)
+    {
+        const auto it
+        {
+            std::find_if(tableFields.begin(), tableFields.end(),
+                         [&pkValue](const ColumnData & column)
+            {
+                return 0 == std::get<TableHeader::Name>(column).compare(pkValue);
+            })
+        };
+
+        if (tableFields.end() == it)
+        {
+            return false;
+        }
+
+        primaryKeyFields.push_back(*it);
+    }
+
+    // Rows without all their primary keys are left to the row by row sync, which reports the error.
+    const auto hasPrimaryKeys
+    {
+        [&primaryKeyList](const nlohmann::json & entry)
+        {
+            return entry.is_object() &&
+                   std::all_of(primaryKeyList.begin(),
+                               primaryKeyList.end(),
+                               [&entry](const std::string & pKey)
+            {
+                const auto it { entry.find(pKey) };
+                return entry.end() != it && !it->is_null();
+            });
+        }
+    };
+
+    if (!std::all_of(data.begin(), data.end(), hasPrimaryKeys))
+    {
+        return false;
+    }
+
+    // The primary keys of the input rows are staged in a temporary table, in the same order, to be matched
+    // against the table with a single join.
+    std::lock_guard<std::mutex> lock(m_stagingMutex);
+    const auto stagingTable { table + SYNC_TABLE_SUBFIX };
+    std::string pkFields;
+    std::string binds;
+    std::string onMatchList;
+
+    for (const auto& pkValue : primaryKeyList)
+    {
+        pkFields.append(pkValue + ",");
+        binds.append("?,");
+        onMatchList.append("s." + pkValue + "=t." + pkValue + " AND ");
+    }
+
+    pkFields = pkFields.substr(0, pkFields.size() - 1);
+    binds = binds.substr(0, binds.size() - 1);
+    onMatchList = onMatchList.substr(0, onMatchList.size() - 5);
+
+    m_sqliteConnection->execute("CREATE TEMP TABLE IF NOT EXISTS " + stagingTable + " AS SELECT " + pkFields +
+                                " FROM " + table + " WHERE 0;");
+    m_sqliteConnection->execute("DELETE FROM " + stagingTable + ";");
+
+    const auto stmtStage { getStatement("INSERT INTO " + stagingTable + " (" + pkFields + ") VALUES (" + binds + ");") };
+
+    for (const auto& entry : data)
+    {
+        int32_t index { 1l };
+
+        for (const auto& field : primaryKeyFields)
+        {
+            bindJsonData(stmtStage, field, entry, index);
+            ++index;
+        }
+
+        // LCOV_EXCL_START
+        if (SQLITE_ERROR == stmtStage->step())
+        {
+            throw dbengine_error{ BIND_FIELDS_DOES_NOT_MATCH };
+        }
+
+        // LCOV_EXCL_STOP
+        stmtStage->reset();
+    }
+
+    // A row repeated in the input depends on the changes made by the previous one, so it must be synced row by row.
+    const auto stmtRepeated
+    {
+        getStatement("SELECT 1 FROM " + stagingTable + " GROUP BY " + pkFields + " HAVING COUNT(*) > 1 LIMIT 1;")
+    };
+
+    if (SQLITE_ROW == stmtRepeated->step())
+    {
+        return false;
+    }
+
+    const auto stmt
+    {
+        getStatement("SELECT t.* FROM " + stagingTable + " s LEFT JOIN " + table + " t ON " + onMatchList +
+                     " ORDER BY s.rowid;")
+    };
+    const auto pkIndex { std::get<TableHeader::CID>(primaryKeyFields.front()) };
+
+    currentRows.clear();
+    currentRows.reserve(data.size());
+
+    // All the rows are read before any callback releases the lock. The rows matching their stored digest are
+    // left empty, as they have no changes.
+    while (SQLITE_ROW == stmt->step())
+    {
+        const auto index { currentRows.size() };
+
+        if (stmt->column(pkIndex)->hasValue() && rowHashIndex.has_value() && index < rowHashes.size() &&
+                stmt->column(rowHashIndex.value())->hasValue() &&
+                stmt->column(rowHashIndex.value())->value(int64_t{}) == rowHashes.at(index))
+        {
+            currentRows.push_back(Row {});
+        }
+        else if (stmt->column(pkIndex)->hasValue())
+        {
+            Row registryFields;
+
+            for (const auto& field : tableFields)
+            {
+                getTableData(stmt,
+                             std::get<TableHeader::CID>(field),
+                             std::get<TableHeader::Type>(field),
+                             std::get<TableHeader::Name>(field),
+                             registryFields);
+            }
+
+            currentRows.push_back(std::move(registryFields));
+        }
+        else
+        {
+            currentRows.push_back(std::nullopt);
+        }
+    }
+
+    // Keeps the existing rows from being deleted when the transaction is closed
+    if (inTransaction)
+    {
+        updateStagedRowsStatusField(table, primaryKeyList);
+    }
+
+    return true;
+}
+
+void SQLiteDBEngine::updateStagedRowsStatusField(const std::string& table,
+                                                 const std::vector<std::string>& primaryKeyList)
+{
+    std::string onMatchList;
+
+    for (const auto& pkValue : primaryKeyList)
+    {
+        onMatchList.append("s." + pkValue + "=" + table + "." + pkValue + " AND ");
+    }
+
+    onMatchList = onMatchList.substr(0, onMatchList.size() - 5);
+
+    const auto stmt
+    {
+        getStatement("UPDATE " + table + " SET " + STATUS_FIELD_NAME + "=1 WHERE EXISTS (SELECT 1 FROM " + table +
+                     SYNC_TABLE_SUBFIX + " s WHERE " + onMatchList + ");")
+    };
+
+    // LCOV_EXCL_START
+    if (SQLITE_ERROR == stmt->step())
+    {
+        throw dbengine_error{ STEP_ERROR_UPDATE_STATUS_FIELD };
+    }
+
+    // LCOV_EXCL_STOP
 }
 
 bool SQLiteDBEngine::insertNewRows(const std::string& table,
@@ -2054,35 +2501,49 @@ void SQLiteDBEngine::getFieldValueFromTuple(const Field& value,
 
 std::shared_ptr<SQLiteLegacy::IStatement>const SQLiteDBEngine::getStatement(const std::string& sql)
 {
-    std::lock_guard<std::mutex> lock(m_stmtMutex);
-    const auto it
+    return getStatement(sql, [&sql]()
     {
-        std::find_if(m_statementsCache.begin(),
-                     m_statementsCache.end(),
-                     [sql](const std::pair<std::string, std::shared_ptr<SQLiteLegacy::IStatement>>& pair)
-        {
-            return 0 == pair.first.compare(sql);
-        })
-    };
+        return sql;
+    });
+}
+
+std::shared_ptr<SQLiteLegacy::IStatement>const SQLiteDBEngine::getStatement(const std::string& queryId,
+                                                                            const std::function<std::string()>& buildQuery)
+{
+    std::lock_guard<std::mutex> lock(m_stmtMutex);
+    const auto it { m_statementsIndex.find(queryId) };
 
-    if (m_statementsCache.end() != it)
+    if (m_statementsIndex.end() != it)
     {
-        it->second->reset();
-        return it->second;
+        // Most recently used statements are kept at the front
+        m_statementsCache.splice(m_statementsCache.begin(), m_statementsCache, it->second);
+        ++m_statementsCacheStats.hits;
+        it->second->second->reset();
+        return it->second->second;
     }
     else
     {
-        m_statementsCache.emplace_back(sql, m_sqliteFactory->createStatement(m_sqliteConnection, sql));
+        ++m_statementsCacheStats.misses;
+        m_statementsCache.emplace_front(queryId, m_sqliteFactory->createStatement(m_sqliteConnection, buildQuery()));
+        m_statementsIndex.emplace(queryId, m_statementsCache.begin());
 
         if (CACHE_STMT_LIMIT <= m_statementsCache.size())
         {
-            m_statementsCache.pop_front();
+            ++m_statementsCacheStats.evictions;
+            m_statementsIndex.erase(m_statementsCache.back().first);
+            m_statementsCache.pop_back();
         }
 
-        return m_statementsCache.back().second;
+        return m_statementsCache.front().second;
     }
 }
 
+StatementCacheStats SQLiteDBEngine::statementCacheStats() const
+{
+    std::lock_guard<std::mutex> lock(m_stmtMutex);
+    return m_statementsCacheStats;
+}
+
 std::string SQLiteDBEngine::getSelectAllQuery(const std::string& table,
                                               const TableColumns& tableFields) const
 {
@@ -14,26 +14,40 @@
 
 #include <tuple>
 #include <iostream>
+#include <list>
 #include <mutex>
 #include <queue>
+#include <unordered_map>
 #include "dbengine.h"
 #include "sqlite_wrapper_factory.h"
 #include "isqlite_wrapper.h"
 #include "mapWrapperSafe.h"
 
 constexpr auto TEMP_TABLE_SUBFIX {"_TEMP"};
+constexpr auto SYNC_TABLE_SUBFIX {"_SYNC"};
 
 constexpr auto STATUS_FIELD_NAME {"db_status_field_dm"};
 constexpr auto STATUS_FIELD_TYPE {"INTEGER"};
 
+// Tables declaring this column keep a digest of the content of each row, so that unchanged rows are detected
+// without comparing them field by field. The digest covers the stored columns except the ignored ones, so a row whose
+// only changes are in ignored columns keeps their stored values, as it does without the digest.
+constexpr auto ROW_HASH_FIELD_NAME {"db_row_hash_dm"};
+
 constexpr auto CACHE_STMT_LIMIT
 {
     30ull
 };
 
+constexpr auto BULK_SYNC_MIN_ROWS
+{
+    2ull
+};
+
 const std::vector<std::string> InternalColumnNames =
 {
-    { STATUS_FIELD_NAME }
+    { STATUS_FIELD_NAME },
+    { ROW_HASH_FIELD_NAME }
 };
 
 enum ColumnType
@@ -117,6 +131,15 @@ struct MaxRows final
     int64_t currentRows;
 };
 
+struct StatementCacheStats final
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+using StatementCacheEntry = std::pair<std::string, std::shared_ptr<SQLiteLegacy::IStatement>>;
+
 class SQLiteDBEngine final : public DbSync::IDbEngine
 {
     public:
@@ -160,6 +183,8 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
 
         void addTableRelationship(const nlohmann::json& data) override;
 
+        StatementCacheStats statementCacheStats() const;
+
     private:
         void initialize(const std::string&              path,
                         const std::string&              tableStmtCreation,
@@ -207,9 +232,35 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
                         const nlohmann::json& ignoredColumns,
                         const std::string& table,
                         const nlohmann::json& data,
+                        const std::optional<int32_t>& rowHashIndex,
+                        std::optional<int64_t>& rowHash,
                         nlohmann::json& updatedData,
                         nlohmann::json& oldData);
 
+        std::optional<int32_t> getRowHashIndex(const std::string& table);
+
+        static int64_t getRowHash(const TableColumns& fields,
+                                  const nlohmann::json& data,
+                                  const nlohmann::json& ignoredColumns);
+
+        void fillRowDiff(const std::vector<std::string>& primaryKeyList,
+                         const nlohmann::json& ignoredColumns,
+                         const nlohmann::json& data,
+                         const Row& registryFields,
+                         nlohmann::json& updatedData,
+                         nlohmann::json& oldData);
+
+        bool getRowsMatchingPKs(const std::string& table,
+                                const std::vector<std::string>& primaryKeyList,
+                                const nlohmann::json& data,
+                                const bool inTransaction,
+                                const std::optional<int32_t>& rowHashIndex,
+                                const std::vector<int64_t>& rowHashes,
+                                std::vector<std::optional<Row>>& currentRows);
+
+        void updateStagedRowsStatusField(const std::string& table,
+                                         const std::vector<std::string>& primaryKeyList);
+
         bool insertNewRows(const std::string& table,
                            const std::vector<std::string>& primaryKeyList,
                            const DbSync::ResultCallback callback,
@@ -301,6 +352,9 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
 
         std::shared_ptr<SQLiteLegacy::IStatement>const getStatement(const std::string& sql);
 
+        std::shared_ptr<SQLiteLegacy::IStatement>const getStatement(const std::string& queryId,
+                                                                    const std::function<std::string()>& buildQuery);
+
         std::string getSelectAllQuery(const std::string& table,
                                       const TableColumns& tableFields) const;
 
@@ -320,10 +374,13 @@ class SQLiteDBEngine final : public DbSync::IDbEngine
                            const std::function<void()> callback = {});
 
         Utils::MapWrapperSafe<std::string, TableColumns> m_tableFields;
-        std::deque<std::pair<std::string, std::shared_ptr<SQLiteLegacy::IStatement>>> m_statementsCache;
+        std::list<StatementCacheEntry> m_statementsCache;
+        std::unordered_map<std::string, std::list<StatementCacheEntry>::iterator> m_statementsIndex;
+        StatementCacheStats m_statementsCacheStats;
         const std::shared_ptr<ISQLiteFactory> m_sqliteFactory;
         std::shared_ptr<SQLiteLegacy::IConnection> m_sqliteConnection;
-        std::mutex m_stmtMutex;
+        mutable std::mutex m_stmtMutex;
+        std::mutex m_stagingMutex;
         std::unique_ptr<SQLiteLegacy::ITransaction> m_transaction;
         std::mutex m_maxRowsMutex;
         std::map<std::string, MaxRows> m_maxRows;
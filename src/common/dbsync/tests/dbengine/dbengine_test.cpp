@@ -859,3 +859,22 @@ TEST_F(DBEngineTest, AddTableRelationshipNoMetadata)
 
     EXPECT_THROW(spEngine->addTableRelationship(relationshipJSON), dbengine_error);
 }
+
+TEST_F(DBEngineTest, StatementCacheStats)
+{
+    std::unique_ptr<SQLiteDBEngine> spEngine;
+    EXPECT_NO_THROW(spEngine = std::make_unique<SQLiteDBEngine>(
+                                   std::make_shared<SQLiteFactory>(),
+                                   ":memory:",
+                                   "CREATE TABLE dummy(`pid` BIGINT, `name` TEXT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"));
+
+    // The statements built for the same table and columns are reused
+    EXPECT_NO_THROW(spEngine->setMaxRows("dummy", 10));
+    EXPECT_NO_THROW(spEngine->setMaxRows("dummy", 10));
+    EXPECT_NO_THROW(spEngine->bulkInsert("dummy", R"([{"pid":1,"name":"a"},{"pid":2,"name":"b"},{"pid":3}])"_json));
+
+    const auto stats { spEngine->statementCacheStats() };
+    EXPECT_EQ(4u, stats.misses);
+    EXPECT_EQ(2u, stats.hits);
+    EXPECT_EQ(0u, stats.evictions);
+}
@@ -729,6 +729,135 @@ TEST_F(DBSyncTest, syncRowInsertAndModified)
     EXPECT_NE(0, dbsync_sync_row(handle, jsInsert2.get(), callbackEmpty));
 }
 
+TEST_F(DBSyncTest, syncRowBatchInsertAndModified)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, `tid` BIGINT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto handle { dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql) };
+    ASSERT_NE(nullptr, handle);
+
+    CallbackMock wrapper;
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":4,"name":"System", "tid":100})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":5,"name":"System", "tid":101})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, nlohmann::json::parse(R"({"pid":4,"name":"Systemmm","tid":100})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":6,"name":"Guake"})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":7,"name":"Guake", "tid":1})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, nlohmann::json::parse(R"({"pid":7,"name":"Guake","tid":2})"))).Times(1);
+
+    const auto insertSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"System", "tid":100},
+                                                              {"pid":5,"name":"System", "tid":101}]})"};           // Insert
+    const auto syncSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"Systemmm", "tid":100},
+                                                            {"pid":5,"name":"System", "tid":101},
+                                                            {"pid":6,"name":"Guake"}]})"};                         // Update, no change and insert
+    const auto repeatedSqlStmt{ R"({"table":"processes","data":[{"pid":7,"name":"Guake", "tid":1},
+                                                                {"pid":7,"name":"Guake", "tid":2}]})"};            // Insert and update
+
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInsert{ cJSON_Parse(insertSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsSync{ cJSON_Parse(syncSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsRepeated{ cJSON_Parse(repeatedSqlStmt) };
+
+    callback_data_t callbackData { callback, &wrapper };
+
+    EXPECT_EQ(0, dbsync_sync_row(handle, jsInsert.get(), callbackData));
+    EXPECT_EQ(0, dbsync_sync_row(handle, jsSync.get(), callbackData));
+    EXPECT_EQ(0, dbsync_sync_row(handle, jsRepeated.get(), callbackData));
+}
+
+TEST_F(DBSyncTest, syncRowWithRowHash)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, `tid` BIGINT, `db_row_hash_dm` BIGINT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto handle { dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql) };
+    ASSERT_NE(nullptr, handle);
+
+    CallbackMock wrapper;
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":4,"name":"System", "tid":100})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":5,"name":"System", "tid":101})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(MODIFIED, nlohmann::json::parse(R"({"pid":5,"name":"Systemmm","tid":101})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, nlohmann::json::parse(R"({"count":2})"))).Times(1);
+
+    const auto insertSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"System", "tid":100},
+                                                              {"pid":5,"name":"System", "tid":101}]})"};  // Insert
+    const auto updateSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"System", "tid":100},
+                                                              {"pid":5,"name":"Systemmm", "tid":101}]})"};  // No change and update
+    const auto selectData
+    {
+        R"({"table":"processes",
+           "query":{"column_list":["count(*) AS count"],
+           "row_filter":"WHERE db_row_hash_dm IS NOT NULL",
+           "distinct_opt":false,
+           "order_by_opt":""}})"
+    };
+
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInsert{ cJSON_Parse(insertSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsUpdate{ cJSON_Parse(updateSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsSelectData{ cJSON_Parse(selectData) };
+
+    callback_data_t callbackData { callback, &wrapper };
+
+    EXPECT_EQ(0, dbsync_sync_row(handle, jsInsert.get(), callbackData));
+    EXPECT_EQ(0, dbsync_sync_row(handle, jsInsert.get(), callbackData));  // Same rows, the digests match
+    EXPECT_EQ(0, dbsync_sync_row(handle, jsUpdate.get(), callbackData));
+    EXPECT_EQ(0, dbsync_select_rows(handle, jsSelectData.get(), callbackData));
+}
+
+TEST_F(DBSyncTest, syncRowWithRowHashIgnoresFieldsNotStored)
+{
+    const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, `tid` BIGINT, `db_row_hash_dm` BIGINT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
+    const auto handle { dbsync_create(HostType::AGENT, DbEngineType::SQLITE3, DATABASE_TEMP, sql) };
+    ASSERT_NE(nullptr, handle);
+
+    nlohmann::json firstHash;
+    nlohmann::json secondHash;
+
+    CallbackMock wrapper;
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":4,"name":"System","tid":100,"utime":1})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(INSERTED, nlohmann::json::parse(R"({"pid":5,"name":"System","tid":101,"utime":1})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, testing::Truly([](const nlohmann::json & row)
+    {
+        return row.contains("hash");
+    })))
+    .WillOnce(testing::SaveArg<1>(&firstHash))
+    .WillOnce(testing::SaveArg<1>(&secondHash));
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, nlohmann::json::parse(R"({"pid":4,"name":"System","tid":100})"))).Times(1);
+    EXPECT_CALL(wrapper, callbackMock(SELECTED, nlohmann::json::parse(R"({"pid":5,"name":"System","tid":101})"))).Times(1);
+
+    const auto insertSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"System","tid":100,"utime":1},
+                                                              {"pid":5,"name":"System","tid":101,"utime":1}]})"};
+    const auto updateSqlStmt{ R"({"table":"processes","data":[{"pid":4,"name":"System","tid":100,"utime":2},
+                                                              {"pid":5,"name":"System","tid":101,"utime":2}]})"};  // Only fields not stored changed
+    const auto selectHash
+    {
+        R"({"table":"processes",
+           "query":{"column_list":["db_row_hash_dm AS hash"],
+           "row_filter":"WHERE pid=4",
+           "distinct_opt":false,
+           "order_by_opt":""}})"
+    };
+    const auto selectAll
+    {
+        R"({"table":"processes",
+           "query":{"column_list":["*"],
+           "row_filter":"",
+           "distinct_opt":false,
+           "order_by_opt":""}})"
+    };
+
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInsert{ cJSON_Parse(insertSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsUpdate{ cJSON_Parse(updateSqlStmt) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsSelectHash{ cJSON_Parse(selectHash) };
+    const std::unique_ptr<cJSON, CJsonSmartDeleter> jsSelectAll{ cJSON_Parse(selectAll) };
+
+    callback_data_t callbackData { callback, &wrapper };
+
+    EXPECT_EQ(0, dbsync_sync_row(handle, jsInsert.get(), callbackData));
+    EXPECT_EQ(0, dbsync_select_rows(handle, jsSelectHash.get(), callbackData));
+    EXPECT_EQ(0, dbsync_sync_row(handle, jsUpdate.get(), callbackData));
+    EXPECT_EQ(0, dbsync_select_rows(handle, jsSelectHash.get(), callbackData));
+    EXPECT_EQ(0, dbsync_select_rows(handle, jsSelectAll.get(), callbackData));  // The digest is not returned
+
+    EXPECT_FALSE(firstHash.empty());
+    EXPECT_EQ(firstHash, secondHash);
+}
+
 TEST_F(DBSyncTest, syncRowInsertAndModifiedWithOldData)
 {
     const auto sql{ "CREATE TABLE processes(`pid` BIGINT, `name` TEXT, `tid` BIGINT, PRIMARY KEY (`pid`)) WITHOUT ROWID;"};
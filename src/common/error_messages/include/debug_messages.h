@@ -188,6 +188,11 @@
 #define FIM_WILDCARDS_ADD_REGISTER          "(6373): Expanding entry '%s' to '%s' to monitor FIM events."
 #define FIM_WILDCARDS_REGISTERS_FINALIZE    "(6374): Wildcard configuration successfully completed."
 #define FIM_REG_VAL_INVALID_TYPE            "(6375): Invalid registry value type for report_changes. Registry key: '%s'. Registry value: '%s'."
+#define FIM_FULL_REHASH_SCAN                "(6376): Hashing every file again in this scan."
+#define FIM_SCAN_POOL_STARTED               "(6377): Scanning directories with %u threads."
+#define FIM_DIFF_SNAPSHOT_READ_ERROR        "(6378): Cannot read the snapshot '%s', it will be replaced."
+#define FIM_REALTIME_MOVE_COALESCED         "(6379): '%s' was moved to '%s' right after being created, only the target will be checked."
+#define FIM_REALTIME_PENDING_FULL           "(6380): Too many real-time paths waiting to settle (%u), checking them now."
 
 /* Modules messages */
 #define WM_UPGRADE_RESULT_AGENT_INFO         "(8151): Agent Information obtained: '%s'"
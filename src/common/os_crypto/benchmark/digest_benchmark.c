@@ -0,0 +1,98 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <shared.h>
+#include <time.h>
+
+#include "md5_sha1_sha256_op.h"
+
+/* Measures the throughput of OS_Digest_File.
+ *
+ * Usage: digest_benchmark [file size in MB] [file]
+ *
+ * A file of the given size (1024 MB by default) is filled with pseudo-random data and digested with each digest
+ * alone, with all of them at once, with direct I/O and through the stdio path used for text files. Each result is
+ * reported in MB/s. Unless direct I/O is used, the file may be partially served from the page cache.
+ */
+
+#define BENCHMARK_BLOCK_SIZE (1024 * 1024)
+
+static int create_file(const char *path, long size_mb) {
+    FILE *fp = fopen(path, "wb");
+    unsigned char *block = malloc(BENCHMARK_BLOCK_SIZE);
+    unsigned int seed = 1;
+    long i;
+    size_t j;
+
+    if (fp == NULL || block == NULL) {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        free(block);
+        return -1;
+    }
+
+    for (i = 0; i < size_mb; i++) {
+        for (j = 0; j < BENCHMARK_BLOCK_SIZE; j++) {
+            seed = seed * 1103515245 + 12345;
+            block[j] = (unsigned char)(seed >> 16);
+        }
+
+        if (fwrite(block, 1, BENCHMARK_BLOCK_SIZE, fp) != BENCHMARK_BLOCK_SIZE) {
+            fclose(fp);
+            free(block);
+            return -1;
+        }
+    }
+
+    free(block);
+    return fclose(fp);
+}
+
+static void measure(const char *name, const char *path, long size_mb, int digests, int mode) {
+    os_md5 md5 = "";
+    os_sha1 sha1 = "";
+    os_sha256 sha256 = "";
+    struct timespec start;
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (OS_Digest_File(path, NULL, digests, md5, sha1, sha256, mode, 0) < 0) {
+        printf("%-16s failed\n", name);
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%-16s %10.1f MB/s\n", name, size_mb / seconds);
+}
+
+int main(int argc, char *argv[]) {
+    const long size_mb = argc > 1 ? atol(argv[1]) : 1024;
+    const char *path = argc > 2 ? argv[2] : "/tmp/digest_benchmark.bin";
+
+    if (size_mb <= 0 || create_file(path, size_mb) < 0) {
+        fprintf(stderr, "Cannot create a file of %ld MB at %s\n", size_mb, path);
+        return EXIT_FAILURE;
+    }
+
+    printf("File of %ld MB\n", size_mb);
+
+    measure("MD5", path, size_mb, OS_DIGEST_MD5, OS_BINARY);
+    measure("SHA1", path, size_mb, OS_DIGEST_SHA1, OS_BINARY);
+    measure("SHA256", path, size_mb, OS_DIGEST_SHA256, OS_BINARY);
+    measure("All", path, size_mb, OS_DIGEST_ALL, OS_BINARY);
+    measure("All, direct I/O", path, size_mb, OS_DIGEST_ALL | OS_DIGEST_DIRECT_IO, OS_BINARY);
+    measure("All, stdio", path, size_mb, OS_DIGEST_ALL, OS_TEXT);
+
+    unlink(path);
+    return EXIT_SUCCESS;
+}
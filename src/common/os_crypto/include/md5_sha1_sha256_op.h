@@ -15,7 +15,27 @@
 #include "../sha1/sha1_op.h"
 #include "../sha256/sha256_op.h"
 
+/* Digests computed by OS_Digest_File */
+#define OS_DIGEST_MD5       0x01
+#define OS_DIGEST_SHA1      0x02
+#define OS_DIGEST_SHA256    0x04
+#define OS_DIGEST_ALL       (OS_DIGEST_MD5 | OS_DIGEST_SHA1 | OS_DIGEST_SHA256)
 
+/* Read the file bypassing the page cache (O_DIRECT), where the system and the filesystem support it */
+#define OS_DIGEST_DIRECT_IO 0x08
+
+/**
+ * @brief Calculates the MD5, SHA1 and SHA256 of a file in a single pass.
+ *
+ * @param [in] fname Name of the file.
+ * @param [in] prefilter_cmd Command whose output is hashed instead of the file, or NULL.
+ * @param [out] md5output Buffer where the MD5 will be written.
+ * @param [out] sha1output Buffer where the SHA1 will be written.
+ * @param [out] sha256output Buffer where the SHA256 will be written.
+ * @param [in] mode Mode for opening the file. OS_BINARY or OS_TEXT.
+ * @param [in] max_size Maximum size of the file in bytes, 0 for no limit.
+ * @return 0 on success, -1 on error.
+ */
 int OS_MD5_SHA1_SHA256_File(const char *fname,
                             char **prefilter_cmd,
                             os_md5 md5output,
@@ -24,4 +44,30 @@ int OS_MD5_SHA1_SHA256_File(const char *fname,
                             int mode,
                             size_t max_size) __attribute((nonnull(1, 3, 4)));
 
+/**
+ * @brief Calculates the selected digests of a file in a single pass.
+ *
+ * Binary files are read straight from their descriptor in large aligned blocks, telling the system that they are
+ * read sequentially and that their pages are not needed afterwards. Text files and prefilter commands are read
+ * through stdio. Digests not selected are not computed and their output buffers are left untouched.
+ *
+ * @param [in] fname Name of the file.
+ * @param [in] prefilter_cmd Command whose output is hashed instead of the file, or NULL.
+ * @param [in] digests Digests to compute (OS_DIGEST_*), optionally with OS_DIGEST_DIRECT_IO.
+ * @param [out] md5output Buffer where the MD5 will be written.
+ * @param [out] sha1output Buffer where the SHA1 will be written.
+ * @param [out] sha256output Buffer where the SHA256 will be written.
+ * @param [in] mode Mode for opening the file. OS_BINARY or OS_TEXT.
+ * @param [in] max_size Maximum size of the file in bytes, 0 for no limit.
+ * @return 0 on success, -1 on error.
+ */
+int OS_Digest_File(const char *fname,
+                   char **prefilter_cmd,
+                   int digests,
+                   os_md5 md5output,
+                   os_sha1 sha1output,
+                   os_sha256 sha256output,
+                   int mode,
+                   size_t max_size) __attribute((nonnull(1, 4, 5, 6)));
+
 #endif /* MD5SHA1SHA256_OP_H */
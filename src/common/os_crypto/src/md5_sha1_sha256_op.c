@@ -17,6 +17,209 @@
 #include <openssl/sha.h>
 #include "headers/defs.h"
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Files are read in blocks of this size, aligned so that O_DIRECT can be used */
+#define OS_DIGEST_BLOCK_SIZE  (1024 * 1024)
+#define OS_DIGEST_BLOCK_ALIGN 4096
+#endif
+
+/* Digests computed over the same data, NULL for the ones not requested */
+typedef struct os_digest_ctx {
+    EVP_MD_CTX *md5;
+    EVP_MD_CTX *sha1;
+    EVP_MD_CTX *sha256;
+} os_digest_ctx;
+
+static EVP_MD_CTX *digest_new(const EVP_MD *type) {
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+
+    if (ctx != NULL && EVP_DigestInit_ex(ctx, type, NULL) != 1) {
+        EVP_MD_CTX_free(ctx);
+        ctx = NULL;
+    }
+
+    return ctx;
+}
+
+/* Returns -1 if any of the requested digests could not be set up */
+static int digest_init(os_digest_ctx *ctx, int digests) {
+    ctx->md5 = (digests & OS_DIGEST_MD5) ? digest_new(EVP_md5()) : NULL;
+    ctx->sha1 = (digests & OS_DIGEST_SHA1) ? digest_new(EVP_sha1()) : NULL;
+    ctx->sha256 = (digests & OS_DIGEST_SHA256) ? digest_new(EVP_sha256()) : NULL;
+
+    if (((digests & OS_DIGEST_MD5) && ctx->md5 == NULL) ||
+        ((digests & OS_DIGEST_SHA1) && ctx->sha1 == NULL) ||
+        ((digests & OS_DIGEST_SHA256) && ctx->sha256 == NULL)) {
+        return (-1);
+    }
+
+    return (0);
+}
+
+static int digest_update(os_digest_ctx *ctx, const void *buf, size_t n) {
+    if (ctx->md5 != NULL && EVP_DigestUpdate(ctx->md5, buf, n) != 1) {
+        return (-1);
+    }
+
+    if (ctx->sha1 != NULL && EVP_DigestUpdate(ctx->sha1, buf, n) != 1) {
+        return (-1);
+    }
+
+    if (ctx->sha256 != NULL && EVP_DigestUpdate(ctx->sha256, buf, n) != 1) {
+        return (-1);
+    }
+
+    return (0);
+}
+
+static int digest_hex(EVP_MD_CTX *ctx, char *output) {
+    static const char hex[] = "0123456789abcdef";
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int len = 0;
+    unsigned int n;
+
+    if (EVP_DigestFinal_ex(ctx, digest, &len) != 1) {
+        return (-1);
+    }
+
+    for (n = 0; n < len; n++) {
+        output[2 * n] = hex[digest[n] >> 4];
+        output[2 * n + 1] = hex[digest[n] & 0x0f];
+    }
+
+    output[2 * len] = '\0';
+
+    return (0);
+}
+
+static int digest_final(os_digest_ctx *ctx, os_md5 md5output, os_sha1 sha1output, os_sha256 sha256output) {
+    if (ctx->md5 != NULL && digest_hex(ctx->md5, md5output) < 0) {
+        return (-1);
+    }
+
+    if (ctx->sha1 != NULL && digest_hex(ctx->sha1, sha1output) < 0) {
+        return (-1);
+    }
+
+    if (ctx->sha256 != NULL && digest_hex(ctx->sha256, sha256output) < 0) {
+        return (-1);
+    }
+
+    return (0);
+}
+
+static void digest_free(os_digest_ctx *ctx) {
+    EVP_MD_CTX_free(ctx->md5);
+    EVP_MD_CTX_free(ctx->sha1);
+    EVP_MD_CTX_free(ctx->sha256);
+}
+
+static void digest_max_size_warn(const char *fname, size_t max_size) {
+    LogWarn("'%s' filesize is larger than the maximum allowed (%d MB). File skipped.", fname, (int)max_size/1048576); // max_size is in bytes
+}
+
+/* Digest a stream read through stdio, as text files and prefilter commands need */
+static int digest_stream(FILE *fp, const char *fname, os_digest_ctx *ctx, size_t max_size) {
+    size_t n, read = 0;
+    unsigned char buf[OS_BUFFER_SIZE + 2];
+
+    buf[OS_BUFFER_SIZE + 1] = '\0';
+
+    while ((n = fread(buf, 1, OS_BUFFER_SIZE, fp)) > 0) {
+
+        if (max_size > 0) {
+            read = read + n;
+            if (read >= max_size) {     // Maximum filesize error
+                digest_max_size_warn(fname, max_size);
+                return (-1);
+            }
+        }
+
+        buf[n] = '\0';
+
+        if (digest_update(ctx, buf, n) < 0) {
+            return (-1);
+        }
+    }
+
+    return (0);
+}
+
+#ifndef WIN32
+/* Digest a binary file read straight from its descriptor in large aligned blocks */
+static int digest_fd(const char *fname, int digests, os_digest_ctx *ctx, size_t max_size) {
+    int fd = -1;
+    int direct = 0;
+    int retval = 0;
+    ssize_t n;
+    off_t total = 0;
+    void *buf = NULL;
+
+#ifdef O_DIRECT
+    if (digests & OS_DIGEST_DIRECT_IO) {
+        // Not every filesystem supports direct I/O, fall back to the page cache in that case
+        fd = open(fname, O_RDONLY | O_CLOEXEC | O_DIRECT);
+        direct = fd >= 0;
+    }
+#else
+    (void)digests;
+#endif
+
+    if (fd < 0 && (fd = open(fname, O_RDONLY | O_CLOEXEC)) < 0) {
+        return (-1);
+    }
+
+    if (posix_memalign(&buf, OS_DIGEST_BLOCK_ALIGN, OS_DIGEST_BLOCK_SIZE) != 0) {
+        close(fd);
+        return (-1);
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (!direct) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
+    while ((n = read(fd, buf, OS_DIGEST_BLOCK_SIZE)) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            retval = -1;
+            break;
+        }
+
+        total += n;
+
+        if (max_size > 0 && (size_t)total >= max_size) {     // Maximum filesize error
+            digest_max_size_warn(fname, max_size);
+            retval = -1;
+            break;
+        }
+
+        if (digest_update(ctx, buf, (size_t)n) < 0) {
+            retval = -1;
+            break;
+        }
+
+#ifdef POSIX_FADV_DONTNEED
+        // Scanned files are rarely read again soon, don't let them evict the cache of other processes
+        if (!direct) {
+            posix_fadvise(fd, total - n, n, POSIX_FADV_DONTNEED);
+        }
+#endif
+    }
+
+    free(buf);
+    close(fd);
+
+    return retval;
+}
+#endif
 
 int OS_MD5_SHA1_SHA256_File(const char *fname,
                             char **prefilter_cmd,
@@ -26,23 +229,50 @@ int OS_MD5_SHA1_SHA256_File(const char *fname,
                             int mode,
                             size_t max_size)
 {
-    size_t n, read = 0;
-    FILE *fp;
-    wfd_t *wfd;
-    unsigned char buf[OS_BUFFER_SIZE + 2];
-    unsigned char sha1_digest[SHA_DIGEST_LENGTH];
-    unsigned char md5_digest[16];
-    unsigned char sha256_digest[SHA256_DIGEST_LENGTH];
+    return OS_Digest_File(fname, prefilter_cmd, OS_DIGEST_ALL, md5output, sha1output, sha256output, mode, max_size);
+}
 
-    EVP_MD_CTX *sha1_ctx = NULL;
-    EVP_MD_CTX *md5_ctx = NULL;
-    EVP_MD_CTX *sha256_ctx = NULL;
+int OS_Digest_File(const char *fname,
+                   char **prefilter_cmd,
+                   int digests,
+                   os_md5 md5output,
+                   os_sha1 sha1output,
+                   os_sha256 sha256output,
+                   int mode,
+                   size_t max_size)
+{
+    int retval;
+    FILE *fp = NULL;
+    wfd_t *wfd = NULL;
+    os_digest_ctx ctx;
 
     /* Clear the memory */
-    md5output[0] = '\0';
-    sha1output[0] = '\0';
-    sha256output[0] = '\0';
-    buf[OS_BUFFER_SIZE + 1] = '\0';
+    if (digests & OS_DIGEST_MD5) {
+        md5output[0] = '\0';
+    }
+    if (digests & OS_DIGEST_SHA1) {
+        sha1output[0] = '\0';
+    }
+    if (digests & OS_DIGEST_SHA256) {
+        sha256output[0] = '\0';
+    }
+
+#ifndef WIN32
+    if (prefilter_cmd == NULL && mode == OS_BINARY) {
+        retval = digest_init(&ctx, digests);
+
+        if (retval == 0) {
+            retval = digest_fd(fname, digests, &ctx, max_size);
+        }
+
+        if (retval == 0) {
+            retval = digest_final(&ctx, md5output, sha1output, sha256output);
+        }
+
+        digest_free(&ctx);
+        return retval;
+    }
+#endif
 
     /* Use prefilter_cmd if set */
     if (prefilter_cmd == NULL) {
@@ -73,65 +303,17 @@ int OS_MD5_SHA1_SHA256_File(const char *fname,
         fp = wfd->file_out;
     }
 
-    /* Initialize all hashes */
-    sha1_ctx = EVP_MD_CTX_new();
-    md5_ctx = EVP_MD_CTX_new();
-    sha256_ctx = EVP_MD_CTX_new();
-    EVP_DigestInit(sha1_ctx, EVP_sha1());
-    EVP_DigestInit(md5_ctx, EVP_md5());
-    EVP_DigestInit(sha256_ctx, EVP_sha256());
-
-    /* Update for each one */
-    while ((n = fread(buf, 1, OS_BUFFER_SIZE, fp)) > 0) {
-
-        if (max_size > 0) {
-            read = read + n;
-            if (read >= max_size) {     // Maximum filesize error
-                LogWarn("'%s' filesize is larger than the maximum allowed (%d MB). File skipped.", fname, (int)max_size/1048576); // max_size is in bytes
-                if (prefilter_cmd == NULL) {
-                    fclose(fp);
-                } else {
-                    wpclose(wfd);
-                }
-                EVP_MD_CTX_free(sha1_ctx);
-                EVP_MD_CTX_free(md5_ctx);
-                EVP_MD_CTX_free(sha256_ctx);
-                return (-1);
-            }
-        }
-
-        buf[n] = '\0';
-
-        EVP_DigestUpdate(sha1_ctx, buf, n);
-        EVP_DigestUpdate(md5_ctx, buf, n);
-        EVP_DigestUpdate(sha256_ctx, buf, n);
-    }
-
-    EVP_DigestFinal(sha1_ctx, sha1_digest, NULL);
-    EVP_DigestFinal(md5_ctx, md5_digest, NULL);
-    EVP_DigestFinal(sha256_ctx, sha256_digest, NULL);
+    retval = digest_init(&ctx, digests);
 
-    EVP_MD_CTX_free(sha1_ctx);
-    EVP_MD_CTX_free(md5_ctx);
-    EVP_MD_CTX_free(sha256_ctx);
-
-    /* Set output for MD5 */
-    for (n = 0; n < 16; n++) {
-        snprintf(md5output, 3, "%02x", md5_digest[n]);
-        md5output += 2;
+    if (retval == 0) {
+        retval = digest_stream(fp, fname, &ctx, max_size);
     }
 
-    /* Set output for SHA-1 */
-    for (n = 0; n < SHA_DIGEST_LENGTH; n++) {
-        snprintf(sha1output, 3, "%02x", sha1_digest[n]);
-        sha1output += 2;
+    if (retval == 0) {
+        retval = digest_final(&ctx, md5output, sha1output, sha256output);
     }
 
-    /* Set output for SHA-256 */
-    for (n = 0; n < SHA256_DIGEST_LENGTH; n++) {
-        snprintf(sha256output, 3, "%02x", sha256_digest[n]);
-        sha256output += 2;
-    }
+    digest_free(&ctx);
 
     /* Close it */
     if (prefilter_cmd == NULL) {
@@ -140,5 +322,5 @@ int OS_MD5_SHA1_SHA256_File(const char *fname,
         wpclose(wfd);
     }
 
-    return (0);
+    return retval;
 }
@@ -11,6 +11,7 @@
 #include <stdarg.h>
 #include <setjmp.h>
 #include <cmocka.h>
+#include <openssl/evp.h>
 
 #include "../headers/shared.h"
 #include "../os_crypto/md5_sha1/md5_sha1_op.h"
@@ -30,6 +31,93 @@ static int teardown_group(void ** state) {
     return 0;
 }
 
+static int evp_md_ctx_new_fails;
+
+extern EVP_MD_CTX *__real_EVP_MD_CTX_new(void);
+EVP_MD_CTX *__wrap_EVP_MD_CTX_new(void) {
+    if (evp_md_ctx_new_fails) {
+        return NULL;
+    }
+    return __real_EVP_MD_CTX_new();
+}
+
+#ifndef TEST_WINAGENT
+#define TEST_BLOCK_SIZE (1024 * 1024)
+
+static const char *small_md5 = "d67c5cbf5b01c9f91932e3b8def5e5f8";
+static const char *small_sha1 = "b8473b86d4c2072ca9b08bd28e373e8253e865c4";
+static const char *small_sha256 = "3c8727e019a42b444667a587b6001251becadabbb36bfed8087a92c18882d111";
+
+// Two blocks and a partial one, byte i being i * 31 + 7
+static const size_t large_size = 2 * TEST_BLOCK_SIZE + 4099;
+static const char *large_md5 = "21b7bdb2a65693e937bfaf6a59ae4e75";
+static const char *large_sha1 = "950350dd8d4dce4f434f09dc0702a9f2c6a9004d";
+static const char *large_sha256 = "c3cfced68629a4877e09cf7320767b3f41ce6be25b5394e0f831f8403deb6808";
+
+// Binary files are read with open/read, which are not wrapped, so these tests use real files
+static void create_tmp_file(char *file_name, const unsigned char *data, size_t size) {
+    size_t written = 0;
+    int fd = mkstemp(file_name);
+
+    assert_int_not_equal(fd, -1);
+
+    while (written < size) {
+        ssize_t n = write(fd, data + written, size - written);
+        assert_true(n > 0);
+        written += n;
+    }
+
+    close(fd);
+}
+
+static int setup_small_file(void **state) {
+    char *file_name = strdup("/tmp/tmp_digest_small-XXXXXX");
+
+    create_tmp_file(file_name, (const unsigned char *)"teststring", strlen("teststring"));
+    *state = file_name;
+    return 0;
+}
+
+static int setup_large_file(void **state) {
+    char *file_name = strdup("/tmp/tmp_digest_large-XXXXXX");
+    unsigned char *data = malloc(large_size);
+    size_t i;
+
+    for (i = 0; i < large_size; i++) {
+        data[i] = (unsigned char)(i * 31 + 7);
+    }
+
+    create_tmp_file(file_name, data, large_size);
+    free(data);
+    *state = file_name;
+    return 0;
+}
+
+static int teardown_file(void **state) {
+    unlink(*state);
+    free(*state);
+    evp_md_ctx_new_fails = 0;
+    return 0;
+}
+
+// Computes each combination of digests, the ones not requested must be left empty
+static void assert_digest_masks(const char *file_name, int flags, const char *md5, const char *sha1, const char *sha256) {
+    int digests;
+
+    for (digests = OS_DIGEST_MD5; digests <= OS_DIGEST_ALL; digests++) {
+        os_md5 md5buffer = "";
+        os_sha1 sha1buffer = "";
+        os_sha256 sha256buffer = "";
+
+        assert_int_equal(OS_Digest_File(file_name, NULL, digests | flags, md5buffer, sha1buffer, sha256buffer, OS_BINARY, 0), 0);
+
+        assert_string_equal(md5buffer, (digests & OS_DIGEST_MD5) ? md5 : "");
+        assert_string_equal(sha1buffer, (digests & OS_DIGEST_SHA1) ? sha1 : "");
+        assert_string_equal(sha256buffer, (digests & OS_DIGEST_SHA256) ? sha256 : "");
+    }
+}
+#endif
+
 // Tests
 
 void test_md5_sha1_sha256_file(void **state)
@@ -162,6 +250,88 @@ void test_md5_sha1_sha256_file_max_size_fail(void **state)
     assert_int_equal(OS_MD5_SHA1_SHA256_File(file_name, NULL, md5buffer, sha1buffer, sha256buffer, OS_TEXT, 1), -1);
 }
 
+#ifndef TEST_WINAGENT
+void test_digest_binary_file_smaller_than_block(void **state)
+{
+    assert_digest_masks(*state, 0, small_md5, small_sha1, small_sha256);
+}
+
+void test_digest_binary_file_larger_than_block(void **state)
+{
+    assert_digest_masks(*state, 0, large_md5, large_sha1, large_sha256);
+}
+
+void test_digest_binary_file_direct_io(void **state)
+{
+    // Where the filesystem does not support O_DIRECT the file is read through the page cache, the result is the same
+    assert_digest_masks(*state, OS_DIGEST_DIRECT_IO, large_md5, large_sha1, large_sha256);
+}
+
+void test_digest_binary_file_legacy_api(void **state)
+{
+    os_md5 md5buffer;
+    os_sha1 sha1buffer;
+    os_sha256 sha256buffer;
+
+    assert_int_equal(OS_MD5_SHA1_SHA256_File(*state, NULL, md5buffer, sha1buffer, sha256buffer, OS_BINARY, 0), 0);
+
+    assert_string_equal(md5buffer, large_md5);
+    assert_string_equal(sha1buffer, large_sha1);
+    assert_string_equal(sha256buffer, large_sha256);
+}
+
+void test_digest_binary_file_max_size_fail(void **state)
+{
+    os_md5 md5buffer;
+    os_sha1 sha1buffer;
+    os_sha256 sha256buffer;
+    char message[OS_SIZE_1024];
+
+    snprintf(message, sizeof(message), "'%s' filesize is larger than the maximum allowed (1 MB). File skipped.", (char *)*state);
+    expect_string(__wrap__mwarn, formatted_msg, message);
+
+    assert_int_equal(OS_Digest_File(*state, NULL, OS_DIGEST_ALL, md5buffer, sha1buffer, sha256buffer, OS_BINARY, TEST_BLOCK_SIZE), -1);
+}
+
+void test_digest_binary_file_not_found(void **state)
+{
+    os_md5 md5buffer;
+    os_sha1 sha1buffer;
+    os_sha256 sha256buffer;
+
+    assert_int_equal(OS_Digest_File("/tmp/tmp_digest_not_found", NULL, OS_DIGEST_ALL, md5buffer, sha1buffer, sha256buffer, OS_BINARY, 0), -1);
+}
+
+void test_digest_binary_file_context_fail(void **state)
+{
+    os_md5 md5buffer;
+    os_sha1 sha1buffer;
+    os_sha256 sha256buffer;
+
+    evp_md_ctx_new_fails = 1;
+
+    assert_int_equal(OS_Digest_File(*state, NULL, OS_DIGEST_SHA256, md5buffer, sha1buffer, sha256buffer, OS_BINARY, 0), -1);
+}
+#endif
+
+void test_digest_text_file_context_fail(void **state)
+{
+    char file_name[256] = "/tmp/tmp_file-XXXXXX";
+    FILE * fp = 0x1;
+    os_md5 md5buffer;
+    os_sha1 sha1buffer;
+    os_sha256 sha256buffer;
+
+    expect_wfopen(file_name, "r", fp);
+    expect_fclose(fp, 0);
+
+    evp_md_ctx_new_fails = 1;
+
+    assert_int_equal(OS_Digest_File(file_name, NULL, OS_DIGEST_MD5, md5buffer, sha1buffer, sha256buffer, OS_TEXT, 20), -1);
+
+    evp_md_ctx_new_fails = 0;
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_md5_sha1_sha256_file),
@@ -170,6 +340,16 @@ int main(void) {
         cmocka_unit_test(test_md5_sha1_sha256_file_fail),
         cmocka_unit_test(test_md5_sha1_sha256_cmd_file_max_size_fail),
         cmocka_unit_test(test_md5_sha1_sha256_file_max_size_fail),
+#ifndef TEST_WINAGENT
+        cmocka_unit_test_setup_teardown(test_digest_binary_file_smaller_than_block, setup_small_file, teardown_file),
+        cmocka_unit_test_setup_teardown(test_digest_binary_file_larger_than_block, setup_large_file, teardown_file),
+        cmocka_unit_test_setup_teardown(test_digest_binary_file_direct_io, setup_large_file, teardown_file),
+        cmocka_unit_test_setup_teardown(test_digest_binary_file_legacy_api, setup_large_file, teardown_file),
+        cmocka_unit_test_setup_teardown(test_digest_binary_file_max_size_fail, setup_large_file, teardown_file),
+        cmocka_unit_test(test_digest_binary_file_not_found),
+        cmocka_unit_test_setup_teardown(test_digest_binary_file_context_fail, setup_small_file, teardown_file),
+#endif
+        cmocka_unit_test(test_digest_text_file_context_fail),
     };
     return cmocka_run_group_tests(tests, setup_group, teardown_group);
 }
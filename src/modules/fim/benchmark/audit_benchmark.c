@@ -0,0 +1,491 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include "shared.h"
+#include "syscheck_audit.h"
+#include <regex.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+
+/* Measures how fast whodata events are parsed as they arrive from the Audit socket.
+ *
+ * Usage: audit_benchmark [capture file] [work folder]
+ *
+ * The capture, in the format of audit.log (the log itself, the output of ausearch --raw or what the af_unix plugin
+ * writes), is replayed over a local Unix socket the way audisp feeds the agent. Without a capture, a stream of events
+ * on monitored files mixed with events of other rules is generated. The records read from the socket are grouped into
+ * events by their id, and every event is parsed with audit_parse_fields, as audit_parse does now, and with the regular
+ * expressions it used to run over the whole event. Results are reported in events per second.
+ */
+
+#define BENCHMARK_EVENTS 200000
+#define BENCHMARK_CHUNK  65536
+
+typedef struct replay {
+    int server;
+    const char *stream;
+    size_t size;
+} replay;
+
+typedef struct parser {
+    const char *name;
+    int (*parse)(const char *event);
+} parser;
+
+static unsigned int seed = 1;
+
+static unsigned int next_random(void) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+}
+
+static void append(char **stream, size_t *size, size_t *capacity, const char *format, ...) {
+    va_list args;
+    int len;
+
+    for (;;) {
+        va_start(args, format);
+        len = vsnprintf(*stream + *size, *capacity - *size, format, args);
+        va_end(args);
+
+        if ((size_t)len < *capacity - *size) {
+            *size += len;
+            return;
+        }
+
+        *capacity *= 2;
+        os_realloc(*stream, *capacity, *stream);
+    }
+}
+
+static void append_hex(char **stream, size_t *size, size_t *capacity, const char *value) {
+    for (; *value != '\0'; value++) {
+        append(stream, size, capacity, "%02X", (unsigned char)*value);
+    }
+}
+
+/* Half of the events are on monitored files, the rest come from other rules: commands run, logins and such */
+static char *generate_stream(int events, size_t *size) {
+    size_t capacity = OS_SIZE_65536;
+    char *stream;
+    int i;
+
+    os_malloc(capacity, stream);
+    *size = 0;
+
+    for (i = 0; i < events; i++) {
+        unsigned int id = 1000 + i;
+        unsigned int pid = 1000 + next_random();
+
+        if (i % 2 == 0) {
+            int items = 1 + next_random() % 5;
+            char name[OS_SIZE_256];
+            int item;
+
+            snprintf(name, sizeof(name), "/etc/app_%u/file ñ %u.conf", next_random() % 50, next_random());
+
+            append(&stream, size, &capacity,
+                   "type=SYSCALL msg=audit(1700000000.%03u:%u): arch=c000003e syscall=257 success=yes exit=3 "
+                   "a0=ffffff9c a1=55c5f8170490 a2=241 a3=1b6 items=%d ppid=%u pid=%u auid=1000 uid=1000 gid=1000 "
+                   "euid=1000 suid=1000 fsuid=1000 egid=1000 sgid=1000 fsgid=1000 tty=pts0 ses=3 comm=\"vim\" "
+                   "exe=\"/usr/bin/vim\" subj=unconfined key=\"wazuh_fim\"\n",
+                   i % 1000, id, items, pid - 1, pid);
+            append(&stream, size, &capacity, "type=CWD msg=audit(1700000000.%03u:%u): cwd=\"/home/user\"\n", i % 1000,
+                   id);
+
+            for (item = 0; item < items; item++) {
+                append(&stream, size, &capacity, "type=PATH msg=audit(1700000000.%03u:%u): item=%d name=", i % 1000, id,
+                       item);
+                // Names with spaces or non-ASCII characters are hex-encoded
+                if (item % 2) {
+                    append_hex(&stream, size, &capacity, name);
+                } else {
+                    append(&stream, size, &capacity, "\"/etc/app_%d/\"", item);
+                }
+                append(&stream, size, &capacity,
+                       " inode=%u dev=fd:00 mode=0100644 ouid=0 ogid=0 rdev=00:00 nametype=%s cap_fp=0 cap_fi=0 "
+                       "cap_fe=0 cap_fver=0\n",
+                       next_random(), item % 2 ? "CREATE" : "PARENT");
+            }
+
+            append(&stream, size, &capacity, "type=PROCTITLE msg=audit(1700000000.%03u:%u): proctitle=", i % 1000, id);
+            append_hex(&stream, size, &capacity, "vim");
+            append(&stream, size, &capacity, "00");
+            append_hex(&stream, size, &capacity, name);
+            append(&stream, size, &capacity, "\n");
+        } else if (i % 3) {
+            append(&stream, size, &capacity,
+                   "type=SYSCALL msg=audit(1700000000.%03u:%u): arch=c000003e syscall=59 success=yes exit=0 "
+                   "a0=55d5b0c1e9e0 a1=55d5b0c1ea40 a2=55d5b0c1ea70 a3=8 items=2 ppid=%u pid=%u auid=1000 uid=1000 "
+                   "gid=1000 euid=1000 suid=1000 fsuid=1000 egid=1000 sgid=1000 fsgid=1000 tty=pts0 ses=3 "
+                   "comm=\"ls\" exe=\"/usr/bin/ls\" subj=unconfined key=\"exec_rule\"\n",
+                   i % 1000, id, pid - 1, pid);
+            append(&stream, size, &capacity,
+                   "type=EXECVE msg=audit(1700000000.%03u:%u): argc=3 a0=\"ls\" a1=\"-la\" a2=\"/var/log/app_%u\"\n",
+                   i % 1000, id, next_random());
+            append(&stream, size, &capacity, "type=CWD msg=audit(1700000000.%03u:%u): cwd=\"/home/user\"\n", i % 1000,
+                   id);
+            append(&stream, size, &capacity,
+                   "type=PATH msg=audit(1700000000.%03u:%u): item=0 name=\"/usr/bin/ls\" inode=%u dev=fd:00 "
+                   "mode=0100755 ouid=0 ogid=0 rdev=00:00 nametype=NORMAL cap_fp=0 cap_fi=0 cap_fe=0 cap_fver=0\n",
+                   i % 1000, id, next_random());
+            append(&stream, size, &capacity,
+                   "type=PATH msg=audit(1700000000.%03u:%u): item=1 name=\"/lib64/ld-linux-x86-64.so.2\" inode=%u "
+                   "dev=fd:00 mode=0100755 ouid=0 ogid=0 rdev=00:00 nametype=NORMAL cap_fp=0 cap_fi=0 cap_fe=0 "
+                   "cap_fver=0\n",
+                   i % 1000, id, next_random());
+            append(&stream, size, &capacity,
+                   "type=PROCTITLE msg=audit(1700000000.%03u:%u): proctitle=6C73002D6C61002F7661722F6C6F67\n",
+                   i % 1000, id);
+        } else {
+            append(&stream, size, &capacity,
+                   "type=USER_START msg=audit(1700000000.%03u:%u): pid=%u uid=0 auid=1000 ses=3 "
+                   "subj=unconfined msg='op=PAM:session_open grantors=pam_unix acct=\"root\" exe=\"/usr/bin/sudo\" "
+                   "hostname=? addr=? terminal=/dev/pts/0 res=success'\n",
+                   i % 1000, id, pid);
+        }
+
+        append(&stream, size, &capacity, "type=EOE msg=audit(1700000000.%03u:%u): \n", i % 1000, id);
+    }
+
+    return stream;
+}
+
+static char *load_capture(const char *path, size_t *size) {
+    FILE *fp = fopen(path, "rb");
+    char *stream;
+    long len;
+
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    os_malloc(len + 1, stream);
+    *size = fread(stream, 1, len, fp);
+    stream[*size] = '\0';
+    fclose(fp);
+
+    return stream;
+}
+
+static double elapsed(const struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* The audisp side: writes the capture to the agent once it connects */
+static void *replay_stream(void *arg) {
+    replay *r = arg;
+    size_t sent = 0;
+    int fd = accept(r->server, NULL, NULL);
+
+    if (fd < 0) {
+        return NULL;
+    }
+
+    while (sent < r->size) {
+        ssize_t n = send(fd, r->stream + sent, r->size - sent, 0);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        sent += n;
+    }
+
+    close(fd);
+    return NULL;
+}
+
+/* Event parsed as audit_parse does now */
+static int parse_fields(const char *event) {
+    audit_fields_t fields;
+
+    audit_parse_fields(event, &fields);
+
+    return fields.key.value != NULL && fields.key.quoted && fields.key.length == strlen(AUDIT_KEY) &&
+           memcmp(fields.key.value, AUDIT_KEY, fields.key.length) == 0 && fields.success.value != NULL &&
+           fields.success.length == 3 && memcmp(fields.success.value, "yes", 3) == 0;
+}
+
+/* Patterns audit_parse used to run over events of monitored files */
+enum { RE_ITEMS, RE_UID, RE_AUID, RE_EUID, RE_GID, RE_PID, RE_PPID, RE_EXE, RE_CWD, RE_PATH0, RE_PATH1, RE_INODE,
+       RE_DEV, RE_PATH2, RE_PATH3, RE_PATH4, RE_COUNT };
+
+static const char *const patterns[RE_COUNT] = {
+    [RE_ITEMS] = " items=([0-9]*) ",       [RE_UID] = " uid=([0-9]*) ",
+    [RE_AUID] = " auid=([0-9]*) ",         [RE_EUID] = " euid=([0-9]*) ",
+    [RE_GID] = " gid=([0-9]*) ",           [RE_PID] = " pid=([0-9]*) ",
+    [RE_PPID] = " ppid=([0-9]*) ",         [RE_EXE] = " exe=\"([^ ]*)\"",
+    [RE_CWD] = " cwd=\"([^ ]*)\"",         [RE_PATH0] = " item=0 name=\"([^ ]*)\"",
+    [RE_PATH1] = " item=1 name=\"([^ ]*)\"", [RE_INODE] = " item=[0-9] name=.* inode=([0-9]*)",
+    [RE_DEV] = " dev=([A-F0-9]*:[A-F0-9]*)", [RE_PATH2] = " item=2 name=\"([^ ]*)\"",
+    [RE_PATH3] = " item=3 name=\"([^ ]*)\"", [RE_PATH4] = " item=4 name=\"([^ ]*)\"",
+};
+
+// Tried when the quoted value isn't found
+static const char *const hex_patterns[RE_COUNT] = {
+    [RE_EXE] = " exe=([A-F0-9]*)",           [RE_CWD] = " cwd=([A-F0-9]*)",
+    [RE_PATH0] = " item=0 name=([A-F0-9]*)", [RE_PATH1] = " item=1 name=([A-F0-9]*)",
+    [RE_PATH2] = " item=2 name=([A-F0-9]*)", [RE_PATH3] = " item=3 name=([A-F0-9]*)",
+    [RE_PATH4] = " item=4 name=([A-F0-9]*)",
+};
+
+static regex_t compiled[RE_COUNT];
+static regex_t compiled_hex[RE_COUNT];
+
+static int regex_field(int field, const char *event, regmatch_t *match) {
+    if (regexec(&compiled[field], event, 2, match, 0) == 0) {
+        return 1;
+    }
+
+    return hex_patterns[field] != NULL && regexec(&compiled_hex[field], event, 2, match, 0) == 0;
+}
+
+/* Event parsed as audit_parse used to do it, the values found aren't copied */
+static int parse_regex(const char *event) {
+    regmatch_t match[2];
+    const char *key;
+    int items = 0;
+    int field;
+
+    // Key lookup of filterkey_audit_events
+    for (key = strstr(event, "key"); key != NULL; key = strstr(key + 1, "key")) {
+        if (key[3] == '=' && (key == event || key[-1] == ' ' || key[-1] == '\n')) {
+            break;
+        }
+    }
+
+    if (key == NULL || strncmp(key + 4, "\"" AUDIT_KEY "\"", strlen(AUDIT_KEY) + 2) != 0 ||
+        strstr(event, "success=yes") == NULL) {
+        return 0;
+    }
+
+    for (field = RE_ITEMS; field <= RE_DEV; field++) {
+        if (regex_field(field, event, match) && field == RE_ITEMS) {
+            items = strtol(event + match[1].rm_so, NULL, 10);
+        }
+    }
+
+    // The rest of names are only looked up for the events that use them
+    switch (items) {
+    case 3:
+        regex_field(RE_PATH2, event, match);
+        break;
+    case 4:
+        regex_field(RE_PATH2, event, match);
+        regex_field(RE_PATH3, event, match);
+        break;
+    case 5:
+        regex_field(RE_PATH4, event, match);
+        break;
+    }
+
+    return 1;
+}
+
+static const char *record_id(const char *line, size_t *len) {
+    const char *begin = strstr(line, "msg=audit(");
+    const char *end;
+
+    if (begin == NULL || (end = strchr(begin += 10, ')'), end == NULL)) {
+        *len = 0;
+        return NULL;
+    }
+
+    *len = end - begin;
+    return begin;
+}
+
+/* The agent side: reads the records from the socket, groups them into events and parses them */
+static int replay_parse(const char *socket_path, const parser *p, const char *stream, size_t size, double *parse_time,
+                        int *matched) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    char *buffer;
+    char *event;
+    size_t event_size = 0;
+    size_t event_capacity = OS_MAXSTR;
+    size_t pending = 0;
+    char id[OS_SIZE_128] = "";
+    replay r = { .stream = stream, .size = size };
+    struct timespec start;
+    pthread_t writer;
+    int events = 0;
+    int fd;
+
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+    unlink(socket_path);
+
+    if (r.server = socket(AF_UNIX, SOCK_STREAM, 0), r.server < 0 ||
+        bind(r.server, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(r.server, 1) != 0) {
+        fprintf(stderr, "Cannot listen on %s: %s\n", socket_path, strerror(errno));
+        return -1;
+    }
+
+    pthread_create(&writer, NULL, replay_stream, &r);
+
+    if (fd = socket(AF_UNIX, SOCK_STREAM, 0), fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "Cannot connect to %s: %s\n", socket_path, strerror(errno));
+        return -1;
+    }
+
+    os_malloc(BENCHMARK_CHUNK + 1, buffer);
+    os_malloc(event_capacity, event);
+    *parse_time = 0;
+    *matched = 0;
+
+    for (;;) {
+        ssize_t n = recv(fd, buffer + pending, BENCHMARK_CHUNK - pending, 0);
+        char *line = buffer;
+        char *endline;
+        int done = n <= 0;
+
+        if (!done) {
+            pending += n;
+        }
+
+        buffer[pending] = '\0';
+
+        // At the end of the stream, the last line may lack its newline
+        while ((endline = strchr(line, '\n')) != NULL || (done && *line != '\0')) {
+            size_t line_len = endline ? (size_t)(endline - line) : strlen(line);
+            size_t id_len;
+            const char *line_id;
+
+            line[line_len] = '\0';
+            line_id = record_id(line, &id_len);
+
+            // An event ends when a record of another one arrives
+            if (event_size > 0 && (line_id == NULL || id_len != strlen(id) || strncmp(line_id, id, id_len) != 0)) {
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                *matched += p->parse(event);
+                *parse_time += elapsed(&start);
+                events++;
+                event_size = 0;
+            }
+
+            if (line_id != NULL && strncmp(line, "type=EOE", 8) != 0) {
+                snprintf(id, sizeof(id), "%.*s", (int)id_len, line_id);
+
+                if (event_size + line_len + 2 > event_capacity) {
+                    event_capacity = 2 * (event_size + line_len + 2);
+                    os_realloc(event, event_capacity, event);
+                }
+
+                memcpy(event + event_size, line, line_len);
+                event_size += line_len;
+                event[event_size++] = '\n';
+                event[event_size] = '\0';
+            }
+
+            line += endline ? line_len + 1 : line_len;
+        }
+
+        pending -= line - buffer;
+        memmove(buffer, line, pending);
+
+        if (done) {
+            break;
+        }
+
+        if (pending == BENCHMARK_CHUNK) {
+            // A single record longer than the buffer, drop it
+            pending = 0;
+        }
+    }
+
+    if (event_size > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        *matched += p->parse(event);
+        *parse_time += elapsed(&start);
+        events++;
+    }
+
+    pthread_join(writer, NULL);
+    close(fd);
+    close(r.server);
+    unlink(socket_path);
+    os_free(buffer);
+    os_free(event);
+
+    return events;
+}
+
+int main(int argc, char **argv) {
+    const char *capture = argc > 1 ? argv[1] : NULL;
+    const char *folder = argc > 2 ? argv[2] : "/tmp";
+    const parser parsers[] = {
+        { "single-pass", parse_fields },
+        { "regex", parse_regex },
+    };
+    char socket_path[PATH_MAX];
+    char *stream;
+    size_t size;
+    size_t i;
+
+    if (capture != NULL && strcmp(capture, "-") != 0) {
+        if (stream = load_capture(capture, &size), stream == NULL) {
+            fprintf(stderr, "Cannot read %s: %s\nUsage: %s [capture file] [work folder]\n", capture, strerror(errno),
+                    argv[0]);
+            return 1;
+        }
+    } else {
+        stream = generate_stream(BENCHMARK_EVENTS, &size);
+    }
+
+    for (i = 0; i < RE_COUNT; i++) {
+        if (regcomp(&compiled[i], patterns[i], REG_EXTENDED | (i == RE_DEV ? REG_ICASE : 0)) != 0 ||
+            (hex_patterns[i] != NULL && regcomp(&compiled_hex[i], hex_patterns[i], REG_EXTENDED | REG_ICASE) != 0)) {
+            fprintf(stderr, "Cannot compile the pattern of field %zu\n", i);
+            return 1;
+        }
+    }
+
+    snprintf(socket_path, sizeof(socket_path), "%s/audit_benchmark.sock", folder);
+
+    for (i = 0; i < sizeof(parsers) / sizeof(parsers[0]); i++) {
+        struct timespec start;
+        double parse_time;
+        double total_time;
+        int matched;
+        int events;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        events = replay_parse(socket_path, &parsers[i], stream, size, &parse_time, &matched);
+        total_time = elapsed(&start);
+
+        if (events < 0) {
+            return 1;
+        }
+
+        printf("%-12s %10.0f events/s replayed %12.0f events/s parsed %8d events %8d on monitored files\n",
+               parsers[i].name, events / total_time, events / parse_time, events, matched);
+    }
+
+    for (i = 0; i < RE_COUNT; i++) {
+        regfree(&compiled[i]);
+        if (hex_patterns[i] != NULL) {
+            regfree(&compiled_hex[i]);
+        }
+    }
+
+    os_free(stream);
+
+    return 0;
+}
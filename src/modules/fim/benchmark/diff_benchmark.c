@@ -0,0 +1,259 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All rights reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include "shared.h"
+#include "syscheck.h"
+#include <time.h>
+#include <zlib.h>
+
+/* Measures the cost of computing the report_changes diff of a file.
+ *
+ * Usage: diff_benchmark [number of files] [work folder]
+ *
+ * A corpus of configuration files (sections, comments and key = value lines, 40 to 2000 lines each) is generated
+ * together with an edited version of each one, with the kind of changes usually found in them: a value changed, a
+ * line added, a line removed or commented out, or a block moved. Every pair is diffed as fim_file_diff does now,
+ * reading the compressed snapshot into memory and diffing it with fim_diff_lines, and as it used to do, uncompressing
+ * the snapshot to a temporary file and running the diff command. Results are reported in diffs per second.
+ */
+
+char *fim_diff_read_snapshot(const char *path, size_t *size);
+char *fim_diff_read_file(const char *path, size_t *size);
+char *fim_diff_lines(const char *old_data, size_t old_size, const char *new_data, size_t new_size);
+
+#define BENCHMARK_FILES 200
+
+static unsigned int seed = 1;
+
+static unsigned int next_random(void) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+}
+
+static char **generate_config(int *count) {
+    int lines = 40 + next_random() % 1960;
+    char **config;
+    char buffer[OS_SIZE_256];
+    int i;
+
+    os_calloc(lines, sizeof(char *), config);
+
+    for (i = 0; i < lines; i++) {
+        unsigned int kind = next_random() % 10;
+
+        if (kind == 0) {
+            snprintf(buffer, sizeof(buffer), "[section_%u]\n", next_random());
+        } else if (kind < 3) {
+            snprintf(buffer, sizeof(buffer), "# Setting %u controls the behavior of module %u\n", next_random(), i);
+        } else if (kind == 3) {
+            snprintf(buffer, sizeof(buffer), "\n");
+        } else {
+            snprintf(buffer, sizeof(buffer), "option_%d_%u = %u\n", i, next_random(), next_random());
+        }
+
+        os_strdup(buffer, config[i]);
+    }
+
+    *count = lines;
+    return config;
+}
+
+static void edit_config(char **config, int count) {
+    int edits = 1 + next_random() % 4;
+    char buffer[OS_SIZE_256];
+
+    while (edits-- > 0) {
+        int line = next_random() % count;
+        unsigned int kind = next_random() % 5;
+
+        if (kind == 0) {
+            snprintf(buffer, sizeof(buffer), "option_%d = %u\n", line, next_random());
+        } else if (kind == 1) {
+            snprintf(buffer, sizeof(buffer), "%snew_option_%u = yes\n", config[line], next_random());
+        } else if (kind == 2) {
+            buffer[0] = '\0';
+        } else if (kind == 3) {
+            snprintf(buffer, sizeof(buffer), "# %s", config[line]);
+        } else {
+            // Move a block of lines down
+            int length = 1 + next_random() % 8;
+            int target = line + length + next_random() % 32;
+            int i;
+
+            if (target >= count) {
+                continue;
+            }
+
+            for (i = 0; i < length; i++) {
+                char *moved = config[line];
+                memmove(config + line, config + line + 1, (target - line) * sizeof(char *));
+                config[target] = moved;
+            }
+
+            continue;
+        }
+
+        os_free(config[line]);
+        os_strdup(buffer, config[line]);
+    }
+}
+
+static int write_config(const char *path, char **config, int count, int compressed) {
+    int i;
+
+    if (compressed) {
+        gzFile fp = gzopen(path, "wb");
+
+        if (fp == NULL) {
+            return -1;
+        }
+
+        for (i = 0; i < count; i++) {
+            gzputs(fp, config[i]);
+        }
+
+        return gzclose(fp) == Z_OK ? 0 : -1;
+    } else {
+        FILE *fp = fopen(path, "w");
+
+        if (fp == NULL) {
+            return -1;
+        }
+
+        for (i = 0; i < count; i++) {
+            fputs(config[i], fp);
+        }
+
+        return fclose(fp);
+    }
+}
+
+static double elapsed(const struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* The in-process diff, as fim_file_diff computes it */
+static size_t diff_in_process(const char *snapshot, const char *file) {
+    size_t old_size;
+    size_t new_size;
+    size_t len = 0;
+    char *old_data = fim_diff_read_snapshot(snapshot, &old_size);
+    char *new_data = fim_diff_read_file(file, &new_size);
+
+    if (old_data != NULL && new_data != NULL) {
+        char *diff = fim_diff_lines(old_data, old_size, new_data, new_size);
+        len = strlen(diff);
+        os_free(diff);
+    }
+
+    os_free(old_data);
+    os_free(new_data);
+
+    return len;
+}
+
+/* The diff through the diff command, as fim_file_diff used to compute it */
+static size_t diff_command(const char *snapshot, const char *file, const char *folder) {
+    char uncompressed[PATH_MAX];
+    char output[PATH_MAX];
+    char command[PATH_MAX * 3 + OS_SIZE_1024];
+    char buffer[OS_MAXSTR + 1];
+    size_t len = 0;
+    FILE *fp;
+
+    snprintf(uncompressed, sizeof(uncompressed), "%s/tmp-entry", folder);
+    snprintf(output, sizeof(output), "%s/diff-file", folder);
+
+    if (w_uncompress_gzfile(snapshot, uncompressed) != 0) {
+        return 0;
+    }
+
+    snprintf(command, sizeof(command), "diff \"%s\" \"%s\" > \"%s\" 2> /dev/null", uncompressed, file, output);
+
+    if (system(command) == 256 && (fp = fopen(output, "rb")) != NULL) {
+        len = fread(buffer, 1, OS_MAXSTR - OS_SK_HEADER - 1, fp);
+        fclose(fp);
+    }
+
+    unlink(output);
+    unlink(uncompressed);
+
+    return len;
+}
+
+int main(int argc, char **argv) {
+    int files = argc > 1 ? atoi(argv[1]) : BENCHMARK_FILES;
+    const char *folder = argc > 2 ? argv[2] : "/tmp";
+    char path[PATH_MAX];
+    struct timespec start;
+    size_t in_process_bytes = 0;
+    size_t command_bytes = 0;
+    double in_process_time;
+    double command_time;
+    int i;
+
+    if (files <= 0) {
+        fprintf(stderr, "Usage: %s [number of files] [work folder]\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < files; i++) {
+        int count;
+        int j;
+        char **config = generate_config(&count);
+
+        snprintf(path, sizeof(path), "%s/diff_benchmark_%d.gz", folder, i);
+        write_config(path, config, count, 1);
+
+        edit_config(config, count);
+
+        snprintf(path, sizeof(path), "%s/diff_benchmark_%d", folder, i);
+        write_config(path, config, count, 0);
+
+        for (j = 0; j < count; j++) {
+            os_free(config[j]);
+        }
+        os_free(config);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < files; i++) {
+        char snapshot[PATH_MAX];
+
+        snprintf(snapshot, sizeof(snapshot), "%s/diff_benchmark_%d.gz", folder, i);
+        snprintf(path, sizeof(path), "%s/diff_benchmark_%d", folder, i);
+        in_process_bytes += diff_in_process(snapshot, path);
+    }
+    in_process_time = elapsed(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < files; i++) {
+        char snapshot[PATH_MAX];
+
+        snprintf(snapshot, sizeof(snapshot), "%s/diff_benchmark_%d.gz", folder, i);
+        snprintf(path, sizeof(path), "%s/diff_benchmark_%d", folder, i);
+        command_bytes += diff_command(snapshot, path, folder);
+    }
+    command_time = elapsed(&start);
+
+    printf("%-12s %10.1f diffs/s %10zu bytes of changes\n", "in-process", files / in_process_time, in_process_bytes);
+    printf("%-12s %10.1f diffs/s %10zu bytes of changes\n", "diff command", files / command_time, command_bytes);
+
+    for (i = 0; i < files; i++) {
+        snprintf(path, sizeof(path), "%s/diff_benchmark_%d.gz", folder, i);
+        unlink(path);
+        snprintf(path, sizeof(path), "%s/diff_benchmark_%d", folder, i);
+        unlink(path);
+    }
+
+    return 0;
+}
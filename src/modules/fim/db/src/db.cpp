@@ -363,16 +363,9 @@ FIMDBErrorCode fim_db_transaction_sync_row(TXN_HANDLE txn_handler, const fim_ent
 
         try
         {
-
-            const std::unique_ptr<cJSON, CJsonSmartDeleter> jsInput
-            {
-                cJSON_Parse((*syncItem->toJSON()).dump().c_str())
-            };
-
-            if (dbsync_sync_txn_row(txn_handler, jsInput.get()) == 0)
-            {
-                retval = FIMDB_OK;
-            }
+            // The item is handed over as is, without going through its text form and the C interface
+            DBSyncTxn(txn_handler).syncTxnRow(*syncItem->toJSON());
+            retval = FIMDB_OK;
         }
         catch (std::exception& err)
         {
@@ -31,6 +31,7 @@ void FileItem::createFimEntry()
             data->user_name = const_cast<char*>(m_username.c_str());
             data->group_name = const_cast<char*>(m_groupname.c_str());
             data->mtime = m_time;
+            data->ctime = m_changeTime;
             data->inode = m_inode;
             std::snprintf(data->hash_md5, sizeof(data->hash_md5), "%s", m_md5.c_str());
             std::snprintf(data->hash_sha1, sizeof(data->hash_sha1), "%s", m_sha1.c_str());
@@ -88,12 +89,14 @@ void FileItem::createJSON()
     data["hash_sha1"] = m_sha1;
     data["hash_sha256"] = m_sha256;
     data["mtime"] = m_time;
+    data["ctime"] = m_changeTime;
     conf["data"] = nlohmann::json::array({data});
 
     if (m_oldData)
     {
         options["return_old_data"] = true;
-        options["ignore"] = nlohmann::json::array({"last_event"});
+        // A change of the change time alone is not reported, it only makes the next scan hash the file again
+        options["ignore"] = nlohmann::json::array({"last_event", "ctime"});
         conf["options"] = options;
     }
 
@@ -45,6 +45,7 @@ class FileItem final : public DBItem
             m_oldData = oldData;
             m_options = fim->file_entry.data->options;
             m_time = fim->file_entry.data->mtime;
+            m_changeTime = fim->file_entry.data->ctime;
             m_size = fim->file_entry.data->size;
             m_dev = fim->file_entry.data->dev;
             m_inode = fim->file_entry.data->inode;
@@ -73,6 +74,7 @@ class FileItem final : public DBItem
         {
             m_options = fim.at("options");
             m_time = fim.at("mtime");
+            m_changeTime = fim.value("ctime", static_cast<time_t>(0));
             m_size = fim.at("size");
             m_dev = fim.at("dev");
             m_inode = fim.at("inode");
@@ -109,6 +111,7 @@ class FileItem final : public DBItem
         unsigned long int                               m_dev;
         unsigned long long int                          m_inode;
         time_t                                          m_time;
+        time_t                                          m_changeTime;
         std::string                                     m_attributes;
         std::string                                     m_groupname;
         std::string                                     m_md5;
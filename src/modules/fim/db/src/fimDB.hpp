@@ -57,6 +57,8 @@ constexpr auto CREATE_FILE_DB_STATEMENT
     hash_sha1 TEXT,
     hash_sha256 TEXT,
     mtime INTEGER,
+    ctime INTEGER,
+    db_row_hash_dm BIGINT,
     PRIMARY KEY(path)) WITHOUT ROWID;
     CREATE INDEX IF NOT EXISTS path_index ON file_entry (path);
     CREATE INDEX IF NOT EXISTS inode_index ON file_entry (dev, inode);)"
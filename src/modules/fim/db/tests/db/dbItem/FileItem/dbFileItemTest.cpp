@@ -32,6 +32,7 @@ void FileItemTest::SetUp()
     data->last_event = 1596489275;
     data->mode = FIM_SCHEDULED;
     data->mtime = 1578075431;
+    data->ctime = 1578075431;
     data->options = 131583;
     data->perm = const_cast<char*>("-rw-rw-r--");
     data->scanned = 1;
@@ -99,7 +100,7 @@ TEST_F(FileItemTest, fileItemConstructorFromJSON)
 {
     const auto insertJSON = R"(
         {
-            "attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "dev":2051, "gid":"0", "group_name":"root",
+            "attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "ctime":1578075431, "dev":2051, "gid":"0", "group_name":"root",
             "hash_md5":"4b531524aa13c8a54614100b570b3dc7", "hash_sha1":"7902feb66d0bcbe4eb88e1bfacf28befc38bd58b",
             "hash_sha256":"e403b83dd73a41b286f8db2ee36d6b0ea6e80b49f02c476e0a20b4181a3a062a", "inode":1152921500312810880, "last_event":1596489275,
             "mode":0, "mtime":1578075431, "options":131583, "path":"/etc/wgetrc", "perm":"-rw-rw-r--", "scanned":1, "size":4925,
@@ -132,6 +133,7 @@ TEST_F(FileItemTest, getFIMEntryWithFimCtr)
     ASSERT_EQ(fileEntry->file_entry.data->last_event, fimEntryTest->file_entry.data->last_event);
     ASSERT_EQ(fileEntry->file_entry.data->mode, fimEntryTest->file_entry.data->mode);
     ASSERT_EQ(fileEntry->file_entry.data->mtime, fimEntryTest->file_entry.data->mtime);
+    ASSERT_EQ(fileEntry->file_entry.data->ctime, fimEntryTest->file_entry.data->ctime);
     ASSERT_EQ(fileEntry->file_entry.data->options, fimEntryTest->file_entry.data->options);
     ASSERT_EQ(std::strcmp(fileEntry->file_entry.data->perm, fimEntryTest->file_entry.data->perm), 0);
     ASSERT_EQ(fileEntry->file_entry.data->scanned, fimEntryTest->file_entry.data->scanned);
@@ -146,7 +148,7 @@ TEST_F(FileItemTest, getFIMEntryWithJSONCtr)
 {
     const auto insertJSON = R"(
         {
-            "attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "dev":2051, "gid":"0", "group_name":"root",
+            "attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "ctime":1578075431, "dev":2051, "gid":"0", "group_name":"root",
             "hash_md5":"4b531524aa13c8a54614100b570b3dc7", "hash_sha1":"7902feb66d0bcbe4eb88e1bfacf28befc38bd58b",
             "hash_sha256":"e403b83dd73a41b286f8db2ee36d6b0ea6e80b49f02c476e0a20b4181a3a062a", "inode":1152921500312810880, "last_event":1596489275,
             "mode":0, "mtime":1578075431, "options":131583, "path":"/etc/wgetrc", "perm":"-rw-rw-r--", "scanned":1, "size":4925,
@@ -168,6 +170,7 @@ TEST_F(FileItemTest, getFIMEntryWithJSONCtr)
     ASSERT_EQ(fileEntry->file_entry.data->last_event, fimEntryTest->file_entry.data->last_event);
     ASSERT_EQ(fileEntry->file_entry.data->mode, fimEntryTest->file_entry.data->mode);
     ASSERT_EQ(fileEntry->file_entry.data->mtime, fimEntryTest->file_entry.data->mtime);
+    ASSERT_EQ(fileEntry->file_entry.data->ctime, fimEntryTest->file_entry.data->ctime);
     ASSERT_EQ(fileEntry->file_entry.data->options, fimEntryTest->file_entry.data->options);
     ASSERT_EQ(std::strcmp(fileEntry->file_entry.data->perm, fimEntryTest->file_entry.data->perm), 0);
     ASSERT_EQ(fileEntry->file_entry.data->scanned, fimEntryTest->file_entry.data->scanned);
@@ -184,7 +187,7 @@ TEST_F(FileItemTest, getJSONWithFimCtr)
     const auto expectedValue = R"(
         {
             "table": "file_entry",
-            "data":[{"attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "dev":2051, "gid":"0", "group_name":"root",
+            "data":[{"attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "ctime":1578075431, "dev":2051, "gid":"0", "group_name":"root",
             "hash_md5":"4b531524aa13c8a54614100b570b3dc7", "hash_sha1":"7902feb66d0bcbe4eb88e1bfacf28befc38bd58b",
             "hash_sha256":"e403b83dd73a41b286f8db2ee36d6b0ea6e80b49f02c476e0a20b4181a3a062a", "inode":1152921500312810880, "last_event":1596489275,
             "mode":0, "mtime":1578075431, "options":131583, "path":"/etc/wgetrc", "perm":"-rw-rw-r--", "scanned":1, "size":4925,
@@ -201,7 +204,7 @@ TEST_F(FileItemTest, getJSONWithJSONCtr)
     const auto expectedValue = R"(
         {
             "table": "file_entry",
-            "data":[{"attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "dev":2051, "gid":"0", "group_name":"root",
+            "data":[{"attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "ctime":1578075431, "dev":2051, "gid":"0", "group_name":"root",
             "hash_md5":"4b531524aa13c8a54614100b570b3dc7", "hash_sha1":"7902feb66d0bcbe4eb88e1bfacf28befc38bd58b",
             "hash_sha256":"e403b83dd73a41b286f8db2ee36d6b0ea6e80b49f02c476e0a20b4181a3a062a", "inode":1152921500312810880, "last_event":1596489275,
             "mode":0, "mtime":1578075431, "options":131583, "path":"/etc/wgetrc", "perm":"-rw-rw-r--", "scanned":1, "size":4925,
@@ -218,11 +221,11 @@ TEST_F(FileItemTest, fileItemReportOldData)
     const auto expectedValue = R"(
         {
             "table": "file_entry",
-            "data":[{"attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "dev":2051, "gid":"0", "group_name":"root",
+            "data":[{"attributes":"10", "checksum":"a2fbef8f81af27155dcee5e3927ff6243593b91a", "ctime":1578075431, "dev":2051, "gid":"0", "group_name":"root",
             "hash_md5":"4b531524aa13c8a54614100b570b3dc7", "hash_sha1":"7902feb66d0bcbe4eb88e1bfacf28befc38bd58b",
             "hash_sha256":"e403b83dd73a41b286f8db2ee36d6b0ea6e80b49f02c476e0a20b4181a3a062a", "inode":1152921500312810880, "last_event":1596489275,
             "mode":0, "mtime":1578075431, "options":131583, "path":"/etc/wgetrc", "perm":"-rw-rw-r--", "scanned":1, "size":4925,
-            "uid":"0", "user_name":"fakeUser"}],"options":{"return_old_data": true, "ignore":["last_event"]}
+            "uid":"0", "user_name":"fakeUser"}],"options":{"return_old_data": true, "ignore":["last_event", "ctime"]}
         }
     )"_json;
     ASSERT_TRUE(*file->toJSON() == expectedValue);
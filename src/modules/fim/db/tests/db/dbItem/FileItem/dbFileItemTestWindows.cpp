@@ -32,6 +32,7 @@ void FileItemTest::SetUp()
     data->last_event = 1596489275;
     data->mode = FIM_SCHEDULED;
     data->mtime = 1578075431;
+    data->ctime = 1578075431;
     data->options = 131583;
     data->scanned = 1;
     data->perm =
@@ -44,6 +45,7 @@ void FileItemTest::SetUp()
     {
         {"attributes", "10"},
         {"checksum", "a2fbef8f81af27155dcee5e3927ff6243593b91a"},
+        {"ctime", 1578075431},
         {"dev", 2051},
         {"gid", "0"},
         {"group_name", "root"},
@@ -143,6 +145,7 @@ TEST_F(FileItemTest, getFIMEntryWithFimCtr)
     ASSERT_EQ(fileEntry->file_entry.data->last_event, fimEntryTest->file_entry.data->last_event);
     ASSERT_EQ(fileEntry->file_entry.data->mode, fimEntryTest->file_entry.data->mode);
     ASSERT_EQ(fileEntry->file_entry.data->mtime, fimEntryTest->file_entry.data->mtime);
+    ASSERT_EQ(fileEntry->file_entry.data->ctime, fimEntryTest->file_entry.data->ctime);
     ASSERT_EQ(fileEntry->file_entry.data->options, fimEntryTest->file_entry.data->options);
     ASSERT_EQ(fileEntry->file_entry.data->scanned, fimEntryTest->file_entry.data->scanned);
     ASSERT_EQ(fileEntry->file_entry.data->size, fimEntryTest->file_entry.data->size);
@@ -167,6 +170,7 @@ TEST_F(FileItemTest, getFIMEntryWithJSONCtr)
     ASSERT_EQ(fileEntry->file_entry.data->last_event, fimEntryTest->file_entry.data->last_event);
     ASSERT_EQ(fileEntry->file_entry.data->mode, fimEntryTest->file_entry.data->mode);
     ASSERT_EQ(fileEntry->file_entry.data->mtime, fimEntryTest->file_entry.data->mtime);
+    ASSERT_EQ(fileEntry->file_entry.data->ctime, fimEntryTest->file_entry.data->ctime);
     ASSERT_EQ(fileEntry->file_entry.data->options, fimEntryTest->file_entry.data->options);
     ASSERT_EQ(fileEntry->file_entry.data->scanned, fimEntryTest->file_entry.data->scanned);
     ASSERT_EQ(fileEntry->file_entry.data->size, fimEntryTest->file_entry.data->size);
@@ -192,6 +196,6 @@ TEST_F(FileItemTest, fileItemReportOldData)
 {
     auto file = std::make_unique<FileItem>(fimEntryTest, true);
     const auto returnValue = *file->toJSON();
-    const auto expectedValue = R"({"return_old_data": true, "ignore":["last_event"]})"_json;
+    const auto expectedValue = R"({"return_old_data": true, "ignore":["last_event", "ctime"]})"_json;
     ASSERT_TRUE(returnValue["options"] == expectedValue);
 }
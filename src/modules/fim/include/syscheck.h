@@ -76,6 +76,7 @@ typedef struct _event_data_s {
     fim_event_type type;
     struct stat statbuf;
     whodata_evt *w_evt;
+    int reuse_hashes;       // Scheduled scans only: take the hashes from the DB for files whose stat data is unchanged
 } event_data_t;
 
 typedef struct fim_tmp_file {
@@ -112,9 +113,13 @@ typedef struct create_json_event_ctx {
     const directory_t* config;
 } create_json_event_ctx;
 
+typedef struct fim_scan_pool fim_scan_pool_t;
+typedef struct fim_scan_worker fim_scan_worker_t;
+
 typedef struct fim_txn_context_s {
     event_data_t* evt_data;
     fim_entry* latest_entry;
+    fim_scan_worker_t* worker;  // Scan worker running the check, NULL if the scan is not parallel
 } fim_txn_context_t;
 
 #ifdef WIN32
@@ -276,10 +281,34 @@ int fim_check_depth(const char *path, const directory_t *configuration);
  * @param file Name of the file to get the data from
  * @param [in] configuration Configuration block associated with a previous event.
  * @param [in] statbuf Buffer acquired from a stat command with information linked to 'path'
+ * @param [in] stored_data Data of the file stored in the DB, or NULL. Its hashes are reused instead of reading the
+ *                         file when the size, modification and change times, inode, device and options have not changed.
  *
  * @return A fim_file_data structure with the data from the file
  */
-fim_file_data *fim_get_data(const char *file, const directory_t *configuration, const struct stat *statbuf);
+fim_file_data *fim_get_data(const char *file,
+                            const directory_t *configuration,
+                            const struct stat *statbuf,
+                            const fim_file_data *stored_data);
+
+/**
+ * @brief Get the data of a file stored in the DB, if its hashes may be reused by fim_get_data
+ *
+ * Only regular files that would be hashed and whose configuration checks both the size and the modification time
+ * are looked up. Files hashed through the prefilter command are never looked up.
+ *
+ * @param file Name of the file
+ * @param [in] configuration Configuration block associated with the file
+ * @param [in] statbuf Buffer acquired from a stat command with information linked to 'file'
+ * @param [out] stored_data Data stored in the DB. Only the scalar fields and the hashes are filled.
+ *
+ * @retval true if the file was found in the DB.
+ * @retval false otherwise.
+ */
+bool fim_get_stored_data(const char *file,
+                         const directory_t *configuration,
+                         const struct stat *statbuf,
+                         fim_file_data *stored_data);
 
 /**
  * @brief Initialize a fim_file_data structure
@@ -404,9 +433,25 @@ void fim_realtime_print_watches();
 /**
  * @brief Process events in the real time queue
  *
+ * Paths are checked once they have gone rt_quiet_period milliseconds without events, so a burst of writes to a file
+ * is checked once. With no quiet period, they are checked as soon as their events are read.
  */
 void realtime_process(void);
 
+/**
+ * @brief Check the paths waiting to settle
+ *
+ * @param force Check every waiting path, even if it hasn't settled yet
+ */
+void realtime_flush(int force);
+
+/**
+ * @brief Get the time until the paths waiting to settle must be checked again
+ *
+ * @return Milliseconds to wait, -1 if no path is waiting
+ */
+int realtime_flush_timeout(void);
+
 /**
  * @brief Deletes subdirectories watches when a folder changes its name
  *
@@ -463,13 +508,6 @@ int audit_init(void);
  */
 char *audit_get_id(const char * event);
 
-/**
- * @brief Initialize regular expressions
- *
- * @return 0 on success, -1 on error
- */
-int init_regex(void);
-
 /**
  * @brief Adds audit rules to directories
  *
@@ -894,6 +932,76 @@ int fim_generate_delete_event(const char *file_path,
                               const void *evt_data,
                               const void *configuration);
 
+/**
+ * @brief Create a pool of workers to scan directories in parallel
+ *
+ * Each worker keeps its own queue of paths to check. Workers take their most recent paths first and, once out of
+ * work, take the oldest ones from the other workers. Files are read with at most syscheck.scan_device_threads
+ * workers per device (one for rotational disks) and DB updates go through a single writer at a time.
+ *
+ * @param threads Number of workers
+ * @param evt_data Information associated to the scan, copied by each worker
+ * @param txn_handle DBSync transaction handler
+ * @param txn_context DBSync transaction context, shared by the workers
+ *
+ * @return Pool of workers, already running
+ */
+fim_scan_pool_t *fim_scan_pool_create(unsigned int threads,
+                                      const event_data_t *evt_data,
+                                      TXN_HANDLE txn_handle,
+                                      fim_txn_context_t *txn_context);
+
+/**
+ * @brief Add a directory to scan to the pool
+ *
+ * @param pool Pool of workers
+ * @param path Path to check
+ * @param configuration Configuration block of the directory
+ */
+void fim_scan_pool_add(fim_scan_pool_t *pool, const char *path, const directory_t *configuration);
+
+/**
+ * @brief Wait until every path added to the pool has been checked, then stop and free the pool
+ *
+ * @param pool Pool of workers
+ */
+void fim_scan_pool_wait(fim_scan_pool_t *pool);
+
+/**
+ * @brief Queue a path to be checked by the pool, from within a worker
+ *
+ * The path is checked right away when the queue of the worker is full.
+ *
+ * @param worker Worker running the check
+ * @param path Path to check
+ * @param configuration Configuration block associated with the path
+ */
+void fim_scan_worker_push(fim_scan_worker_t *worker, const char *path, const directory_t *configuration);
+
+/**
+ * @brief Wait until a file of a device may be read
+ *
+ * @param worker Worker running the check
+ * @param device Device of the file
+ */
+void fim_scan_worker_acquire_device(fim_scan_worker_t *worker, dev_t device);
+
+/**
+ * @brief Release the device acquired with fim_scan_worker_acquire_device
+ *
+ * @param worker Worker running the check
+ * @param device Device of the file
+ */
+void fim_scan_worker_release_device(fim_scan_worker_t *worker, dev_t device);
+
+/**
+ * @brief Synchronize an entry within the scan transaction, one worker at a time
+ *
+ * @param worker Worker running the check
+ * @param entry Entry to synchronize
+ */
+void fim_scan_worker_sync_row(fim_scan_worker_t *worker, fim_entry *entry);
+
 /**
  * @brief Send a state synchronization message.
  *
@@ -32,6 +32,37 @@ typedef enum audit_key_type {
     FIM_AUDIT_CUSTOM_KEY
 } audit_key_type;
 
+#define AUDIT_MAX_ITEMS 5 // PATH records read from an event
+
+// Value of a field of an audit event, it points into the event and isn't null-terminated
+typedef struct {
+    const char *value;
+    size_t length;
+    int quoted;     // Unquoted paths, names and keys are hex-encoded
+} audit_field_t;
+
+// Fields of an audit event read by FIM, NULL values for the missing ones
+typedef struct {
+    audit_field_t key;
+    audit_field_t success;
+    audit_field_t syscall;
+    audit_field_t items;
+    audit_field_t uid;
+    audit_field_t gid;
+    audit_field_t auid;
+    audit_field_t euid;
+    audit_field_t pid;
+    audit_field_t ppid;
+    audit_field_t exe;
+    audit_field_t cwd;
+    audit_field_t name[AUDIT_MAX_ITEMS];
+    audit_field_t inode;
+    audit_field_t dev;
+    audit_field_t op;
+    audit_field_t dir;
+    int config_change;
+} audit_fields_t;
+
 /**
  * @brief Checks if the manipulation of the audit rule was done by FIM or by an user
 
@@ -56,7 +87,17 @@ int fim_audit_rules_init();
 int fim_rules_initial_load();
 
 // Public parse functions
-void clean_regex();
+
+/**
+ * @brief Reads the fields used by FIM from an audit event in a single pass.
+ *
+ * The key is read from any record, the rest of fields only from the SYSCALL, CWD, PATH and CONFIG_CHANGE records.
+ * The first occurrence of a field is kept, but for the inode, which is the one of the last PATH record.
+ *
+ * @param buffer Audit event, made of the records that share its id.
+ * @param [out] fields Fields of the event, pointing into buffer.
+ */
+void audit_parse_fields(const char *buffer, audit_fields_t *fields);
 
 extern pthread_mutex_t audit_mutex;
 extern atomic_int_t audit_thread_active;
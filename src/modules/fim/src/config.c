@@ -509,10 +509,15 @@ cJSON *getSyscheckInternalOptions(void) {
     cJSON *syscheckd = cJSON_CreateObject();
 
     cJSON_AddNumberToObject(syscheckd,"rt_delay",syscheck.rt_delay);
+    cJSON_AddNumberToObject(syscheckd,"rt_quiet_period",syscheck.rt_quiet_period);
+    cJSON_AddNumberToObject(syscheckd,"rt_max_pending",syscheck.rt_max_pending);
     cJSON_AddNumberToObject(syscheckd,"default_max_depth",syscheck.max_depth);
     cJSON_AddNumberToObject(syscheckd,"symlink_scan_interval",syscheck.sym_checker_interval);
     cJSON_AddNumberToObject(syscheckd,"debug",sys_debug_level);
     cJSON_AddNumberToObject(syscheckd,"file_max_size",syscheck.file_max_size);
+    cJSON_AddNumberToObject(syscheckd,"rehash_interval",syscheck.rehash_interval);
+    cJSON_AddNumberToObject(syscheckd,"scan_threads",syscheck.scan_threads);
+    cJSON_AddNumberToObject(syscheckd,"scan_device_threads",syscheck.scan_device_threads);
 #ifdef WIN32
     cJSON_AddNumberToObject(syscheckd,"max_fd_win_rt",syscheck.max_fd_win_rt);
 #else
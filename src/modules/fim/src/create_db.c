@@ -476,18 +476,64 @@ int fim_generate_delete_event(const char *file_path,
     return fim_db_get_path(file_path, callback_data);
 }
 
+/**
+ * @brief Check every monitored directory within a scan transaction
+ *
+ * Directories are walked by a pool of workers when syscheck.scan_threads is greater than 1.
+ *
+ * @param evt_data Information associated to the scan
+ * @param txn_handle DBSync transaction handler
+ * @param txn_ctx DBSync transaction context
+ */
+static void fim_scan_directories(event_data_t *evt_data, TXN_HANDLE txn_handle, fim_txn_context_t *txn_ctx) {
+    OSListNode *node_it;
+    directory_t *dir_it;
+    fim_scan_pool_t *pool = NULL;
+
+    if (syscheck.scan_threads > 1) {
+        pool = fim_scan_pool_create(syscheck.scan_threads, evt_data, txn_handle, txn_ctx);
+    }
+
+    w_rwlock_rdlock(&syscheck.directories_lock);
+    OSList_foreach(node_it, syscheck.directories) {
+        dir_it = node_it->data;
+        char *path = fim_get_real_path(dir_it);
+
+        if (pool != NULL) {
+            fim_scan_pool_add(pool, path, dir_it);
+        } else {
+            fim_checker(path, evt_data, dir_it, txn_handle, txn_ctx);
+        }
+
+        // Verify the directory is being monitored correctly
+#ifndef WIN32
+        realtime_adddir(path, dir_it);
+#elif defined WIN_WHODATA
+        if (FIM_MODE(dir_it->options) == FIM_WHODATA) {
+            realtime_adddir(path, dir_it);
+        }
+#endif
+        os_free(path);
+    }
+
+    // The workers read the configuration of the directories until the pool is done
+    if (pool != NULL) {
+        fim_scan_pool_wait(pool);
+    }
+    w_rwlock_unlock(&syscheck.directories_lock);
+}
+
 time_t fim_scan() {
     struct timespec start;
     struct timespec end;
     time_t end_of_scan;
     clock_t cputime_start;
     int nodes_count = 0;
-    OSListNode *node_it;
-    directory_t *dir_it;
     event_data_t evt_data = { .report_event = true, .mode = FIM_SCHEDULED, .w_evt = NULL };
     fim_txn_context_t txn_ctx = { .evt_data = &evt_data, .latest_entry = NULL };
 
     static fim_state_db _files_db_state = FIM_STATE_DB_EMPTY;
+    static time_t _next_rehash = 0;
 #ifdef WIN32
     static fim_state_db _registry_key_state = FIM_STATE_DB_EMPTY;
     static fim_state_db _registry_value_state = FIM_STATE_DB_EMPTY;
@@ -501,6 +547,22 @@ time_t fim_scan() {
     LogInfo(FIM_FREQUENCY_STARTED);
     fim_send_scan_info(FIM_SCAN_START);
 
+    // Every rehash_interval seconds, a scan reads every file again regardless of its stat data
+    if (syscheck.rehash_interval > 0) {
+        time_t now = time(NULL);
+
+        if (_next_rehash != 0 && now >= _next_rehash) {
+            LogDebug(FIM_FULL_REHASH_SCAN);
+            _next_rehash = 0;
+        } else {
+            evt_data.reuse_hashes = true;
+        }
+
+        if (_next_rehash == 0) {
+            _next_rehash = now + syscheck.rehash_interval;
+        }
+    }
+
 
     TXN_HANDLE db_transaction_handle = fim_db_transaction_start(FIMDB_FILE_TXN_TABLE, transaction_callback, &txn_ctx);
     if (db_transaction_handle == NULL) {
@@ -516,23 +578,7 @@ time_t fim_scan() {
 
     update_wildcards_config();
 
-    w_rwlock_rdlock(&syscheck.directories_lock);
-    OSList_foreach(node_it, syscheck.directories) {
-        dir_it = node_it->data;
-        char *path = fim_get_real_path(dir_it);
-
-        fim_checker(path, &evt_data, dir_it, db_transaction_handle, &txn_ctx);
-
-#ifndef WIN32
-        realtime_adddir(path, dir_it);
-#elif defined WIN_WHODATA
-        if (FIM_MODE(dir_it->options) == FIM_WHODATA) {
-            realtime_adddir(path, dir_it);
-        }
-#endif
-        os_free(path);
-    }
-    w_rwlock_unlock(&syscheck.directories_lock);
+    fim_scan_directories(&evt_data, db_transaction_handle, &txn_ctx);
 
     w_mutex_unlock(&syscheck.fim_scan_mutex);
 
@@ -548,27 +594,10 @@ time_t fim_scan() {
 
         db_transaction_handle = fim_db_transaction_start(FIMDB_FILE_TXN_TABLE, transaction_callback, &txn_ctx);
 
-        w_rwlock_rdlock(&syscheck.directories_lock);
-        OSList_foreach(node_it, syscheck.directories) {
-            dir_it = node_it->data;
-            char *path;
-            event_data_t evt_data = { .mode = FIM_SCHEDULED, .report_event = true, .w_evt = NULL };
-
-            path = fim_get_real_path(dir_it);
-
-            fim_checker(path, &evt_data, dir_it, db_transaction_handle, &txn_ctx);
+        event_data_t evt_data = { .mode = FIM_SCHEDULED, .report_event = true, .w_evt = NULL,
+                                  .reuse_hashes = txn_ctx.evt_data->reuse_hashes };
 
-            // Verify the directory is being monitored correctly
-#ifndef WIN32
-            realtime_adddir(path, dir_it);
-#elif defined WIN_WHODATA
-            if (FIM_MODE(dir_it->options) == FIM_WHODATA) {
-                realtime_adddir(path, dir_it);
-            }
-#endif
-            os_free(path);
-        }
-        w_rwlock_unlock(&syscheck.directories_lock);
+        fim_scan_directories(&evt_data, db_transaction_handle, &txn_ctx);
 
         w_mutex_unlock(&syscheck.fim_scan_mutex);
 
@@ -815,7 +844,11 @@ int fim_directory(const char *dir,
         str_lowercase(f_name);
 #endif
         // Process the event related to f_name
-        fim_checker(f_name, evt_data, configuration, dbsync_txn, ctx);
+        if (ctx != NULL && ctx->worker != NULL) {
+            fim_scan_worker_push(ctx->worker, f_name, configuration);
+        } else {
+            fim_checker(f_name, evt_data, configuration, dbsync_txn, ctx);
+        }
     }
 
     os_free(f_name);
@@ -883,19 +916,34 @@ void fim_file(const char *path,
     assert(evt_data != NULL);
 
     fim_entry new_entry;
+    fim_file_data stored_data;
+    bool stored = false;
 
     check_max_fps();
 
+    if (evt_data->mode == FIM_SCHEDULED && evt_data->reuse_hashes) {
+        stored = fim_get_stored_data(path, configuration, &(evt_data->statbuf), &stored_data);
+    }
+
     new_entry.type = FIM_TYPE_FILE;
     new_entry.file_entry.path = (char *)path;
-    new_entry.file_entry.data = fim_get_data(path, configuration, &(evt_data->statbuf));
+    if (txn_context != NULL && txn_context->worker != NULL) {
+        fim_scan_worker_acquire_device(txn_context->worker, evt_data->statbuf.st_dev);
+        new_entry.file_entry.data = fim_get_data(path, configuration, &(evt_data->statbuf), stored ? &stored_data : NULL);
+        fim_scan_worker_release_device(txn_context->worker, evt_data->statbuf.st_dev);
+    } else {
+        new_entry.file_entry.data = fim_get_data(path, configuration, &(evt_data->statbuf), stored ? &stored_data : NULL);
+    }
 
     if (new_entry.file_entry.data == NULL) {
         LogDebug(FIM_GET_ATTRIBUTES, path);
         return;
     }
 
-    if (txn_handle != NULL) {
+    if (txn_handle != NULL && txn_context->worker != NULL) {
+        fim_scan_worker_sync_row(txn_context->worker, &new_entry);
+        free_file_data(new_entry.file_entry.data);
+    } else if (txn_handle != NULL) {
         txn_context->latest_entry = &new_entry;
 
         fim_db_transaction_sync_row(txn_handle, &new_entry);
@@ -1243,8 +1291,83 @@ int fim_check_depth(const char *path, const directory_t *configuration) {
 }
 
 
+// Check whether the hashes of a file have to be calculated
+static bool fim_file_needs_hashes(const directory_t *configuration, const struct stat *statbuf) {
+    // We won't calculate hash for symbolic links, empty or large files
+    return S_ISREG(statbuf->st_mode) && (statbuf->st_size > 0 && statbuf->st_size < syscheck.file_max_size) &&
+           (configuration->options & (CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM));
+}
+
+// Get the digests to calculate for a file
+static int fim_get_digests(const directory_t *configuration) {
+    int digests = 0;
+
+    if (configuration->options & CHECK_MD5SUM) {
+        digests |= OS_DIGEST_MD5;
+    }
+
+    if (configuration->options & CHECK_SHA1SUM) {
+        digests |= OS_DIGEST_SHA1;
+    }
+
+    if (configuration->options & CHECK_SHA256SUM) {
+        digests |= OS_DIGEST_SHA256;
+    }
+
+    return digests;
+}
+
+// Callback
+static void fim_copy_stored_data(void *data, void *ctx) {
+    const fim_file_data *entry_data = ((fim_entry *)data)->file_entry.data;
+    fim_file_data *stored_data = (fim_file_data *)ctx;
+
+    stored_data->size = entry_data->size;
+    stored_data->mtime = entry_data->mtime;
+    stored_data->ctime = entry_data->ctime;
+    stored_data->inode = entry_data->inode;
+    stored_data->dev = entry_data->dev;
+    stored_data->options = entry_data->options;
+    stored_data->last_event = entry_data->last_event;
+    snprintf(stored_data->hash_md5, sizeof(os_md5), "%s", entry_data->hash_md5);
+    snprintf(stored_data->hash_sha1, sizeof(os_sha1), "%s", entry_data->hash_sha1);
+    snprintf(stored_data->hash_sha256, sizeof(os_sha256), "%s", entry_data->hash_sha256);
+}
+
+bool fim_get_stored_data(const char *file,
+                         const directory_t *configuration,
+                         const struct stat *statbuf,
+                         fim_file_data *stored_data) {
+    // Without the size and the modification time there is no way to tell that the file is unchanged
+    if ((configuration->options & (CHECK_SIZE | CHECK_MTIME)) != (CHECK_SIZE | CHECK_MTIME) ||
+        syscheck.prefilter_cmd != NULL || !fim_file_needs_hashes(configuration, statbuf)) {
+        return false;
+    }
+
+    init_fim_data_entry(stored_data);
+
+    callback_context_t callback_data;
+    callback_data.callback = fim_copy_stored_data;
+    callback_data.context = stored_data;
+
+    return fim_db_get_path(file, callback_data) == FIMDB_OK;
+}
+
+// Check whether the hashes stored for a file are still valid
+static bool fim_stored_hashes_valid(const fim_file_data *data, const fim_file_data *stored_data) {
+    // The change time cannot be set from user space, so it catches writes whose modification time was reset.
+    // A file changed within the same second it was hashed may have changed after being read.
+    return stored_data->options == data->options && stored_data->size == data->size &&
+           stored_data->mtime == data->mtime && stored_data->ctime == data->ctime &&
+           stored_data->inode == data->inode && stored_data->dev == data->dev &&
+           stored_data->mtime < stored_data->last_event && stored_data->ctime < stored_data->last_event;
+}
+
 // Get data from file
-fim_file_data *fim_get_data(const char *file, const directory_t *configuration, const struct stat *statbuf) {
+fim_file_data *fim_get_data(const char *file,
+                            const directory_t *configuration,
+                            const struct stat *statbuf,
+                            const fim_file_data *stored_data) {
     fim_file_data * data = NULL;
 
     os_calloc(1, sizeof(fim_file_data), data);
@@ -1316,11 +1439,18 @@ fim_file_data *fim_get_data(const char *file, const directory_t *configuration,
     // The file exists and we don't have to delete it from the hash tables
     data->scanned = 1;
 
-    // We won't calculate hash for symbolic links, empty or large files
-    if (S_ISREG(statbuf->st_mode) && (statbuf->st_size > 0 && statbuf->st_size < syscheck.file_max_size) &&
-        (configuration->options & (CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM))) {
-        if (OS_MD5_SHA1_SHA256_File(file, syscheck.prefilter_cmd, data->hash_md5,
-                                    data->hash_sha1, data->hash_sha256, OS_BINARY, syscheck.file_max_size) < 0) {
+    data->inode = statbuf->st_ino;
+    data->dev = statbuf->st_dev;
+    data->ctime = statbuf->st_ctime;
+    data->options = configuration->options;
+
+    if (fim_file_needs_hashes(configuration, statbuf)) {
+        if (stored_data != NULL && fim_stored_hashes_valid(data, stored_data)) {
+            snprintf(data->hash_md5, sizeof(os_md5), "%s", stored_data->hash_md5);
+            snprintf(data->hash_sha1, sizeof(os_sha1), "%s", stored_data->hash_sha1);
+            snprintf(data->hash_sha256, sizeof(os_sha256), "%s", stored_data->hash_sha256);
+        } else if (OS_Digest_File(file, syscheck.prefilter_cmd, fim_get_digests(configuration), data->hash_md5,
+                                  data->hash_sha1, data->hash_sha256, OS_BINARY, syscheck.file_max_size) < 0) {
             LogDebug(FIM_HASHES_FAIL, file);
             free_file_data(data);
             return NULL;
@@ -1339,9 +1469,6 @@ fim_file_data *fim_get_data(const char *file, const directory_t *configuration,
         data->hash_sha256[0] = '\0';
     }
 
-    data->inode = statbuf->st_ino;
-    data->dev = statbuf->st_dev;
-    data->options = configuration->options;
     data->last_event = time(NULL);
     fim_get_checksum(data);
 
@@ -1360,6 +1487,7 @@ void init_fim_data_entry(fim_file_data *data) {
     data->user_name = NULL;
     data->group_name = NULL;
     data->mtime = 0;
+    data->ctime = 0;
     data->inode = 0;
     data->hash_md5[0] = '\0';
     data->hash_sha1[0] = '\0';
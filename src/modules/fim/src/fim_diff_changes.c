@@ -11,6 +11,10 @@
 #include "../os_crypto/md5/md5_op.h"
 #include "syscheck.h"
 
+#ifndef WIN32
+#include <zlib.h>
+#endif
+
 
 // Remove static qualifier from tests
 #ifdef WAZUH_UNIT_TESTING
@@ -32,6 +36,30 @@
 
 static const char *STR_MORE_CHANGES = "More changes...";
 
+#ifndef WIN32
+static const char *STR_NO_NEWLINE = "\n\\ No newline at end of file\n";
+static const char *STR_BINARY_FILES = "Binary files differ\n";
+
+// Blocks in which the snapshots and the monitored files are read
+#define FIM_DIFF_READ_SIZE 65536
+
+// Edit distance beyond which the rest of the changed lines are reported as a single change
+#define FIM_DIFF_MAX_EDIT_COST 1024
+
+typedef struct diff_line {
+    const char *data;
+    size_t len;             // Including the trailing newline, if any
+    unsigned long hash;
+} diff_line;
+
+typedef struct diff_output {
+    char *buffer;
+    size_t len;
+    size_t size;
+    int full;
+} diff_output;
+#endif
+
 #ifdef WIN32
 
 /* Prototypes */
@@ -123,6 +151,7 @@ int fim_diff_create_compress_file(const diff_data *diff);
  */
 void fim_diff_modify_compress_estimation(float compressed_size, float uncompressed_size);
 
+#ifdef WIN32
 /**
  * @brief Compares MD5 hashes of the old and new files to see if they are the same
  *
@@ -149,6 +178,41 @@ char *fim_diff_generate(const diff_data *diff);
  * @return String with the changes to add to the alert
  */
 char *gen_diff_str(const diff_data *diff);
+#else
+/**
+ * @brief Reads the whole content of a compressed snapshot
+ *
+ * @param path Path of the compressed snapshot
+ * @param size Size of the uncompressed content
+ *
+ * @return Content of the snapshot, NULL if it doesn't exist or can't be read
+ */
+char *fim_diff_read_snapshot(const char *path, size_t *size);
+
+/**
+ * @brief Reads the whole content of a file
+ *
+ * @param path Path of the file
+ * @param size Size of the content
+ *
+ * @return Content of the file, NULL if it can't be read
+ */
+char *fim_diff_read_file(const char *path, size_t *size);
+
+/**
+ * @brief Computes the differences between two contents, line by line, in the output format of the diff command
+ *
+ * The output is limited to the maximum size of an alert, ending with a notice if some changes don't fit.
+ *
+ * @param old_data Previous content
+ * @param old_size Size of the previous content
+ * @param new_data Current content
+ * @param new_size Size of the current content
+ *
+ * @return String with the changes to add to the alert
+ */
+char *fim_diff_lines(const char *old_data, size_t old_size, const char *new_data, size_t new_size);
+#endif
 
 /**
  * @brief Checks if a specific file has been configured with the ``nodiff`` option
@@ -406,6 +470,12 @@ char *fim_file_diff(const char *filename, const directory_t *configuration) {
 
     char *diff_changes = NULL;
     int ret;
+#ifndef WIN32
+    char *old_data = NULL;
+    char *new_data = NULL;
+    size_t old_size = 0;
+    size_t new_size = 0;
+#endif
 
     // Generate diff structure
     diff_data *diff = initialize_file_diff_data(filename, configuration);
@@ -427,7 +497,11 @@ char *fim_file_diff(const char *filename, const directory_t *configuration) {
     }
 
     // If the file is not there, create compressed file and return.
+#ifndef WIN32
+    if (old_data = fim_diff_read_snapshot(diff->compress_file, &old_size), old_data == NULL) {
+#else
     if (w_uncompress_gzfile(diff->compress_file, diff->uncompress_file) != 0) {
+#endif
         if (ret = fim_diff_create_compress_file(diff), ret == 0){
             mkdir_ex(diff->compress_folder);
             save_compress_file(diff);
@@ -449,7 +523,16 @@ char *fim_file_diff(const char *filename, const directory_t *configuration) {
         goto cleanup;
     }
 
+#ifndef WIN32
+    if (new_data = fim_diff_read_file(diff->file_origin, &new_size), new_data == NULL) {
+        syscheck.diff_folder_size += backup_file_size;
+        goto cleanup;
+    }
+
+    if (old_size == new_size && memcmp(old_data, new_data, new_size) == 0) {
+#else
     if (fim_diff_compare(diff) == -1) {
+#endif
         LogDebug(FIM_DIFF_IDENTICAL_MD5_FILES);
         syscheck.diff_folder_size += backup_file_size;
         os_strdup("No content changes were found for this file.", diff_changes);
@@ -462,10 +545,14 @@ char *fim_file_diff(const char *filename, const directory_t *configuration) {
         goto cleanup;
     }
 
+#ifndef WIN32
+    diff_changes = fim_diff_lines(old_data, old_size, new_data, new_size);
+#else
     if (diff_changes = fim_diff_generate(diff), !diff_changes){
         syscheck.diff_folder_size += backup_file_size;
         goto cleanup;
     }
+#endif
 
     save_compress_file(diff);
 
@@ -476,6 +563,10 @@ cleanup:
     }
 
     free_diff_data(diff);
+#ifndef WIN32
+    os_free(old_data);
+    os_free(new_data);
+#endif
 
     return diff_changes;
 }
@@ -643,6 +734,7 @@ void fim_diff_modify_compress_estimation(float compressed_size, float uncompress
     }
 }
 
+#ifdef WIN32
 int fim_diff_compare(const diff_data *diff) {
     os_md5 md5sum_old;
     os_md5 md5sum_new;
@@ -776,6 +868,350 @@ char *gen_diff_str(const diff_data *diff){
     return diff_str;
 }
 
+#else
+char *fim_diff_read_snapshot(const char *path, size_t *size) {
+    gzFile fp;
+    char *data = NULL;
+    size_t capacity = 0;
+    int n;
+
+    *size = 0;
+
+    if (fp = gzopen(path, "rb"), fp == NULL) {
+        return NULL;
+    }
+
+    do {
+        if (capacity - *size < FIM_DIFF_READ_SIZE) {
+            capacity += FIM_DIFF_READ_SIZE;
+            os_realloc(data, capacity, data);
+        }
+
+        if (n = gzread(fp, data + *size, FIM_DIFF_READ_SIZE), n < 0) {
+            LogDebug(FIM_DIFF_SNAPSHOT_READ_ERROR, path);
+            os_free(data);
+            break;
+        }
+
+        *size += n;
+    } while (n > 0);
+
+    gzclose(fp);
+
+    return data;
+}
+
+char *fim_diff_read_file(const char *path, size_t *size) {
+    FILE *fp;
+    char *data = NULL;
+    size_t capacity = 0;
+    size_t n;
+
+    *size = 0;
+
+    if (fp = wfopen(path, "rb"), fp == NULL) {
+        LogDebug(FOPEN_ERROR, path, errno, strerror(errno));
+        return NULL;
+    }
+
+    do {
+        if (capacity - *size < FIM_DIFF_READ_SIZE) {
+            capacity += FIM_DIFF_READ_SIZE;
+            os_realloc(data, capacity, data);
+        }
+
+        n = fread(data + *size, 1, FIM_DIFF_READ_SIZE, fp);
+        *size += n;
+    } while (n > 0);
+
+    fclose(fp);
+
+    return data;
+}
+
+/* Splits a content in lines, the last one may lack its newline */
+static diff_line *fim_diff_split_lines(const char *data, size_t size, size_t *count) {
+    diff_line *lines = NULL;
+    size_t capacity = 0;
+    size_t offset = 0;
+
+    *count = 0;
+
+    while (offset < size) {
+        const char *end = memchr(data + offset, '\n', size - offset);
+        size_t len = end ? (size_t)(end - (data + offset)) + 1 : size - offset;
+        unsigned long hash = 5381;
+        size_t i;
+
+        for (i = 0; i < len; i++) {
+            hash = hash * 33 + (unsigned char)data[offset + i];
+        }
+
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            os_realloc(lines, capacity * sizeof(diff_line), lines);
+        }
+
+        lines[*count].data = data + offset;
+        lines[*count].len = len;
+        lines[*count].hash = hash;
+        (*count)++;
+        offset += len;
+    }
+
+    return lines;
+}
+
+static int fim_diff_line_equal(const diff_line *a, const diff_line *b) {
+    return a->hash == b->hash && a->len == b->len && memcmp(a->data, b->data, a->len) == 0;
+}
+
+/**
+ * Marks the lines removed from old and added to new, following the Myers algorithm. If the edit distance goes beyond
+ * FIM_DIFF_MAX_EDIT_COST, every line is marked, which still is a valid (not minimal) diff.
+ */
+static void fim_diff_mark_changes(const diff_line *old_lines, int n, const diff_line *new_lines, int m,
+                                  char *removed, char *added) {
+    int limit = n + m < FIM_DIFF_MAX_EDIT_COST ? n + m : FIM_DIFF_MAX_EDIT_COST;
+    int offset = limit + 1;
+    int *v;
+    int *trace;
+    int d;
+    int k;
+    int x;
+    int y;
+
+    os_calloc(2 * limit + 3, sizeof(int), v);
+    // The values of step d, k in [-d, d], start at index d * d
+    os_calloc((size_t)(limit + 1) * (limit + 1), sizeof(int), trace);
+
+    for (d = 0; d <= limit; d++) {
+        for (k = -d; k <= d; k += 2) {
+            if (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) {
+                x = v[offset + k + 1];
+            } else {
+                x = v[offset + k - 1] + 1;
+            }
+
+            y = x - k;
+
+            while (x < n && y < m && fim_diff_line_equal(&old_lines[x], &new_lines[y])) {
+                x++;
+                y++;
+            }
+
+            v[offset + k] = x;
+            trace[d * d + d + k] = x;
+
+            if (x >= n && y >= m) {
+                goto found;
+            }
+        }
+    }
+
+    memset(removed, 1, n);
+    memset(added, 1, m);
+    goto end;
+
+found:
+    // Walk back the steps from the end of both contents
+    x = n;
+    y = m;
+
+    for (; d > 0; d--) {
+        int prev_k;
+        int prev_x;
+        int prev_y;
+
+        k = x - y;
+
+        if (k == -d || (k != d && trace[(d - 1) * (d - 1) + (d - 1) + k - 1] < trace[(d - 1) * (d - 1) + (d - 1) + k + 1])) {
+            prev_k = k + 1;
+        } else {
+            prev_k = k - 1;
+        }
+
+        prev_x = trace[(d - 1) * (d - 1) + (d - 1) + prev_k];
+        prev_y = prev_x - prev_k;
+
+        while (x > prev_x && y > prev_y) {
+            x--;
+            y--;
+        }
+
+        if (prev_k == k + 1) {
+            added[y - 1] = 1;
+        } else {
+            removed[x - 1] = 1;
+        }
+
+        x = prev_x;
+        y = prev_y;
+    }
+
+end:
+    os_free(trace);
+    os_free(v);
+}
+
+static void fim_diff_write(diff_output *output, const char *data, size_t len) {
+    size_t room = output->size - output->len;
+
+    if (output->full) {
+        return;
+    }
+
+    if (len >= room) {
+        len = room;
+        output->full = 1;
+    }
+
+    memcpy(output->buffer + output->len, data, len);
+    output->len += len;
+}
+
+static void fim_diff_write_range(diff_output *output, size_t first, size_t last) {
+    char range[OS_SIZE_64];
+    int len;
+
+    if (first == last) {
+        len = snprintf(range, sizeof(range), "%zu", first);
+    } else {
+        len = snprintf(range, sizeof(range), "%zu,%zu", first, last);
+    }
+
+    fim_diff_write(output, range, len);
+}
+
+static void fim_diff_write_lines(diff_output *output, const char *prefix, const diff_line *lines, size_t count) {
+    size_t i;
+
+    for (i = 0; i < count && !output->full; i++) {
+        fim_diff_write(output, prefix, 2);
+        fim_diff_write(output, lines[i].data, lines[i].len);
+
+        if (lines[i].data[lines[i].len - 1] != '\n') {
+            fim_diff_write(output, STR_NO_NEWLINE, strlen(STR_NO_NEWLINE));
+        }
+    }
+}
+
+/* Writes a hunk replacing old lines [i0, i1) with new lines [j0, j1), both counted from 0 */
+static void fim_diff_write_hunk(diff_output *output,
+                                const diff_line *old_lines, size_t i0, size_t i1,
+                                const diff_line *new_lines, size_t j0, size_t j1) {
+    if (i0 == i1) {
+        fim_diff_write_range(output, i0, i0);
+        fim_diff_write(output, "a", 1);
+        fim_diff_write_range(output, j0 + 1, j1);
+    } else {
+        fim_diff_write_range(output, i0 + 1, i1);
+
+        if (j0 == j1) {
+            fim_diff_write(output, "d", 1);
+            fim_diff_write_range(output, j0, j0);
+        } else {
+            fim_diff_write(output, "c", 1);
+            fim_diff_write_range(output, j0 + 1, j1);
+        }
+    }
+
+    fim_diff_write(output, "\n", 1);
+    fim_diff_write_lines(output, "< ", old_lines + i0, i1 - i0);
+
+    if (i0 != i1 && j0 != j1) {
+        fim_diff_write(output, "---\n", 4);
+    }
+
+    fim_diff_write_lines(output, "> ", new_lines + j0, j1 - j0);
+}
+
+char *fim_diff_lines(const char *old_data, size_t old_size, const char *new_data, size_t new_size) {
+    diff_output output = { .len = 0, .size = OS_MAXSTR - OS_SK_HEADER - 1, .full = 0 };
+    diff_line *old_lines;
+    diff_line *new_lines;
+    size_t n;
+    size_t m;
+    size_t prefix = 0;
+    size_t suffix = 0;
+    size_t i;
+    size_t j;
+    char *removed;
+    char *added;
+
+    os_malloc(output.size + 1, output.buffer);
+
+    // Same rule as the diff command to tell binary files apart
+    if (memchr(old_data, '\0', old_size < OS_SIZE_8192 ? old_size : OS_SIZE_8192) ||
+        memchr(new_data, '\0', new_size < OS_SIZE_8192 ? new_size : OS_SIZE_8192)) {
+        fim_diff_write(&output, STR_BINARY_FILES, strlen(STR_BINARY_FILES));
+        output.buffer[output.len] = '\0';
+        return output.buffer;
+    }
+
+    old_lines = fim_diff_split_lines(old_data, old_size, &n);
+    new_lines = fim_diff_split_lines(new_data, new_size, &m);
+
+    // Most edits touch a few lines, only the middle part goes through the diff algorithm
+    while (prefix < n && prefix < m && fim_diff_line_equal(&old_lines[prefix], &new_lines[prefix])) {
+        prefix++;
+    }
+
+    while (suffix < n - prefix && suffix < m - prefix &&
+           fim_diff_line_equal(&old_lines[n - 1 - suffix], &new_lines[m - 1 - suffix])) {
+        suffix++;
+    }
+
+    os_calloc(n + 1, sizeof(char), removed);
+    os_calloc(m + 1, sizeof(char), added);
+
+    fim_diff_mark_changes(old_lines + prefix, (int)(n - prefix - suffix), new_lines + prefix, (int)(m - prefix - suffix),
+                          removed + prefix, added + prefix);
+
+    for (i = prefix, j = prefix; (i < n || j < m) && !output.full;) {
+        size_t i0 = i;
+        size_t j0 = j;
+
+        while ((i < n && removed[i]) || (j < m && added[j])) {
+            while (i < n && removed[i]) {
+                i++;
+            }
+
+            while (j < m && added[j]) {
+                j++;
+            }
+        }
+
+        if (i == i0 && j == j0) {
+            i++;
+            j++;
+            continue;
+        }
+
+        fim_diff_write_hunk(&output, old_lines, i0, i, new_lines, j0, j);
+    }
+
+    if (output.full) {
+        size_t len = output.len - strlen(STR_MORE_CHANGES);
+
+        while (len > 0 && output.buffer[len - 1] != '\n') {
+            len--;
+        }
+
+        strcpy(output.buffer + len, STR_MORE_CHANGES);
+    } else {
+        output.buffer[output.len] = '\0';
+    }
+
+    os_free(added);
+    os_free(removed);
+    os_free(new_lines);
+    os_free(old_lines);
+
+    return output.buffer;
+}
+#endif
+
 void save_compress_file(const diff_data *diff){
     if (rename_ex(diff->compress_tmp_file, diff->compress_file) != 0) {
         LogError(RENAME_ERROR, diff->compress_tmp_file, diff->compress_file, errno, strerror(errno));
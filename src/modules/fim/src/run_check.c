@@ -472,9 +472,16 @@ void *fim_run_realtime(__attribute__((unused)) void * args) {
             struct timeval selecttime;
             fd_set rfds;
             int run_now = 0;
+            int timeout = realtime_flush_timeout();
 
-            selecttime.tv_sec = SYSCHECK_WAIT;
-            selecttime.tv_usec = 0;
+            // Wake up in time to check the paths waiting to settle
+            if (timeout >= 0) {
+                selecttime.tv_sec = timeout / 1000;
+                selecttime.tv_usec = (timeout % 1000) * 1000;
+            } else {
+                selecttime.tv_sec = SYSCHECK_WAIT;
+                selecttime.tv_usec = 0;
+            }
 
             // zero-out the fd_set
             FD_ZERO (&rfds);
@@ -485,6 +492,7 @@ void *fim_run_realtime(__attribute__((unused)) void * args) {
                 LogError(FIM_ERROR_SELECT);
             } else if (run_now == 0) {
                 // Timeout
+                realtime_flush(0);
             } else if (FD_ISSET (nfds, &rfds)) {
                 realtime_process();
             }
@@ -33,6 +33,30 @@
 #define REALTIME_EVENT_SIZE     (sizeof (struct inotify_event))
 #define REALTIME_EVENT_BUFFER   (2048 * (REALTIME_EVENT_SIZE + 16))
 
+// Moves remembered while waiting for their IN_MOVED_TO half
+#define REALTIME_PENDING_MOVES  16
+
+// A path that keeps changing is checked anyway after this many quiet periods
+#define REALTIME_MAX_DEFERRAL   10
+
+// Events of a path waiting for the path to settle
+typedef struct realtime_pending {
+    struct timespec first;      // First event since the path was last checked
+    struct timespec last;       // Last event
+    int created;                // The first event created the path
+} realtime_pending;
+
+// Source of a move, paired with its target through the inotify cookie
+typedef struct realtime_move {
+    uint32_t cookie;
+    char *path;
+} realtime_move;
+
+// Only the real-time thread touches the pending paths
+static rb_tree *pending_paths;
+static realtime_move pending_moves[REALTIME_PENDING_MOVES];
+static unsigned int next_move;
+
 int realtime_start() {
     OSListNode *node_it;
     os_calloc(1, sizeof(rtfim), syscheck.realtime);
@@ -197,11 +221,116 @@ void fim_realtime_delete_watches(const directory_t *configuration) {
     return;
 }
 
+/* Remember the source of a move, or pair the target of a move with its source */
+static void realtime_pair_move(const char *path, const struct inotify_event *event) {
+    unsigned int i;
+
+    if (event->cookie == 0) {
+        return;
+    }
+
+    if (event->mask & IN_MOVED_FROM) {
+        realtime_move *move = &pending_moves[next_move++ % REALTIME_PENDING_MOVES];
+
+        os_free(move->path);
+        os_strdup(path, move->path);
+        move->cookie = event->cookie;
+        return;
+    }
+
+    for (i = 0; i < REALTIME_PENDING_MOVES; i++) {
+        realtime_move *move = &pending_moves[i];
+        realtime_pending *source;
+
+        if (move->path == NULL || move->cookie != event->cookie) {
+            continue;
+        }
+
+        // A path created and moved away before it settled was never reported, there is nothing to check there
+        if (source = rbtree_get(pending_paths, move->path), source != NULL && source->created) {
+            LogDebug(FIM_REALTIME_MOVE_COALESCED, move->path, path);
+            rbtree_delete(pending_paths, move->path);
+        }
+
+        os_free(move->path);
+        move->cookie = 0;
+        break;
+    }
+}
+
+/* Add an event to the paths waiting to settle */
+static void realtime_queue_event(const char *path, const struct inotify_event *event, const struct timespec *now) {
+    realtime_pending *pending;
+
+    os_calloc(1, sizeof(realtime_pending), pending);
+    pending->first = *now;
+    pending->last = *now;
+    pending->created = (event->mask & IN_CREATE) != 0;
+
+    if (rbtree_insert(pending_paths, path, pending) == NULL) {
+        LogDebug("Duplicate event in real-time buffer: %s", path);
+        os_free(pending);
+
+        if (pending = rbtree_get(pending_paths, path), pending != NULL) {
+            pending->last = *now;
+        }
+    }
+
+    if (event->mask & (IN_MOVED_FROM | IN_MOVED_TO)) {
+        realtime_pair_move(path, event);
+    }
+}
+
+/* Check whether a path had no events during the quiet period, or has waited too long already */
+static int realtime_settled(const realtime_pending *pending, const struct timespec *now) {
+    double quiet_period = syscheck.rt_quiet_period / 1000.0;
+
+    return time_diff(&pending->last, now) >= quiet_period ||
+           time_diff(&pending->first, now) >= quiet_period * REALTIME_MAX_DEFERRAL;
+}
+
+void realtime_flush(int force) {
+    struct timespec now;
+    char **paths;
+
+    if (pending_paths == NULL) {
+        return;
+    }
+
+    gettime(&now);
+    paths = rbtree_keys(pending_paths);
+
+    for (int i = 0; paths[i] != NULL; i++) {
+        realtime_pending *pending = rbtree_get(pending_paths, paths[i]);
+
+        if (!force && pending != NULL && !realtime_settled(pending, &now)) {
+            continue;
+        }
+
+        rbtree_delete(pending_paths, paths[i]);
+
+        w_rwlock_rdlock(&syscheck.directories_lock);
+        fim_realtime_event(paths[i]);
+        w_rwlock_unlock(&syscheck.directories_lock);
+    }
+
+    free_strarray(paths);
+}
+
+int realtime_flush_timeout() {
+    if (pending_paths == NULL || rbtree_empty(pending_paths)) {
+        return -1;
+    }
+
+    return syscheck.rt_quiet_period;
+}
+
 /* Process events in the real time queue */
 void realtime_process() {
     ssize_t len;
     char buf[REALTIME_EVENT_BUFFER + 1];
     struct inotify_event *event;
+    struct timespec now;
 
     buf[REALTIME_EVENT_BUFFER] = '\0';
 
@@ -219,7 +348,13 @@ void realtime_process() {
         return;
     }
 
-    rb_tree * tree = rbtree_init();
+    if (pending_paths == NULL) {
+        pending_paths = rbtree_init();
+        rbtree_set_dispose(pending_paths, free);
+    }
+
+    gettime(&now);
+
     for (size_t i = 0; i < (size_t) len; i += REALTIME_EVENT_SIZE + event->len) {
         char wdchar[33];
         char final_name[MAX_LINE + 1];
@@ -257,9 +392,7 @@ void realtime_process() {
             }
         }
 
-        if (rbtree_insert(tree, final_name, NULL) == NULL) {
-            LogDebug("Duplicate event in real-time buffer: %s", final_name);
-        }
+        realtime_queue_event(final_name, event, &now);
 
         switch(event->mask) {
         case IN_MOVE_SELF:
@@ -274,16 +407,15 @@ void realtime_process() {
         w_mutex_unlock(&syscheck.fim_realtime_mutex);
     }
 
-    char ** paths = rbtree_keys(tree);
-
-    for (int i = 0; paths[i] != NULL; i++) {
-        w_rwlock_rdlock(&syscheck.directories_lock);
-        fim_realtime_event(paths[i]);
-        w_rwlock_unlock(&syscheck.directories_lock);
+    if (syscheck.rt_quiet_period == 0) {
+        // Without a quiet period, paths are checked once per read, as soon as their events arrive
+        realtime_flush(1);
+    } else if (rbtree_size(pending_paths) >= syscheck.rt_max_pending) {
+        LogDebug(FIM_REALTIME_PENDING_FULL, rbtree_size(pending_paths));
+        realtime_flush(1);
+    } else {
+        realtime_flush(0);
     }
-
-    free_strarray(paths);
-    rbtree_destroy(tree);
 }
 
 int realtime_update_watch(const char *wd, const char *dir) {
@@ -0,0 +1,401 @@
+/* Copyright (C) 2015, Wazuh Inc.
+ * All right reserved.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation
+ */
+
+#include "shared.h"
+#include "syscheck.h"
+#include "db/include/db.h"
+
+#ifdef __linux__
+#include <sys/sysmacros.h>
+#endif
+
+#ifdef WAZUH_UNIT_TESTING
+/* Remove static qualifier when unit testing */
+#define static
+#endif
+
+// Maximum number of paths waiting in the queue of a worker
+#define FIM_SCAN_QUEUE_SIZE 4096
+
+typedef struct fim_scan_task {
+    char *path;
+    const directory_t *configuration;
+} fim_scan_task_t;
+
+/* Bounded double-ended queue. The owner pushes and pops at the tail, other workers steal from the head. */
+typedef struct fim_scan_queue {
+    pthread_mutex_t mutex;
+    fim_scan_task_t tasks[FIM_SCAN_QUEUE_SIZE];
+    unsigned int head;
+    unsigned int count;
+} fim_scan_queue_t;
+
+struct fim_scan_worker {
+    fim_scan_pool_t *pool;
+    unsigned int id;
+    pthread_t thread;
+    event_data_t evt_data;
+    fim_txn_context_t txn_context;
+    fim_scan_queue_t queue;
+};
+
+typedef struct fim_scan_device {
+    dev_t device;
+    unsigned int limit;     // 0 means unlimited
+    unsigned int busy;
+} fim_scan_device_t;
+
+struct fim_scan_pool {
+    fim_scan_worker_t *workers;
+    unsigned int size;      // Workers allocated
+    unsigned int threads;   // Workers running
+    TXN_HANDLE txn_handle;
+    fim_txn_context_t *txn_context;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t available;
+    pthread_cond_t idle;
+    fim_scan_task_t *roots;
+    unsigned int roots_count;
+    unsigned int queued;    // Paths waiting in any queue
+    unsigned int pending;   // Paths waiting or being checked
+    bool stop;
+
+    pthread_mutex_t writer_mutex;
+
+    pthread_mutex_t device_mutex;
+    pthread_cond_t device_released;
+    fim_scan_device_t *devices;
+    unsigned int devices_count;
+};
+
+static void fim_scan_pool_task_added(fim_scan_pool_t *pool) {
+    w_mutex_lock(&pool->mutex);
+    pool->queued++;
+    pool->pending++;
+    w_cond_signal(&pool->available);
+    w_mutex_unlock(&pool->mutex);
+}
+
+static void fim_scan_pool_task_taken(fim_scan_pool_t *pool) {
+    w_mutex_lock(&pool->mutex);
+    pool->queued--;
+    w_mutex_unlock(&pool->mutex);
+}
+
+static void fim_scan_pool_task_done(fim_scan_pool_t *pool) {
+    w_mutex_lock(&pool->mutex);
+    if (--pool->pending == 0) {
+        w_cond_broadcast(&pool->idle);
+    }
+    w_mutex_unlock(&pool->mutex);
+}
+
+/* The most recent path of the worker keeps the walk depth first, as the serial scan does */
+static bool fim_scan_worker_pop(fim_scan_worker_t *worker, fim_scan_task_t *task) {
+    fim_scan_queue_t *queue = &worker->queue;
+    bool found = false;
+
+    w_mutex_lock(&queue->mutex);
+    if (queue->count > 0) {
+        queue->count--;
+        *task = queue->tasks[(queue->head + queue->count) % FIM_SCAN_QUEUE_SIZE];
+        found = true;
+    }
+    w_mutex_unlock(&queue->mutex);
+
+    return found;
+}
+
+/* The oldest path of a worker is usually the closest to the root, hence the one with the most work below it */
+static bool fim_scan_worker_steal(fim_scan_worker_t *victim, fim_scan_task_t *task) {
+    fim_scan_queue_t *queue = &victim->queue;
+    bool found = false;
+
+    w_mutex_lock(&queue->mutex);
+    if (queue->count > 0) {
+        *task = queue->tasks[queue->head];
+        queue->head = (queue->head + 1) % FIM_SCAN_QUEUE_SIZE;
+        queue->count--;
+        found = true;
+    }
+    w_mutex_unlock(&queue->mutex);
+
+    return found;
+}
+
+static bool fim_scan_pool_pop_root(fim_scan_pool_t *pool, fim_scan_task_t *task) {
+    bool found = false;
+
+    w_mutex_lock(&pool->mutex);
+    if (pool->roots_count > 0) {
+        *task = pool->roots[--pool->roots_count];
+        pool->queued--;
+        found = true;
+    }
+    w_mutex_unlock(&pool->mutex);
+
+    return found;
+}
+
+static bool fim_scan_worker_next(fim_scan_worker_t *worker, fim_scan_task_t *task) {
+    fim_scan_pool_t *pool = worker->pool;
+    unsigned int i;
+
+    if (fim_scan_worker_pop(worker, task)) {
+        fim_scan_pool_task_taken(pool);
+        return true;
+    }
+
+    if (fim_scan_pool_pop_root(pool, task)) {
+        return true;
+    }
+
+    for (i = 1; i < pool->size; i++) {
+        if (fim_scan_worker_steal(&pool->workers[(worker->id + i) % pool->size], task)) {
+            fim_scan_pool_task_taken(pool);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void *fim_scan_worker_main(void *arg) {
+    fim_scan_worker_t *worker = (fim_scan_worker_t *)arg;
+    fim_scan_pool_t *pool = worker->pool;
+    fim_scan_task_t task;
+
+    while (1) {
+        if (fim_scan_worker_next(worker, &task)) {
+            fim_checker(task.path, &worker->evt_data, task.configuration, pool->txn_handle, &worker->txn_context);
+            os_free(task.path);
+            fim_scan_pool_task_done(pool);
+            continue;
+        }
+
+        w_mutex_lock(&pool->mutex);
+        while (pool->queued == 0 && !pool->stop) {
+            w_cond_wait(&pool->available, &pool->mutex);
+        }
+
+        if (pool->stop) {
+            w_mutex_unlock(&pool->mutex);
+            break;
+        }
+        w_mutex_unlock(&pool->mutex);
+    }
+
+    return NULL;
+}
+
+fim_scan_pool_t *fim_scan_pool_create(unsigned int threads,
+                                      const event_data_t *evt_data,
+                                      TXN_HANDLE txn_handle,
+                                      fim_txn_context_t *txn_context) {
+    fim_scan_pool_t *pool;
+    unsigned int i;
+
+    os_calloc(1, sizeof(fim_scan_pool_t), pool);
+    os_calloc(threads, sizeof(fim_scan_worker_t), pool->workers);
+    pool->size = threads;
+
+    pool->txn_handle = txn_handle;
+    pool->txn_context = txn_context;
+    w_mutex_init(&pool->mutex, NULL);
+    w_cond_init(&pool->available, NULL);
+    w_cond_init(&pool->idle, NULL);
+    w_mutex_init(&pool->writer_mutex, NULL);
+    w_mutex_init(&pool->device_mutex, NULL);
+    w_cond_init(&pool->device_released, NULL);
+
+    for (i = 0; i < threads; i++) {
+        fim_scan_worker_t *worker = &pool->workers[i];
+
+        worker->pool = pool;
+        worker->id = i;
+        worker->evt_data = *evt_data;
+        worker->txn_context.evt_data = &worker->evt_data;
+        worker->txn_context.worker = worker;
+        w_mutex_init(&worker->queue.mutex, NULL);
+    }
+
+    for (i = 0; i < threads; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, fim_scan_worker_main, &pool->workers[i]) != 0) {
+            LogError(THREAD_ERROR " Cannot create FIM scan worker.");
+            break;
+        }
+        pool->threads++;
+    }
+
+    if (pool->threads == 0) {
+        fim_scan_pool_wait(pool);
+        return NULL;
+    }
+
+    LogDebug(FIM_SCAN_POOL_STARTED, pool->threads);
+
+    return pool;
+}
+
+void fim_scan_pool_add(fim_scan_pool_t *pool, const char *path, const directory_t *configuration) {
+    w_mutex_lock(&pool->mutex);
+    os_realloc(pool->roots, (pool->roots_count + 1) * sizeof(fim_scan_task_t), pool->roots);
+    os_strdup(path, pool->roots[pool->roots_count].path);
+    pool->roots[pool->roots_count].configuration = configuration;
+    pool->roots_count++;
+    pool->queued++;
+    pool->pending++;
+    w_cond_signal(&pool->available);
+    w_mutex_unlock(&pool->mutex);
+}
+
+void fim_scan_pool_wait(fim_scan_pool_t *pool) {
+    unsigned int i;
+
+    w_mutex_lock(&pool->mutex);
+    while (pool->pending > 0) {
+        w_cond_wait(&pool->idle, &pool->mutex);
+    }
+    pool->stop = true;
+    w_cond_broadcast(&pool->available);
+    w_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < pool->threads; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < pool->size; i++) {
+        w_mutex_destroy(&pool->workers[i].queue.mutex);
+    }
+
+    w_cond_destroy(&pool->device_released);
+    w_mutex_destroy(&pool->device_mutex);
+    w_mutex_destroy(&pool->writer_mutex);
+    w_cond_destroy(&pool->idle);
+    w_cond_destroy(&pool->available);
+    w_mutex_destroy(&pool->mutex);
+
+    os_free(pool->devices);
+    os_free(pool->roots);
+    os_free(pool->workers);
+    os_free(pool);
+}
+
+void fim_scan_worker_push(fim_scan_worker_t *worker, const char *path, const directory_t *configuration) {
+    fim_scan_queue_t *queue = &worker->queue;
+
+    w_mutex_lock(&queue->mutex);
+
+    if (queue->count == FIM_SCAN_QUEUE_SIZE) {
+        w_mutex_unlock(&queue->mutex);
+
+        // Other workers are busy enough, keep walking depth first
+        fim_checker(path, &worker->evt_data, configuration, worker->pool->txn_handle, &worker->txn_context);
+        return;
+    }
+
+    // Counted before it's visible, so that it can't be checked and released before being counted
+    fim_scan_pool_task_added(worker->pool);
+
+    fim_scan_task_t *task = &queue->tasks[(queue->head + queue->count) % FIM_SCAN_QUEUE_SIZE];
+    os_strdup(path, task->path);
+    task->configuration = configuration;
+    queue->count++;
+
+    w_mutex_unlock(&queue->mutex);
+}
+
+/* Disks with moving heads lose throughput as soon as two files are read at once */
+static unsigned int fim_scan_device_limit(dev_t device) {
+#ifdef __linux__
+    char path[PATH_MAX];
+    FILE *fp;
+    int rotational = 0;
+
+    // Partitions don't have a queue of their own, it belongs to the parent disk
+    snprintf(path, sizeof(path), "/sys/dev/block/%u:%u/queue/rotational", major(device), minor(device));
+    if (fp = wfopen(path, "r"), fp == NULL) {
+        snprintf(path, sizeof(path), "/sys/dev/block/%u:%u/../queue/rotational", major(device), minor(device));
+        fp = wfopen(path, "r");
+    }
+
+    if (fp != NULL) {
+        if (fscanf(fp, "%d", &rotational) != 1) {
+            rotational = 0;
+        }
+        fclose(fp);
+    }
+
+    if (rotational == 1) {
+        return 1;
+    }
+#else
+    (void)device;
+#endif
+
+    return syscheck.scan_device_threads;
+}
+
+void fim_scan_worker_acquire_device(fim_scan_worker_t *worker, dev_t device) {
+    fim_scan_pool_t *pool = worker->pool;
+    unsigned int i;
+
+    w_mutex_lock(&pool->device_mutex);
+
+    for (i = 0; i < pool->devices_count; i++) {
+        if (pool->devices[i].device == device) {
+            break;
+        }
+    }
+
+    if (i == pool->devices_count) {
+        os_realloc(pool->devices, (pool->devices_count + 1) * sizeof(fim_scan_device_t), pool->devices);
+        pool->devices[i].device = device;
+        pool->devices[i].limit = fim_scan_device_limit(device);
+        pool->devices[i].busy = 0;
+        pool->devices_count++;
+    }
+
+    // Other workers may add devices while this one waits, moving the array, so only the index is kept
+    while (pool->devices[i].limit > 0 && pool->devices[i].busy >= pool->devices[i].limit) {
+        w_cond_wait(&pool->device_released, &pool->device_mutex);
+    }
+    pool->devices[i].busy++;
+
+    w_mutex_unlock(&pool->device_mutex);
+}
+
+void fim_scan_worker_release_device(fim_scan_worker_t *worker, dev_t device) {
+    fim_scan_pool_t *pool = worker->pool;
+    unsigned int i;
+
+    w_mutex_lock(&pool->device_mutex);
+
+    for (i = 0; i < pool->devices_count; i++) {
+        if (pool->devices[i].device == device) {
+            pool->devices[i].busy--;
+            break;
+        }
+    }
+
+    w_cond_broadcast(&pool->device_released);
+    w_mutex_unlock(&pool->device_mutex);
+}
+
+void fim_scan_worker_sync_row(fim_scan_worker_t *worker, fim_entry *entry) {
+    fim_scan_pool_t *pool = worker->pool;
+
+    // The transaction callback reads the entry from the context given when the transaction started
+    w_mutex_lock(&pool->writer_mutex);
+    pool->txn_context->latest_entry = entry;
+    fim_db_transaction_sync_row(pool->txn_handle, entry);
+    pool->txn_context->latest_entry = NULL;
+    w_mutex_unlock(&pool->writer_mutex);
+}
@@ -51,9 +51,14 @@ void init_magic(magic_t *cookie_ptr)
 void read_internal(int debug_level)
 {
     syscheck.rt_delay = getDefine_Int("syscheck", "rt_delay", 0, 1000);
+    syscheck.rt_quiet_period = getDefine_Int("syscheck", "rt_quiet_period", 0, 60000);
+    syscheck.rt_max_pending = getDefine_Int("syscheck", "rt_max_pending", 1, 1000000);
     syscheck.max_depth = getDefine_Int("syscheck", "default_max_depth", 1, 320);
     syscheck.file_max_size = (size_t)getDefine_Int("syscheck", "file_max_size", 0, 4095) * 1024 * 1024;
     syscheck.sym_checker_interval = getDefine_Int("syscheck", "symlink_scan_interval", 1, 2592000);
+    syscheck.rehash_interval = getDefine_Int("syscheck", "rehash_interval", 0, 31536000);
+    syscheck.scan_threads = getDefine_Int("syscheck", "scan_threads", 1, 64);
+    syscheck.scan_device_threads = getDefine_Int("syscheck", "scan_device_threads", 0, 64);
 
 #ifndef WIN32
     syscheck.max_audit_entries = getDefine_Int("syscheck", "max_audit_entries", 1, 4096);
@@ -19,298 +19,332 @@
 #define STATIC
 #endif
 
-static regex_t regexCompiled_uid;
-static regex_t regexCompiled_pid;
-static regex_t regexCompiled_ppid;
-static regex_t regexCompiled_gid;
-static regex_t regexCompiled_auid;
-static regex_t regexCompiled_euid;
-
-static regex_t regexCompiled_cwd;
-static regex_t regexCompiled_pname;
-static regex_t regexCompiled_path0;
-static regex_t regexCompiled_path1;
-static regex_t regexCompiled_path2;
-static regex_t regexCompiled_path3;
-static regex_t regexCompiled_path4;
-
-static regex_t regexCompiled_cwd_hex;
-static regex_t regexCompiled_pname_hex;
-static regex_t regexCompiled_path0_hex;
-static regex_t regexCompiled_path1_hex;
-static regex_t regexCompiled_path2_hex;
-static regex_t regexCompiled_path3_hex;
-static regex_t regexCompiled_path4_hex;
-
-static regex_t regexCompiled_items;
-static regex_t regexCompiled_inode;
-static regex_t regexCompiled_dir;
-static regex_t regexCompiled_dir_hex;
-static regex_t regexCompiled_syscall;
-static regex_t regexCompiled_dev;
-
-// Initialize regular expressions
-int init_regex(void) {
-
-    static const char *pattern_uid = " uid=([0-9]*) ";
-    if (regcomp(&regexCompiled_uid, pattern_uid, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "uid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_gid = " gid=([0-9]*) ";
-    if (regcomp(&regexCompiled_gid, pattern_gid, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "gid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_auid = " auid=([0-9]*) ";
-    if (regcomp(&regexCompiled_auid, pattern_auid, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "auid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+#define AUDIT_FIELD_IS(name, length, literal) ((length) == sizeof(literal) - 1 && memcmp(name, literal, length) == 0)
+
+// Records whose fields are read by FIM, the rest are only scanned for the key
+typedef enum audit_record_type {
+    AUDIT_RECORD_OTHER = 0,
+    AUDIT_RECORD_SYSCALL,
+    AUDIT_RECORD_CWD,
+    AUDIT_RECORD_PATH,
+    AUDIT_RECORD_CONFIG_CHANGE,
+    AUDIT_RECORD_SKIP
+} audit_record_type;
+
+static int audit_is_separator(char c) {
+    // Fields are separated by spaces, records by newlines, and the enriched fields by a group separator
+    return c == ' ' || c == '\n' || c == '\035';
+}
+
+static audit_record_type audit_get_record_type(const audit_field_t *type) {
+    if (AUDIT_FIELD_IS(type->value, type->length, "SYSCALL")) {
+        return AUDIT_RECORD_SYSCALL;
     }
-    static const char *pattern_euid = " euid=([0-9]*) ";
-    if (regcomp(&regexCompiled_euid, pattern_euid, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "euid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    if (AUDIT_FIELD_IS(type->value, type->length, "CWD")) {
+        return AUDIT_RECORD_CWD;
     }
-    static const char *pattern_pid = " pid=([0-9]*) ";
-    if (regcomp(&regexCompiled_pid, pattern_pid, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "pid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    if (AUDIT_FIELD_IS(type->value, type->length, "PATH")) {
+        return AUDIT_RECORD_PATH;
     }
-    static const char *pattern_ppid = " ppid=([0-9]*) ";
-    if (regcomp(&regexCompiled_ppid, pattern_ppid, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "ppid"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    if (AUDIT_FIELD_IS(type->value, type->length, "CONFIG_CHANGE")) {
+        return AUDIT_RECORD_CONFIG_CHANGE;
     }
-    static const char *pattern_inode = " item=[0-9] name=.* inode=([0-9]*)";
-    if (regcomp(&regexCompiled_inode, pattern_inode, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "inode"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    // Long records that never hold a key
+    if (AUDIT_FIELD_IS(type->value, type->length, "PROCTITLE") ||
+        AUDIT_FIELD_IS(type->value, type->length, "EXECVE")) {
+        return AUDIT_RECORD_SKIP;
     }
+    return AUDIT_RECORD_OTHER;
+}
 
-    static const char *pattern_items = " items=([0-9]*) ";
-    if (regcomp(&regexCompiled_items, pattern_items, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "items"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+/**
+ * @brief Returns the end of the record starting at the given position.
+ *
+ * @param record Position within the record.
+ * @return The newline closing the record, the separator before the next record if they aren't split by lines, or
+ *         the end of the buffer.
+ */
+static const char *audit_skip_record(const char *record) {
+    const char *end;
 
-    static const char *pattern_syscall = " syscall=([0-9]*)";
-    if (regcomp(&regexCompiled_syscall, pattern_syscall, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "syscall"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    if ((end = strchr(record, '\n')) == NULL && (end = strstr(record, " type=")) == NULL) {
+        end = record + strlen(record);
     }
 
-    static const char *pattern_pname = " exe=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_pname, pattern_pname, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "pname"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_cwd = " cwd=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_cwd, pattern_cwd, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "cwd"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+    return end;
+}
 
-    static const char *pattern_dir = " dir=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_dir, pattern_dir, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "dir"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+static void audit_set_field(audit_field_t *field, const audit_field_t *value) {
+    // The first occurrence of a field is the one used
+    if (field->value == NULL) {
+        *field = *value;
     }
+}
 
-    static const char *pattern_path0 = " item=0 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path0, pattern_path0, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path0"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_path1 = " item=1 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path1, pattern_path1, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path1"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_path2 = " item=2 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path2, pattern_path2, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path2"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_path3 = " item=3 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path3, pattern_path3, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path3"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
-    static const char *pattern_path4 = " item=4 name=\"([^ ]*)\"";
-    if (regcomp(&regexCompiled_path4, pattern_path4, REG_EXTENDED)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path4"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+void audit_parse_fields(const char *buffer, audit_fields_t *fields) {
+    audit_record_type record = AUDIT_RECORD_OTHER;
+    audit_field_t value;
+    const char *name;
+    const char *pos = buffer;
+    size_t name_length;
+    long item = -1;
 
-    static const char *pattern_pname_hex = " exe=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_pname_hex, pattern_pname_hex, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "pname_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+    memset(fields, 0, sizeof(audit_fields_t));
 
-    static const char *pattern_cwd_hex = " cwd=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_cwd_hex, pattern_cwd_hex, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "cwd_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+    while (*pos != '\0') {
+        if (audit_is_separator(*pos)) {
+            pos++;
+            continue;
+        }
 
-    static const char *pattern_dir_hex = " dir=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_dir_hex, pattern_dir_hex, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "dir_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+        name = pos;
+        while (*pos != '=' && *pos != '\0' && !audit_is_separator(*pos)) {
+            pos++;
+        }
 
-    static const char *pattern_path0_hex = " item=0 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path0_hex, pattern_path0_hex, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path0_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+        if (*pos != '=') {
+            // Not a key=value token
+            continue;
+        }
 
-    static const char *pattern_path1_hex = " item=1 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path1_hex, pattern_path1_hex, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path1_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+        name_length = pos++ - name;
 
-    static const char *pattern_path2_hex = " item=2 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path2_hex, pattern_path2_hex, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path2_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
-    }
+        if (*pos == '"') {
+            value.value = ++pos;
+            while (*pos != '"' && *pos != '\0' && *pos != '\n') {
+                pos++;
+            }
+            value.length = pos - value.value;
+            value.quoted = 1;
+
+            if (*pos == '"') {
+                pos++;
+            }
+        } else {
+            value.value = pos;
+            while (*pos != '\0' && !audit_is_separator(*pos)) {
+                pos++;
+            }
+            value.length = pos - value.value;
+            value.quoted = 0;
+        }
 
-    static const char *pattern_path3_hex = " item=3 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path3_hex, pattern_path3_hex, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path3_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+        if (AUDIT_FIELD_IS(name, name_length, "type")) {
+            record = audit_get_record_type(&value);
+            item = -1;
+
+            if (record == AUDIT_RECORD_SKIP) {
+                pos = audit_skip_record(pos);
+            } else if (record == AUDIT_RECORD_CONFIG_CHANGE) {
+                fields->config_change = 1;
+            }
+            continue;
+        }
+
+        if (AUDIT_FIELD_IS(name, name_length, "key")) {
+            audit_set_field(&fields->key, &value);
+            continue;
+        }
+
+        switch (record) {
+        case AUDIT_RECORD_SYSCALL:
+            switch (name_length) {
+            case 3:
+                if (AUDIT_FIELD_IS(name, name_length, "uid")) {
+                    audit_set_field(&fields->uid, &value);
+                } else if (AUDIT_FIELD_IS(name, name_length, "gid")) {
+                    audit_set_field(&fields->gid, &value);
+                } else if (AUDIT_FIELD_IS(name, name_length, "pid")) {
+                    audit_set_field(&fields->pid, &value);
+                } else if (AUDIT_FIELD_IS(name, name_length, "exe")) {
+                    audit_set_field(&fields->exe, &value);
+                }
+                break;
+            case 4:
+                if (AUDIT_FIELD_IS(name, name_length, "auid")) {
+                    audit_set_field(&fields->auid, &value);
+                } else if (AUDIT_FIELD_IS(name, name_length, "euid")) {
+                    audit_set_field(&fields->euid, &value);
+                } else if (AUDIT_FIELD_IS(name, name_length, "ppid")) {
+                    audit_set_field(&fields->ppid, &value);
+                }
+                break;
+            case 5:
+                if (AUDIT_FIELD_IS(name, name_length, "items")) {
+                    audit_set_field(&fields->items, &value);
+                }
+                break;
+            case 7:
+                if (AUDIT_FIELD_IS(name, name_length, "success")) {
+                    audit_set_field(&fields->success, &value);
+                } else if (AUDIT_FIELD_IS(name, name_length, "syscall")) {
+                    audit_set_field(&fields->syscall, &value);
+                }
+                break;
+            default:
+                break;
+            }
+            break;
+
+        case AUDIT_RECORD_CWD:
+            if (AUDIT_FIELD_IS(name, name_length, "cwd")) {
+                audit_set_field(&fields->cwd, &value);
+            }
+            break;
+
+        case AUDIT_RECORD_PATH:
+            if (AUDIT_FIELD_IS(name, name_length, "item")) {
+                item = strtol(value.value, NULL, 10);
+            } else if (AUDIT_FIELD_IS(name, name_length, "name")) {
+                if (item >= 0 && item < AUDIT_MAX_ITEMS) {
+                    audit_set_field(&fields->name[item], &value);
+                }
+            } else if (AUDIT_FIELD_IS(name, name_length, "inode")) {
+                // The inode reported is the one of the last item
+                fields->inode = value;
+            } else if (AUDIT_FIELD_IS(name, name_length, "dev")) {
+                audit_set_field(&fields->dev, &value);
+            }
+            break;
+
+        case AUDIT_RECORD_CONFIG_CHANGE:
+            if (AUDIT_FIELD_IS(name, name_length, "op")) {
+                audit_set_field(&fields->op, &value);
+            } else if (AUDIT_FIELD_IS(name, name_length, "dir")) {
+                audit_set_field(&fields->dir, &value);
+            }
+            break;
+
+        default:
+            break;
+        }
     }
+}
 
-    static const char *pattern_path4_hex = " item=4 name=([A-F0-9]*)";
-    if (regcomp(&regexCompiled_path4_hex, pattern_path4_hex, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "path4_hex"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+static int audit_hex_digit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
     }
-    static const char *pattern_dev = " dev=([A-F0-9]*:[A-F0-9]*)";
-    if (regcomp(&regexCompiled_dev, pattern_dev, REG_EXTENDED | REG_ICASE)) {
-        LogError(FIM_ERROR_WHODATA_COMPILE_REGEX, "dev"); // LCOV_EXCL_LINE
-        return -1; // LCOV_EXCL_LINE
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
     }
-    return 0;
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
 }
 
-void clean_regex() {
-    static int freed = 0;
+/**
+ * @brief Decodes a hex-encoded value.
+ *
+ * @param encoded Hex-encoded value.
+ * @param length Length of the encoded value.
+ * @param [out] decoded Buffer of at least length / 2 + 1 bytes that receives the decoded, null-terminated, value.
+ * @return 0 on success, -1 if the value isn't an even number of hex digits.
+ */
+static int audit_decode_hex(const char *encoded, size_t length, char *decoded) {
+    size_t i;
+
+    if (length % 2 != 0) {
+        return -1;
+    }
+
+    for (i = 0; i < length; i += 2) {
+        int high = audit_hex_digit(encoded[i]);
+        int low = audit_hex_digit(encoded[i + 1]);
 
-    if (freed) { // Prevent double free
-        return;
+        if (high < 0 || low < 0) {
+            return -1;
+        }
+
+        decoded[i / 2] = (char)(high << 4 | low);
     }
 
-    regfree(&regexCompiled_uid);
-    regfree(&regexCompiled_gid);
-    regfree(&regexCompiled_auid);
-    regfree(&regexCompiled_euid);
-    regfree(&regexCompiled_pid);
-    regfree(&regexCompiled_ppid);
-    regfree(&regexCompiled_inode);
-    regfree(&regexCompiled_items);
-    regfree(&regexCompiled_syscall);
-    regfree(&regexCompiled_pname);
-    regfree(&regexCompiled_cwd);
-    regfree(&regexCompiled_dir);
-    regfree(&regexCompiled_path0);
-    regfree(&regexCompiled_path1);
-    regfree(&regexCompiled_path2);
-    regfree(&regexCompiled_path3);
-    regfree(&regexCompiled_path4);
-
-    regfree(&regexCompiled_pname_hex);
-    regfree(&regexCompiled_cwd_hex);
-    regfree(&regexCompiled_dir_hex);
-    regfree(&regexCompiled_path0_hex);
-    regfree(&regexCompiled_path1_hex);
-    regfree(&regexCompiled_path2_hex);
-    regfree(&regexCompiled_path3_hex);
-    regfree(&regexCompiled_path4_hex);
-    regfree(&regexCompiled_dev);
-
-    freed = 1;
+    decoded[length / 2] = '\0';
+    return 0;
 }
 
 /**
- * @brief Looks for a specific field in an audit event.
+ * @brief Copies the value of a field.
  *
- * @param buffer Audit message.
- * @param key Audit field to look for
- * @return Value of the field specified in key.
+ * @param field Field of the event.
+ * @return A copy of the value, NULL if the field is missing.
  */
-STATIC char *get_audit_field(const char *buffer, const char *key) {
-    char *value = NULL;
-    char *start = NULL;
-    char *ascii_value = NULL;
-    int is_hex_buffer = 1;
-    int limiter_pos = 0;
-    int key_length = strlen(key);
-
-    // Find the key
-    for (start = strstr(buffer, key); start != NULL; start = strstr(start + 1, key)) {
-        if (start[key_length] != '=') {
-            continue;
-        }
-        // Check if the there is a field that matches `key` argument.
-        if (start == buffer || *(start - 1) == ' ' || *(start - 1) == '\n') {
-            break;
-        }
-    }
+STATIC char *audit_field_dup(const audit_field_t *field) {
+    char *value;
 
-    if (start == NULL) {
+    if (field->value == NULL) {
         return NULL;
     }
 
-    start += key_length + 1;
+    os_malloc(field->length + 1, value);
+    memcpy(value, field->value, field->length);
+    value[field->length] = '\0';
 
-    if (*start == '"') {
-        is_hex_buffer = 0;
-        start++;
+    return value;
+}
+
+/**
+ * @brief Copies the value of a field that audit hex-encodes unless it's printable, like paths.
+ *
+ * @param field Field of the event.
+ * @return The decoded value, NULL if the field is missing or can't be decoded.
+ */
+STATIC char *audit_field_decode(const audit_field_t *field) {
+    char *value;
+    size_t length = 0;
+
+    if (field->value == NULL || field->quoted) {
+        return audit_field_dup(field);
     }
 
-    // The key can be limited by one of these three characters
-    if (limiter_pos = strcspn(start, "\n\035 \""), limiter_pos == 0) {
-        return NULL;
+    // Only the leading hex digits are taken, unset values like "(null)" are read as empty ones
+    while (length < field->length && audit_hex_digit(field->value[length]) >= 0) {
+        length++;
     }
 
-    os_calloc(limiter_pos + 1, sizeof(char), value);
-    strncpy(value, start, limiter_pos);
+    os_malloc(length / 2 + 1, value);
 
-    if (is_hex_buffer) {
-        ascii_value = decode_hex_buffer_2_ascii_buffer(value, limiter_pos);
-        free(value);
-        return ascii_value;
+    if (audit_decode_hex(field->value, length, value) != 0) {
+        LogError("Error found while decoding HEX bufer: '%.*s'", (int)length, field->value);
+        os_free(value);
     }
 
     return value;
 }
 
 /**
- * @brief Scans the buffer for a valid audit key (AUDIT_KEY, AUDIT_HC_KEY or a user configured key)
+ * @brief Checks if the key of an audit event is a valid one (AUDIT_KEY, AUDIT_HC_KEY or a user configured key)
  *
- * @param buffer Audit message being scanned.
+ * @param fields Fields of the audit event.
  * @return Type of key.
  * @retval FIM_AUDIT_UNKNOWN_KEY if the key is unknown.
  * @retval FIM_AUDIT_KEY if the key of the event is AUDIT_KEY.
  * @retval FIM_AUDIT_HC_KEY if the key of the event is AUDIT_HEALTHCHECK_KEY.
  * @retval FIM_AUDIT_CUSTOM_KEY if the key of the event is configured using the audit_key option.
  */
-STATIC audit_key_type filterkey_audit_events(const char *buffer) {
+STATIC audit_key_type filterkey_audit_events(const audit_fields_t *fields) {
     char *save_ptr = NULL;
     char *full_key = NULL;
     char *key = NULL;
     int i;
 
-    // Find the key
-    if (full_key = get_audit_field(buffer, "key"), full_key == NULL) {
+    if (fields->key.value == NULL || fields->key.length == 0) {
         return FIM_AUDIT_UNKNOWN_KEY;
     }
 
+    // Several keys are hex-encoded, separated by \001
+    if (fields->key.quoted) {
+        full_key = audit_field_dup(&fields->key);
+    } else {
+        os_malloc(fields->key.length / 2 + 1, full_key);
+
+        if (audit_decode_hex(fields->key.value, fields->key.length, full_key) != 0) {
+            free(full_key);
+            return FIM_AUDIT_UNKNOWN_KEY;
+        }
+    }
+
     for (key = strtok_r(full_key, "\001", &save_ptr); key != NULL; key = strtok_r(NULL, "\001", &save_ptr)) {
         if (*key == '\0') {
             continue;
@@ -452,12 +486,7 @@ char *audit_get_id(const char *event) {
 
 void audit_parse(char *buffer) {
     static int auid_err_reported = 0;
-    char *psuccess;
-    char *pconfig;
-    char *pdelete;
     char *endptr = NULL;
-    regmatch_t match[2];
-    int match_size;
     char *path0 = NULL;
     char *path1 = NULL;
     char *path2 = NULL;
@@ -468,37 +497,19 @@ void audit_parse(char *buffer) {
     whodata_evt *w_evt;
     unsigned int items = 0;
     audit_key_type filter_key;
+    audit_fields_t fields;
+
+    audit_parse_fields(buffer, &fields);
 
     // Checks if the key obtained is one of those configured to monitor
-    filter_key = filterkey_audit_events(buffer);
+    filter_key = filterkey_audit_events(&fields);
 
     switch (filter_key) {
     case FIM_AUDIT_KEY:
-        if ((pconfig = strstr(buffer, "type=CONFIG_CHANGE"), pconfig) &&
-            ((pdelete = strstr(buffer, "op=remove_rule"), pdelete) ||
-             (pdelete = strstr(buffer, "op=\"remove_rule\""), pdelete))) { // Detect rules modification.
-
+        if (fields.config_change && fields.op.value != NULL &&
+            AUDIT_FIELD_IS(fields.op.value, fields.op.length, "remove_rule")) { // Detect rules modification.
             // Filter rule removed
-            char *p_dir = NULL;
-            if (regexec(&regexCompiled_dir, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_calloc(1, match_size + 1, p_dir);
-                snprintf(p_dir, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            }
-
-
-            else if (regexec(&regexCompiled_dir_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, p_dir);
-                    snprintf(p_dir, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            char *p_dir = audit_field_decode(&fields.dir);
 
             if (p_dir && *p_dir != '\0') {
                 LogInfo(FIM_AUDIT_REMOVE_RULE, p_dir);
@@ -532,29 +543,18 @@ void audit_parse(char *buffer) {
         }
         // Fallthrough
     case FIM_AUDIT_CUSTOM_KEY:
-        if (psuccess = strstr(buffer, "success=yes"), psuccess) {
+        if (fields.success.value != NULL && AUDIT_FIELD_IS(fields.success.value, fields.success.length, "yes")) {
 
             os_calloc(1, sizeof(whodata_evt), w_evt);
 
             // Items
-            if (regexec(&regexCompiled_items, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *chr_item;
-                os_malloc(match_size + 1, chr_item);
-                snprintf(chr_item, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            if (fields.items.value != NULL) {
                 // No further checks needed on items
-                items = strtol(chr_item, NULL, 10);
-
-                free(chr_item);
+                items = strtol(fields.items.value, NULL, 10);
             }
 
             // user_name & user_id
-            if (regexec(&regexCompiled_uid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->user_id);
-                snprintf(w_evt->user_id, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            if (w_evt->user_id = audit_field_dup(&fields.uid), w_evt->user_id) {
                 if (w_evt->user_id[0] != '\0') {
                     errno = 0;
                     int user_id = strtol(w_evt->user_id, &endptr, 10);
@@ -567,12 +567,8 @@ void audit_parse(char *buffer) {
             }
 
             // audit_name & audit_uid
-            if (regexec(&regexCompiled_auid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *auid = NULL;
-                os_malloc(match_size + 1, auid);
-                snprintf(auid, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                if (strcmp(auid, "4294967295") == 0) { // Invalid auid (-1)
+            if (fields.auid.value != NULL) {
+                if (AUDIT_FIELD_IS(fields.auid.value, fields.auid.length, "4294967295")) { // Invalid auid (-1)
                     if (!auid_err_reported) {
                         LogDebug(FIM_AUDIT_INVALID_AUID);
                         auid_err_reported = 1;
@@ -580,8 +576,7 @@ void audit_parse(char *buffer) {
                     w_evt->audit_name = NULL;
                     w_evt->audit_uid = NULL;
                 } else {
-                    w_evt->audit_uid = auid;
-                    auid = NULL;
+                    w_evt->audit_uid = audit_field_dup(&fields.auid);
 
                     if (w_evt->audit_uid[0] != '\0') {
                         errno = 0;
@@ -593,14 +588,9 @@ void audit_parse(char *buffer) {
                         endptr = NULL;
                     }
                 }
-                os_free(auid);
             }
             // effective_name && effective_uid
-            if (regexec(&regexCompiled_euid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->effective_uid);
-                snprintf(w_evt->effective_uid, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            if (w_evt->effective_uid = audit_field_dup(&fields.euid), w_evt->effective_uid) {
                 if (w_evt->effective_uid[0] != '\0') {
                     errno = 0;
                     int euid = strtol(w_evt->effective_uid, &endptr, 10);
@@ -612,11 +602,7 @@ void audit_parse(char *buffer) {
                 }
             }
             // group_name & group_id
-            if (regexec(&regexCompiled_gid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->group_id);
-                snprintf(w_evt->group_id, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
+            if (w_evt->group_id = audit_field_dup(&fields.gid), w_evt->group_id) {
                 if (w_evt->group_id[0] != '\0') {
                     errno = 0;
                     int gid = strtol(w_evt->group_id, &endptr, 10);
@@ -628,24 +614,14 @@ void audit_parse(char *buffer) {
                 }
             }
             // process_id
-            if (regexec(&regexCompiled_pid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *pid = NULL;
-                os_malloc(match_size + 1, pid);
-                snprintf(pid, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-
-                w_evt->process_id = strtol(pid, &endptr, 10);
-
-                free(pid);
+            if (fields.pid.value != NULL) {
+                w_evt->process_id = strtol(fields.pid.value, NULL, 10);
             }
             // ppid
-            if (regexec(&regexCompiled_ppid, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *ppid = NULL;
+            if (fields.ppid.value != NULL) {
+                char *ppid = audit_field_dup(&fields.ppid);
                 os_malloc(OS_FLSIZE, w_evt->parent_name);
                 os_malloc(OS_FLSIZE, w_evt->parent_cwd);
-                os_malloc(match_size + 1, ppid);
-                snprintf(ppid, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
                 get_parent_process_info(ppid, &w_evt->parent_name, &w_evt->parent_cwd);
 
                 w_evt->ppid = strtol(ppid, &endptr, 10);
@@ -653,89 +629,22 @@ void audit_parse(char *buffer) {
                 free(ppid);
             }
             // process_name
-            if (regexec(&regexCompiled_pname, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->process_name);
-                snprintf(w_evt->process_name, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            } else if (regexec(&regexCompiled_pname_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, w_evt->process_name);
-                    snprintf(w_evt->process_name, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            w_evt->process_name = audit_field_decode(&fields.exe);
 
             // cwd
-            if (regexec(&regexCompiled_cwd, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->cwd);
-                snprintf(w_evt->cwd, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            } else if (regexec(&regexCompiled_cwd_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, w_evt->cwd);
-                    snprintf(w_evt->cwd, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            w_evt->cwd = audit_field_decode(&fields.cwd);
 
             // path0
-            if (regexec(&regexCompiled_path0, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, path0);
-                snprintf(path0, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            } else if (regexec(&regexCompiled_path0_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, path0);
-                    snprintf(path0, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            path0 = audit_field_decode(&fields.name[0]);
 
             // path1
-            if (regexec(&regexCompiled_path1, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, path1);
-                snprintf(path1, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            } else if (regexec(&regexCompiled_path1_hex, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                if (decoded_buffer) {
-                    const int decoded_length = match_size / 2;
-                    os_malloc(decoded_length + 1, path1);
-                    snprintf(path1, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                    os_free(decoded_buffer);
-                } else {
-                    LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                }
-            }
+            path1 = audit_field_decode(&fields.name[1]);
 
             // inode
-            if (regexec(&regexCompiled_inode, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, w_evt->inode);
-                snprintf(w_evt->inode, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-            }
-            // dev
-            if (regexec(&regexCompiled_dev, buffer, 2, match, 0) == 0) {
-                match_size = match[1].rm_eo - match[1].rm_so;
-                os_malloc(match_size + 1, dev);
-                snprintf(dev, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
+            w_evt->inode = audit_field_dup(&fields.inode);
 
+            // dev
+            if (dev = audit_field_dup(&fields.dev), dev) {
                 char *aux = wstr_chr(dev, ':');
 
                 if (aux) {
@@ -799,22 +708,7 @@ void audit_parse(char *buffer) {
                 break;
             case 3:
                 // path2
-                if (regexec(&regexCompiled_path2, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    os_malloc(match_size + 1, path2);
-                    snprintf(path2, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                } else if (regexec(&regexCompiled_path2_hex, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                    if (decoded_buffer) {
-                        const int decoded_length = match_size / 2;
-                        os_malloc(decoded_length + 1, path2);
-                        snprintf(path2, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                        os_free(decoded_buffer);
-                    } else {
-                        LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                    }
-                }
+                path2 = audit_field_decode(&fields.name[2]);
 
                 if (w_evt->cwd && path1 && path2) {
                     if (file_path = gen_audit_path(w_evt->cwd, path1, path2), file_path) {
@@ -835,40 +729,10 @@ void audit_parse(char *buffer) {
                 break;
             case 4:
                 // path2
-                if (regexec(&regexCompiled_path2, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    os_malloc(match_size + 1, path2);
-                    snprintf(path2, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                } else if (regexec(&regexCompiled_path2_hex, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                    if (decoded_buffer) {
-                        const int decoded_length = match_size / 2;
-                        os_malloc(decoded_length + 1, path2);
-                        snprintf(path2, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                        os_free(decoded_buffer);
-                    } else {
-                        LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                    }
-                }
+                path2 = audit_field_decode(&fields.name[2]);
 
                 // path3
-                if (regexec(&regexCompiled_path3, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    os_malloc(match_size + 1, path3);
-                    snprintf(path3, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                } else if (regexec(&regexCompiled_path3_hex, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                    if (decoded_buffer) {
-                        const int decoded_length = match_size / 2;
-                        os_malloc(decoded_length + 1, path3);
-                        snprintf(path3, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                        os_free(decoded_buffer);
-                    } else {
-                        LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                    }
-                }
+                path3 = audit_field_decode(&fields.name[3]);
 
                 if (w_evt->cwd && path0 && path1 && path2 && path3) {
                     // Send event 1/2
@@ -910,22 +774,7 @@ void audit_parse(char *buffer) {
                 break;
             case 5:
                 // path4
-                if (regexec(&regexCompiled_path4, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    os_malloc(match_size + 1, path4);
-                    snprintf(path4, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
-                } else if (regexec(&regexCompiled_path4_hex, buffer, 2, match, 0) == 0) {
-                    match_size = match[1].rm_eo - match[1].rm_so;
-                    char *decoded_buffer = decode_hex_buffer_2_ascii_buffer(buffer + match[1].rm_so, match_size);
-                    if (decoded_buffer) {
-                        const int decoded_length = match_size / 2;
-                        os_malloc(decoded_length + 1, path4);
-                        snprintf(path4, decoded_length + 1, "%.*s", decoded_length, decoded_buffer);
-                        os_free(decoded_buffer);
-                    } else {
-                        LogError("Error found while decoding HEX bufer: '%.*s'", match_size, buffer + match[1].rm_so);
-                    }
-                }
+                path4 = audit_field_decode(&fields.name[4]);
 
                 if (w_evt->cwd && path1 && path4) {
                     char *file_path;
@@ -953,11 +802,8 @@ void audit_parse(char *buffer) {
         }
         break;
     case FIM_AUDIT_HC_KEY:
-        if (regexec(&regexCompiled_syscall, buffer, 2, match, 0) == 0) {
-            match_size = match[1].rm_eo - match[1].rm_so;
-            char *syscall = NULL;
-            os_malloc(match_size + 1, syscall);
-            snprintf(syscall, match_size + 1, "%.*s", match_size, buffer + match[1].rm_so);
+        if (fields.syscall.value != NULL) {
+            char *syscall = audit_field_dup(&fields.syscall);
             if (!strcmp(syscall, "2") || !strcmp(syscall, "257") || !strcmp(syscall, "5") ||
                 !strcmp(syscall, "295") || !strcmp(syscall, "56")) {
                 // x86_64: 2 open
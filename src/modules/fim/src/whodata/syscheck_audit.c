@@ -351,12 +351,6 @@ int audit_init(void) {
         return -1;
     }
 
-    int regex_comp = init_regex();
-    if (regex_comp < 0) {
-        LogError("Can't init regex in 'init_regex()'");
-        return -1;
-    }
-
     if (fim_audit_rules_init() != 0) {
         return -1;
     }
@@ -457,8 +451,6 @@ void *audit_main(audit_data_t *audit_data) {
     LogDebug(FIM_AUDIT_THREAD_STOPED);
     close(audit_data->socket);
 
-    // Clean regexes used for parsing events
-    clean_regex();
     // Change Audit monitored folders to Inotify.
     w_rwlock_wrlock(&syscheck.directories_lock);
     OSList_foreach(node_it, syscheck.directories) {
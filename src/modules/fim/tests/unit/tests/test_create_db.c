@@ -638,14 +638,15 @@ void expect_get_data (char *user, char *group, char *file_path, int calculate_ch
     will_return(__wrap_get_UTC_modification_time, 123456);
 #endif
     if (calculate_checksums) {
-        expect_OS_MD5_SHA1_SHA256_File_call(file_path,
-                                            syscheck.prefilter_cmd,
-                                            "d41d8cd98f00b204e9800998ecf8427e",
-                                            "da39a3ee5e6b4b0d3255bfef95601890afd80709",
-                                            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
-                                            OS_BINARY,
-                                            0x400,
-                                            0);
+        expect_OS_Digest_File_call(file_path,
+                                   syscheck.prefilter_cmd,
+                                   OS_DIGEST_ALL,
+                                   "d41d8cd98f00b204e9800998ecf8427e",
+                                   "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+                                   "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+                                   OS_BINARY,
+                                   0x400,
+                                   0);
     }
 }
 
@@ -1383,10 +1384,10 @@ static void test_fim_file_modify_transaction(void **state) {
     expect_value(__wrap_decode_win_acl_json, perms, permissions);
 #endif
 
-    expect_OS_MD5_SHA1_SHA256_File_call(file_path, syscheck.prefilter_cmd, "d41d8cd98f00b204e9800998ecf8427e",
-                                        "da39a3ee5e6b4b0d3255bfef95601890afd80709",
-                                        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", OS_BINARY,
-                                        0x400, 0);
+    expect_OS_Digest_File_call(file_path, syscheck.prefilter_cmd, OS_DIGEST_ALL, "d41d8cd98f00b204e9800998ecf8427e",
+                               "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+                               "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", OS_BINARY,
+                               0x400, 0);
 
     will_return(__wrap_fim_db_transaction_sync_row, FIMDB_OK);
 
@@ -1440,10 +1441,10 @@ static void test_fim_file_modify(void **state) {
     expect_value(__wrap_decode_win_acl_json, perms, permissions);
 #endif
 
-    expect_OS_MD5_SHA1_SHA256_File_call(file_path, syscheck.prefilter_cmd, "d41d8cd98f00b204e9800998ecf8427e",
-                                        "da39a3ee5e6b4b0d3255bfef95601890afd80709",
-                                        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", OS_BINARY,
-                                        0x400, 0);
+    expect_OS_Digest_File_call(file_path, syscheck.prefilter_cmd, OS_DIGEST_ALL, "d41d8cd98f00b204e9800998ecf8427e",
+                               "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+                               "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", OS_BINARY,
+                               0x400, 0);
 
     will_return(__wrap_fim_db_file_update, FIMDB_OK);
 
@@ -1475,14 +1476,15 @@ static void test_fim_file_no_attributes(void **state) {
     expect_value(__wrap_decode_win_acl_json, perms, permissions);
 #endif
 
-    expect_OS_MD5_SHA1_SHA256_File_call(file_path,
-                                        syscheck.prefilter_cmd,
-                                        "d41d8cd98f00b204e9800998ecf8427e",
-                                        "da39a3ee5e6b4b0d3255bfef95601890afd80709",
-                                        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
-                                        OS_BINARY,
-                                        0x400,
-                                        -1);
+    expect_OS_Digest_File_call(file_path,
+                               syscheck.prefilter_cmd,
+                               OS_DIGEST_ALL,
+                               "d41d8cd98f00b204e9800998ecf8427e",
+                               "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+                               "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+                               OS_BINARY,
+                               0x400,
+                               -1);
 
     snprintf(buffer1, OS_SIZE_256, FIM_HASHES_FAIL, file_path);
     snprintf(buffer2, OS_SIZE_256, FIM_GET_ATTRIBUTES, file_path);
@@ -1538,18 +1540,19 @@ static void test_fim_file_error_on_insert(void **state) {
 
     expect_value(__wrap_decode_win_acl_json, perms, permissions);
 #endif
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, fname, file_path);
+    expect_string(__wrap_OS_Digest_File, fname, file_path);
 #ifndef TEST_WINAGENT
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, prefilter_cmd, syscheck.prefilter_cmd);
+    expect_string(__wrap_OS_Digest_File, prefilter_cmd, syscheck.prefilter_cmd);
 #else
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, prefilter_cmd, syscheck.prefilter_cmd);
+    expect_string(__wrap_OS_Digest_File, prefilter_cmd, syscheck.prefilter_cmd);
 #endif
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, md5output, "d41d8cd98f00b204e9800998ecf8427e");
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, sha1output, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, sha256output, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
-    expect_value(__wrap_OS_MD5_SHA1_SHA256_File, mode, OS_BINARY);
-    expect_value(__wrap_OS_MD5_SHA1_SHA256_File, max_size, 0x400);
-    will_return(__wrap_OS_MD5_SHA1_SHA256_File, 0);
+    expect_value(__wrap_OS_Digest_File, digests, OS_DIGEST_ALL);
+    expect_string(__wrap_OS_Digest_File, md5output, "d41d8cd98f00b204e9800998ecf8427e");
+    expect_string(__wrap_OS_Digest_File, sha1output, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    expect_string(__wrap_OS_Digest_File, sha256output, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    expect_value(__wrap_OS_Digest_File, mode, OS_BINARY);
+    expect_value(__wrap_OS_Digest_File, max_size, 0x400);
+    will_return(__wrap_OS_Digest_File, 0);
 
     will_return(__wrap_fim_db_file_update, FIMDB_OK);
 
@@ -3133,7 +3136,7 @@ static void test_fim_get_data(void **state) {
                             .st_mtime = 3456 };
 
     expect_get_data(strdup("user"), strdup("group"), "test", 1);
-    fim_data->local_data = fim_get_data("test", &configuration, &statbuf);
+    fim_data->local_data = fim_get_data("test", &configuration, &statbuf, NULL);
 
 #ifndef TEST_WINAGENT
     assert_string_equal(fim_data->local_data->perm, "r--r--r--");
@@ -3159,7 +3162,7 @@ static void test_fim_get_data_no_hashes(void **state) {
 
     expect_get_data(strdup("user"), strdup("group"), "test", 0);
 
-    fim_data->local_data = fim_get_data("test", &configuration, &statbuf);
+    fim_data->local_data = fim_get_data("test", &configuration, &statbuf, NULL);
 
 #ifndef TEST_WINAGENT
     assert_string_equal(fim_data->local_data->perm, "r--r--r--");
@@ -3186,26 +3189,139 @@ static void test_fim_get_data_hash_error(void **state) {
 
     expect_get_data(strdup("user"), strdup("group"), "test", 0);
 
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, fname, "test");
+    expect_string(__wrap_OS_Digest_File, fname, "test");
 #ifndef TEST_WINAGENT
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, prefilter_cmd, syscheck.prefilter_cmd);
+    expect_string(__wrap_OS_Digest_File, prefilter_cmd, syscheck.prefilter_cmd);
 #else
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, prefilter_cmd, syscheck.prefilter_cmd);
+    expect_string(__wrap_OS_Digest_File, prefilter_cmd, syscheck.prefilter_cmd);
 #endif
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, md5output, "d41d8cd98f00b204e9800998ecf8427e");
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, sha1output, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
-    expect_string(__wrap_OS_MD5_SHA1_SHA256_File, sha256output, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
-    expect_value(__wrap_OS_MD5_SHA1_SHA256_File, mode, OS_BINARY);
-    expect_value(__wrap_OS_MD5_SHA1_SHA256_File, max_size, 0x400);
-    will_return(__wrap_OS_MD5_SHA1_SHA256_File, -1);
+    expect_value(__wrap_OS_Digest_File, digests, OS_DIGEST_ALL);
+    expect_string(__wrap_OS_Digest_File, md5output, "d41d8cd98f00b204e9800998ecf8427e");
+    expect_string(__wrap_OS_Digest_File, sha1output, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    expect_string(__wrap_OS_Digest_File, sha256output, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    expect_value(__wrap_OS_Digest_File, mode, OS_BINARY);
+    expect_value(__wrap_OS_Digest_File, max_size, 0x400);
+    will_return(__wrap_OS_Digest_File, -1);
 
     expect_string(__wrap__mdebug1, formatted_msg, "(6324): Couldn't generate hashes for 'test'");
 
-    fim_data->local_data = fim_get_data("test", &configuration, &statbuf);
+    fim_data->local_data = fim_get_data("test", &configuration, &statbuf, NULL);
 
     assert_null(fim_data->local_data);
 }
 
+static void test_fim_get_data_stored_hashes(void **state) {
+    fim_data_t *fim_data = *state;
+    directory_t configuration = { .options = CHECK_SIZE | CHECK_PERM | CHECK_MTIME | CHECK_OWNER | CHECK_GROUP |
+                                             CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM };
+    struct stat statbuf = { .st_mode = S_IFREG | 00444,
+                            .st_size = 1000,
+                            .st_uid = 0,
+                            .st_gid = 0,
+                            .st_ino = 1234,
+                            .st_dev = 2345,
+                            .st_mtime = 3456,
+                            .st_ctime = 3456 };
+    fim_file_data stored_data = { .size = 1000,
+                                  .inode = 1234,
+                                  .dev = 2345,
+                                  .ctime = 3456,
+#ifndef TEST_WINAGENT
+                                  .mtime = 3456,
+#else
+                                  .mtime = 123456,
+#endif
+                                  .last_event = 200000,
+                                  .options = configuration.options,
+                                  .hash_md5 = "3691689a513ace7e508297b583d7050d",
+                                  .hash_sha1 = "07f05add1049244e7e71ad0f54f24d8094cd8f8b",
+                                  .hash_sha256 = "672a8ceaea40a441f0268ca9bbb33e99f9643c6262667b61fbe57694df224d40" };
+
+    // The file is not read again
+    expect_get_data(strdup("user"), strdup("group"), "test", 0);
+
+    fim_data->local_data = fim_get_data("test", &configuration, &statbuf, &stored_data);
+
+    assert_string_equal(fim_data->local_data->hash_md5, "3691689a513ace7e508297b583d7050d");
+    assert_string_equal(fim_data->local_data->hash_sha1, "07f05add1049244e7e71ad0f54f24d8094cd8f8b");
+    assert_string_equal(fim_data->local_data->hash_sha256, "672a8ceaea40a441f0268ca9bbb33e99f9643c6262667b61fbe57694df224d40");
+}
+
+static void test_fim_get_data_stored_hashes_ctime_changed(void **state) {
+    fim_data_t *fim_data = *state;
+    directory_t configuration = { .options = CHECK_SIZE | CHECK_PERM | CHECK_MTIME | CHECK_OWNER | CHECK_GROUP |
+                                             CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM };
+    struct stat statbuf = { .st_mode = S_IFREG | 00444,
+                            .st_size = 1000,
+                            .st_uid = 0,
+                            .st_gid = 0,
+                            .st_ino = 1234,
+                            .st_dev = 2345,
+                            .st_mtime = 3456,
+                            .st_ctime = 5678 };
+    fim_file_data stored_data = { .size = 1000,
+                                  .inode = 1234,
+                                  .dev = 2345,
+                                  .ctime = 3456,
+#ifndef TEST_WINAGENT
+                                  .mtime = 3456,
+#else
+                                  .mtime = 123456,
+#endif
+                                  .last_event = 200000,
+                                  .options = configuration.options,
+                                  .hash_md5 = "3691689a513ace7e508297b583d7050d",
+                                  .hash_sha1 = "07f05add1049244e7e71ad0f54f24d8094cd8f8b",
+                                  .hash_sha256 = "672a8ceaea40a441f0268ca9bbb33e99f9643c6262667b61fbe57694df224d40" };
+
+    // The file was written and its modification time reset afterwards
+    expect_get_data(strdup("user"), strdup("group"), "test", 1);
+
+    fim_data->local_data = fim_get_data("test", &configuration, &statbuf, &stored_data);
+
+    assert_string_equal(fim_data->local_data->hash_md5, "d41d8cd98f00b204e9800998ecf8427e");
+    assert_string_equal(fim_data->local_data->hash_sha1, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    assert_string_equal(fim_data->local_data->hash_sha256, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+static void test_fim_get_data_stored_hashes_outdated(void **state) {
+    fim_data_t *fim_data = *state;
+    directory_t configuration = { .options = CHECK_SIZE | CHECK_PERM | CHECK_MTIME | CHECK_OWNER | CHECK_GROUP |
+                                             CHECK_MD5SUM | CHECK_SHA1SUM | CHECK_SHA256SUM };
+    struct stat statbuf = { .st_mode = S_IFREG | 00444,
+                            .st_size = 1000,
+                            .st_uid = 0,
+                            .st_gid = 0,
+                            .st_ino = 1234,
+                            .st_dev = 2345,
+                            .st_mtime = 3456,
+                            .st_ctime = 3456 };
+    // Hashed within the second the file was last modified
+    fim_file_data stored_data = { .size = 1000,
+                                  .inode = 1234,
+                                  .dev = 2345,
+                                  .ctime = 3456,
+#ifndef TEST_WINAGENT
+                                  .mtime = 3456,
+                                  .last_event = 3456,
+#else
+                                  .mtime = 123456,
+                                  .last_event = 123456,
+#endif
+                                  .options = configuration.options,
+                                  .hash_md5 = "3691689a513ace7e508297b583d7050d",
+                                  .hash_sha1 = "07f05add1049244e7e71ad0f54f24d8094cd8f8b",
+                                  .hash_sha256 = "672a8ceaea40a441f0268ca9bbb33e99f9643c6262667b61fbe57694df224d40" };
+
+    expect_get_data(strdup("user"), strdup("group"), "test", 1);
+
+    fim_data->local_data = fim_get_data("test", &configuration, &statbuf, &stored_data);
+
+    assert_string_equal(fim_data->local_data->hash_md5, "d41d8cd98f00b204e9800998ecf8427e");
+    assert_string_equal(fim_data->local_data->hash_sha1, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    assert_string_equal(fim_data->local_data->hash_sha256, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
 #ifdef TEST_WINAGENT
 static void test_fim_get_data_fail_to_get_file_premissions(void **state) {
     fim_data_t *fim_data = *state;
@@ -3220,7 +3336,7 @@ static void test_fim_get_data_fail_to_get_file_premissions(void **state) {
     will_return(__wrap_w_get_file_permissions, ERROR_ACCESS_DENIED);
 
 
-    fim_data->local_data = fim_get_data("test", &configuration, &statbuf);
+    fim_data->local_data = fim_get_data("test", &configuration, &statbuf, NULL);
 
     assert_null(fim_data->local_data);
 }
@@ -4408,6 +4524,9 @@ int main(void) {
         cmocka_unit_test_teardown(test_fim_get_data, teardown_local_data),
         cmocka_unit_test_teardown(test_fim_get_data_no_hashes, teardown_local_data),
         cmocka_unit_test(test_fim_get_data_hash_error),
+        cmocka_unit_test_teardown(test_fim_get_data_stored_hashes, teardown_local_data),
+        cmocka_unit_test_teardown(test_fim_get_data_stored_hashes_ctime_changed, teardown_local_data),
+        cmocka_unit_test_teardown(test_fim_get_data_stored_hashes_outdated, teardown_local_data),
 #ifdef TEST_WINAGENT
         cmocka_unit_test(test_fim_get_data_fail_to_get_file_premissions),
 #endif
@@ -23,6 +23,10 @@
 #include "../wrappers/libc/stdlib_wrappers.h"
 #include "../wrappers/posix/stat_wrappers.h"
 
+#ifndef TEST_WINAGENT
+#include "../wrappers/externals/zlib/zlib_wrappers.h"
+#endif
+
 #ifdef TEST_WINAGENT
 #define CHECK_REGISTRY_ALL                                                                             \
     CHECK_SIZE | CHECK_PERM | CHECK_OWNER | CHECK_GROUP | CHECK_MTIME | CHECK_MD5SUM | CHECK_SHA1SUM | \
@@ -104,10 +108,11 @@ int fim_diff_delete_compress_folder(const char *folder);
 int fim_diff_estimate_compression(float file_size);
 int fim_diff_create_compress_file(const diff_data *diff);
 void fim_diff_modify_compress_estimation(float compressed_size, float uncompressed_size);
-int fim_diff_compare(const diff_data *diff);
 void save_compress_file(const diff_data *diff);
 int is_file_nodiff(const char *filename);
 int is_registry_nodiff(const char *key_name, const char *value_name, int arch);
+#ifdef TEST_WINAGENT
+int fim_diff_compare(const diff_data *diff);
 char *gen_diff_str(const diff_data *diff);
 char *fim_diff_generate(const diff_data *diff);
 
@@ -120,13 +125,43 @@ void expect_gen_diff_generate(gen_diff_struct *gen_diff_data_container) {
     expect_fread(gen_diff_data_container->strarray[0], n);
 
     expect_fclose(fp, 0);
+}
+#else
+char *fim_diff_read_snapshot(const char *path, size_t *size);
+char *fim_diff_read_file(const char *path, size_t *size);
+char *fim_diff_lines(const char *old_data, size_t old_size, const char *new_data, size_t new_size);
 
-#ifndef TEST_WINAGENT
-    expect_string(__wrap_unlink, file, gen_diff_data_container->diff->diff_file);
-    will_return(__wrap_unlink, 0);
-#endif
+void expect_fim_diff_read_snapshot(const char *path, gzFile fp, const char *content) {
+    expect_string(__wrap_gzopen, path, path);
+    expect_string(__wrap_gzopen, mode, "rb");
+    will_return(__wrap_gzopen, fp);
+
+    if (fp) {
+        expect_value(__wrap_gzread, gz_fd, fp);
+        will_return(__wrap_gzread, strlen(content));
+        will_return(__wrap_gzread, content);
+
+        expect_value(__wrap_gzread, gz_fd, fp);
+        will_return(__wrap_gzread, 0);
+
+        expect_value(__wrap_gzclose, file, fp);
+        will_return(__wrap_gzclose, 0);
+    }
 }
 
+void expect_fim_diff_read_file(const char *path, FILE *fp, char *content) {
+    expect_wfopen(path, "rb", fp);
+
+    if (fp) {
+        expect_fread(content, strlen(content));
+        expect_fread("", 0);
+        expect_fclose(fp, 0);
+    } else {
+        expect_any(__wrap__mdebug2, formatted_msg);
+    }
+}
+#endif
+
 void expect_initialize_file_diff_data(const char *path, int ret_abspath){
     expect_abspath(path, ret_abspath);
     if (!ret_abspath) {
@@ -186,6 +221,7 @@ void expect_save_compress_file(const char *compress_tmp_file, const char *compre
     expect_rename_ex(compress_tmp_file, compress_file, rename_fail);
 }
 
+#ifdef TEST_WINAGENT
 void expect_fim_diff_compare(const char *uncompress_file, const char *file_origin, os_md5 md5sum_old, os_md5 md5sum_new, int ret) {
     expect_OS_MD5_File_call(uncompress_file, md5sum_old, OS_BINARY, ret);
     if (!ret) {
@@ -197,14 +233,11 @@ void expect_fim_diff_generate(gen_diff_struct *gen_diff_data_container, int gene
     if (generate_fail) {
         expect_system(-1);
     } else {
-#ifndef TEST_WINAGENT
-        expect_system(256);
-#else
         expect_system(1);
-#endif
         expect_gen_diff_generate(gen_diff_data_container);
     }
 }
+#endif
 
 void expect_fim_diff_delete_compress_folder(const char *folder, int isDir_ret, int rmdir_ex_ret, int remove_empty_folder_ret) {
     syscheck.diff_folder_size = -1;
@@ -307,11 +340,34 @@ static int teardown_free_diff_data(void **state) {
     return 0;
 }
 
+#ifndef TEST_WINAGENT
+static int setup_long_content(void **state) {
+    // 60 lines of 1000 characters, more than an alert can hold but less than a single read
+    char *content = malloc(60 * 1001 + 1);
+    int i;
+
+    if (content == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < 60; i++) {
+        memset(content + i * 1001, 'b', 1000);
+        content[i * 1001 + 1000] = '\n';
+    }
+    content[60 * 1001] = '\0';
+
+    *state = content;
+
+    return 0;
+}
+#endif
+
 static int teardown_disk_quota_exceeded(void **state) {
     syscheck.disk_quota_full_msg = false;
     return 0;
 }
 
+#ifdef TEST_WINAGENT
 static int setup_array_strings(void **state) {
     char **strarray = calloc(2, sizeof(char*));
 
@@ -342,7 +398,6 @@ static int setup_gen_diff_str(void **state) {
     setup_array_strings((void **)&gen_diff_data_container->strarray);
     setup_diff_data((void **)&gen_diff_data_container->diff);
 
-#ifdef TEST_WINAGENT
     gen_diff_data_container->strarray[0] = strdup(
         "Comparing files start.txt and end.txt\r\n"
         "***** start.txt\r\n"
@@ -351,13 +406,6 @@ static int setup_gen_diff_str(void **state) {
         "    1:  First Line 123\r\n"
         "    2:  Last line\r\n"
         "*****\r\n\r\n\r\n");
-#else
-    gen_diff_data_container->strarray[0] = strdup(
-        "< First line\n"
-        "---\n"
-        "> First Line 123\n"
-        "> Last line\n");
-#endif
     if(gen_diff_data_container->strarray[0] == NULL) fail();
 
     char *output = strdup(
@@ -385,7 +433,6 @@ static int teardown_free_gen_diff_str(void **state) {
     return 0;
 }
 
-#ifdef TEST_WINAGENT
 static int setup_full_diff_functionality(void **state) {
     gen_diff_struct *gen_diff_data_container = *state;
 
@@ -826,6 +873,7 @@ void test_fim_diff_modify_compress_estimation_ok(void **state) {
     assert_float_equal(syscheck.comp_estimation_perc, 0.7, 0.001);
 }
 
+#ifdef TEST_WINAGENT
 void test_fim_diff_compare_fail_uncompress_MD5(void **state) {
     diff_data *diff = *state;
     diff->uncompress_file = strdup("/path/to/uncompress/file");
@@ -882,6 +930,7 @@ void test_fim_diff_compare_fail_match(void **state) {
 
     assert_int_equal(ret, -1);
 }
+#endif
 
 void test_save_compress_file_ok(void **state) {
     diff_data *diff = *state;
@@ -954,6 +1003,7 @@ void test_is_registry_nodiff_not_match(void **state) {
 }
 #endif
 
+#ifdef TEST_WINAGENT
 // gen_diff_str function tests
 
 void test_gen_diff_str_wfropen_fail(void **state) {
@@ -980,11 +1030,6 @@ void test_gen_diff_str_fread_fail(void **state) {
 
     expect_fclose(fp, 0);
 
-#ifndef TEST_WINAGENT
-    expect_string(__wrap_unlink, file, "/path/to/diff/file");
-    will_return(__wrap_unlink, 0);
-#endif
-
     expect_string(__wrap__merror, formatted_msg, "(6666): Unable to generate diff alert (fread).");
 
     char *diff_str = gen_diff_str(diff);
@@ -1004,17 +1049,11 @@ void test_gen_diff_str_ok(void **state) {
 
     expect_fclose(fp, 0);
 
-#ifndef TEST_WINAGENT
-    expect_string(__wrap_unlink, file, "/path/to/diff/file");
-    will_return(__wrap_unlink, 0);
-#endif
-
     char *diff_str = gen_diff_str(gen_diff_data_container->diff);
     assert_string_equal(diff_str, gen_diff_data_container->strarray[1]);
     free(diff_str);
 }
 
-#ifdef TEST_WINAGENT
 void test_fim_diff_generate_filters_fail(void **state) {
     diff_data *diff = *state;
     diff->uncompress_file = strdup("\%wrong path");
@@ -1040,7 +1079,6 @@ void test_fim_diff_generate_status_equal(void **state) {
     char *diff_str = fim_diff_generate(diff);
     assert_ptr_equal(diff_str, NULL);
 }
-#endif
 
 void test_fim_diff_generate_status_error(void **state) {
     diff_data *diff = *state;
@@ -1051,11 +1089,7 @@ void test_fim_diff_generate_status_error(void **state) {
 
     expect_system(-1);
 
-#ifdef TEST_WINAGENT
     expect_string(__wrap__merror, formatted_msg, "(6714): Command fc output an error");
-#else
-    expect_string(__wrap__merror, formatted_msg, "(6714): Command diff output an error");
-#endif
 
     char *diff_str = fim_diff_generate(diff);
     assert_ptr_equal(diff_str, NULL);
@@ -1068,11 +1102,7 @@ void test_fim_diff_generate_status_ok(void **state) {
     gen_diff_data_container->diff->file_origin = strdup("/path/to/file/origin");
     gen_diff_data_container->diff->diff_file = strdup("/path/to/diff/file");
 
-#ifndef TEST_WINAGENT
-    expect_system(256);
-#else
     expect_system(1);
-#endif
 
     expect_gen_diff_generate(gen_diff_data_container);
 
@@ -1081,7 +1111,6 @@ void test_fim_diff_generate_status_ok(void **state) {
     free(diff_str);
 }
 
-#ifdef TEST_WINAGENT
 void test_fim_diff_registry_tmp_fopen_fail(void **state) {
     diff_data *diff = *state;
     diff->file_origin = strdup("/path/to/file/origin");
@@ -1578,7 +1607,11 @@ void test_fim_file_diff_uncompress_fail(void **state) {
 
     expect_fim_diff_check_limits(GENERIC_PATH, COMPRESS_FOLDER, 0);
 
+#ifdef TEST_WINAGENT
     expect_w_uncompress_gzfile(COMPRESS_FILE, UNCOMPRESS_FILE, (FILE *)1234);
+#else
+    expect_fim_diff_read_snapshot(COMPRESS_FILE, NULL, NULL);
+#endif
 
     expect_fim_diff_create_compress_file(GENERIC_PATH, COMPRESS_TMP_FILE, 0);
 
@@ -1608,7 +1641,11 @@ void test_fim_file_diff_create_compress_fail(void **state) {
 
     expect_fim_diff_check_limits(GENERIC_PATH, COMPRESS_FOLDER, 0);
 
+#ifdef TEST_WINAGENT
     expect_w_uncompress_gzfile(COMPRESS_FILE, UNCOMPRESS_FILE, NULL);
+#else
+    expect_fim_diff_read_snapshot(COMPRESS_FILE, (gzFile)1234, "First line\n");
+#endif
 
     expect_FileSize(COMPRESS_FILE, 1024 * 1024);
 
@@ -1630,8 +1667,10 @@ void test_fim_file_diff_create_compress_fail(void **state) {
 
 void test_fim_file_diff_compare_fail(void **state) {
     const char *filename = GENERIC_PATH;
+#ifdef TEST_WINAGENT
     os_md5 md5sum_old = "3c183a30cffcda1408daf1c61d47b274";
     os_md5 md5sum_new = "abc44bfb4ab4cf4af49a4fa9b04fa44a";
+#endif
     const directory_t configuration = { .diff_size_limit = 1024 };
 
     syscheck.comp_estimation_perc = 0.4;
@@ -1643,6 +1682,7 @@ void test_fim_file_diff_compare_fail(void **state) {
 
     expect_fim_diff_check_limits(GENERIC_PATH, COMPRESS_FOLDER, 0);
 
+#ifdef TEST_WINAGENT
     expect_w_uncompress_gzfile(COMPRESS_FILE, UNCOMPRESS_FILE, NULL);
 
     expect_FileSize(COMPRESS_FILE, 1024 * 1024);
@@ -1650,6 +1690,15 @@ void test_fim_file_diff_compare_fail(void **state) {
     expect_fim_diff_create_compress_file(GENERIC_PATH, COMPRESS_TMP_FILE, 0);
 
     expect_fim_diff_compare(UNCOMPRESS_FILE, GENERIC_PATH, md5sum_old, md5sum_new, -1);
+#else
+    expect_fim_diff_read_snapshot(COMPRESS_FILE, (gzFile)1234, "First line\n");
+
+    expect_FileSize(COMPRESS_FILE, 1024 * 1024);
+
+    expect_fim_diff_create_compress_file(GENERIC_PATH, COMPRESS_TMP_FILE, 0);
+
+    expect_fim_diff_read_file(GENERIC_PATH, (FILE *)2345, "First line\n");
+#endif
 
     expect_string(__wrap__mdebug2, formatted_msg, "(6351): The files are identical, don't compute differences");
 
@@ -1699,8 +1748,6 @@ void test_fim_file_diff_nodiff(void **state) {
 #else
 void test_fim_file_diff_nodiff(void **state) {
     const char *filename = "/path/to/ignore";
-    os_md5 md5sum_old = "3c183a30cffcda1408daf1c61d47b274";
-    os_md5 md5sum_new = "abc44bfb4ab4cf4af49a4fa9b04fa44a";
     const directory_t configuration = { .diff_size_limit = 1024 };
 
     syscheck.comp_estimation_perc = 0.4;
@@ -1712,13 +1759,13 @@ void test_fim_file_diff_nodiff(void **state) {
 
     expect_fim_diff_check_limits("/path/to/ignore", "aaa", 0);
 
-    expect_w_uncompress_gzfile("queue/diff/file/2ee531af6f6a5f133cdd38e818e1de895c29114c/last-entry.gz", UNCOMPRESS_FILE, NULL);
+    expect_fim_diff_read_snapshot("queue/diff/file/2ee531af6f6a5f133cdd38e818e1de895c29114c/last-entry.gz", (gzFile)1234, "First line\n");
 
     expect_FileSize("queue/diff/file/2ee531af6f6a5f133cdd38e818e1de895c29114c/last-entry.gz", 1024 * 1024);
 
     expect_fim_diff_create_compress_file("/path/to/ignore", COMPRESS_TMP_FILE, 0);
 
-    expect_fim_diff_compare(UNCOMPRESS_FILE, "/path/to/ignore", md5sum_old, md5sum_new, 0);
+    expect_fim_diff_read_file("/path/to/ignore", (FILE *)2345, "First Line 123\n");
 
     expect_string(__wrap_rmdir_ex, name, TMP_FOLDER);
     will_return(__wrap_rmdir_ex, 0);
@@ -1731,6 +1778,7 @@ void test_fim_file_diff_nodiff(void **state) {
 }
 #endif
 
+#ifdef TEST_WINAGENT
 void test_fim_file_diff_generate_fail(void **state) {
     gen_diff_struct *gen_diff_data_container = *state;
     os_md5 md5sum_old = "3c183a30cffcda1408daf1c61d47b274";
@@ -1740,15 +1788,9 @@ void test_fim_file_diff_generate_fail(void **state) {
     syscheck.comp_estimation_perc = 0.4;
     syscheck.diff_folder_size = 512;
 
-#ifndef TEST_WINAGENT
-    gen_diff_data_container->diff->uncompress_file = strdup(UNCOMPRESS_FILE);
-    gen_diff_data_container->diff->file_origin = strdup("/path/to/file/origin");
-    gen_diff_data_container->diff->diff_file = strdup("queue/diff/tmp/diff-file");
-#else
     gen_diff_data_container->diff->uncompress_file = strdup("queue/diff/tmp/tmp-entry");
     gen_diff_data_container->diff->file_origin = strdup("queue/diff/tmp/[x64] " KEY_NAME_HASHED VALUE_NAME_HASHED);
     gen_diff_data_container->diff->diff_file = strdup("queue/diff/tmp/diff-file");
-#endif
 
     expect_initialize_file_diff_data(GENERIC_PATH, 1);
 
@@ -1766,11 +1808,7 @@ void test_fim_file_diff_generate_fail(void **state) {
 
     expect_fim_diff_generate(gen_diff_data_container, 1);
 
-#ifndef TEST_WINAGENT
-    expect_string(__wrap__merror, formatted_msg, "(6714): Command diff output an error");
-#else
     expect_string(__wrap__merror, formatted_msg, "(6714): Command fc output an error");
-#endif
 
     expect_string(__wrap_rmdir_ex, name, TMP_FOLDER);
     will_return(__wrap_rmdir_ex, 0);
@@ -1789,15 +1827,9 @@ void test_fim_file_diff_generate_diff_str(void **state) {
     syscheck.comp_estimation_perc = 0.4;
     syscheck.diff_folder_size = 512;
 
-#ifndef TEST_WINAGENT
-    gen_diff_data_container->diff->uncompress_file = strdup(UNCOMPRESS_FILE);
-    gen_diff_data_container->diff->file_origin = strdup("/path/to/file/origin");
-    gen_diff_data_container->diff->diff_file = strdup("queue/diff/tmp/diff-file");
-#else
     gen_diff_data_container->diff->uncompress_file = strdup("queue/diff/tmp/tmp-entry");
     gen_diff_data_container->diff->file_origin = strdup("queue/diff/tmp/[x64] " KEY_NAME_HASHED VALUE_NAME_HASHED);
     gen_diff_data_container->diff->diff_file = strdup("queue/diff/tmp/diff-file");
-#endif
 
     expect_initialize_file_diff_data(GENERIC_PATH, 1);
 
@@ -1836,19 +1868,6 @@ void test_fim_file_diff_generate_diff_str_too_long(void **state) {
     syscheck.comp_estimation_perc = 0.4;
     syscheck.diff_folder_size = 512;
 
-#ifndef TEST_WINAGENT
-    int input_size = strlen(gen_diff_data_container->strarray[0]);
-    os_realloc(gen_diff_data_container->strarray[0], OS_MAXSTR, gen_diff_data_container->strarray[0]);
-    memset(gen_diff_data_container->strarray[0] + input_size - 1, 'a', OS_MAXSTR - input_size);
-    gen_diff_data_container->strarray[0][OS_MAXSTR - 1] = '\0';
-
-    os_realloc(gen_diff_data_container->strarray[1], strlen(gen_diff_data_container->strarray[1]) - 12 + strlen(STR_MORE_CHANGES) + 1, gen_diff_data_container->strarray[1]);
-    strcpy(gen_diff_data_container->strarray[1] + strlen(gen_diff_data_container->strarray[1]) - 12, STR_MORE_CHANGES);
-
-    gen_diff_data_container->diff->uncompress_file = strdup(UNCOMPRESS_FILE);
-    gen_diff_data_container->diff->file_origin = strdup("/path/to/file/origin");
-    gen_diff_data_container->diff->diff_file = strdup("queue/diff/tmp/diff-file");
-#else
     strcpy(gen_diff_data_container->strarray[0], "Comparing files start.txt and end.txt\r\n"
                                                  "Error diffs\r\n"
                                                  "***** start.txt\r\n"
@@ -1869,7 +1888,6 @@ void test_fim_file_diff_generate_diff_str_too_long(void **state) {
     gen_diff_data_container->diff->uncompress_file = strdup("queue/diff/tmp/tmp-entry");
     gen_diff_data_container->diff->file_origin = strdup("queue/diff/tmp/[x64] " KEY_NAME_HASHED VALUE_NAME_HASHED);
     gen_diff_data_container->diff->diff_file = strdup("queue/diff/tmp/diff-file");
-#endif
 
     expect_initialize_file_diff_data(GENERIC_PATH, 1);
 
@@ -1896,6 +1914,153 @@ void test_fim_file_diff_generate_diff_str_too_long(void **state) {
     assert_string_equal(diff_str, gen_diff_data_container->strarray[1]);
     free(diff_str);
 }
+#else
+void test_fim_file_diff_read_file_fail(void **state) {
+    const directory_t configuration = { .diff_size_limit = 1024 };
+
+    syscheck.comp_estimation_perc = 0.4;
+    syscheck.diff_folder_size = 512;
+
+    expect_initialize_file_diff_data(GENERIC_PATH, 1);
+
+    expect_mkdir_ex(TMP_FOLDER, 0);
+
+    expect_fim_diff_check_limits(GENERIC_PATH, COMPRESS_FOLDER, 0);
+
+    expect_fim_diff_read_snapshot(COMPRESS_FILE, (gzFile)1234, "First line\n");
+
+    expect_FileSize(COMPRESS_FILE, 1024 * 1024);
+
+    expect_fim_diff_create_compress_file(GENERIC_PATH, COMPRESS_TMP_FILE, 0);
+
+    expect_fim_diff_read_file(GENERIC_PATH, NULL, NULL);
+
+    expect_string(__wrap_rmdir_ex, name, TMP_FOLDER);
+    will_return(__wrap_rmdir_ex, 0);
+
+    char *diff_str = fim_file_diff(GENERIC_PATH, &configuration);
+
+    assert_ptr_equal(diff_str, NULL);
+}
+
+void test_fim_file_diff_generate_diff_str(void **state) {
+    const directory_t configuration = { .diff_size_limit = 1024 };
+
+    syscheck.comp_estimation_perc = 0.4;
+    syscheck.diff_folder_size = 512;
+
+    expect_initialize_file_diff_data(GENERIC_PATH, 1);
+
+    expect_mkdir_ex(TMP_FOLDER, 0);
+
+    expect_fim_diff_check_limits(GENERIC_PATH, COMPRESS_FOLDER, 0);
+
+    expect_fim_diff_read_snapshot(COMPRESS_FILE, (gzFile)1234, "First line\n");
+
+    expect_FileSize(COMPRESS_FILE, 1024 * 1024);
+
+    expect_fim_diff_create_compress_file(GENERIC_PATH, COMPRESS_TMP_FILE, 0);
+
+    expect_fim_diff_read_file(GENERIC_PATH, (FILE *)2345, "First Line 123\nLast line\n");
+
+    expect_save_compress_file(COMPRESS_TMP_FILE, COMPRESS_FILE, 0);
+
+    expect_string(__wrap_rmdir_ex, name, TMP_FOLDER);
+    will_return(__wrap_rmdir_ex, 0);
+
+    char *diff_str = fim_file_diff(GENERIC_PATH, &configuration);
+
+    assert_string_equal(diff_str, "1c1,2\n< First line\n---\n> First Line 123\n> Last line\n");
+
+    free(diff_str);
+}
+
+void test_fim_file_diff_generate_diff_str_too_long(void **state) {
+    const directory_t configuration = { .diff_size_limit = 1024 };
+    char *new_content = *state;
+    size_t len;
+
+    syscheck.comp_estimation_perc = 0.4;
+    syscheck.diff_folder_size = 512;
+
+    expect_initialize_file_diff_data(GENERIC_PATH, 1);
+
+    expect_mkdir_ex(TMP_FOLDER, 0);
+
+    expect_fim_diff_check_limits(GENERIC_PATH, COMPRESS_FOLDER, 0);
+
+    expect_fim_diff_read_snapshot(COMPRESS_FILE, (gzFile)1234, "a\n");
+
+    expect_FileSize(COMPRESS_FILE, 1024 * 1024);
+
+    expect_fim_diff_create_compress_file(GENERIC_PATH, COMPRESS_TMP_FILE, 0);
+
+    expect_fim_diff_read_file(GENERIC_PATH, (FILE *)2345, new_content);
+
+    expect_save_compress_file(COMPRESS_TMP_FILE, COMPRESS_FILE, 0);
+
+    expect_string(__wrap_rmdir_ex, name, TMP_FOLDER);
+    will_return(__wrap_rmdir_ex, 0);
+
+    char *diff_str = fim_file_diff(GENERIC_PATH, &configuration);
+    *state = diff_str;
+
+    len = strlen(diff_str);
+    assert_true(len <= OS_MAXSTR - OS_SK_HEADER - 1);
+    assert_memory_equal(diff_str, "1c1,60\n< a\n---\n> ", 17);
+    assert_string_equal(diff_str + len - strlen(STR_MORE_CHANGES), STR_MORE_CHANGES);
+    // Only whole lines are reported
+    assert_int_equal(diff_str[len - strlen(STR_MORE_CHANGES) - 1], '\n');
+
+    free(new_content);
+}
+
+// fim_diff_lines
+
+void test_fim_diff_lines_added(void **state) {
+    char *diff_str = fim_diff_lines("a\nb\n", 4, "a\nb\nc\nd\n", 8);
+    *state = diff_str;
+
+    assert_string_equal(diff_str, "2a3,4\n> c\n> d\n");
+}
+
+void test_fim_diff_lines_removed(void **state) {
+    char *diff_str = fim_diff_lines("a\nb\nc\n", 6, "c\n", 2);
+    *state = diff_str;
+
+    assert_string_equal(diff_str, "1,2d0\n< a\n< b\n");
+}
+
+void test_fim_diff_lines_changed(void **state) {
+    const char *old_data = "[main]\nport = 80\nhost = a\n# end\n";
+    const char *new_data = "[main]\nport = 8080\nhost = a\nuser = b\n# end\n";
+    char *diff_str = fim_diff_lines(old_data, strlen(old_data), new_data, strlen(new_data));
+    *state = diff_str;
+
+    assert_string_equal(diff_str, "2c2\n< port = 80\n---\n> port = 8080\n3a4\n> user = b\n");
+}
+
+void test_fim_diff_lines_no_newline(void **state) {
+    char *diff_str = fim_diff_lines("a\nb", 3, "a\nc", 3);
+    *state = diff_str;
+
+    assert_string_equal(diff_str, "2c2\n< b\n\\ No newline at end of file\n---\n> c\n\\ No newline at end of file\n");
+}
+
+void test_fim_diff_lines_binary(void **state) {
+    char *diff_str = fim_diff_lines("a\0b", 3, "a\0c", 3);
+    *state = diff_str;
+
+    assert_string_equal(diff_str, "Binary files differ\n");
+}
+
+void test_fim_diff_lines_empty(void **state) {
+    char *diff_str = fim_diff_lines("", 0, "a\n", 2);
+    *state = diff_str;
+
+    assert_string_equal(diff_str, "0a1\n> a\n");
+}
+#endif
 
 void test_fim_diff_process_delete_file_ok(void **state) {
 #ifdef TEST_WINAGENT
@@ -2028,11 +2193,13 @@ int main(void) {
         cmocka_unit_test(test_fim_diff_modify_compress_estimation_MIN_COMP_ESTIM),
         cmocka_unit_test(test_fim_diff_modify_compress_estimation_ok),
 
+#ifdef TEST_WINAGENT
         // fim_diff_compare
         cmocka_unit_test_setup_teardown(test_fim_diff_compare_fail_uncompress_MD5, setup_diff_data, teardown_free_diff_data),
         cmocka_unit_test_setup_teardown(test_fim_diff_compare_fail_origin_MD5, setup_diff_data, teardown_free_diff_data),
         cmocka_unit_test_setup_teardown(test_fim_diff_compare_fail_not_match, setup_diff_data, teardown_free_diff_data),
         cmocka_unit_test_setup_teardown(test_fim_diff_compare_fail_match, setup_diff_data, teardown_free_diff_data),
+#endif
 
         // save_compress_file
         cmocka_unit_test_setup_teardown(test_save_compress_file_ok, setup_diff_data, teardown_free_diff_data),
@@ -2048,7 +2215,6 @@ int main(void) {
         cmocka_unit_test(test_is_registry_nodiff_normal_check),
         cmocka_unit_test(test_is_registry_nodiff_regex_check),
         cmocka_unit_test(test_is_registry_nodiff_not_match),
-#endif
 
         // gen_diff_str
         cmocka_unit_test_setup_teardown(test_gen_diff_str_wfropen_fail, setup_diff_data, teardown_free_diff_data),
@@ -2058,7 +2224,6 @@ int main(void) {
         // fim_diff_generate
         cmocka_unit_test_setup_teardown(test_fim_diff_generate_status_error, setup_diff_data, teardown_free_diff_data),
         cmocka_unit_test_setup_teardown(test_fim_diff_generate_status_ok, setup_gen_diff_str, teardown_free_gen_diff_str),
-#ifdef TEST_WINAGENT
         cmocka_unit_test_setup_teardown(test_fim_diff_generate_filters_fail, setup_diff_data, teardown_free_diff_data),
         cmocka_unit_test_setup_teardown(test_fim_diff_generate_status_equal, setup_diff_data, teardown_free_diff_data),
 
@@ -2095,11 +2260,20 @@ int main(void) {
 #ifdef TEST_WINAGENT
         cmocka_unit_test_setup_teardown(test_fim_file_diff_generate_fail, setup_full_diff_functionality, teardown_full_diff_functionality),
         cmocka_unit_test_setup_teardown(test_fim_file_diff_generate_diff_str, setup_full_diff_functionality, teardown_full_diff_functionality),
+        cmocka_unit_test_setup_teardown(test_fim_file_diff_generate_diff_str_too_long, setup_gen_diff_str, teardown_free_gen_diff_str),
 #else
-        cmocka_unit_test_setup_teardown(test_fim_file_diff_generate_fail, setup_gen_diff_str, teardown_free_gen_diff_str),
-        cmocka_unit_test_setup_teardown(test_fim_file_diff_generate_diff_str, setup_gen_diff_str, teardown_free_gen_diff_str),
+        cmocka_unit_test(test_fim_file_diff_read_file_fail),
+        cmocka_unit_test(test_fim_file_diff_generate_diff_str),
+        cmocka_unit_test_setup_teardown(test_fim_file_diff_generate_diff_str_too_long, setup_long_content, teardown_free_string),
+
+        // fim_diff_lines
+        cmocka_unit_test_teardown(test_fim_diff_lines_added, teardown_free_string),
+        cmocka_unit_test_teardown(test_fim_diff_lines_removed, teardown_free_string),
+        cmocka_unit_test_teardown(test_fim_diff_lines_changed, teardown_free_string),
+        cmocka_unit_test_teardown(test_fim_diff_lines_no_newline, teardown_free_string),
+        cmocka_unit_test_teardown(test_fim_diff_lines_binary, teardown_free_string),
+        cmocka_unit_test_teardown(test_fim_diff_lines_empty, teardown_free_string),
 #endif
-        cmocka_unit_test_setup_teardown(test_fim_file_diff_generate_diff_str_too_long, setup_gen_diff_str, teardown_free_gen_diff_str),
 
         // fim_diff_process_delete_file
         cmocka_unit_test(test_fim_diff_process_delete_file_ok),
@@ -25,6 +25,7 @@
 #include "../wrappers/wazuh/shared/fs_op_wrappers.h"
 #include "../wrappers/wazuh/shared/hash_op_wrappers.h"
 #include "../wrappers/wazuh/shared/randombytes_wrappers.h"
+#include "../wrappers/wazuh/shared/rbtree_op_wrappers.h"
 #include "../wrappers/wazuh/shared/syscheck_op_wrappers.h"
 #include "../wrappers/wazuh/shared/vector_op_wrappers.h"
 #include "../wrappers/wazuh/shared/file_op_wrappers.h"
@@ -49,6 +50,21 @@ typedef struct realtime_process_data{
     OSHashNode *node;
 } realtime_process_data;
 
+#if defined(TEST_AGENT)
+// This struct should always reflect the one defined in run_realtime.c
+typedef struct realtime_pending {
+    struct timespec first;
+    struct timespec last;
+    int created;
+} realtime_pending;
+
+static void expect_rbtree_get(const char *key, void *ret) {
+    expect_any(__wrap_rbtree_get, tree);
+    expect_string(__wrap_rbtree_get, key, key);
+    will_return(__wrap_rbtree_get, ret);
+}
+#endif
+
 static int setup_OSHash(void **state);
 static int teardown_OSHash(void **state);
 
@@ -613,6 +629,7 @@ void test_realtime_process_len(void **state) {
     will_return(__wrap_OSHash_Get_ex, "test");
 
     expect_string(__wrap__mdebug2, formatted_msg, "Duplicate event in real-time buffer: test/test");
+    expect_rbtree_get("test/test", NULL);
 
     expect_function_call(__wrap_pthread_mutex_unlock);
 
@@ -621,6 +638,7 @@ void test_realtime_process_len(void **state) {
 
     will_return(__wrap_rbtree_keys, paths);
 
+    expect_rbtree_get("/test", NULL);
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_string(__wrap_fim_realtime_event, file, "/test");
     expect_function_call(__wrap_pthread_rwlock_unlock);
@@ -653,6 +671,7 @@ void test_realtime_process_len_zero(void **state) {
     will_return(__wrap_OSHash_Get_ex, "test");
 
     expect_string(__wrap__mdebug2, formatted_msg, "Duplicate event in real-time buffer: test");
+    expect_rbtree_get("test", NULL);
 
     expect_function_call(__wrap_pthread_mutex_unlock);
 
@@ -661,6 +680,7 @@ void test_realtime_process_len_zero(void **state) {
 
     will_return(__wrap_rbtree_keys, paths);
 
+    expect_rbtree_get("/test", NULL);
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_string(__wrap_fim_realtime_event, file, "/test");
     expect_function_call(__wrap_pthread_rwlock_unlock);
@@ -691,6 +711,7 @@ void test_realtime_process_len_path_separator(void **state) {
     will_return(__wrap_OSHash_Get_ex, "test/");
 
     expect_string(__wrap__mdebug2, formatted_msg, "Duplicate event in real-time buffer: test/test");
+    expect_rbtree_get("test/test", NULL);
 
     expect_function_call(__wrap_pthread_mutex_unlock);
 
@@ -699,6 +720,7 @@ void test_realtime_process_len_path_separator(void **state) {
 
     will_return(__wrap_rbtree_keys, paths);
 
+    expect_rbtree_get("/test", NULL);
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_string(__wrap_fim_realtime_event, file, "/test");
     expect_function_call(__wrap_pthread_rwlock_unlock);
@@ -734,6 +756,7 @@ void test_realtime_process_overflow(void **state) {
 
     will_return(__wrap_rbtree_keys, paths);
 
+    expect_rbtree_get("/test", NULL);
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_string(__wrap_fim_realtime_event, file, "/test");
     expect_function_call(__wrap_pthread_rwlock_unlock);
@@ -764,6 +787,7 @@ void test_realtime_process_delete(void **state) {
     will_return(__wrap_OSHash_Get_ex, "test");
 
     expect_string(__wrap__mdebug2, formatted_msg, "Duplicate event in real-time buffer: test/test");
+    expect_rbtree_get("test/test", NULL);
 
     char *data = strdup("delete this");
     expect_value(__wrap_OSHash_Delete_ex, self, syscheck.realtime->dirtb);
@@ -779,6 +803,7 @@ void test_realtime_process_delete(void **state) {
 
     will_return(__wrap_rbtree_keys, paths);
 
+    expect_rbtree_get("/test", NULL);
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_string(__wrap_fim_realtime_event, file, "/test");
     expect_function_call(__wrap_pthread_rwlock_unlock);
@@ -811,6 +836,7 @@ void test_realtime_process_move_self(void **state) {
     will_return(__wrap_OSHash_Get_ex, "test");
 
     expect_string(__wrap__mdebug2, formatted_msg, "Duplicate event in real-time buffer: test/test");
+    expect_rbtree_get("test/test", NULL);
 
     // In delete_subdirectories_watches
     OSHashNode *node = data->node;
@@ -844,6 +870,7 @@ void test_realtime_process_move_self(void **state) {
 
     will_return(__wrap_rbtree_keys, paths);
 
+    expect_rbtree_get("/test", NULL);
     expect_function_call(__wrap_pthread_rwlock_rdlock);
     expect_string(__wrap_fim_realtime_event, file, "/test");
     expect_function_call(__wrap_pthread_rwlock_unlock);
@@ -869,6 +896,154 @@ void test_realtime_process_failure(void **state)
     realtime_process();
 }
 
+void test_realtime_process_move_created(void **state) {
+    union {
+        struct inotify_event event;
+        char data[2 * (sizeof(struct inotify_event) + 16)];
+    } buffer;
+    struct inotify_event *moved_from = &buffer.event;
+    struct inotify_event *moved_to = (struct inotify_event *) (void *) (buffer.data + sizeof(struct inotify_event) + 16);
+    realtime_pending source = { .created = 1 };
+
+    memset(&buffer, 0, sizeof(buffer));
+    moved_from->wd = 1;
+    moved_from->mask = IN_MOVED_FROM;
+    moved_from->cookie = 5;
+    moved_from->len = 16;
+    strcpy(moved_from->name, "tmp");
+    moved_to->wd = 1;
+    moved_to->mask = IN_MOVED_TO;
+    moved_to->cookie = 5;
+    moved_to->len = 16;
+    strcpy(moved_to->name, "file");
+
+    syscheck.realtime->fd = 1;
+
+    expect_function_call(__wrap_pthread_mutex_lock);
+    will_return(__wrap_read, &buffer);
+    will_return(__wrap_read, sizeof(buffer));
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    // IN_MOVED_FROM
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Get_ex, key, "1");
+    will_return(__wrap_OSHash_Get_ex, "test");
+    expect_string(__wrap__mdebug2, formatted_msg, "Duplicate event in real-time buffer: test/tmp");
+    expect_rbtree_get("test/tmp", NULL);
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    // IN_MOVED_TO, paired with the source that was created right before
+    expect_function_call(__wrap_pthread_mutex_lock);
+    expect_value(__wrap_OSHash_Get_ex, self, syscheck.realtime->dirtb);
+    expect_string(__wrap_OSHash_Get_ex, key, "1");
+    will_return(__wrap_OSHash_Get_ex, "test");
+    expect_string(__wrap__mdebug2, formatted_msg, "Duplicate event in real-time buffer: test/file");
+    expect_rbtree_get("test/file", NULL);
+    expect_rbtree_get("test/tmp", &source);
+    expect_string(__wrap__mdebug2, formatted_msg, "(6379): 'test/tmp' was moved to 'test/file' right after being created, only the target will be checked.");
+    expect_function_call(__wrap_pthread_mutex_unlock);
+
+    char **paths = NULL;
+    paths = os_AddStrArray("test/file", paths);
+
+    will_return(__wrap_rbtree_keys, paths);
+
+    expect_rbtree_get("test/file", NULL);
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_string(__wrap_fim_realtime_event, file, "test/file");
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    realtime_process();
+}
+
+void test_realtime_flush_not_settled(void **state) {
+    realtime_pending pending = { .created = 0 };
+    char **paths = NULL;
+
+    paths = os_AddStrArray("/test", paths);
+    syscheck.rt_quiet_period = 1000;
+    gettime(&pending.first);
+    pending.last = pending.first;
+
+    will_return(__wrap_rbtree_keys, paths);
+    expect_rbtree_get("/test", &pending);
+
+    realtime_flush(0);
+
+    syscheck.rt_quiet_period = 0;
+}
+
+void test_realtime_flush_settled(void **state) {
+    realtime_pending pending = { .created = 0 };
+    char **paths = NULL;
+
+    paths = os_AddStrArray("/test", paths);
+    syscheck.rt_quiet_period = 1000;
+
+    will_return(__wrap_rbtree_keys, paths);
+    expect_rbtree_get("/test", &pending);
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_string(__wrap_fim_realtime_event, file, "/test");
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    realtime_flush(0);
+
+    syscheck.rt_quiet_period = 0;
+}
+
+void test_realtime_flush_deferred_too_long(void **state) {
+    realtime_pending pending = { .created = 0 };
+    char **paths = NULL;
+
+    paths = os_AddStrArray("/test", paths);
+    syscheck.rt_quiet_period = 1000;
+    gettime(&pending.last);
+    pending.first = pending.last;
+    pending.first.tv_sec -= 60;
+
+    will_return(__wrap_rbtree_keys, paths);
+    expect_rbtree_get("/test", &pending);
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_string(__wrap_fim_realtime_event, file, "/test");
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    realtime_flush(0);
+
+    syscheck.rt_quiet_period = 0;
+}
+
+void test_realtime_flush_force(void **state) {
+    realtime_pending pending = { .created = 0 };
+    char **paths = NULL;
+
+    paths = os_AddStrArray("/test", paths);
+    syscheck.rt_quiet_period = 1000;
+    gettime(&pending.first);
+    pending.last = pending.first;
+
+    will_return(__wrap_rbtree_keys, paths);
+    expect_rbtree_get("/test", &pending);
+
+    expect_function_call(__wrap_pthread_rwlock_rdlock);
+    expect_string(__wrap_fim_realtime_event, file, "/test");
+    expect_function_call(__wrap_pthread_rwlock_unlock);
+
+    realtime_flush(1);
+
+    syscheck.rt_quiet_period = 0;
+}
+
+void test_realtime_flush_timeout_no_pending(void **state) {
+    syscheck.rt_quiet_period = 1000;
+
+    assert_int_equal(realtime_flush_timeout(), -1);
+
+    syscheck.rt_quiet_period = 0;
+}
+
 void test_delete_subdirectories_watches_realtime_fd_null(void **state) {
     (void) state;
     char *dir = "/test";
@@ -1993,6 +2168,14 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_realtime_process_delete, setup_inotify_event, teardown_inotify_event),
         cmocka_unit_test_setup_teardown(test_realtime_process_move_self, setup_realtime_process, teardown_realtime_process),
         cmocka_unit_test(test_realtime_process_failure),
+        cmocka_unit_test_setup_teardown(test_realtime_process_move_created, setup_OSHash, teardown_OSHash),
+
+        /* realtime_flush */
+        cmocka_unit_test(test_realtime_flush_not_settled),
+        cmocka_unit_test(test_realtime_flush_settled),
+        cmocka_unit_test(test_realtime_flush_deferred_too_long),
+        cmocka_unit_test(test_realtime_flush_force),
+        cmocka_unit_test(test_realtime_flush_timeout_no_pending),
 
         /* delete_subdirectories_watches */
         cmocka_unit_test_setup_teardown(test_delete_subdirectories_watches_realtime_fd_null, setup_hash_node, teardown_hash_node),
@@ -0,0 +1,445 @@
+/*
+ * Copyright (C) 2015, Wazuh Inc.
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General Public
+ * License (version 2) as published by the FSF - Free Software
+ * Foundation.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../wrappers/common.h"
+#include "../wrappers/wazuh/shared/debug_op_wrappers.h"
+
+#include "syscheck.h"
+#include "scan_pool.c"
+
+#define TEST_DEVICE ((dev_t)0xfffff)
+#define TEST_DEVICE_THREADS 2
+#define TEST_POOL_THREADS 4
+
+/* Workers call the wrappers at the same time, so they record what happened instead of using cmocka mocks */
+typedef struct scan_record {
+    pthread_mutex_t mutex;
+    char **checked;
+    unsigned int checked_count;
+    char **synced;
+    unsigned int synced_count;
+    unsigned int syncing;
+    unsigned int max_syncing;
+    unsigned int reading;
+    unsigned int max_reading;
+    unsigned int wrong_entries;
+    unsigned int missing_workers;
+} scan_record_t;
+
+static scan_record_t record = { .mutex = PTHREAD_MUTEX_INITIALIZER };
+static void (*checker_hook)(const char *path, const directory_t *configuration, fim_txn_context_t *ctx);
+
+static int txn_dummy;
+static TXN_HANDLE test_txn_handle = (TXN_HANDLE)&txn_dummy;
+static fim_txn_context_t test_txn_context;
+static event_data_t test_evt_data;
+static directory_t test_configuration;
+
+/* wrappers */
+
+void __wrap_fim_checker(const char *path,
+                        __attribute__((unused)) event_data_t *evt_data,
+                        const directory_t *configuration,
+                        __attribute__((unused)) TXN_HANDLE txn_handle,
+                        fim_txn_context_t *ctx) {
+    w_mutex_lock(&record.mutex);
+    os_realloc(record.checked, (record.checked_count + 1) * sizeof(char *), record.checked);
+    os_strdup(path, record.checked[record.checked_count++]);
+    if (ctx == NULL || ctx->worker == NULL) {
+        record.missing_workers++;
+    }
+    w_mutex_unlock(&record.mutex);
+
+    if (checker_hook != NULL) {
+        checker_hook(path, configuration, ctx);
+    }
+}
+
+int __wrap_fim_db_transaction_sync_row(__attribute__((unused)) TXN_HANDLE txn_handler, const fim_entry *entry) {
+    w_mutex_lock(&record.mutex);
+    if (test_txn_context.latest_entry != entry) {
+        record.wrong_entries++;
+    }
+    if (++record.syncing > record.max_syncing) {
+        record.max_syncing = record.syncing;
+    }
+    os_realloc(record.synced, (record.synced_count + 1) * sizeof(char *), record.synced);
+    os_strdup(entry->file_entry.path, record.synced[record.synced_count++]);
+    w_mutex_unlock(&record.mutex);
+
+    // Give other workers the chance to overlap if the writer wasn't exclusive
+    usleep(100);
+
+    w_mutex_lock(&record.mutex);
+    record.syncing--;
+    w_mutex_unlock(&record.mutex);
+
+    return 0;
+}
+
+/* auxiliary functions */
+
+/* Directories are the paths with fewer than 3 levels, each one with 4 subdirectories or files */
+static void check_directory_tree(const char *path, const directory_t *configuration, fim_txn_context_t *ctx) {
+    char child[PATH_MAX];
+    unsigned int depth = 0;
+    const char *c;
+    unsigned int i;
+
+    for (c = path; *c != '\0'; c++) {
+        depth += (*c == '/');
+    }
+
+    if (depth < 3) {
+        for (i = 0; i < 4; i++) {
+            snprintf(child, sizeof(child), "%s/%u", path, i);
+            fim_scan_worker_push(ctx->worker, child, configuration);
+        }
+        return;
+    }
+
+    fim_entry entry = { .file_entry.path = (char *)path };
+
+    fim_scan_worker_acquire_device(ctx->worker, TEST_DEVICE);
+    fim_scan_worker_sync_row(ctx->worker, &entry);
+    fim_scan_worker_release_device(ctx->worker, TEST_DEVICE);
+}
+
+static void check_device_file(__attribute__((unused)) const char *path,
+                              __attribute__((unused)) const directory_t *configuration,
+                              fim_txn_context_t *ctx) {
+    fim_scan_worker_acquire_device(ctx->worker, TEST_DEVICE);
+
+    w_mutex_lock(&record.mutex);
+    if (++record.reading > record.max_reading) {
+        record.max_reading = record.reading;
+    }
+    w_mutex_unlock(&record.mutex);
+
+    usleep(2000);
+
+    w_mutex_lock(&record.mutex);
+    record.reading--;
+    w_mutex_unlock(&record.mutex);
+
+    fim_scan_worker_release_device(ctx->worker, TEST_DEVICE);
+}
+
+static void *acquire_device_thread(void *arg) {
+    fim_scan_worker_acquire_device((fim_scan_worker_t *)arg, TEST_DEVICE);
+    return NULL;
+}
+
+/* Same setup as fim_scan_pool_create, without starting the workers, so the queues can be checked step by step */
+static fim_scan_pool_t *create_stopped_pool(unsigned int size) {
+    fim_scan_pool_t *pool;
+    unsigned int i;
+
+    os_calloc(1, sizeof(fim_scan_pool_t), pool);
+    os_calloc(size, sizeof(fim_scan_worker_t), pool->workers);
+    pool->size = size;
+    pool->txn_handle = test_txn_handle;
+    pool->txn_context = &test_txn_context;
+    w_mutex_init(&pool->mutex, NULL);
+    w_cond_init(&pool->available, NULL);
+    w_cond_init(&pool->idle, NULL);
+    w_mutex_init(&pool->writer_mutex, NULL);
+    w_mutex_init(&pool->device_mutex, NULL);
+    w_cond_init(&pool->device_released, NULL);
+
+    for (i = 0; i < size; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].id = i;
+        pool->workers[i].txn_context.evt_data = &pool->workers[i].evt_data;
+        pool->workers[i].txn_context.worker = &pool->workers[i];
+        w_mutex_init(&pool->workers[i].queue.mutex, NULL);
+    }
+
+    return pool;
+}
+
+static bool was_checked(const char *path) {
+    unsigned int i;
+
+    for (i = 0; i < record.checked_count; i++) {
+        if (strcmp(record.checked[i], path) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* setup/teardown */
+
+static int setup_record(__attribute__((unused)) void **state) {
+    checker_hook = NULL;
+    syscheck.scan_device_threads = TEST_DEVICE_THREADS;
+    memset(&test_txn_context, 0, sizeof(test_txn_context));
+    return 0;
+}
+
+static int teardown_record(__attribute__((unused)) void **state) {
+    unsigned int i;
+
+    for (i = 0; i < record.checked_count; i++) {
+        os_free(record.checked[i]);
+    }
+    for (i = 0; i < record.synced_count; i++) {
+        os_free(record.synced[i]);
+    }
+    os_free(record.checked);
+    os_free(record.synced);
+
+    record.checked_count = 0;
+    record.synced_count = 0;
+    record.syncing = 0;
+    record.max_syncing = 0;
+    record.reading = 0;
+    record.max_reading = 0;
+    record.wrong_entries = 0;
+    record.missing_workers = 0;
+
+    return 0;
+}
+
+/* tests */
+
+static void test_fim_scan_worker_queue_order(__attribute__((unused)) void **state) {
+    fim_scan_pool_t *pool = create_stopped_pool(2);
+    fim_scan_task_t task;
+
+    fim_scan_worker_push(&pool->workers[0], "/a", &test_configuration);
+    fim_scan_worker_push(&pool->workers[0], "/b", &test_configuration);
+    fim_scan_worker_push(&pool->workers[0], "/c", &test_configuration);
+    assert_int_equal(pool->queued, 3);
+    assert_int_equal(pool->pending, 3);
+
+    // The owner takes the most recent path
+    assert_true(fim_scan_worker_pop(&pool->workers[0], &task));
+    assert_string_equal(task.path, "/c");
+    assert_ptr_equal(task.configuration, &test_configuration);
+    os_free(task.path);
+    fim_scan_pool_task_taken(pool);
+
+    // Other workers take the oldest one
+    assert_true(fim_scan_worker_steal(&pool->workers[0], &task));
+    assert_string_equal(task.path, "/a");
+    os_free(task.path);
+    fim_scan_pool_task_taken(pool);
+
+    // An idle worker steals once its own queue and the roots are empty
+    assert_true(fim_scan_worker_next(&pool->workers[1], &task));
+    assert_string_equal(task.path, "/b");
+    os_free(task.path);
+    assert_int_equal(pool->queued, 0);
+
+    assert_false(fim_scan_worker_next(&pool->workers[1], &task));
+
+    // The own queue goes before the roots, and the last root goes first
+    fim_scan_pool_add(pool, "/root1", &test_configuration);
+    fim_scan_pool_add(pool, "/root2", &test_configuration);
+    fim_scan_worker_push(&pool->workers[1], "/own", &test_configuration);
+    assert_int_equal(pool->queued, 3);
+
+    assert_true(fim_scan_worker_next(&pool->workers[1], &task));
+    assert_string_equal(task.path, "/own");
+    os_free(task.path);
+    assert_true(fim_scan_worker_next(&pool->workers[1], &task));
+    assert_string_equal(task.path, "/root2");
+    os_free(task.path);
+    assert_true(fim_scan_worker_next(&pool->workers[0], &task));
+    assert_string_equal(task.path, "/root1");
+    os_free(task.path);
+    assert_int_equal(pool->queued, 0);
+    assert_int_equal(pool->pending, 6);
+
+    while (pool->pending > 0) {
+        fim_scan_pool_task_done(pool);
+    }
+
+    assert_int_equal(record.checked_count, 0);
+
+    fim_scan_pool_wait(pool);
+}
+
+static void test_fim_scan_worker_push_full_queue(__attribute__((unused)) void **state) {
+    fim_scan_pool_t *pool = create_stopped_pool(1);
+    fim_scan_task_t task;
+    unsigned int i;
+
+    for (i = 0; i < FIM_SCAN_QUEUE_SIZE; i++) {
+        fim_scan_worker_push(&pool->workers[0], "/queued", &test_configuration);
+    }
+    assert_int_equal(record.checked_count, 0);
+
+    // No room left, the path is checked right away by the pushing worker
+    fim_scan_worker_push(&pool->workers[0], "/overflow", &test_configuration);
+
+    assert_int_equal(record.checked_count, 1);
+    assert_string_equal(record.checked[0], "/overflow");
+    assert_int_equal(record.missing_workers, 0);
+    assert_int_equal(pool->workers[0].queue.count, FIM_SCAN_QUEUE_SIZE);
+    assert_int_equal(pool->queued, FIM_SCAN_QUEUE_SIZE);
+    assert_int_equal(pool->pending, FIM_SCAN_QUEUE_SIZE);
+
+    while (fim_scan_worker_next(&pool->workers[0], &task)) {
+        assert_string_equal(task.path, "/queued");
+        os_free(task.path);
+        fim_scan_pool_task_done(pool);
+    }
+
+    assert_int_equal(pool->queued, 0);
+    assert_int_equal(pool->pending, 0);
+
+    fim_scan_pool_wait(pool);
+}
+
+static void test_fim_scan_pool_wait_idle_workers(__attribute__((unused)) void **state) {
+    fim_scan_pool_t *pool;
+
+    expect_string(__wrap__mdebug1, formatted_msg, "(6377): Scanning directories with 4 threads.");
+
+    pool = fim_scan_pool_create(TEST_POOL_THREADS, &test_evt_data, test_txn_handle, &test_txn_context);
+    assert_non_null(pool);
+
+    // Nothing to scan, every worker is waiting
+    fim_scan_pool_wait(pool);
+
+    assert_int_equal(record.checked_count, 0);
+}
+
+static void test_fim_scan_pool_wait_single_root(__attribute__((unused)) void **state) {
+    fim_scan_pool_t *pool;
+
+    expect_string(__wrap__mdebug1, formatted_msg, "(6377): Scanning directories with 4 threads.");
+
+    pool = fim_scan_pool_create(TEST_POOL_THREADS, &test_evt_data, test_txn_handle, &test_txn_context);
+    assert_non_null(pool);
+
+    // A single file keeps one worker busy while the others find nothing to take
+    fim_scan_pool_add(pool, "/file", &test_configuration);
+    fim_scan_pool_wait(pool);
+
+    assert_int_equal(record.checked_count, 1);
+    assert_string_equal(record.checked[0], "/file");
+    assert_int_equal(record.missing_workers, 0);
+}
+
+static void test_fim_scan_worker_device_limit(__attribute__((unused)) void **state) {
+    fim_scan_pool_t *pool;
+    char path[PATH_MAX];
+    unsigned int i;
+
+    checker_hook = check_device_file;
+
+    expect_string(__wrap__mdebug1, formatted_msg, "(6377): Scanning directories with 4 threads.");
+
+    pool = fim_scan_pool_create(TEST_POOL_THREADS, &test_evt_data, test_txn_handle, &test_txn_context);
+    assert_non_null(pool);
+
+    for (i = 0; i < 16; i++) {
+        snprintf(path, sizeof(path), "/file%u", i);
+        fim_scan_pool_add(pool, path, &test_configuration);
+    }
+    fim_scan_pool_wait(pool);
+
+    assert_int_equal(record.checked_count, 16);
+    assert_in_range(record.max_reading, 1, TEST_DEVICE_THREADS);
+}
+
+static void test_fim_scan_worker_device_added_while_waiting(__attribute__((unused)) void **state) {
+    fim_scan_pool_t *pool = create_stopped_pool(2);
+    pthread_t waiter;
+    unsigned int i;
+
+    syscheck.scan_device_threads = 1;
+
+    fim_scan_worker_acquire_device(&pool->workers[0], TEST_DEVICE);
+    assert_int_equal(pthread_create(&waiter, NULL, acquire_device_thread, &pool->workers[1]), 0);
+
+    // Let the second worker block on the busy device
+    usleep(10000);
+
+    // New devices grow the array the waiting worker is looking at
+    for (i = 1; i <= 64; i++) {
+        fim_scan_worker_acquire_device(&pool->workers[0], TEST_DEVICE - i);
+    }
+    assert_int_equal(pool->devices_count, 65);
+
+    fim_scan_worker_release_device(&pool->workers[0], TEST_DEVICE);
+    pthread_join(waiter, NULL);
+
+    assert_true(pool->devices[0].device == TEST_DEVICE);
+    assert_int_equal(pool->devices[0].busy, 1);
+    for (i = 1; i <= 64; i++) {
+        assert_int_equal(pool->devices[i].busy, 1);
+        fim_scan_worker_release_device(&pool->workers[0], TEST_DEVICE - i);
+    }
+    fim_scan_worker_release_device(&pool->workers[1], TEST_DEVICE);
+    assert_int_equal(pool->devices[0].busy, 0);
+
+    fim_scan_pool_wait(pool);
+}
+
+static void test_fim_scan_worker_sync_row_every_file(__attribute__((unused)) void **state) {
+    fim_scan_pool_t *pool;
+    unsigned int i;
+    unsigned int j;
+
+    checker_hook = check_directory_tree;
+
+    expect_string(__wrap__mdebug1, formatted_msg, "(6377): Scanning directories with 4 threads.");
+
+    pool = fim_scan_pool_create(TEST_POOL_THREADS, &test_evt_data, test_txn_handle, &test_txn_context);
+    assert_non_null(pool);
+
+    fim_scan_pool_add(pool, "/dir0", &test_configuration);
+    fim_scan_pool_add(pool, "/dir1", &test_configuration);
+    fim_scan_pool_wait(pool);
+
+    // 2 roots, 8 subdirectories and 32 files
+    assert_int_equal(record.checked_count, 42);
+    assert_true(was_checked("/dir0/3"));
+    assert_true(was_checked("/dir1/0/2"));
+    assert_int_equal(record.missing_workers, 0);
+
+    // Every file is synchronized once, with the shared context pointing to it, and one at a time
+    assert_int_equal(record.synced_count, 32);
+    for (i = 0; i < record.synced_count; i++) {
+        for (j = i + 1; j < record.synced_count; j++) {
+            assert_string_not_equal(record.synced[i], record.synced[j]);
+        }
+    }
+    assert_int_equal(record.wrong_entries, 0);
+    assert_int_equal(record.max_syncing, 1);
+    assert_null(test_txn_context.latest_entry);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_fim_scan_worker_queue_order, setup_record, teardown_record),
+        cmocka_unit_test_setup_teardown(test_fim_scan_worker_push_full_queue, setup_record, teardown_record),
+        cmocka_unit_test_setup_teardown(test_fim_scan_pool_wait_idle_workers, setup_record, teardown_record),
+        cmocka_unit_test_setup_teardown(test_fim_scan_pool_wait_single_root, setup_record, teardown_record),
+        cmocka_unit_test_setup_teardown(test_fim_scan_worker_device_limit, setup_record, teardown_record),
+        cmocka_unit_test_setup_teardown(test_fim_scan_worker_device_added_while_waiting, setup_record, teardown_record),
+        cmocka_unit_test_setup_teardown(test_fim_scan_worker_sync_row_every_file, setup_record, teardown_record),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -30,13 +30,12 @@
 #define PERMS (AUDIT_PERM_WRITE | AUDIT_PERM_ATTR)
 
 extern unsigned int count_reload_retries;
-audit_key_type filterkey_audit_events(char *buffer);
+audit_key_type filterkey_audit_events(const audit_fields_t *fields);
 
 /* setup/teardown */
 static int setup_group(void **state) {
     (void) state;
     test_mode = 1;
-    init_regex();
 
     return 0;
 }
@@ -45,7 +44,6 @@ static int teardown_group(void **state) {
     (void) state;
     memset(&syscheck, 0, sizeof(syscheck_config));
     Free_Syscheck(&syscheck);
-    clean_regex();
     test_mode = 0;
     return 0;
 }
@@ -115,6 +113,21 @@ static int teardown_custom_key(void **state) {
     return 0;
 }
 
+static audit_key_type filter_event_key(const char *event) {
+    audit_fields_t fields;
+
+    audit_parse_fields(event, &fields);
+
+    return filterkey_audit_events(&fields);
+}
+
+static void assert_audit_field(const audit_field_t *field, const char *value, int quoted) {
+    assert_non_null(field->value);
+    assert_int_equal(field->length, strlen(value));
+    assert_memory_equal(field->value, value, field->length);
+    assert_int_equal(field->quoted, quoted);
+}
+
 
 void test_filterkey_audit_events_custom(void **state) {
     (void) state;
@@ -128,7 +141,7 @@ void test_filterkey_audit_events_custom(void **state) {
     snprintf(buff, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, key);
     expect_string(__wrap__mdebug2, formatted_msg, buff);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_CUSTOM_KEY);
 }
@@ -145,7 +158,7 @@ void test_filterkey_audit_events_discard(void **state) {
     syscheck.audit_key[0] = calloc(strlen(key) + 2, sizeof(char));
     snprintf(syscheck.audit_key[0], strlen(key) + 1, "%s", key);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     free(syscheck.audit_key[0]);
     free(syscheck.audit_key);
@@ -164,7 +177,7 @@ void test_filterkey_audit_events_hc(void **state) {
     snprintf(buff, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "wazuh_hc");
     expect_string(__wrap__mdebug2, formatted_msg, buff);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_HC_KEY);
 }
@@ -180,7 +193,7 @@ void test_filterkey_audit_events_fim(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "wazuh_fim");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_KEY);
 }
@@ -191,7 +204,7 @@ void test_filterkey_audit_events_missing_whitespace(void **state) {
     audit_key_type ret;
     char * event = "type=LOGIN msg=audit(1571145421.379:659): pid=16455 uid=0 old-auid=4294967295 auid=0 tty=(none) old-ses=4294967295 ses=57key=\"wazuh_fim\"";
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_UNKNOWN_KEY);
 }
@@ -202,7 +215,7 @@ void test_filterkey_audit_events_missing_equal_sign(void **state) {
     audit_key_type ret;
     char * event = "type=LOGIN msg=audit(1571145421.379:659): pid=16455 uid=0 old-auid=4294967295 auid=0 tty=(none) old-ses=4294967295 ses=57 key\"wazuh_fim\"";
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_UNKNOWN_KEY);
 }
@@ -213,7 +226,7 @@ void test_filterkey_audit_events_no_key(void **state) {
     audit_key_type ret;
     char * event = "type=LOGIN msg=audit(1571145421.379:659): pid=16455 uid=0 old-auid=4294967295 auid=0 tty=(none) old-ses=4294967295 ses=57";
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_UNKNOWN_KEY);
 }
@@ -228,7 +241,7 @@ void test_filterkey_audit_events_key_at_the_beggining(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "wazuh_fim");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_KEY);
 }
@@ -243,7 +256,7 @@ void test_filterkey_audit_events_key_end_line(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "wazuh_fim");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_KEY);
 }
@@ -261,7 +274,7 @@ void test_filterkey_audit_events_hex_coded_key_no_fim(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "key_1");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_CUSTOM_KEY);
 }
@@ -278,7 +291,7 @@ void test_filterkey_audit_events_hex_coded_key_no_fim_second_key(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "key_2");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_CUSTOM_KEY);
 }
@@ -294,7 +307,7 @@ void test_filterkey_audit_events_hex_coded_key_fim(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "wazuh_fim");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_KEY);
 }
@@ -311,7 +324,7 @@ void test_filterkey_audit_events_path_named_key(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "key_1");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_CUSTOM_KEY);
 }
@@ -327,7 +340,7 @@ void test_filterkey_audit_events_separator(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "wazuh_fim");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_KEY);
 }
@@ -344,12 +357,72 @@ void test_filterkey_audit_events_separator_in_key(void **state) {
     snprintf(audit_key_msg, OS_SIZE_128, FIM_AUDIT_MATCH_KEY, "wazuh_f`5");
     expect_string(__wrap__mdebug2, formatted_msg, audit_key_msg);
 
-    ret = filterkey_audit_events(event);
+    ret = filter_event_key(event);
 
     assert_int_equal(ret, FIM_AUDIT_CUSTOM_KEY);
 }
 
 
+void test_audit_parse_fields(void **state) {
+    (void) state;
+    audit_fields_t fields;
+    const char *event =
+        "type=SYSCALL msg=audit(1571914029.306:3004254): arch=c000003e syscall=263 success=yes exit=0 a0=ffffff9c a1=55c5f8170490 a2=0 a3=7ff365c5eca0 items=2 ppid=3211 pid=44082 auid=1000 uid=0 gid=10 euid=20 suid=0 fsuid=0 egid=0 sgid=0 fsgid=0 tty=pts3 ses=5 comm=\"rm\" exe=\"/usr/bin/rm\" key=\"wazuh_fim\"\035ARCH=x86_64 SYSCALL=unlinkat AUID=\"user\" UID=\"root\"\n"
+        "type=CWD msg=audit(1571914029.306:3004254): cwd=2F726F6F742F74657374C3B1\n"
+        "type=PATH msg=audit(1571914029.306:3004254): item=0 name=\"/root/test\" inode=110 dev=08:02 mode=040755 ouid=0 ogid=0 rdev=00:00 nametype=PARENT cap_fp=0 cap_fi=0 cap_fe=0 cap_fver=0\n"
+        "type=PATH msg=audit(1571914029.306:3004254): item=1 name=74657374C3B1 inode=19 dev=08:03 mode=0100644 ouid=0 ogid=0 rdev=00:00 nametype=DELETE cap_fp=0 cap_fi=0 cap_fe=0 cap_fver=0\n"
+        "type=PROCTITLE msg=audit(1571914029.306:3004254): proctitle=726D0074657374\n";
+
+    audit_parse_fields(event, &fields);
+
+    assert_audit_field(&fields.key, "wazuh_fim", 1);
+    assert_audit_field(&fields.success, "yes", 0);
+    assert_audit_field(&fields.syscall, "263", 0);
+    assert_audit_field(&fields.items, "2", 0);
+    assert_audit_field(&fields.uid, "0", 0);
+    assert_audit_field(&fields.gid, "10", 0);
+    assert_audit_field(&fields.auid, "1000", 0);
+    assert_audit_field(&fields.euid, "20", 0);
+    assert_audit_field(&fields.pid, "44082", 0);
+    assert_audit_field(&fields.ppid, "3211", 0);
+    assert_audit_field(&fields.exe, "/usr/bin/rm", 1);
+    assert_audit_field(&fields.cwd, "2F726F6F742F74657374C3B1", 0);
+    assert_audit_field(&fields.name[0], "/root/test", 1);
+    assert_audit_field(&fields.name[1], "74657374C3B1", 0);
+    assert_null(fields.name[2].value);
+    assert_audit_field(&fields.inode, "19", 0);
+    assert_audit_field(&fields.dev, "08:02", 0);
+    assert_null(fields.op.value);
+    assert_null(fields.dir.value);
+    assert_int_equal(fields.config_change, 0);
+}
+
+void test_audit_parse_fields_record_types(void **state) {
+    (void) state;
+    audit_fields_t fields;
+    const char *event =
+        "type=EXECVE msg=audit(1572878838.610:220): argc=2 a0=\"rm\" key=\"ignored\" uid=1\n"
+        "type=CONFIG_CHANGE msg=audit(1572878838.610:220): auid=0 ses=5 op=remove_rule dir=\"/root/test\" key=\"wazuh_fim\" list=4 res=1\n"
+        "type=SYSCALL msg=audit(1572878838.610:220): arch=c000003e syscall=263 success=yes exit=0 items=6 ppid=4340 pid=62845 auid=3 uid=4 gid=5 euid=6 exe=\"/usr/bin/rm\" key=(null)\n"
+        "type=CWD msg=audit(1572878838.610:220): cwd=\"/root\"\n"
+        "type=PATH msg=audit(1572878838.610:220): item=5 name=\"/root/ignored\" inode=7 dev=fd:00\n";
+
+    audit_parse_fields(event, &fields);
+
+    assert_audit_field(&fields.key, "wazuh_fim", 1);
+    assert_int_equal(fields.config_change, 1);
+    assert_audit_field(&fields.op, "remove_rule", 0);
+    assert_audit_field(&fields.dir, "/root/test", 1);
+    assert_audit_field(&fields.uid, "4", 0);
+    assert_audit_field(&fields.auid, "3", 0);
+    assert_audit_field(&fields.cwd, "/root", 1);
+    assert_null(fields.name[0].value);
+    assert_null(fields.name[4].value);
+    assert_audit_field(&fields.inode, "7", 0);
+    assert_audit_field(&fields.dev, "fd:00", 0);
+}
+
+
 void test_gen_audit_path(void **state) {
     (void) state;
 
@@ -1331,6 +1404,8 @@ int main(void) {
         cmocka_unit_test_setup_teardown(test_filterkey_audit_events_hex_coded_key_no_fim, setup_custom_key, teardown_custom_key),
         cmocka_unit_test_setup_teardown(test_filterkey_audit_events_hex_coded_key_no_fim_second_key, setup_custom_key, teardown_custom_key),
         cmocka_unit_test_setup_teardown(test_filterkey_audit_events_path_named_key, setup_custom_key, teardown_custom_key),
+        cmocka_unit_test(test_audit_parse_fields),
+        cmocka_unit_test(test_audit_parse_fields_record_types),
         cmocka_unit_test_teardown(test_gen_audit_path, free_string),
         cmocka_unit_test_teardown(test_gen_audit_path2, free_string),
         cmocka_unit_test_teardown(test_gen_audit_path3, free_string),
@@ -843,16 +843,6 @@ void test_audit_get_id_end_error(void **state) {
 }
 
 
-void test_init_regex(void **state) {
-    (void) state;
-    int ret;
-
-    ret = init_regex();
-
-    assert_int_equal(ret, 0);
-}
-
-
 void test_audit_read_events_select_error(void **state) {
     (void) state;
     int *audit_sock = *state;
@@ -1509,7 +1499,6 @@ int main(void) {
         cmocka_unit_test_teardown(test_audit_get_id, free_string),
         cmocka_unit_test(test_audit_get_id_begin_error),
         cmocka_unit_test(test_audit_get_id_end_error),
-        cmocka_unit_test(test_init_regex),
         cmocka_unit_test_setup_teardown(test_audit_read_events_select_error, test_audit_read_events_setup, test_audit_read_events_teardown),
         cmocka_unit_test_setup_teardown(test_audit_read_events_select_case_0, test_audit_read_events_setup, test_audit_read_events_teardown),
         cmocka_unit_test_setup_teardown(test_audit_read_events_select_success_recv_error_audit_connection_closed, test_audit_read_events_setup, test_audit_read_events_teardown),
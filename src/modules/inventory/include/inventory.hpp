@@ -3,11 +3,13 @@
 #include <chrono>
 #include <condition_variable>
 #include <ctime>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <stack>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <commonDefs.h>
 #include <dbsync.hpp>
@@ -66,6 +68,15 @@ private:
 
     void Destroy();
 
+    struct Scanner
+    {
+        std::string name;                                   // Scanner (and table) name
+        std::function<void()> scan;                         // Scan function
+        std::chrono::milliseconds interval;                 // Scan interval
+        std::chrono::steady_clock::time_point nextScanTime; // Time of the next scan
+        bool running;                                       // Scan in progress on a worker
+    };
+
     std::string GetCreateStatement() const;
     nlohmann::json EcsProcessesData(const nlohmann::json& originalData, bool createFields = true);
     nlohmann::json EcsSystemData(const nlohmann::json& originalData, bool createFields = true);
@@ -77,7 +88,10 @@ private:
     nlohmann::json GetNetworkData();
     nlohmann::json GetPortsData();
 
-    void UpdateChanges(const std::string& table, const nlohmann::json& values, const bool isFirstScan);
+    void UpdateChanges(const std::string& table,
+                       const nlohmann::json& values,
+                       const bool isFirstScan,
+                       const std::string& scanTime);
     void NotifyChange(ReturnTypeCallback result,
                       const nlohmann::json& data,
                       const std::string& table,
@@ -101,7 +115,8 @@ private:
     void ScanHotfixes();
     void ScanPorts();
     void ScanProcesses();
-    void Scan();
+    std::vector<Scanner> GetScanners();
+    void ScanWorker(std::vector<Scanner>& scanners);
     void SyncLoop();
     void ShowConfig();
     cJSON* Dump() const;
@@ -134,23 +149,25 @@ private:
     std::string m_agentUUID {""}; // Agent UUID
     std::shared_ptr<ISysInfo> m_spInfo;
     std::function<void(const std::string&)> m_reportDiffFunction;
-    bool m_enabled;              // Main switch
-    std::string m_dbFilePath;    // Database path
-    std::time_t m_intervalValue; // Scan interval
-    bool m_scanOnStart;          // Scan always on start
-    bool m_hardware;             // Hardware inventory
-    bool m_system;               // System inventory
-    bool m_networks;             // Networks inventory
-    bool m_packages;             // Installed packages inventory
-    bool m_ports;                // Opened ports inventory
-    bool m_portsAll;             // Scan only listening ports or all
-    bool m_processes;            // Running processes inventory
-    bool m_hotfixes;             // Windows hotfixes installed
+    bool m_enabled;                                     // Main switch
+    std::string m_dbFilePath;                           // Database path
+    std::time_t m_intervalValue;                        // Scan interval
+    std::map<std::string, std::time_t> m_scanIntervals; // Interval of each scan
+    bool m_scanOnStart;                                 // Scan always on start
+    bool m_hardware;                                    // Hardware inventory
+    bool m_system;                                      // System inventory
+    bool m_networks;                                    // Networks inventory
+    bool m_packages;                                    // Installed packages inventory
+    bool m_ports;                                       // Opened ports inventory
+    bool m_portsAll;                                    // Scan only listening ports or all
+    bool m_processes;                                   // Running processes inventory
+    bool m_hotfixes;                                    // Windows hotfixes installed
     std::atomic<bool> m_stopping;
     bool m_notify;
     std::unique_ptr<DBSync> m_spDBSync;
     std::condition_variable m_cv;
-    std::mutex m_mutex;
+    std::mutex m_mutex;         // Serializes the changes to the database
+    std::mutex m_scheduleMutex; // Protects the scanners schedule
     std::unique_ptr<InvNormalizer> m_spNormalizer;
     std::string m_scanTime;
     std::function<int(Message)> m_pushMessage;
@@ -66,6 +66,16 @@ void Inventory::Setup(std::shared_ptr<const configuration::ConfigurationParser>
     m_processes =
         configurationParser->GetConfigOrDefault(config::inventory::DEFAULT_PROCESSES, "inventory", "processes");
     m_hotfixes = configurationParser->GetConfigOrDefault(config::inventory::DEFAULT_HOTFIXES, "inventory", "hotfixes");
+
+    // Each scan may have its own interval, e.g. "packages_interval"
+    const auto defaultInterval = std::to_string(m_intervalValue) + "ms";
+    m_scanIntervals.clear();
+
+    for (const auto* scan : {"hardware", "system", "networks", "packages", "ports", "processes", "hotfixes"})
+    {
+        m_scanIntervals[scan] =
+            configurationParser->GetTimeConfigOrDefault(defaultInterval, "inventory", std::string(scan) + "_interval");
+    }
 }
 
 void Inventory::Stop()
@@ -171,6 +181,8 @@ cJSON* Inventory::Dump() const
     else
         cJSON_AddStringToObject(invJson, "scan-on-start", "no");
     cJSON_AddNumberToObject(invJson, "interval", static_cast<double>(m_intervalValue));
+    for (const auto& [scan, interval] : m_scanIntervals)
+        cJSON_AddNumberToObject(invJson, (scan + "_interval").c_str(), static_cast<double>(interval));
     if (m_networks)
         cJSON_AddStringToObject(invJson, "networks", "yes");
     else
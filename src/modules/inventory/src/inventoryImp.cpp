@@ -1,5 +1,6 @@
 #include "statelessEvent.hpp"
 
+#include <algorithm>
 #include <commonDefs.h>
 #include <config.h>
 #include <defs.h>
@@ -9,6 +10,7 @@
 #include <nlohmann/json.hpp>
 #include <stringHelper.h>
 #include <timeHelper.h>
+#include <tuple>
 
 constexpr auto EMPTY_VALUE {""};
 
@@ -17,6 +19,8 @@ constexpr size_t MAX_ID_SIZE = 512;
 
 constexpr auto QUEUE_SIZE {4096};
 
+constexpr size_t MAX_SCAN_WORKERS {4};
+
 static const std::map<ReturnTypeCallback, std::string> OPERATION_MAP {
     // LCOV_EXCL_START
     {MODIFIED, "update"},
@@ -66,6 +70,7 @@ constexpr auto PACKAGES_SQL_STATEMENT {
     description TEXT,
     size BIGINT,
     format TEXT,
+    db_row_hash_dm BIGINT,
     PRIMARY KEY (name,version,architecture,format,location)) WITHOUT ROWID;)"};
 
 constexpr auto PROCESSES_SQL_STATEMENT {
@@ -84,6 +89,7 @@ constexpr auto PROCESSES_SQL_STATEMENT {
     start_time BIGINT,
     tgid BIGINT,
     tty BIGINT,
+    db_row_hash_dm BIGINT,
     PRIMARY KEY (pid)) WITHOUT ROWID;)"};
 
 constexpr auto PORTS_SQL_STATEMENT {
@@ -134,6 +140,10 @@ constexpr auto METADATA_SQL_STATEMENT {
     value TEXT,
     PRIMARY KEY (key)) WITHOUT ROWID;)"};
 
+// Statements bringing a database created by a previous version up to date, one per version
+static const std::vector<std::string> UPGRADE_SQL_STATEMENTS {"ALTER TABLE packages ADD COLUMN db_row_hash_dm BIGINT;",
+                                                              "ALTER TABLE processes ADD COLUMN db_row_hash_dm BIGINT;"};
+
 constexpr auto NETWORKS_TABLE {"networks"};
 constexpr auto PACKAGES_TABLE {"packages"};
 constexpr auto HOTFIXES_TABLE {"hotfixes"};
@@ -357,7 +367,10 @@ void Inventory::NotifyEvent(ReturnTypeCallback result,
     m_reportDiffFunction(msgToSend);
 }
 
-void Inventory::UpdateChanges(const std::string& table, const nlohmann::json& values, const bool isFirstScan)
+void Inventory::UpdateChanges(const std::string& table,
+                              const nlohmann::json& values,
+                              const bool isFirstScan,
+                              const std::string& scanTime)
 {
     const auto callback {[this, table, isFirstScan](ReturnTypeCallback result, const nlohmann::json& data)
                          {
@@ -365,6 +378,14 @@ void Inventory::UpdateChanges(const std::string& table, const nlohmann::json& va
                          }};
 
     const std::unique_lock<std::mutex> lock {m_mutex};
+
+    // A partial scan would report the rows not collected yet as deleted
+    if (m_stopping)
+    {
+        return;
+    }
+
+    m_scanTime = scanTime;
     DBSyncTxn txn {m_spDBSync->handle(), nlohmann::json {table}, 0, QUEUE_SIZE, callback};
     nlohmann::json input;
     input["table"] = table;
@@ -449,7 +470,8 @@ void Inventory::Init(const std::shared_ptr<ISysInfo>& spInfo,
         const std::unique_lock<std::mutex> lock {m_mutex};
         m_stopping = false;
         m_spDBSync = std::make_unique<DBSync>(
-            HostType::AGENT, DbEngineType::SQLITE3, dbPath, GetCreateStatement(), DbManagement::PERSISTENT);
+            HostType::AGENT, DbEngineType::SQLITE3, dbPath, GetCreateStatement(), DbManagement::PERSISTENT,
+            UPGRADE_SQL_STATEMENTS);
         m_spNormalizer = std::make_unique<InvNormalizer>(normalizerConfigPath, normalizerType);
     }
 
@@ -509,6 +531,11 @@ void Inventory::Init(const std::shared_ptr<ISysInfo>& spInfo,
 void Inventory::Destroy()
 {
     m_stopping = true;
+
+    // Workers check the flag with the schedule locked, so they either see it or are already waiting
+    {
+        const std::lock_guard<std::mutex> lock {m_scheduleMutex};
+    }
     m_cv.notify_all();
 }
 
@@ -644,9 +671,10 @@ void Inventory::ScanHardware()
     if (m_hardware)
     {
         LogTrace("Starting hardware scan");
+        const auto scanTime = Utils::getCurrentISO8601();
         nlohmann::json hwData;
         hwData[0] = m_spInfo->hardware();
-        UpdateChanges(HARDWARE_TABLE, hwData, !m_hardwareFirstScan);
+        UpdateChanges(HARDWARE_TABLE, hwData, !m_hardwareFirstScan, scanTime);
         LogTrace("Ending hardware scan");
 
         if (!m_hardwareFirstScan && !m_stopping)
@@ -662,9 +690,10 @@ void Inventory::ScanSystem()
     if (m_system)
     {
         LogTrace("Starting os scan");
+        const auto scanTime = Utils::getCurrentISO8601();
         nlohmann::json SystemData;
         SystemData[0] = m_spInfo->os();
-        UpdateChanges(SYSTEM_TABLE, SystemData, !m_systemFirstScan);
+        UpdateChanges(SYSTEM_TABLE, SystemData, !m_systemFirstScan, scanTime);
         LogTrace("Ending os scan");
 
         if (!m_systemFirstScan && !m_stopping)
@@ -755,6 +784,7 @@ void Inventory::ScanNetwork()
     if (m_networks)
     {
         LogTrace("Starting network scan");
+        const auto scanTime = Utils::getCurrentISO8601();
         const auto networkData(GetNetworkData());
 
         if (!networkData.is_null())
@@ -763,7 +793,7 @@ void Inventory::ScanNetwork()
 
             if (itNet != networkData.end())
             {
-                UpdateChanges(NETWORKS_TABLE, itNet.value(), !m_networksFirstScan);
+                UpdateChanges(NETWORKS_TABLE, itNet.value(), !m_networksFirstScan, scanTime);
             }
         }
 
@@ -782,38 +812,27 @@ void Inventory::ScanPackages()
     if (m_packages)
     {
         LogTrace("Starting packages scan");
-        const auto callback {[this](ReturnTypeCallback result, const nlohmann::json& data)
-                             {
-                                 NotifyChange(result, data, PACKAGES_TABLE, !m_packagesFirstScan);
-                             }};
+        const auto scanTime = Utils::getCurrentISO8601();
+        auto packages = nlohmann::json::array();
 
-        const std::unique_lock<std::mutex> lock {m_mutex};
-        DBSyncTxn txn {m_spDBSync->handle(), nlohmann::json {PACKAGES_TABLE}, 0, QUEUE_SIZE, callback};
+        // Packages are collected without holding the database, so that other scans can apply their changes meanwhile
         m_spInfo->packages(
-            [this, &txn](nlohmann::json& rawData)
+            [this, &packages](nlohmann::json& rawData)
             {
                 if (m_stopping)
                 {
                     return;
                 }
 
-                nlohmann::json input;
-
-                input["table"] = PACKAGES_TABLE;
                 m_spNormalizer->Normalize("packages", rawData);
                 m_spNormalizer->RemoveExcluded("packages", rawData);
 
                 if (!rawData.empty())
                 {
-                    input["data"] = nlohmann::json::array({rawData});
-                    if (m_packagesFirstScan)
-                    {
-                        input["options"]["return_old_data"] = true;
-                    }
-                    txn.syncTxnRow(input);
+                    packages.push_back(std::move(rawData));
                 }
             });
-        txn.getDeletedRows(callback);
+        UpdateChanges(PACKAGES_TABLE, packages, !m_packagesFirstScan, scanTime);
 
         if (!m_packagesFirstScan && !m_stopping)
         {
@@ -830,11 +849,12 @@ void Inventory::ScanHotfixes()
     if (m_hotfixes)
     {
         LogTrace("Starting hotfixes scan");
+        const auto scanTime = Utils::getCurrentISO8601();
         auto hotfixes = m_spInfo->hotfixes();
 
         if (!hotfixes.is_null())
         {
-            UpdateChanges(HOTFIXES_TABLE, hotfixes, !m_hotfixesFirstScan);
+            UpdateChanges(HOTFIXES_TABLE, hotfixes, !m_hotfixesFirstScan, scanTime);
         }
 
         if (!m_hotfixesFirstScan && !m_stopping)
@@ -912,8 +932,9 @@ void Inventory::ScanPorts()
     if (m_ports)
     {
         LogTrace("Starting ports scan");
+        const auto scanTime = Utils::getCurrentISO8601();
         const auto& portsData {GetPortsData()};
-        UpdateChanges(PORTS_TABLE, portsData, !m_portsFirstScan);
+        UpdateChanges(PORTS_TABLE, portsData, !m_portsFirstScan, scanTime);
         LogTrace("Ending ports scan");
 
         if (!m_portsFirstScan && !m_stopping)
@@ -929,32 +950,20 @@ void Inventory::ScanProcesses()
     if (m_processes)
     {
         LogTrace("Starting processes scan");
-        const auto callback {[this](ReturnTypeCallback result, const nlohmann::json& data)
-                             {
-                                 NotifyChange(result, data, PROCESSES_TABLE, !m_processesFirstScan);
-                             }};
-        const std::unique_lock<std::mutex> lock {m_mutex};
-        DBSyncTxn txn {m_spDBSync->handle(), nlohmann::json {PROCESSES_TABLE}, 0, QUEUE_SIZE, callback};
+        const auto scanTime = Utils::getCurrentISO8601();
+        auto processes = nlohmann::json::array();
+
         m_spInfo->processes(std::function<void(nlohmann::json&)>(
-            [this, &txn](nlohmann::json& rawData)
+            [this, &processes](nlohmann::json& rawData)
             {
                 if (m_stopping)
                 {
                     return;
                 }
 
-                nlohmann::json input;
-                input["table"] = PROCESSES_TABLE;
-                input["data"] = nlohmann::json::array({rawData});
-
-                if (m_processesFirstScan)
-                {
-                    input["options"]["return_old_data"] = true;
-                }
-
-                txn.syncTxnRow(input);
+                processes.push_back(std::move(rawData));
             }));
-        txn.getDeletedRows(callback);
+        UpdateChanges(PROCESSES_TABLE, processes, !m_processesFirstScan, scanTime);
 
         if (!m_processesFirstScan && !m_stopping)
         {
@@ -966,46 +975,110 @@ void Inventory::ScanProcesses()
     }
 }
 
-void Inventory::Scan()
+std::vector<Inventory::Scanner> Inventory::GetScanners()
 {
-    LogInfo("Starting evaluation.");
-    m_scanTime = Utils::getCurrentISO8601();
-
-    TryCatchTask([&]() { ScanHardware(); });
-    TryCatchTask([&]() { ScanSystem(); });
-    TryCatchTask([&]() { ScanPackages(); });
-    TryCatchTask([&]() { ScanProcesses(); });
-    TryCatchTask([&]() { ScanHotfixes(); });
-    TryCatchTask([&]() { ScanPorts(); });
-    TryCatchTask([&]() { ScanNetwork(); });
-
-    m_notify = true;
-    LogInfo("Evaluation finished.");
+    const std::vector<std::tuple<std::string, bool, std::function<void()>>> scans {
+        {HARDWARE_TABLE, m_hardware, [this]() { ScanHardware(); }},
+        {SYSTEM_TABLE, m_system, [this]() { ScanSystem(); }},
+        {PACKAGES_TABLE, m_packages, [this]() { ScanPackages(); }},
+        {PROCESSES_TABLE, m_processes, [this]() { ScanProcesses(); }},
+        {HOTFIXES_TABLE, m_hotfixes, [this]() { ScanHotfixes(); }},
+        {PORTS_TABLE, m_ports, [this]() { ScanPorts(); }},
+        {NETWORKS_TABLE, m_networks, [this]() { ScanNetwork(); }}};
+
+    const auto now {std::chrono::steady_clock::now()};
+    std::vector<Scanner> scanners;
+
+    for (const auto& [name, enabled, scan] : scans)
+    {
+        if (enabled)
+        {
+            const auto itInterval {m_scanIntervals.find(name)};
+            const std::chrono::milliseconds interval {itInterval != m_scanIntervals.end() ? itInterval->second
+                                                                                         : m_intervalValue};
+
+            scanners.push_back({name, scan, interval, m_scanOnStart ? now : now + interval, false});
+        }
+    }
+
+    return scanners;
+}
+
+void Inventory::ScanWorker(std::vector<Scanner>& scanners)
+{
+    std::unique_lock<std::mutex> lock {m_scheduleMutex};
+
+    while (!m_stopping)
+    {
+        // The scanner due the soonest among those not being run by another worker
+        auto next {scanners.end()};
+
+        for (auto it = scanners.begin(); it != scanners.end(); ++it)
+        {
+            if (!it->running && (next == scanners.end() || it->nextScanTime < next->nextScanTime))
+            {
+                next = it;
+            }
+        }
+
+        if (next == scanners.end())
+        {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        if (next->nextScanTime > std::chrono::steady_clock::now())
+        {
+            m_cv.wait_until(lock, next->nextScanTime);
+            continue;
+        }
+
+        next->running = true;
+        lock.unlock();
+
+        TryCatchTask(next->scan);
+
+        lock.lock();
+        next->running = false;
+        next->nextScanTime = std::chrono::steady_clock::now() + next->interval;
+
+        // Another worker may be waiting for this scanner
+        m_cv.notify_all();
+    }
 }
 
 void Inventory::SyncLoop()
 {
     LogInfo("Module started.");
 
-    if (m_scanOnStart && !m_stopping)
+    // Every scanner runs on its own interval. Scanners collect their data in parallel, while changes to the
+    // database are serialized.
+    auto scanners {GetScanners()};
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < std::min(scanners.size(), MAX_SCAN_WORKERS); ++i)
     {
-        Scan();
+        workers.emplace_back([this, &scanners]() { ScanWorker(scanners); });
     }
 
-    while (!m_stopping)
+    for (auto& worker : workers)
     {
-        {
-            std::unique_lock<std::mutex> lock {m_mutex};
-            m_cv.wait_for(lock, std::chrono::milliseconds {m_intervalValue}, [&]() { return m_stopping.load(); });
-        }
-        Scan();
+        worker.join();
     }
+
+    // Stop may have been called before there was any worker to notify
+    {
+        std::unique_lock<std::mutex> lock {m_scheduleMutex};
+        m_cv.wait(lock, [&]() { return m_stopping.load(); });
+    }
+
     const std::unique_lock<std::mutex> lock {m_mutex};
     m_spDBSync.reset(nullptr);
 }
 
 void Inventory::WriteMetadata(const std::string& key, const std::string& value)
 {
+    const std::unique_lock<std::mutex> lock {m_mutex};
     auto insertQuery {InsertQuery::builder().table(MD_TABLE).data({{"key", key}, {"value", value}}).build()};
     m_spDBSync->insertData(insertQuery.query());
 }
@@ -1045,7 +1118,8 @@ void Inventory::CleanMetadata()
         {
             const std::unique_lock<std::mutex> lock {m_mutex};
             m_spDBSync = std::make_unique<DBSync>(
-                HostType::AGENT, DbEngineType::SQLITE3, m_dbFilePath, GetCreateStatement(), DbManagement::PERSISTENT);
+                HostType::AGENT, DbEngineType::SQLITE3, m_dbFilePath, GetCreateStatement(), DbManagement::PERSISTENT,
+                UPGRADE_SQL_STATEMENTS);
             for (const auto& key : TABLE_TO_KEY_MAP)
             {
                 if (!ReadMetadata(key.second).empty())
@@ -236,6 +236,56 @@ TEST_F(InventoryImpTest, noScanOnStart)
     }
 }
 
+TEST_F(InventoryImpTest, scanIntervals)
+{
+    const auto spInfoWrapper {std::make_shared<SysInfoWrapper>()};
+
+    EXPECT_CALL(*spInfoWrapper, hardware())
+        .Times(::testing::AtLeast(2))
+        .WillRepeatedly(Return(nlohmann::json::parse(
+            R"({"board_serial":"Intel Corporation","scan_time":"2020/12/28 21:49:50", "cpu_mhz":2904,"cpu_cores":2,"cpu_name":"Intel(R) Core(TM) i5-9400 CPU @ 2.90GHz", "ram_free":2257872,"ram_total":4972208,"ram_usage":54})")));
+    EXPECT_CALL(*spInfoWrapper, os()).Times(0);
+    EXPECT_CALL(*spInfoWrapper, packages(testing::_))
+        .Times(1)
+        .WillOnce(::testing::InvokeArgument<0>(
+            R"({"architecture":"amd64","scan_time":"2020/12/28 21:49:50", "group":"x11","name":"xserver-xorg","priority":"optional","size":4111222333,"source":"xorg","version":"1:7.7+19ubuntu14","format":"deb","location":" "})"_json));
+    EXPECT_CALL(*spInfoWrapper, networks()).Times(0);
+    EXPECT_CALL(*spInfoWrapper, processes(testing::_)).Times(0);
+    EXPECT_CALL(*spInfoWrapper, ports()).Times(0);
+    EXPECT_CALL(*spInfoWrapper, hotfixes()).Times(0);
+
+    const std::string inventoryConfig = R"(
+        inventory:
+            enabled: true
+            interval: 1
+            packages_interval: 1h
+            scan_on_start: true
+            hardware: true
+            system: false
+            networks: false
+            packages: true
+            ports: false
+            processes: false
+            hotfixes: false
+    )";
+    auto configParser = std::make_shared<configuration::ConfigurationParser>(inventoryConfig);
+    Inventory::Instance().Setup(configParser);
+
+    std::thread t {[&spInfoWrapper]()
+                   {
+                       Inventory::Instance().Init(spInfoWrapper, ReportFunction, INVENTORY_DB_PATH, "", "");
+                       Inventory::Instance().SetAgentUUID("1234");
+                   }};
+
+    std::this_thread::sleep_for(std::chrono::seconds {SLEEP_DURATION_SECONDS});
+    Inventory::Instance().Stop();
+
+    if (t.joinable())
+    {
+        t.join();
+    }
+}
+
 TEST_F(InventoryImpTest, noHardware)
 {
     const auto spInfoWrapper {std::make_shared<SysInfoWrapper>()};
@@ -8,8 +8,15 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/steady_timer.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <limits>
 #include <list>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
 
 namespace logcollector
 {
@@ -17,6 +24,12 @@ namespace logcollector
     /// @brief Interface for log readers
     class IReader;
 
+    /// @brief Reading positions of the local files
+    class FileCheckpoints;
+
+    /// @brief Watcher of the local files
+    class FileWatcher;
+
     /// @brief Logcollector module class
     ///
     /// This module is responsible for collecting logs from various sources and processing them.
@@ -51,6 +64,10 @@ namespace logcollector
         void SetPushMessageFunction(const std::function<int(Message)>& pushMessage);
 
         /// @brief Sends a message to que queue
+        ///
+        /// Messages are gathered per location (the file or the provider they were read from) and pushed to the queue
+        /// together, once there are enough of them or once the batch interval expires.
+        ///
         /// @param location Location of the message
         /// @param log Message to send
         /// @param collectorType type of logcollector
@@ -93,10 +110,67 @@ namespace logcollector
         /// @param configurationParser Configuration parser
         void SetupFileReader(const std::shared_ptr<const configuration::ConfigurationParser> configurationParser);
 
+        /// @brief Sets up the batching of the messages
+        /// @param configurationParser Configuration parser
+        void SetupBatching(const std::shared_ptr<const configuration::ConfigurationParser> configurationParser);
+
+        /// @brief Pushes the pending messages of every location to the queue
+        /// @return True if every pending message was pushed, false if some are kept for a later flush
+        bool FlushBatches();
+
+        /// @brief Sets up the saving of the file reading positions
+        /// @param configurationParser Configuration parser
+        void SetupCheckpoints(const std::shared_ptr<const configuration::ConfigurationParser> configurationParser);
+
+        /// @brief Saves the file reading positions, after pushing the messages read up to them. Nothing is saved while
+        /// some of those messages are still pending.
+        void SaveCheckpoints();
+
         /// @brief Clean all readers
         void CleanAllReaders();
 
+        /// @brief Reading positions of the local files, or nullptr if they are not saved
+        std::shared_ptr<FileCheckpoints> m_fileCheckpoints;
+
+        /// @brief Watcher shared by the file readers, or nullptr if the files are polled
+        std::shared_ptr<FileWatcher> m_fileWatcher;
+
     private:
+        /// @brief Messages of a location waiting to be pushed to the queue
+        struct MessageBatch
+        {
+            /// @brief Metadata shared by all the messages of the collector type
+            std::string metadata;
+
+            /// @brief Pending messages
+            nlohmann::json messages = nlohmann::json::array();
+
+            /// @brief Size of the logs of the pending messages
+            size_t bytes = 0;
+        };
+
+        /// @brief Pushes the pending messages of a location to the queue. Must be called with the batches mutex held.
+        ///
+        /// The messages the queue has no room for are kept for the next flush, up to the size of a batch.
+        ///
+        /// @param collectorType Collector type
+        /// @param batch Pending messages of the location
+        /// @return True if every pending message was pushed, false if some are kept for a later flush
+        bool FlushBatch(const std::string& collectorType, MessageBatch& batch);
+
+        /// @brief Pushes the pending messages every batch interval, until the readers are cleaned
+        /// @return Awaitable result
+        boost::asio::awaitable<void> RunBatchFlusher();
+
+        /// @brief Saves the file reading positions every checkpoint interval, until the readers are cleaned
+        /// @return Awaitable result
+        boost::asio::awaitable<void> RunCheckpointSaver();
+
+        /// @brief Gets the current time in ISO 8601 format, formatting the date and time only once per second. Must
+        /// be called with the batches mutex held.
+        /// @return Current time
+        std::string CurrentTimestamp();
+
         /// @brief Module name
         const std::string m_moduleName = "logcollector";
 
@@ -120,6 +194,33 @@ namespace logcollector
 
         /// @brief List of steady timers
         std::list<boost::asio::steady_timer*> m_timers;
+
+        /// @brief Maximum number of messages pushed at once. Every message is pushed on its own until configured.
+        size_t m_batchMaxEvents = 1;
+
+        /// @brief Size of the logs of a batch that makes it be pushed straight away
+        size_t m_batchMaxBytes = std::numeric_limits<size_t>::max();
+
+        /// @brief Maximum time messages wait to be pushed
+        std::chrono::milliseconds m_batchInterval {0};
+
+        /// @brief Pending messages by collector type and location
+        std::map<std::pair<std::string, std::string>, MessageBatch> m_batches;
+
+        /// @brief Mutex protecting the batches and the cached timestamp
+        std::mutex m_batchesMutex;
+
+        /// @brief Second of the cached timestamp
+        std::time_t m_timestampSecond = -1;
+
+        /// @brief Date and time of the cached timestamp, without the milliseconds
+        std::string m_timestampPrefix;
+
+        /// @brief Indicates that the readers are being cleaned, so the batch flusher must exit
+        std::atomic<bool> m_cleaning = false;
+
+        /// @brief Interval between savings of the file reading positions
+        std::chrono::milliseconds m_checkpointInterval {0};
     };
 
 } // namespace logcollector
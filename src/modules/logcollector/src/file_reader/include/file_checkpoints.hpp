@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace logcollector
+{
+
+    /// @brief File identifier
+    ///
+    /// Identifies a file on disk regardless of its name, so that a file replaced by another one with the same name
+    /// can be told apart.
+    struct FileId
+    {
+        /// @brief Device (or volume) the file is stored on
+        uint64_t device = 0;
+
+        /// @brief File index (inode) within the device
+        uint64_t index = 0;
+
+        /// @brief Equality operator
+        bool operator==(const FileId&) const = default;
+    };
+
+    /// @brief Reading position of a file
+    struct FileCheckpoint
+    {
+        /// @brief Identifier of the file
+        FileId fileId;
+
+        /// @brief Offset of the first byte not read yet
+        uint64_t offset = 0;
+
+        /// @brief Number of bytes at the start of the file covered by the head hash
+        uint64_t headSize = 0;
+
+        /// @brief Hash of the first bytes of the file, tells apart a new file that reuses the identifier
+        uint64_t headHash = 0;
+
+        /// @brief Equality operator
+        bool operator==(const FileCheckpoint&) const = default;
+    };
+
+    /// @brief File checkpoints class
+    ///
+    /// Keeps the reading position of every local file, so that the readers resume where they left off after the
+    /// agent restarts. Checkpoints are updated in memory and written to disk by Save, replacing the previous file
+    /// at once so that a crash never leaves it half written.
+    class FileCheckpoints
+    {
+    public:
+        /// @brief Constructor. Loads the checkpoints saved in the file, if any.
+        /// @param path Path of the checkpoints file
+        explicit FileCheckpoints(std::string path);
+
+        /// @brief Gets the checkpoint of a file
+        /// @param filename File name
+        /// @return Checkpoint, or nullopt if the file has none
+        std::optional<FileCheckpoint> Get(const std::string& filename) const;
+
+        /// @brief Sets the checkpoint of a file
+        /// @param filename File name
+        /// @param checkpoint Checkpoint
+        void Set(const std::string& filename, const FileCheckpoint& checkpoint);
+
+        /// @brief Removes the checkpoint of a file
+        /// @param filename File name
+        void Remove(const std::string& filename);
+
+        /// @brief Writes the checkpoints to disk, if they changed since the last save
+        /// @return True if the checkpoints on disk are up to date
+        bool Save();
+
+    private:
+        /// @brief Reads the checkpoints from disk
+        void Load();
+
+        /// @brief Path of the checkpoints file
+        std::string m_path;
+
+        /// @brief Checkpoints by file name
+        std::map<std::string, FileCheckpoint> m_checkpoints;
+
+        /// @brief Indicates that the checkpoints changed since the last save
+        bool m_dirty = false;
+
+        /// @brief Mutex protecting the checkpoints
+        mutable std::mutex m_mutex;
+    };
+
+    /// @brief Replaces the contents of a file at once, making sure the new ones are on disk before returning
+    /// @param path Path of the file
+    /// @param contents New contents of the file
+    /// @return True if the file was replaced
+    bool ReplaceFileContents(const std::string& path, const std::string& contents);
+
+} // namespace logcollector
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <ctime>
 #include <exception>
 #include <fstream>
 #include <list>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include <file_checkpoints.hpp>
+#include <file_watcher.hpp>
 #include <logcollector.hpp>
 #include <reader.hpp>
 
@@ -32,14 +40,53 @@ namespace logcollector
         /// @return A log, or an empty string if the end of the file has been reached
         std::string NextLog();
 
+        /// @brief Gets the next line from the file
+        ///
+        /// Lines are read from a buffer that is filled with large reads. Lines longer
+        /// than the maximum log size are split. A partial line at the end of the file
+        /// is kept until it is completed.
+        ///
+        /// @return A view of the line, without the newline, that is valid until the
+        /// next call; or nullopt if there are no complete lines left
+        std::optional<std::string_view> NextLine();
+
+        /// @brief Takes the partial line kept at the end of the file
+        ///
+        /// Used once the file has been rotated away, as the line will never be completed.
+        ///
+        /// @return The partial line, or an empty string if there is none
+        std::string TakePartialLine();
+
         /// @brief Seeks to the end of the file
         void SeekEnd();
 
+        /// @brief Resumes reading at a checkpoint
+        ///
+        /// The checkpoint is only used if it belongs to the file: same identifier and first bytes, and an offset
+        /// within the file. Otherwise the file was replaced or truncated since then, and it is read from the
+        /// beginning.
+        ///
+        /// @param checkpoint Checkpoint saved for the file name
+        /// @return True if reading resumes at the checkpoint, false if it starts at the beginning
+        bool Resume(const FileCheckpoint& checkpoint);
+
+        /// @brief Gets the current reading position
+        /// @return Checkpoint to resume reading at
+        FileCheckpoint Checkpoint();
+
+        /// @brief Gets the offset of the first byte not returned as a line yet
+        /// @return Offset
+        inline uint64_t Offset() const
+        {
+            return m_streamOffset - (m_end - m_begin);
+        }
+
         /// @brief Checks if the file has been rotated
         ///
-        /// This method checks if the file has been rotated by comparing the current
-        /// size of the file with the reading position. If the file size is lower
-        /// than the reading position, the file has been rotated.
+        /// This method checks if the file has been rotated by comparing the file
+        /// found at its path with the open one. If it is a different file (device
+        /// or inode), or its size is lower than the reading position, the file has
+        /// been rotated.
         ///
         /// @return True if the file has been rotated, false otherwise
         bool Rotated();
@@ -55,14 +102,49 @@ namespace logcollector
         }
 
     private:
+        /// @brief Reads more data into the buffer
+        /// @return True if any data was read
+        bool FillBuffer();
+
+        /// @brief Discards the buffered data
+        void ClearBuffer();
+
+        /// @brief Moves the stream to an offset, discarding the buffered data
+        /// @param offset Offset
+        /// @return True on success
+        bool SeekTo(uint64_t offset);
+
+        /// @brief Hashes the first bytes of the file, leaving the reading position untouched
+        /// @param size Number of bytes to hash
+        /// @return Number of bytes hashed (fewer if the file is shorter) and their hash
+        std::pair<uint64_t, uint64_t> HashHead(uint64_t size);
+
         /// @brief File name
         std::string m_filename;
 
         /// @brief Shared pointer to the input stream
         std::shared_ptr<std::istream> m_stream;
 
-        /// @brief Current position in the file
-        std::streampos m_pos;
+        /// @brief Data read from the stream, not yet returned as lines
+        std::vector<char> m_buffer;
+
+        /// @brief Start of the unread data in the buffer
+        size_t m_begin = 0;
+
+        /// @brief End of the unread data in the buffer
+        size_t m_end = 0;
+
+        /// @brief Offset of the stream, i.e. the end of the buffered data
+        uint64_t m_streamOffset = 0;
+
+        /// @brief Identifier of the open file
+        FileId m_fileId;
+
+        /// @brief Number of bytes covered by the head hash
+        uint64_t m_headSize = 0;
+
+        /// @brief Hash of the first bytes of the file
+        uint64_t m_headHash = 0;
     };
 
     /// @brief File reader class
@@ -79,7 +161,14 @@ namespace logcollector
         /// @param pattern File pattern
         /// @param fileWait File wait time in milliseconds
         /// @param reloadInterval Reload interval in milliseconds
-        FileReader(Logcollector& logcollector, std::string pattern, std::time_t fileWait, std::time_t reloadInterval);
+        /// @param watcher File watcher shared by the readers, or nullptr to poll the files
+        /// @param checkpoints Reading positions to resume at, or nullptr to start at the end of the files
+        FileReader(Logcollector& logcollector,
+                   std::string pattern,
+                   std::time_t fileWait,
+                   std::time_t reloadInterval,
+                   std::shared_ptr<FileWatcher> watcher = nullptr,
+                   std::shared_ptr<FileCheckpoints> checkpoints = nullptr);
 
         /// @brief Runs the file reader
         /// @return Awaitable result
@@ -116,6 +205,30 @@ namespace logcollector
         /// @post The file is destroyed and may not be used anymore
         void RemoveLocalfile(const std::string& filename);
 
+        /// @brief Sets the reading position of a newly found file
+        ///
+        /// Resumes at the saved checkpoint, if any. Files never read before are read from the end.
+        ///
+        /// @param lf Localfile
+        void StartLocalfile(Localfile& lf);
+
+        /// @brief Sends the complete lines available in a file
+        /// @param lf Localfile
+        void SendLines(Localfile& lf);
+
+        /// @brief Saves the reading position of a file
+        /// @param lf Localfile
+        void SaveCheckpoint(Localfile& lf);
+
+        /// @brief Waits until a file or directory changes, or the interval expires
+        ///
+        /// Uses the file watcher if the path is being watched, and polls otherwise.
+        ///
+        /// @param path File or directory path
+        /// @param pollInterval Time to wait if the path is not being watched, in milliseconds
+        /// @return Awaitable result
+        Awaitable WaitForChange(const std::string& path, std::time_t pollInterval);
+
         /// @brief File pattern
         std::string m_filePattern;
 
@@ -130,6 +243,12 @@ namespace logcollector
 
         /// @brief File pattern
         const std::string m_collectorType = FILE_READER_TYPE;
+
+        /// @brief File watcher shared by the readers, or nullptr if the files are polled
+        std::shared_ptr<FileWatcher> m_watcher;
+
+        /// @brief Reading positions of the files, or nullptr if they are not kept
+        std::shared_ptr<FileCheckpoints> m_checkpoints;
     };
 
     /// @brief Open error class
@@ -151,4 +270,10 @@ namespace logcollector
         std::string m_what;
     };
 
+    /// @brief Gets the identifier of a file
+    /// @param filename File name
+    /// @return File identifier
+    /// @throws OpenError if the file cannot be accessed
+    FileId GetFileId(const std::string& filename);
+
 } // namespace logcollector
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace logcollector
+{
+
+    /// @brief File watcher class
+    ///
+    /// Wakes up the readers as soon as their files change, instead of having them poll the files. Files are watched
+    /// for modifications, renames and deletion, and directories for new files. It uses inotify on Linux; on other
+    /// platforms the watcher is not enabled and the readers keep polling.
+    ///
+    /// A single watcher is shared by every reader, so that the module uses one inotify instance however many files
+    /// it reads. Each watch is held by its owners (usually the readers), which are woken up and release it on their
+    /// own, so that several readers may watch the same directory or file.
+    class FileWatcher : public std::enable_shared_from_this<FileWatcher>
+    {
+    public:
+        /// @brief Constructor
+        FileWatcher();
+
+        /// @brief Destructor
+        ~FileWatcher();
+
+        /// @brief Deleted copy constructor
+        FileWatcher(const FileWatcher&) = delete;
+
+        /// @brief Deleted copy assignment operator
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        /// @brief Checks if file system notifications are available
+        /// @return True if files can be watched
+        bool Enabled() const;
+
+        /// @brief Starts watching a file for modifications, renames and deletion
+        ///
+        /// If the file was already being watched, the watch is moved to the file now found at that path.
+        ///
+        /// @param path File path
+        /// @param owner Owner of the watch
+        /// @return True if the file is being watched
+        bool WatchFile(const std::string& path, const void* owner);
+
+        /// @brief Starts watching a directory for new files
+        /// @param path Directory path
+        /// @param owner Owner of the watch
+        /// @return True if the directory is being watched
+        bool WatchDirectory(const std::string& path, const void* owner);
+
+        /// @brief Stops watching a file or directory, once no other owner is watching it
+        /// @param path File or directory path
+        /// @param owner Owner of the watch
+        void Unwatch(const std::string& path, const void* owner);
+
+        /// @brief Checks if a file or directory is being watched by an owner
+        /// @param path File or directory path
+        /// @param owner Owner of the watch
+        /// @return True if it is being watched
+        bool Watching(const std::string& path, const void* owner) const;
+
+        /// @brief Waits until a watched file or directory changes
+        ///
+        /// Returns straight away if it changed since the last wait of the owner.
+        ///
+        /// @param path File or directory path
+        /// @param owner Owner of the watch
+        /// @param timeout Maximum time to wait
+        /// @return True if it changed, false if the timeout expired or the watcher was stopped
+        boost::asio::awaitable<bool>
+        WaitForChange(const std::string& path, const void* owner, std::chrono::milliseconds timeout);
+
+        /// @brief Reads the notifications and wakes up the waiters, until the watcher is stopped
+        /// @return Awaitable result
+        boost::asio::awaitable<void> Run();
+
+        /// @brief Stops the watcher and wakes up all the waiters
+        /// @note May be called from any thread
+        void Stop();
+
+    private:
+        /// @brief State of an owner of a watch
+        struct Waiter
+        {
+            /// @brief Set when a notification arrives, cleared by the waiter
+            bool changed = false;
+
+            /// @brief Timer the waiter sleeps on, canceled to wake it up
+            std::shared_ptr<boost::asio::steady_timer> signal;
+        };
+
+        /// @brief Watched file or directory
+        struct Watch
+        {
+            /// @brief Watch descriptor
+            int wd = -1;
+
+            /// @brief Owners of the watch
+            std::map<const void*, Waiter> waiters;
+        };
+
+        /// @brief Adds a watch for a path
+        /// @param path File or directory path
+        /// @param owner Owner of the watch
+        /// @param mask Events to watch
+        /// @return True if the path is being watched
+        bool AddWatch(const std::string& path, const void* owner, uint32_t mask);
+
+        /// @brief Checks if another path holds the same watch descriptor, as hard links or a path renamed do
+        /// @param path Path to leave out
+        /// @param wd Watch descriptor
+        /// @return True if another path holds it
+        bool SharedDescriptor(const std::string& path, int wd) const;
+
+        /// @brief Gets the state of an owner of a watch
+        /// @param path File or directory path
+        /// @param owner Owner of the watch
+        /// @return State of the owner, or nullptr if it's not watching the path
+        Waiter* FindWaiter(const std::string& path, const void* owner);
+
+        /// @brief Wakes up the waiters of the watches the notifications read refer to
+        /// @param buffer Buffer holding the notifications
+        /// @param length Number of bytes read into the buffer
+        void ProcessEvents(const std::vector<char>& buffer, size_t length);
+
+        /// @brief Marks the watch with the given descriptor as changed and wakes up its waiters
+        /// @param wd Watch descriptor
+        void Notify(int wd);
+
+        /// @brief Cancels the pending read and wakes up all the waiters. Must be called from the executor.
+        void CancelAll();
+
+        /// @brief Notification file descriptor
+        int m_fd = -1;
+
+        /// @brief Watches by path
+        std::map<std::string, Watch> m_watches;
+
+        /// @brief Indicates if the watcher has been stopped
+        std::atomic<bool> m_stopped = false;
+
+        /// @brief Mutex protecting the executor and the read cancellation handler
+        std::mutex m_mutex;
+
+        /// @brief Executor the watcher runs on, set by Run
+        std::optional<boost::asio::any_io_executor> m_executor;
+
+        /// @brief Cancels the pending read, set while Run is reading
+        std::function<void()> m_cancelRead;
+    };
+
+} // namespace logcollector
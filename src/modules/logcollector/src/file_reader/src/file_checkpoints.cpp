@@ -0,0 +1,108 @@
+#include "file_checkpoints.hpp"
+
+#include <logger.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace logcollector;
+
+FileCheckpoints::FileCheckpoints(std::string path)
+    : m_path(std::move(path))
+{
+    Load();
+}
+
+std::optional<FileCheckpoint> FileCheckpoints::Get(const std::string& filename) const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (const auto it = m_checkpoints.find(filename); it != m_checkpoints.end())
+    {
+        return it->second;
+    }
+
+    return std::nullopt;
+}
+
+void FileCheckpoints::Set(const std::string& filename, const FileCheckpoint& checkpoint)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto [it, inserted] = m_checkpoints.try_emplace(filename, checkpoint);
+
+    if (inserted || it->second != checkpoint)
+    {
+        it->second = checkpoint;
+        m_dirty = true;
+    }
+}
+
+void FileCheckpoints::Remove(const std::string& filename)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_checkpoints.erase(filename) > 0)
+    {
+        m_dirty = true;
+    }
+}
+
+bool FileCheckpoints::Save()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_dirty)
+    {
+        return true;
+    }
+
+    std::ostringstream contents;
+
+    for (const auto& [filename, checkpoint] : m_checkpoints)
+    {
+        contents << checkpoint.fileId.device << ' ' << checkpoint.fileId.index << ' ' << checkpoint.offset << ' '
+                 << checkpoint.headSize << ' ' << checkpoint.headHash << ' ' << filename << '\n';
+    }
+
+    if (!ReplaceFileContents(m_path, contents.str()))
+    {
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+void FileCheckpoints::Load()
+{
+    std::ifstream file(m_path);
+
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        FileCheckpoint checkpoint;
+        std::string filename;
+
+        fields >> checkpoint.fileId.device >> checkpoint.fileId.index >> checkpoint.offset >> checkpoint.headSize >>
+            checkpoint.headHash;
+
+        // The file name goes last, after a single space, as it may contain spaces itself
+        if (fields.fail() || fields.get() != ' ' || !std::getline(fields, filename) || filename.empty())
+        {
+            LogWarn("Ignoring malformed line in the logcollector checkpoints file: {}", line);
+            continue;
+        }
+
+        m_checkpoints[filename] = checkpoint;
+    }
+
+    LogDebug("Loaded {} logcollector checkpoints from {}", m_checkpoints.size(), m_path);
+}
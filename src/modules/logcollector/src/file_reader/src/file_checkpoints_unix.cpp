@@ -0,0 +1,80 @@
+#include "file_checkpoints.hpp"
+
+#include <logger.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+bool logcollector::ReplaceFileContents(const std::string& path, const std::string& contents)
+{
+    // The previous file is only replaced once the new one is complete and on disk
+    const auto tmpPath = path + ".tmp";
+
+    const int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+
+    if (fd < 0)
+    {
+        LogWarn("Cannot open the file {}: {}", tmpPath, std::strerror(errno));
+        return false;
+    }
+
+    size_t written = 0;
+
+    while (written < contents.size())
+    {
+        const auto result = write(fd, contents.data() + written, contents.size() - written);
+
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (result < 0)
+        {
+            LogWarn("Cannot write the file {}: {}", tmpPath, std::strerror(errno));
+            close(fd);
+            return false;
+        }
+
+        written += static_cast<size_t>(result);
+    }
+
+    if (fsync(fd) != 0)
+    {
+        LogWarn("Cannot sync the file {}: {}", tmpPath, std::strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+
+    if (rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        LogWarn("Cannot replace the file {}: {}", path, std::strerror(errno));
+        return false;
+    }
+
+    // The new name only survives a crash once the directory entry is on disk
+    const auto parent = std::filesystem::path(path).parent_path();
+    const int dirFd = open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (dirFd < 0)
+    {
+        LogWarn("Cannot open the directory of {}: {}", path, std::strerror(errno));
+        return false;
+    }
+
+    const bool synced = fsync(dirFd) == 0;
+
+    if (!synced)
+    {
+        LogWarn("Cannot sync the directory of {}: {}", path, std::strerror(errno));
+    }
+
+    close(dirFd);
+    return synced;
+}
@@ -0,0 +1,46 @@
+#include "file_checkpoints.hpp"
+
+#include <logger.hpp>
+
+#include <windows.h>
+
+bool logcollector::ReplaceFileContents(const std::string& path, const std::string& contents)
+{
+    // The previous file is only replaced once the new one is complete and on disk
+    const auto tmpPath = path + ".tmp";
+
+    HANDLE hFile = CreateFile(tmpPath.c_str(),
+                              GENERIC_WRITE,
+                              0,
+                              nullptr,
+                              CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_WRITE_THROUGH,
+                              nullptr);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        LogWarn("Cannot open the file {}: error {}", tmpPath, GetLastError());
+        return false;
+    }
+
+    DWORD written = 0;
+    const auto success = WriteFile(hFile, contents.data(), static_cast<DWORD>(contents.size()), &written, nullptr) &&
+                         written == contents.size() && FlushFileBuffers(hFile);
+
+    if (!success)
+    {
+        LogWarn("Cannot write the file {}: error {}", tmpPath, GetLastError());
+        CloseHandle(hFile);
+        return false;
+    }
+
+    CloseHandle(hFile);
+
+    if (!MoveFileEx(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        LogWarn("Cannot replace the file {}: error {}", path, GetLastError());
+        return false;
+    }
+
+    return true;
+}
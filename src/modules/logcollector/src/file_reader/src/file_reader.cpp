@@ -5,74 +5,186 @@
 #include <logger.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
 #include <string>
+#include <tuple>
 
 using namespace logcollector;
 
+namespace
+{
+    /// @brief Longest log, longer lines are split
+    constexpr size_t MAX_LINE_SIZE = config::logcollector::BUFFER_SIZE - 1;
+
+    /// @brief Size of the reads from the file
+    constexpr size_t READ_BLOCK_SIZE = 64 * 1024;
+
+    static_assert(READ_BLOCK_SIZE > MAX_LINE_SIZE, "A partial line must always leave room to read");
+
+    /// @brief Number of bytes at the start of a file that tell it apart from a new file with the same identifier
+    constexpr uint64_t HEAD_HASH_SIZE = 1024;
+
+    /// @brief Hashes data with 64-bit FNV-1a, which gives the same result on every build and platform
+    /// @param data Data to hash
+    /// @param size Size of the data
+    /// @return Hash
+    uint64_t HashData(const char* data, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+} // namespace
+
 FileReader::FileReader(Logcollector& logcollector,
                        std::string pattern,
                        std::time_t fileWait,
-                       std::time_t reloadInterval)
+                       std::time_t reloadInterval,
+                       std::shared_ptr<FileWatcher> watcher,
+                       std::shared_ptr<FileCheckpoints> checkpoints)
     : IReader(logcollector)
     , m_filePattern(std::move(pattern))
     , m_localfiles()
     , m_fileWait(fileWait)
     , m_reloadInterval(reloadInterval)
+    , m_watcher(std::move(watcher))
+    , m_checkpoints(std::move(checkpoints))
 {
 }
 
 Awaitable FileReader::Run()
 {
+    // New files are noticed right away if the directory holding them is known, otherwise at the next reload
+    const auto directory = std::filesystem::path(m_filePattern).parent_path().string();
+
+    if (m_watcher && !directory.empty() && directory.find_first_of("*?[") == std::string::npos)
+    {
+        m_watcher->WatchDirectory(directory, this);
+    }
+
     while (m_keepRunning.load())
     {
         Reload(
             [&](Localfile& lf)
             {
-                lf.SeekEnd();
+                StartLocalfile(lf);
                 m_logcollector.EnqueueTask(ReadLocalfile(&lf));
             });
 
-        co_await m_logcollector.Wait(std::chrono::milliseconds(m_reloadInterval));
+        co_await WaitForChange(directory, m_reloadInterval);
+    }
+
+    if (m_watcher)
+    {
+        m_watcher->Unwatch(directory, this);
     }
 }
 
 void FileReader::Stop()
 {
+    // The watcher is shared, its owner stops it and wakes up every reader
     m_keepRunning.store(false);
 }
 
 Awaitable FileReader::ReadLocalfile(Localfile* lf)
 {
+    if (m_watcher)
+    {
+        m_watcher->WatchFile(lf->Filename(), this);
+    }
+
+    auto missing = false;
+
     while (m_keepRunning.load())
     {
-        auto log = lf->NextLog();
+        SendLines(*lf);
+        SaveCheckpoint(*lf);
 
-        while (!log.empty())
-        {
-            m_logcollector.SendMessage(lf->Filename(), log, m_collectorType);
-            log = lf->NextLog();
-        }
+        auto rotated = false;
 
         try
         {
-            if (lf->Rotated())
+            rotated = lf->Rotated();
+
+            if (rotated)
             {
+                // Lines written to the old file right before it was rotated away are read before releasing it
+                SendLines(*lf);
+
+                if (const auto partialLine = lf->TakePartialLine(); !partialLine.empty())
+                {
+                    m_logcollector.SendMessage(lf->Filename(), partialLine, m_collectorType);
+                }
+
                 LogInfo("File '{}' rotated, reloading", lf->Filename());
                 lf->Reopen();
+                SaveCheckpoint(*lf);
+
+                if (m_watcher)
+                {
+                    m_watcher->WatchFile(lf->Filename(), this);
+                }
             }
+
+            missing = false;
         }
         catch (OpenError&)
         {
-            LogInfo("File inaccesible: {}", lf->Filename());
-            co_return;
+            if (missing)
+            {
+                LogInfo("File inaccesible: {}", lf->Filename());
+
+                if (m_checkpoints)
+                {
+                    m_checkpoints->Remove(lf->Filename());
+                }
+                break;
+            }
+
+            // The file may be in the middle of a rotation (renamed, but not created again yet)
+            missing = true;
+        }
+
+        // After a rotation the new file is read straight away, it may have been written before being watched
+        if (missing)
+        {
+            co_await m_logcollector.Wait(std::chrono::milliseconds(m_fileWait));
+        }
+        else if (!rotated)
+        {
+            co_await WaitForChange(lf->Filename(), m_fileWait);
         }
+    }
 
-        co_await m_logcollector.Wait(std::chrono::milliseconds(m_fileWait));
+    if (m_watcher)
+    {
+        m_watcher->Unwatch(lf->Filename(), this);
     }
 
     RemoveLocalfile(lf->Filename());
 }
 
+Awaitable FileReader::WaitForChange(const std::string& path, std::time_t pollInterval)
+{
+    if (m_watcher && m_watcher->Watching(path, this))
+    {
+        // Notifications may be missed (e.g. on network file systems), so the path is still checked every reload
+        co_await m_watcher->WaitForChange(path, this, std::chrono::milliseconds(m_reloadInterval));
+    }
+    else
+    {
+        co_await m_logcollector.Wait(std::chrono::milliseconds(pollInterval));
+    }
+}
+
 void FileReader::AddLocalfiles(const std::list<std::string>& paths, const std::function<void(Localfile&)>& callback)
 {
     for (auto& path : paths)
@@ -91,15 +203,55 @@ void FileReader::RemoveLocalfile(const std::string& filename)
     m_localfiles.remove_if([&filename](Localfile& lf) { return lf.Filename() == filename; });
 }
 
+void FileReader::StartLocalfile(Localfile& lf)
+{
+    const auto checkpoint = m_checkpoints ? m_checkpoints->Get(lf.Filename()) : std::nullopt;
+
+    if (!checkpoint.has_value())
+    {
+        lf.SeekEnd();
+    }
+    else if (lf.Resume(*checkpoint))
+    {
+        LogDebug("Resuming file '{}' at offset {}", lf.Filename(), checkpoint->offset);
+    }
+    else
+    {
+        LogInfo("File '{}' changed since it was last read, reading it from the beginning", lf.Filename());
+    }
+
+    SaveCheckpoint(lf);
+}
+
+void FileReader::SendLines(Localfile& lf)
+{
+    for (auto line = lf.NextLine(); line.has_value(); line = lf.NextLine())
+    {
+        if (!line->empty())
+        {
+            m_logcollector.SendMessage(lf.Filename(), std::string(*line), m_collectorType);
+        }
+    }
+}
+
+void FileReader::SaveCheckpoint(Localfile& lf)
+{
+    if (m_checkpoints)
+    {
+        m_checkpoints->Set(lf.Filename(), lf.Checkpoint());
+    }
+}
+
 Localfile::Localfile(std::string filename)
     : m_filename(std::move(filename))
     , m_stream(make_shared<std::ifstream>(m_filename))
-    , m_pos()
 {
     if (m_stream->fail())
     {
         throw OpenError(m_filename);
     }
+
+    m_fileId = GetFileId(m_filename);
 }
 
 Localfile::Localfile(std::shared_ptr<std::istream> stream)
@@ -110,28 +262,173 @@ Localfile::Localfile(std::shared_ptr<std::istream> stream)
 
 std::string Localfile::NextLog()
 {
-    auto buffer = std::vector<char>(config::logcollector::BUFFER_SIZE);
+    const auto line = NextLine();
+    return line ? std::string(*line) : std::string();
+}
 
-    if (m_stream->getline(buffer.data(), config::logcollector::BUFFER_SIZE).good())
+std::optional<std::string_view> Localfile::NextLine()
+{
+    while (true)
     {
-        m_pos = m_stream->tellg();
-        return {buffer.data(), static_cast<size_t>(m_stream->gcount()) - 1};
+        const auto* begin = m_buffer.data() + m_begin;
+        const auto available = m_end - m_begin;
+        const auto* newline =
+            static_cast<const char*>(std::memchr(begin, '\n', std::min(available, MAX_LINE_SIZE + 1)));
+
+        if (newline != nullptr)
+        {
+            const auto length = static_cast<size_t>(newline - begin);
+            m_begin += length + 1;
+            return std::string_view(begin, length);
+        }
+
+        if (available > MAX_LINE_SIZE)
+        {
+            m_begin += MAX_LINE_SIZE;
+            return std::string_view(begin, MAX_LINE_SIZE);
+        }
+
+        if (!FillBuffer())
+        {
+            return std::nullopt;
+        }
     }
-    else
+}
+
+bool Localfile::FillBuffer()
+{
+    if (m_buffer.empty())
+    {
+        m_buffer.resize(READ_BLOCK_SIZE);
+    }
+
+    // Keep the partial line, it is shorter than a log so there is always room to read
+    if (m_begin > 0)
+    {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+
+    // Reading from the buffer directly does not set eofbit, so new data is picked up by the next read
+    const auto bytesRead = m_stream->rdbuf()->sgetn(m_buffer.data() + m_end,
+                                                    static_cast<std::streamsize>(m_buffer.size() - m_end));
+
+    if (bytesRead <= 0)
+    {
+        return false;
+    }
+
+    m_end += static_cast<size_t>(bytesRead);
+    m_streamOffset += static_cast<uint64_t>(bytesRead);
+    return true;
+}
+
+void Localfile::ClearBuffer()
+{
+    m_begin = 0;
+    m_end = 0;
+}
+
+std::string Localfile::TakePartialLine()
+{
+    if (m_begin == m_end)
     {
-        m_stream->seekg(m_pos);
-        m_stream->clear();
         return {};
     }
+
+    auto line = std::string(m_buffer.data() + m_begin, m_end - m_begin);
+    m_begin = m_end;
+    return line;
 }
 
 void Localfile::SeekEnd()
 {
     m_stream->seekg(0, std::ios::end);
+    ClearBuffer();
+
+    const auto position = m_stream->tellg();
+    m_streamOffset = position > 0 ? static_cast<uint64_t>(position) : 0;
+}
+
+bool Localfile::SeekTo(uint64_t offset)
+{
+    const auto position = std::streampos(static_cast<std::streamoff>(offset));
+
+    m_stream->clear();
+    ClearBuffer();
+
+    if (m_stream->rdbuf()->pubseekpos(position, std::ios::in) != position)
+    {
+        m_streamOffset = 0;
+        return false;
+    }
+
+    m_streamOffset = offset;
+    return true;
+}
+
+std::pair<uint64_t, uint64_t> Localfile::HashHead(uint64_t size)
+{
+    std::array<char, HEAD_HASH_SIZE> head {};
+    auto* buffer = m_stream->rdbuf();
+    std::streamsize bytesRead = 0;
+
+    if (buffer->pubseekpos(0, std::ios::in) == std::streampos(0))
+    {
+        bytesRead = buffer->sgetn(head.data(), static_cast<std::streamsize>(std::min(size, HEAD_HASH_SIZE)));
+    }
+
+    // The buffered data starts at the stream offset, so the stream must go back there
+    buffer->pubseekpos(std::streampos(static_cast<std::streamoff>(m_streamOffset)), std::ios::in);
+
+    const auto headSize = bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+    return {headSize, HashData(head.data(), headSize)};
+}
+
+bool Localfile::Resume(const FileCheckpoint& checkpoint)
+{
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(m_filename, ec);
+
+    if (!ec && checkpoint.fileId == m_fileId && checkpoint.offset <= fileSize)
+    {
+        const auto [headSize, headHash] = HashHead(checkpoint.headSize);
+
+        if (headSize == checkpoint.headSize && headHash == checkpoint.headHash && SeekTo(checkpoint.offset))
+        {
+            m_headSize = headSize;
+            m_headHash = headHash;
+            return true;
+        }
+    }
+
+    SeekTo(0);
+    m_headSize = 0;
+    m_headHash = 0;
+    return false;
+}
+
+FileCheckpoint Localfile::Checkpoint()
+{
+    const auto offset = Offset();
+
+    // The head only covers data already read, so it grows along with the file until it reaches its full size
+    if (m_headSize < HEAD_HASH_SIZE && offset > m_headSize)
+    {
+        std::tie(m_headSize, m_headHash) = HashHead(std::min(offset, HEAD_HASH_SIZE));
+    }
+
+    return {m_fileId, offset, m_headSize, m_headHash};
 }
 
 bool Localfile::Rotated()
 {
+    if (GetFileId(m_filename) != m_fileId)
+    {
+        return true;
+    }
+
     try
     {
         auto fileSize = std::filesystem::file_size(m_filename);
@@ -147,11 +444,17 @@ bool Localfile::Rotated()
 void Localfile::Reopen()
 {
     m_stream = std::make_shared<std::ifstream>(m_filename);
+    ClearBuffer();
+    m_streamOffset = 0;
+    m_headSize = 0;
+    m_headHash = 0;
 
     if (m_stream->fail())
     {
         throw OpenError(m_filename);
     }
+
+    m_fileId = GetFileId(m_filename);
 }
 
 OpenError::OpenError(const std::string& filename)
@@ -3,6 +3,7 @@
 #include <glob.h>
 #include <logcollector.hpp>
 #include <logger.hpp>
+#include <sys/stat.h>
 
 #include <span>
 
@@ -40,3 +41,15 @@ void FileReader::Reload(const std::function<void(Localfile&)>& callback)
     AddLocalfiles(localfiles, callback);
     globfree(&globResult);
 }
+
+FileId logcollector::GetFileId(const std::string& filename)
+{
+    struct stat fileStat {};
+
+    if (stat(filename.c_str(), &fileStat) != 0)
+    {
+        throw OpenError(filename);
+    }
+
+    return {static_cast<uint64_t>(fileStat.st_dev), static_cast<uint64_t>(fileStat.st_ino)};
+}
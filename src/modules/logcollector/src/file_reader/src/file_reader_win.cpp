@@ -39,3 +39,31 @@ void FileReader::Reload(const std::function<void(Localfile&)>& callback)
     AddLocalfiles(files, callback);
     FindClose(hFind);
 }
+
+FileId logcollector::GetFileId(const std::string& filename)
+{
+    HANDLE hFile = CreateFile(filename.c_str(),
+                              0,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        throw OpenError(filename);
+    }
+
+    BY_HANDLE_FILE_INFORMATION fileInfo;
+    const auto success = GetFileInformationByHandle(hFile, &fileInfo);
+    CloseHandle(hFile);
+
+    if (!success)
+    {
+        throw OpenError(filename);
+    }
+
+    return {static_cast<uint64_t>(fileInfo.dwVolumeSerialNumber),
+            (static_cast<uint64_t>(fileInfo.nFileIndexHigh) << 32) | fileInfo.nFileIndexLow};
+}
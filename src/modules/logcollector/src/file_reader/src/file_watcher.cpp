@@ -0,0 +1,345 @@
+#include "file_watcher.hpp"
+
+#include <logger.hpp>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#if defined(__linux__)
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using namespace logcollector;
+
+namespace
+{
+#if defined(__linux__)
+    /// @brief Events that wake up the reader of a file: new data, truncation, rotation and deletion
+    constexpr uint32_t FILE_EVENTS = IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF;
+
+    /// @brief Events that make a file reader expand its pattern again
+    constexpr uint32_t DIRECTORY_EVENTS = IN_CREATE | IN_MOVED_TO;
+
+    /// @brief Size of the buffer the notifications are read into
+    constexpr size_t EVENTS_BUFFER_SIZE = 64 * 1024;
+#endif
+} // namespace
+
+FileWatcher::FileWatcher()
+{
+#if defined(__linux__)
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (m_fd == -1)
+    {
+        LogWarn("Cannot initialize inotify, files will be polled: {}", std::strerror(errno));
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#if defined(__linux__)
+    if (m_fd != -1)
+    {
+        close(m_fd);
+    }
+#endif
+}
+
+bool FileWatcher::Enabled() const
+{
+    return m_fd != -1;
+}
+
+bool FileWatcher::WatchFile([[maybe_unused]] const std::string& path, [[maybe_unused]] const void* owner)
+{
+#if defined(__linux__)
+    return AddWatch(path, owner, FILE_EVENTS);
+#else
+    return false;
+#endif
+}
+
+bool FileWatcher::WatchDirectory([[maybe_unused]] const std::string& path, [[maybe_unused]] const void* owner)
+{
+#if defined(__linux__)
+    return AddWatch(path, owner, DIRECTORY_EVENTS | IN_ONLYDIR);
+#else
+    return false;
+#endif
+}
+
+bool FileWatcher::AddWatch([[maybe_unused]] const std::string& path,
+                           [[maybe_unused]] const void* owner,
+                           [[maybe_unused]] uint32_t mask)
+{
+#if defined(__linux__)
+    if (!Enabled())
+    {
+        return false;
+    }
+
+    const auto wd = inotify_add_watch(m_fd, path.c_str(), mask);
+
+    if (wd == -1)
+    {
+        LogDebug("Cannot watch '{}', it will be polled: {}", path, std::strerror(errno));
+        Unwatch(path, owner);
+        return false;
+    }
+
+    auto& watch = m_watches[path];
+
+    if (watch.wd != -1 && watch.wd != wd && !SharedDescriptor(path, watch.wd))
+    {
+        // The path now points to a different file, the old one (if it still exists) is no longer of interest
+        inotify_rm_watch(m_fd, watch.wd);
+    }
+
+    watch.wd = wd;
+    watch.waiters.try_emplace(owner);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FileWatcher::SharedDescriptor(const std::string& path, int wd) const
+{
+    return std::any_of(m_watches.begin(),
+                       m_watches.end(),
+                       [&path, wd](const auto& watch) { return watch.first != path && watch.second.wd == wd; });
+}
+
+void FileWatcher::Unwatch(const std::string& path, const void* owner)
+{
+    const auto it = m_watches.find(path);
+
+    if (it == m_watches.end())
+    {
+        return;
+    }
+
+    if (const auto waiter = it->second.waiters.find(owner); waiter != it->second.waiters.end())
+    {
+        if (waiter->second.signal)
+        {
+            waiter->second.signal->cancel();
+        }
+
+        it->second.waiters.erase(waiter);
+    }
+
+    if (!it->second.waiters.empty())
+    {
+        return;
+    }
+
+#if defined(__linux__)
+    if (it->second.wd != -1 && !SharedDescriptor(path, it->second.wd))
+    {
+        inotify_rm_watch(m_fd, it->second.wd);
+    }
+#endif
+
+    m_watches.erase(it);
+}
+
+bool FileWatcher::Watching(const std::string& path, const void* owner) const
+{
+    const auto it = m_watches.find(path);
+    return it != m_watches.end() && it->second.waiters.contains(owner);
+}
+
+boost::asio::awaitable<bool>
+FileWatcher::WaitForChange(const std::string& path, const void* owner, std::chrono::milliseconds timeout)
+{
+    auto executor = co_await boost::asio::this_coro::executor;
+
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_executor)
+        {
+            m_executor = executor;
+        }
+    }
+
+    auto* waiter = FindWaiter(path, owner);
+
+    if (waiter == nullptr || m_stopped.load())
+    {
+        co_return false;
+    }
+
+    if (!waiter->changed)
+    {
+        if (!waiter->signal)
+        {
+            waiter->signal = std::make_shared<boost::asio::steady_timer>(executor);
+        }
+
+        const auto signal = waiter->signal;
+        signal->expires_after(timeout);
+
+        boost::system::error_code ec;
+        co_await signal->async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+        // The path may have been unwatched while waiting
+        waiter = FindWaiter(path, owner);
+
+        if (waiter == nullptr || m_stopped.load())
+        {
+            co_return false;
+        }
+    }
+
+    co_return std::exchange(waiter->changed, false);
+}
+
+FileWatcher::Waiter* FileWatcher::FindWaiter(const std::string& path, const void* owner)
+{
+    const auto it = m_watches.find(path);
+
+    if (it == m_watches.end())
+    {
+        return nullptr;
+    }
+
+    const auto waiter = it->second.waiters.find(owner);
+    return waiter == it->second.waiters.end() ? nullptr : &waiter->second;
+}
+
+boost::asio::awaitable<void> FileWatcher::Run()
+{
+#if defined(__linux__)
+    auto executor = co_await boost::asio::this_coro::executor;
+
+    // The descriptor owns a duplicate, so that it can close it without affecting the watches
+    boost::asio::posix::stream_descriptor descriptor(executor, dup(m_fd));
+
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_executor = executor;
+        m_cancelRead = [&descriptor]()
+        {
+            descriptor.cancel();
+        };
+    }
+
+    auto buffer = std::vector<char>(EVENTS_BUFFER_SIZE);
+
+    while (!m_stopped.load())
+    {
+        boost::system::error_code ec;
+        const auto length = co_await descriptor.async_read_some(
+            boost::asio::buffer(buffer), boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+        if (ec)
+        {
+            if (ec != boost::asio::error::operation_aborted)
+            {
+                LogWarn("Cannot read file notifications, files will be polled: {}", ec.message());
+            }
+            break;
+        }
+
+        ProcessEvents(buffer, length);
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelRead = nullptr;
+    }
+#endif
+    co_return;
+}
+
+void FileWatcher::ProcessEvents([[maybe_unused]] const std::vector<char>& buffer, [[maybe_unused]] size_t length)
+{
+#if defined(__linux__)
+    for (size_t offset = 0; offset + sizeof(inotify_event) <= length;)
+    {
+        inotify_event event {};
+        std::memcpy(&event, buffer.data() + offset, sizeof(inotify_event));
+        offset += sizeof(inotify_event) + event.len;
+
+        if ((event.mask & IN_Q_OVERFLOW) != 0)
+        {
+            // Notifications were lost, wake everyone up so that they check their files
+            for (const auto& watch : m_watches)
+            {
+                Notify(watch.second.wd);
+            }
+            continue;
+        }
+
+        Notify(event.wd);
+    }
+#endif
+}
+
+void FileWatcher::Notify(int wd)
+{
+    for (auto& [path, watch] : m_watches)
+    {
+        if (watch.wd != wd)
+        {
+            continue;
+        }
+
+        for (auto& [owner, waiter] : watch.waiters)
+        {
+            waiter.changed = true;
+
+            if (waiter.signal)
+            {
+                waiter.signal->cancel();
+            }
+        }
+    }
+}
+
+void FileWatcher::Stop()
+{
+    m_stopped.store(true);
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_executor)
+    {
+        boost::asio::post(*m_executor, [self = shared_from_this()]() { self->CancelAll(); });
+    }
+}
+
+void FileWatcher::CancelAll()
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cancelRead)
+        {
+            m_cancelRead();
+        }
+    }
+
+    for (auto& [path, watch] : m_watches)
+    {
+        for (auto& [owner, waiter] : watch.waiters)
+        {
+            if (waiter.signal)
+            {
+                waiter.signal->cancel();
+            }
+        }
+    }
+}
@@ -7,18 +7,27 @@
 #include <logger.hpp>
 #include <timeHelper.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdio>
 #include <iomanip>
+#include <iterator>
 #include <map>
 #include <sstream>
 
+#include "file_checkpoints.hpp"
 #include "file_reader.hpp"
+#include "file_watcher.hpp"
 
 using namespace logcollector;
 
 namespace logcollector
 {
     constexpr int ACTIVE_READERS_WAIT_MS = 10;
+
+    /// @brief Name of the file holding the reading positions, in the data folder
+    constexpr auto CHECKPOINTS_FILE_NAME = "logcollector.checkpoints";
 }
 
 void Logcollector::Start()
@@ -72,6 +81,10 @@ void Logcollector::Setup(std::shared_ptr<const configuration::ConfigurationParse
         m_ioContext.restart();
     }
 
+    m_cleaning = false;
+
+    SetupBatching(configurationParser);
+    SetupCheckpoints(configurationParser);
     SetupFileReader(configurationParser);
     AddPlatformSpecificReader(configurationParser);
 }
@@ -84,16 +97,61 @@ void Logcollector::SetupFileReader(const std::shared_ptr<const configuration::Co
     const auto reloadInterval = configurationParser->GetTimeConfigOrDefault(
         config::logcollector::DEFAULT_RELOAD_INTERVAL, "logcollector", "reload_interval");
 
+    const auto watchFiles = configurationParser->GetConfigOrDefault(
+        config::logcollector::DEFAULT_WATCH_FILES, "logcollector", "watch_files");
+
     const auto localFilesDefault = std::vector<std::string> {config::logcollector::DEFAULT_LOCALFILES};
 
     const auto localfiles = configurationParser->GetConfigOrDefault(localFilesDefault, "logcollector", "localfiles");
 
+    if (watchFiles && !localfiles.empty() && !m_fileWatcher)
+    {
+        // A single watcher serves every reader, so that the module takes one inotify instance
+        auto watcher = std::make_shared<FileWatcher>();
+
+        if (watcher->Enabled())
+        {
+            m_fileWatcher = std::move(watcher);
+            EnqueueTask(m_fileWatcher->Run());
+        }
+    }
+
     for (const auto& lf : localfiles)
     {
-        AddReader(std::make_shared<FileReader>(*this, lf, fileWait, reloadInterval));
+        AddReader(std::make_shared<FileReader>(*this, lf, fileWait, reloadInterval, m_fileWatcher, m_fileCheckpoints));
     }
 }
 
+void Logcollector::SetupBatching(const std::shared_ptr<const configuration::ConfigurationParser> configurationParser)
+{
+    m_batchMaxEvents = configurationParser->GetConfigInRangeOrDefault<size_t>(
+        config::logcollector::DEFAULT_BATCH_EVENTS, 1, 10000, "logcollector", "batch_events");
+
+    m_batchMaxBytes = configurationParser->GetBytesConfigInRangeOrDefault(
+        config::logcollector::DEFAULT_BATCH_SIZE, 1, 10000000, "logcollector", "batch_size");
+
+    m_batchInterval = std::chrono::milliseconds(configurationParser->GetTimeConfigInRangeOrDefault(
+        config::logcollector::DEFAULT_BATCH_INTERVAL, 1, 60000, "logcollector", "batch_interval"));
+
+    if (m_batchMaxEvents > 1)
+    {
+        EnqueueTask(RunBatchFlusher());
+    }
+}
+
+void Logcollector::SetupCheckpoints(
+    const std::shared_ptr<const configuration::ConfigurationParser> configurationParser)
+{
+    const auto dataPath = configurationParser->GetConfigOrDefault(config::DEFAULT_DATA_PATH, "agent", "path.data");
+
+    m_checkpointInterval = std::chrono::milliseconds(configurationParser->GetTimeConfigInRangeOrDefault(
+        config::logcollector::DEFAULT_CHECKPOINT_INTERVAL, 100, 3600000, "logcollector", "checkpoint_interval"));
+
+    m_fileCheckpoints = std::make_shared<FileCheckpoints>(dataPath + "/" + CHECKPOINTS_FILE_NAME);
+
+    EnqueueTask(RunCheckpointSaver());
+}
+
 void Logcollector::Stop()
 {
     CleanAllReaders();
@@ -133,11 +191,20 @@ void Logcollector::SendMessage(const std::string& location, const std::string& l
         throw std::runtime_error("Message queue not set, cannot send message.");
     }
 
-    auto metadata = nlohmann::json::object();
-    auto data = nlohmann::json::object();
+    const std::lock_guard<std::mutex> lock(m_batchesMutex);
+
+    // Each reader fills its own batches, so that the messages of a file are pushed together
+    auto& batch = m_batches[{collectorType, location}];
+
+    if (batch.metadata.empty())
+    {
+        auto metadata = nlohmann::json::object();
+        metadata["module"] = m_moduleName;
+        metadata["collector"] = collectorType;
+        batch.metadata = metadata.dump();
+    }
 
-    metadata["module"] = m_moduleName;
-    metadata["collector"] = collectorType;
+    auto data = nlohmann::json::object();
 
     if (collectorType == FILE_READER_TYPE)
     {
@@ -148,12 +215,161 @@ void Logcollector::SendMessage(const std::string& location, const std::string& l
         data["event"]["provider"] = location;
     }
     data["event"]["original"] = log;
-    data["event"]["created"] = Utils::getCurrentISO8601();
+    data["event"]["created"] = CurrentTimestamp();
+
+    batch.messages.push_back(std::move(data));
+    batch.bytes += log.size();
+
+    LogTrace("Message queued: '{}':'{}'", location, log);
+
+    if (batch.messages.size() >= m_batchMaxEvents || batch.bytes >= m_batchMaxBytes)
+    {
+        FlushBatch(collectorType, batch);
+    }
+}
+
+bool Logcollector::FlushBatches()
+{
+    const std::lock_guard<std::mutex> lock(m_batchesMutex);
+
+    bool flushed = true;
+
+    for (auto it = m_batches.begin(); it != m_batches.end();)
+    {
+        flushed = FlushBatch(it->first.first, it->second) && flushed;
+
+        // Locations come and go (e.g. rotated files with dated names), so the batches left empty are dropped
+        it = it->second.messages.empty() ? m_batches.erase(it) : std::next(it);
+    }
+
+    return flushed;
+}
+
+bool Logcollector::FlushBatch(const std::string& collectorType, MessageBatch& batch)
+{
+    if (batch.messages.empty())
+    {
+        return true;
+    }
+
+    const auto count = batch.messages.size();
+
+    // A single message is pushed as is, several ones as an array that is stored all at once. The queue stores nothing
+    // from an array that doesn't fit in it, so the messages are kept until it takes them.
+    auto data = count == 1 ? batch.messages[0] : batch.messages;
+    auto pushed = static_cast<size_t>(std::max(
+        m_pushMessage(Message(MessageType::STATELESS, std::move(data), m_moduleName, collectorType, batch.metadata)),
+        0));
+
+    if (pushed > 0)
+    {
+        if (pushed < count)
+        {
+            // The storage failed to store some of them, and there is no telling which
+            LogWarn("{} messages from {} could not be stored.", count - pushed, collectorType);
+        }
 
-    auto message = Message(MessageType::STATELESS, data, m_moduleName, collectorType, metadata.dump());
-    m_pushMessage(message);
+        LogTrace("{} messages pushed from {}", count, collectorType);
 
-    LogTrace("Message pushed: '{}':'{}'", location, log);
+        batch.messages = nlohmann::json::array();
+        batch.bytes = 0;
+        return true;
+    }
+
+    if (count > 1)
+    {
+        // The queue is nearly full, push as many messages as it has room for
+        while (pushed < count &&
+               m_pushMessage(Message(
+                   MessageType::STATELESS, batch.messages[pushed], m_moduleName, collectorType, batch.metadata)) > 0)
+        {
+            ++pushed;
+        }
+
+        LogTrace("{} messages pushed from {}", pushed, collectorType);
+    }
+
+    batch.messages.erase(batch.messages.begin(), batch.messages.begin() + static_cast<std::ptrdiff_t>(pushed));
+
+    if (batch.messages.size() > m_batchMaxEvents)
+    {
+        // The queue is full, do not hold more messages than a batch
+        const auto dropped = batch.messages.size() - m_batchMaxEvents;
+        batch.messages.erase(batch.messages.begin(), batch.messages.begin() + static_cast<std::ptrdiff_t>(dropped));
+        LogWarn("The queue is full, {} messages from {} dropped.", dropped, collectorType);
+    }
+
+    batch.bytes = 0;
+    for (const auto& message : batch.messages)
+    {
+        batch.bytes += message["event"]["original"].get_ref<const std::string&>().size();
+    }
+
+    return false;
+}
+
+Awaitable Logcollector::RunBatchFlusher()
+{
+    while (!m_cleaning.load())
+    {
+        co_await Wait(m_batchInterval);
+        FlushBatches();
+    }
+}
+
+void Logcollector::SaveCheckpoints()
+{
+    if (!m_fileCheckpoints)
+    {
+        return;
+    }
+
+    // A position is only saved once the lines before it are in the queue, so none is lost on a crash
+    if (!FlushBatches())
+    {
+        LogDebug("The queue has no room for every pending message, reading positions not saved.");
+        return;
+    }
+
+    m_fileCheckpoints->Save();
+}
+
+Awaitable Logcollector::RunCheckpointSaver()
+{
+    while (!m_cleaning.load())
+    {
+        co_await Wait(m_checkpointInterval);
+        SaveCheckpoints();
+    }
+}
+
+std::string Logcollector::CurrentTimestamp()
+{
+    const auto now = std::chrono::system_clock::now();
+    const auto seconds = std::chrono::system_clock::to_time_t(now);
+
+    if (seconds != m_timestampSecond)
+    {
+        struct tm buf {};
+        std::array<char, 32> formatted {};
+
+        if (gmtime_r(&seconds, &buf) == nullptr ||
+            std::strftime(formatted.data(), formatted.size(), "%FT%T", &buf) == 0)
+        {
+            return Utils::getCurrentISO8601();
+        }
+
+        m_timestampPrefix = formatted.data();
+        m_timestampSecond = seconds;
+    }
+
+    const auto milliseconds =
+        std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+
+    std::array<char, 8> suffix {};
+    std::snprintf(suffix.data(), suffix.size(), ".%03dZ", static_cast<int>(milliseconds));
+
+    return m_timestampPrefix + suffix.data();
 }
 
 void Logcollector::AddReader(std::shared_ptr<IReader> reader)
@@ -164,11 +380,18 @@ void Logcollector::AddReader(std::shared_ptr<IReader> reader)
 
 void Logcollector::CleanAllReaders()
 {
+    m_cleaning = true;
+
     for (const auto& reader : m_readers)
     {
         reader->Stop();
     }
 
+    if (m_fileWatcher)
+    {
+        m_fileWatcher->Stop();
+    }
+
     {
         const std::lock_guard<std::mutex> lock(m_timersMutex);
         for (const auto& timer : m_timers)
@@ -182,6 +405,11 @@ void Logcollector::CleanAllReaders()
         std::this_thread::sleep_for(std::chrono::milliseconds(ACTIVE_READERS_WAIT_MS));
     }
     m_readers.clear();
+    m_fileWatcher.reset();
+
+    // Messages read before stopping are not lost
+    FlushBatches();
+    SaveCheckpoints();
 }
 
 Awaitable Logcollector::Wait(std::chrono::milliseconds ms)
@@ -1,9 +1,17 @@
 #include <gtest/gtest.h>
+#include <fstream>
 #include <list>
 #include <spdlog/spdlog.h>
 #include <sstream>
 
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <config.h>
+#include <file_checkpoints.hpp>
 #include <file_reader.hpp>
+#include <file_watcher.hpp>
 #include <logcollector.hpp>
 #include <logcollector_mock.hpp>
 #include <tempfile.hpp>
@@ -40,6 +48,36 @@ TEST(Localfile, PartialLine)
     ASSERT_EQ(answer, "Hello World");
 }
 
+TEST(Localfile, MultipleLines)
+{
+    auto stream = std::make_shared<std::stringstream>();
+    auto lf = Localfile(stream);
+
+    *stream << "Line 1\n\nLine 3\nLine";
+    ASSERT_EQ(lf.NextLine(), "Line 1");
+    ASSERT_EQ(lf.NextLine(), "");
+    ASSERT_EQ(lf.NextLine(), "Line 3");
+    ASSERT_EQ(lf.NextLine(), std::nullopt);
+
+    *stream << " 4\n";
+    ASSERT_EQ(lf.NextLine(), "Line 4");
+    ASSERT_EQ(lf.NextLine(), std::nullopt);
+}
+
+TEST(Localfile, LongLineIsSplit)
+{
+    auto stream = std::make_shared<std::stringstream>();
+    auto lf = Localfile(stream);
+
+    const auto longLine = std::string(config::logcollector::BUFFER_SIZE + 10, 'a');
+    *stream << longLine << "\nHello World\n";
+
+    const auto first = lf.NextLog();
+    ASSERT_EQ(first.size(), config::logcollector::BUFFER_SIZE - 1);
+    ASSERT_EQ(first + lf.NextLog(), longLine);
+    ASSERT_EQ(lf.NextLog(), "Hello World");
+}
+
 TEST(Localfile, OpenError)
 {
     try
@@ -104,3 +142,270 @@ TEST(FileReader, Reload)
     auto d = TempFile("/tmp/fileD.log");
     reader.Reload([&](Localfile& lf) { mockCallback.Call(lf.Filename()); });
 }
+
+TEST(Localfile, RotatedByRename)
+{
+    auto fileA = std::make_unique<TempFile>("/tmp/A.log", "Hello World\n");
+    auto lf = Localfile("/tmp/A.log");
+
+    lf.SeekEnd();
+    ASSERT_FALSE(lf.Rotated());
+
+    // The new file is larger than the reading position, only its inode tells it apart
+    std::filesystem::rename("/tmp/A.log", "/tmp/A.log.1");
+    auto fileB = TempFile("/tmp/A.log", "Hello World, after the rotation\n");
+    ASSERT_TRUE(lf.Rotated());
+
+    lf.Reopen();
+    ASSERT_FALSE(lf.Rotated());
+    ASSERT_EQ(lf.NextLog(), "Hello World, after the rotation");
+
+    std::filesystem::remove("/tmp/A.log.1");
+}
+
+TEST(Localfile, TakePartialLine)
+{
+    auto stream = std::make_shared<std::stringstream>();
+    auto lf = Localfile(stream);
+
+    *stream << "Line 1\nLine";
+    ASSERT_EQ(lf.NextLine(), "Line 1");
+    ASSERT_EQ(lf.NextLine(), std::nullopt);
+    ASSERT_EQ(lf.TakePartialLine(), "Line");
+    ASSERT_EQ(lf.TakePartialLine(), "");
+}
+
+TEST(Localfile, ResumesAtCheckpoint)
+{
+    auto fileA = TempFile("/tmp/A.log", "Line 1\nLine 2\n");
+    auto checkpoint = FileCheckpoint();
+
+    {
+        auto lf = Localfile("/tmp/A.log");
+        ASSERT_EQ(lf.NextLog(), "Line 1");
+        checkpoint = lf.Checkpoint();
+        ASSERT_EQ(checkpoint.offset, 7);
+        ASSERT_EQ(checkpoint.headSize, 7);
+    }
+
+    fileA.Write("Line 3\n");
+
+    auto lf = Localfile("/tmp/A.log");
+    ASSERT_TRUE(lf.Resume(checkpoint));
+    ASSERT_EQ(lf.NextLog(), "Line 2");
+    ASSERT_EQ(lf.NextLog(), "Line 3");
+    ASSERT_EQ(lf.Checkpoint().offset, 21);
+}
+
+TEST(Localfile, ResumeOfChangedFileStartsAtBeginning)
+{
+    auto checkpoint = FileCheckpoint();
+
+    {
+        auto fileA = TempFile("/tmp/A.log", "Line 1\nLine 2\n");
+        auto lf = Localfile("/tmp/A.log");
+        lf.SeekEnd();
+        checkpoint = lf.Checkpoint();
+    }
+
+    // Even if the new file gets the same inode, its first bytes tell it apart
+    auto fileB = TempFile("/tmp/A.log", "Other 1\nOther 2\n");
+    auto lf = Localfile("/tmp/A.log");
+
+    ASSERT_FALSE(lf.Resume(checkpoint));
+    ASSERT_EQ(lf.NextLog(), "Other 1");
+}
+
+TEST(FileCheckpoints, SaveAndLoad)
+{
+    const auto path = std::string("/tmp/logcollector.checkpoints");
+    const auto checkpoint = FileCheckpoint {{1, 2}, 3, 4, 5}; // NOLINT
+
+    {
+        auto checkpoints = FileCheckpoints(path);
+        checkpoints.Set("/tmp/A.log", checkpoint);
+        checkpoints.Set("/tmp/with spaces.log", checkpoint);
+        checkpoints.Set("/tmp/B.log", checkpoint);
+        checkpoints.Remove("/tmp/B.log");
+        ASSERT_TRUE(checkpoints.Save());
+    }
+
+    auto checkpoints = FileCheckpoints(path);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(checkpoints.Get("/tmp/A.log"), checkpoint);
+    ASSERT_EQ(checkpoints.Get("/tmp/with spaces.log"), checkpoint);
+    ASSERT_EQ(checkpoints.Get("/tmp/B.log"), std::nullopt);
+}
+
+TEST(FileCheckpoints, SaveFailsWithoutDirectory)
+{
+    auto checkpoints = FileCheckpoints("/tmp/missing-logcollector-dir/logcollector.checkpoints");
+    checkpoints.Set("/tmp/A.log", FileCheckpoint {{1, 2}, 3, 4, 5}); // NOLINT
+
+    ASSERT_FALSE(checkpoints.Save());
+    ASSERT_FALSE(std::filesystem::exists("/tmp/missing-logcollector-dir"));
+}
+
+TEST(FileCheckpoints, ReplaceFileContents)
+{
+    const auto path = std::string("/tmp/logcollector.replaced");
+
+    ASSERT_TRUE(ReplaceFileContents(path, "first\n"));
+    ASSERT_TRUE(ReplaceFileContents(path, "second\n"));
+
+    std::ifstream file(path);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(contents, "second\n");
+    ASSERT_FALSE(std::filesystem::exists(path + ".tmp"));
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+TEST(FileWatcher, WakesUpOnModification)
+{
+    auto watcher = std::make_shared<FileWatcher>();
+
+    if (!watcher->Enabled())
+    {
+        GTEST_SKIP() << "File watching is not available";
+    }
+
+    auto file = TempFile("/tmp/watched.log");
+    ASSERT_TRUE(watcher->WatchFile(file.Path(), this));
+
+    auto changed = false;
+    boost::asio::io_context ioContext;
+
+    boost::asio::co_spawn(ioContext, watcher->Run(), boost::asio::detached);
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            file.Write("Hello World\n");
+            changed = co_await watcher->WaitForChange(file.Path(), this, std::chrono::seconds(10));
+            watcher->Stop();
+        },
+        boost::asio::detached);
+
+    const auto start = std::chrono::steady_clock::now();
+    ioContext.run();
+
+    EXPECT_TRUE(changed);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST(FileWatcher, WakesUpOnNewFile)
+{
+    auto watcher = std::make_shared<FileWatcher>();
+
+    if (!watcher->Enabled())
+    {
+        GTEST_SKIP() << "File watching is not available";
+    }
+
+    std::filesystem::create_directories("/tmp/watched");
+    ASSERT_TRUE(watcher->WatchDirectory("/tmp/watched", this));
+
+    auto changed = false;
+    boost::asio::io_context ioContext;
+
+    boost::asio::co_spawn(ioContext, watcher->Run(), boost::asio::detached);
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            auto file = TempFile("/tmp/watched/new.log");
+            changed = co_await watcher->WaitForChange("/tmp/watched", this, std::chrono::seconds(10));
+            watcher->Stop();
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+    std::filesystem::remove_all("/tmp/watched");
+
+    EXPECT_TRUE(changed);
+}
+
+TEST(FileWatcher, SharesWatchesBetweenOwners)
+{
+    auto watcher = std::make_shared<FileWatcher>();
+
+    if (!watcher->Enabled())
+    {
+        GTEST_SKIP() << "File watching is not available";
+    }
+
+    const auto first = 1;
+    const auto second = 2;
+
+    std::filesystem::create_directories("/tmp/watched");
+    ASSERT_TRUE(watcher->WatchDirectory("/tmp/watched", &first));
+    ASSERT_TRUE(watcher->WatchDirectory("/tmp/watched", &second));
+
+    auto firstChanged = false;
+    auto secondChanged = false;
+    auto firstWatching = true;
+    auto secondWatching = false;
+    boost::asio::io_context ioContext;
+
+    boost::asio::co_spawn(ioContext, watcher->Run(), boost::asio::detached);
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            auto file = TempFile("/tmp/watched/new.log");
+            firstChanged = co_await watcher->WaitForChange("/tmp/watched", &first, std::chrono::seconds(10));
+            secondChanged = co_await watcher->WaitForChange("/tmp/watched", &second, std::chrono::seconds(10));
+
+            // Releasing the watch of one owner does not affect the other one
+            watcher->Unwatch("/tmp/watched", &first);
+            firstWatching = watcher->Watching("/tmp/watched", &first);
+            secondWatching = watcher->Watching("/tmp/watched", &second);
+            watcher->Stop();
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+    std::filesystem::remove_all("/tmp/watched");
+
+    EXPECT_TRUE(firstChanged);
+    EXPECT_TRUE(secondChanged);
+    EXPECT_FALSE(firstWatching);
+    EXPECT_TRUE(secondWatching);
+}
+
+TEST(FileWatcher, TimesOutWithoutChanges)
+{
+    auto watcher = std::make_shared<FileWatcher>();
+
+    if (!watcher->Enabled())
+    {
+        GTEST_SKIP() << "File watching is not available";
+    }
+
+    auto file = TempFile("/tmp/watched.log");
+    ASSERT_TRUE(watcher->WatchFile(file.Path(), this));
+
+    auto changed = true;
+    auto unwatchedChanged = true;
+    boost::asio::io_context ioContext;
+
+    boost::asio::co_spawn(ioContext, watcher->Run(), boost::asio::detached);
+    boost::asio::co_spawn(
+        ioContext,
+        [&]() -> boost::asio::awaitable<void>
+        {
+            changed = co_await watcher->WaitForChange(file.Path(), this, std::chrono::milliseconds(50));
+            unwatchedChanged = co_await watcher->WaitForChange("/tmp/unwatched.log", this, std::chrono::seconds(10));
+            watcher->Stop();
+        },
+        boost::asio::detached);
+
+    ioContext.run();
+
+    EXPECT_FALSE(changed);
+    EXPECT_FALSE(unwatchedChanged);
+}
+// NOLINTEND(cppcoreguidelines-avoid-capturing-lambda-coroutines)
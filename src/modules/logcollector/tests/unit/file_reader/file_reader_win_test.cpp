@@ -3,6 +3,7 @@
 #include <spdlog/spdlog.h>
 #include <sstream>
 
+#include <config.h>
 #include <file_reader.hpp>
 #include <logcollector.hpp>
 #include <logcollector_mock.hpp>
@@ -48,6 +49,36 @@ TEST(Localfile, PartialLine)
     ASSERT_EQ(answer, "Hello World");
 }
 
+TEST(Localfile, MultipleLines)
+{
+    auto stream = std::make_shared<std::stringstream>();
+    auto lf = Localfile(stream);
+
+    *stream << "Line 1\n\nLine 3\nLine";
+    ASSERT_EQ(lf.NextLine(), "Line 1");
+    ASSERT_EQ(lf.NextLine(), "");
+    ASSERT_EQ(lf.NextLine(), "Line 3");
+    ASSERT_EQ(lf.NextLine(), std::nullopt);
+
+    *stream << " 4\n";
+    ASSERT_EQ(lf.NextLine(), "Line 4");
+    ASSERT_EQ(lf.NextLine(), std::nullopt);
+}
+
+TEST(Localfile, LongLineIsSplit)
+{
+    auto stream = std::make_shared<std::stringstream>();
+    auto lf = Localfile(stream);
+
+    const auto longLine = std::string(config::logcollector::BUFFER_SIZE + 10, 'a');
+    *stream << longLine << "\nHello World\n";
+
+    const auto first = lf.NextLog();
+    ASSERT_EQ(first.size(), config::logcollector::BUFFER_SIZE - 1);
+    ASSERT_EQ(first + lf.NextLog(), longLine);
+    ASSERT_EQ(lf.NextLog(), "Hello World");
+}
+
 TEST(Localfile, OpenError)
 {
     try
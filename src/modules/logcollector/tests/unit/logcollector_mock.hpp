@@ -29,6 +29,36 @@ namespace logcollector
             Logcollector::SetupFileReader(configurationParser);
         }
 
+        void SetupBatching(std::shared_ptr<const configuration::ConfigurationParser> configurationParser)
+        {
+            Logcollector::SetupBatching(configurationParser);
+        }
+
+        bool FlushBatches()
+        {
+            return Logcollector::FlushBatches();
+        }
+
+        void SetupCheckpoints(std::shared_ptr<const configuration::ConfigurationParser> configurationParser)
+        {
+            Logcollector::SetupCheckpoints(configurationParser);
+        }
+
+        void SaveCheckpoints()
+        {
+            Logcollector::SaveCheckpoints();
+        }
+
+        std::shared_ptr<FileCheckpoints> Checkpoints()
+        {
+            return m_fileCheckpoints;
+        }
+
+        std::shared_ptr<FileWatcher> Watcher()
+        {
+            return m_fileWatcher;
+        }
+
         MOCK_METHOD(void, AddReader, (std::shared_ptr<IReader> reader), (override));
         MOCK_METHOD(void, EnqueueTask, (Awaitable task), (override));
         MOCK_METHOD(boost::asio::awaitable<void>, Wait, (std::chrono::milliseconds ms), (override));
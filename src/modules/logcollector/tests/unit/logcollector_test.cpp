@@ -1,7 +1,10 @@
 #include "logcollector_mock.hpp"
 #include "tempfile.hpp"
 #include <configuration_parser.hpp>
+#include <file_checkpoints.hpp>
 #include <file_reader.hpp>
+#include <file_watcher.hpp>
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <regex>
 
@@ -53,6 +56,33 @@ TEST(Logcollector, SetupFileReader)
     ASSERT_NE(capturedReader2, nullptr);
 }
 
+TEST(Logcollector, SetupFileReaderSharesWatcher)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      localfiles:
+        - /var/log/auth.log
+        - /var/log/syslog
+      watch_files: true
+    )";
+
+    auto logcollector = LogcollectorMock();
+    auto config = std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW));
+
+    if (!FileWatcher().Enabled())
+    {
+        GTEST_SKIP() << "File watching is not available";
+    }
+
+    // The readers are not run, so the only task is the watcher, started once for both of them
+    EXPECT_CALL(logcollector, AddReader(::testing::_)).Times(2).WillRepeatedly(::testing::Return());
+    EXPECT_CALL(logcollector, EnqueueTask(::testing::_)).Times(1);
+
+    logcollector.SetupFileReader(config);
+
+    ASSERT_NE(logcollector.Watcher(), nullptr);
+}
+
 TEST(Logcollector, SendMessageFile)
 {
     PushMessageMock mock;
@@ -103,6 +133,223 @@ TEST(Logcollector, SendMessageApp)
     ASSERT_EQ(capturedMessage.metaData, METADATA);
 }
 
+TEST(Logcollector, SendMessageBatchesMessages)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      batch_events: 3
+    )";
+
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+    auto config = std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW));
+
+    EXPECT_CALL(logcollector, EnqueueTask(::testing::_)).Times(1);
+    logcollector.SetupBatching(config);
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    Message capturedMessage(MessageType::STATELESS, nlohmann::json::object(), "", "", "");
+
+    EXPECT_CALL(mock, Call(::testing::_)).Times(0);
+
+    logcollector.SendMessage("/test/location1", "log 1", "file");
+    logcollector.SendMessage("/test/location2", "log 2", "file");
+    logcollector.SendMessage("/test/location1", "log 3", "file");
+    ::testing::Mock::VerifyAndClearExpectations(&mock);
+
+    EXPECT_CALL(mock, Call(::testing::_))
+        .WillOnce(::testing::DoAll(::testing::SaveArg<0>(&capturedMessage), ::testing::Return(3)));
+
+    // The third message of a location fills its batch, which is pushed as a single message
+    logcollector.SendMessage("/test/location1", "log 4", "file");
+
+    ASSERT_TRUE(capturedMessage.data.is_array());
+    ASSERT_EQ(capturedMessage.data.size(), 3);
+    ASSERT_EQ(capturedMessage.data[1]["event"]["original"], "log 3");
+    ASSERT_EQ(capturedMessage.data[2]["log"]["file"]["path"], "/test/location1");
+    ASSERT_EQ(capturedMessage.data[2]["event"]["original"], "log 4");
+    ASSERT_TRUE(IsISO8601(capturedMessage.data[2]["event"]["created"]));
+    ASSERT_EQ(capturedMessage.moduleType, "file");
+    ASSERT_EQ(capturedMessage.metaData, R"({"collector":"file","module":"logcollector"})");
+    ::testing::Mock::VerifyAndClearExpectations(&mock);
+
+    // The other location keeps its own batch
+    EXPECT_CALL(mock, Call(::testing::_))
+        .WillOnce(::testing::DoAll(::testing::SaveArg<0>(&capturedMessage), ::testing::Return(1)));
+
+    logcollector.FlushBatches();
+
+    ASSERT_EQ(capturedMessage.data["log"]["file"]["path"], "/test/location2");
+    ASSERT_EQ(capturedMessage.data["event"]["original"], "log 2");
+}
+
+TEST(Logcollector, FlushBatchesPushesPendingMessagesPerLocation)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      batch_events: 100
+    )";
+
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+    auto config = std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW));
+
+    EXPECT_CALL(logcollector, EnqueueTask(::testing::_)).Times(1);
+    logcollector.SetupBatching(config);
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    std::vector<Message> capturedMessages;
+
+    EXPECT_CALL(mock, Call(::testing::_))
+        .Times(2)
+        .WillRepeatedly(::testing::DoAll(
+            ::testing::Invoke([&capturedMessages](Message message) { capturedMessages.push_back(std::move(message)); }),
+            ::testing::Return(1)));
+
+    logcollector.SendMessage("/test/location", "log 1", "file");
+    logcollector.SendMessage("/test/location", "log 2", "file");
+    logcollector.SendMessage("Audit", "log 3", "windows-eventlog");
+    logcollector.FlushBatches();
+
+    // Nothing is left to push
+    logcollector.FlushBatches();
+
+    ASSERT_EQ(capturedMessages.size(), 2);
+    ASSERT_EQ(capturedMessages[0].moduleType, "file");
+    ASSERT_EQ(capturedMessages[0].data.size(), 2);
+    ASSERT_EQ(capturedMessages[1].moduleType, "windows-eventlog");
+    ASSERT_EQ(capturedMessages[1].data["event"]["original"], "log 3");
+}
+
+TEST(Logcollector, SendMessagePushesBatchOverSizeLimit)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      batch_events: 100
+      batch_size: 10B
+    )";
+
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+    auto config = std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW));
+
+    EXPECT_CALL(logcollector, EnqueueTask(::testing::_)).Times(1);
+    logcollector.SetupBatching(config);
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    EXPECT_CALL(mock, Call(::testing::Field(&Message::data, ::testing::SizeIs(2)))).WillOnce(::testing::Return(2));
+
+    logcollector.SendMessage("/test/location", "12345", "file");
+    logcollector.SendMessage("/test/location", "67890", "file");
+}
+
+TEST(Logcollector, FlushBatchKeepsMessagesTheQueueHasNoRoomFor)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      batch_events: 3
+    )";
+
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+    auto config = std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW));
+
+    EXPECT_CALL(logcollector, EnqueueTask(::testing::_)).Times(1);
+    logcollector.SetupBatching(config);
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    // The queue has room for two messages only, so the batch is not stored and its messages are pushed one by one
+    const ::testing::InSequence sequence;
+    EXPECT_CALL(mock, Call(::testing::Field(&Message::data, ::testing::SizeIs(3)))).WillOnce(::testing::Return(0));
+    EXPECT_CALL(mock,
+                Call(::testing::Field(&Message::data,
+                                      ::testing::Truly([](const nlohmann::json& data) { return data.is_object(); }))))
+        .WillOnce(::testing::Return(1))
+        .WillOnce(::testing::Return(1))
+        .WillOnce(::testing::Return(0));
+
+    logcollector.SendMessage("/test/location", "log 1", "file");
+    logcollector.SendMessage("/test/location", "log 2", "file");
+    logcollector.SendMessage("/test/location", "log 3", "file");
+    ::testing::Mock::VerifyAndClearExpectations(&mock);
+
+    // The last one is pushed once the queue has room again
+    Message capturedMessage(MessageType::STATELESS, nlohmann::json::object(), "", "", "");
+    EXPECT_CALL(mock, Call(::testing::_))
+        .WillOnce(::testing::DoAll(::testing::SaveArg<0>(&capturedMessage), ::testing::Return(1)));
+
+    logcollector.FlushBatches();
+
+    ASSERT_EQ(capturedMessage.data["event"]["original"], "log 3");
+}
+
+TEST(Logcollector, FlushBatchDropsMessagesOverABatchWhenTheQueueIsFull)
+{
+    auto constexpr CONFIG_RAW = R"(
+    logcollector:
+      batch_events: 2
+    )";
+
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+    auto config = std::make_shared<configuration::ConfigurationParser>(std::string(CONFIG_RAW));
+
+    EXPECT_CALL(logcollector, EnqueueTask(::testing::_)).Times(1);
+    logcollector.SetupBatching(config);
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    EXPECT_CALL(mock, Call(::testing::_)).WillRepeatedly(::testing::Return(0));
+
+    logcollector.SendMessage("/test/location", "log 1", "file");
+    logcollector.SendMessage("/test/location", "log 2", "file");
+    logcollector.SendMessage("/test/location", "log 3", "file");
+    ::testing::Mock::VerifyAndClearExpectations(&mock);
+
+    Message capturedMessage(MessageType::STATELESS, nlohmann::json::object(), "", "", "");
+    EXPECT_CALL(mock, Call(::testing::_))
+        .WillOnce(::testing::DoAll(::testing::SaveArg<0>(&capturedMessage), ::testing::Return(2)));
+
+    logcollector.FlushBatches();
+
+    ASSERT_EQ(capturedMessage.data.size(), 2);
+    ASSERT_EQ(capturedMessage.data[0]["event"]["original"], "log 2");
+    ASSERT_EQ(capturedMessage.data[1]["event"]["original"], "log 3");
+}
+
+TEST(Logcollector, SaveCheckpointsWaitsForPendingMessages)
+{
+    const auto dataPath = std::filesystem::temp_directory_path() / "logcollector_checkpoints_test";
+    const auto checkpointsPath = dataPath / "logcollector.checkpoints";
+    const auto configRaw = "agent:\n  path.data: " + dataPath.string() + "\nlogcollector:\n  batch_events: 2\n";
+
+    std::filesystem::remove_all(dataPath);
+    std::filesystem::create_directories(dataPath);
+
+    PushMessageMock mock;
+    LogcollectorMock logcollector;
+    auto config = std::make_shared<configuration::ConfigurationParser>(configRaw);
+
+    EXPECT_CALL(logcollector, EnqueueTask(::testing::_)).Times(2);
+    logcollector.SetupBatching(config);
+    logcollector.SetupCheckpoints(config);
+    logcollector.SetPushMessageFunction([&mock](Message message) { return mock.Call(std::move(message)); });
+
+    logcollector.SendMessage("/tmp/A.log", "log 1", "file");
+    logcollector.Checkpoints()->Set("/tmp/A.log", FileCheckpoint {{1, 2}, 6, 0, 0}); // NOLINT
+
+    // The line before the position is not in the queue yet, so the position is not saved
+    EXPECT_CALL(mock, Call(::testing::_)).WillOnce(::testing::Return(0));
+    logcollector.SaveCheckpoints();
+    ASSERT_FALSE(std::filesystem::exists(checkpointsPath));
+    ::testing::Mock::VerifyAndClearExpectations(&mock);
+
+    EXPECT_CALL(mock, Call(::testing::_)).WillOnce(::testing::Return(1));
+    logcollector.SaveCheckpoints();
+    ASSERT_TRUE(std::filesystem::exists(checkpointsPath));
+
+    std::filesystem::remove_all(dataPath);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);